@@ -8,16 +8,23 @@
 #include <limits>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <ImfChannelList.h>
+#include <ImfCompression.h>
 #include <ImfFrameBuffer.h>
 #include <ImfHeader.h>
 #include <ImfInputPart.h>
 #include <ImfMultiPartInputFile.h>
-#include <ImfOutputFile.h>
+#include <ImfMultiPartOutputFile.h>
+#include <ImfOutputPart.h>
 #include <ImfPartType.h>
+#include <ImfThreading.h>
+#include <ImfTileDescription.h>
 #include <ImfTiledInputPart.h>
+#include <ImfTiledOutputPart.h>
 
 namespace crisp {
 namespace {
@@ -25,6 +32,19 @@ namespace openexr = OPENEXR_IMF_NAMESPACE;
 
 constexpr uint32_t kRgbaChannelCount = 4;
 
+constexpr std::array<std::pair<std::string_view, ExrCompression>, 10> kCompressionNames = {{
+    {"none", ExrCompression::None},
+    {"rle", ExrCompression::Rle},
+    {"zips", ExrCompression::Zips},
+    {"zip", ExrCompression::Zip},
+    {"piz", ExrCompression::Piz},
+    {"pxr24", ExrCompression::Pxr24},
+    {"b44", ExrCompression::B44},
+    {"b44a", ExrCompression::B44a},
+    {"dwaa", ExrCompression::Dwaa},
+    {"dwab", ExrCompression::Dwab},
+}};
+
 std::string pathToUtf8(const std::filesystem::path& path) {
     const auto utf8Path = path.u8string();
     return {reinterpret_cast<const char*>(utf8Path.data()), utf8Path.size()};
@@ -50,6 +70,47 @@ std::vector<std::string> getChannelNames(const openexr::ChannelList& channels) {
     return channelNames;
 }
 
+openexr::Compression toOpenExrCompression(const ExrCompression compression) {
+    switch (compression) {
+    case ExrCompression::None:
+        return openexr::NO_COMPRESSION;
+    case ExrCompression::Rle:
+        return openexr::RLE_COMPRESSION;
+    case ExrCompression::Zips:
+        return openexr::ZIPS_COMPRESSION;
+    case ExrCompression::Zip:
+        return openexr::ZIP_COMPRESSION;
+    case ExrCompression::Piz:
+        return openexr::PIZ_COMPRESSION;
+    case ExrCompression::Pxr24:
+        return openexr::PXR24_COMPRESSION;
+    case ExrCompression::B44:
+        return openexr::B44_COMPRESSION;
+    case ExrCompression::B44a:
+        return openexr::B44A_COMPRESSION;
+    case ExrCompression::Dwaa:
+        return openexr::DWAA_COMPRESSION;
+    case ExrCompression::Dwab:
+        return openexr::DWAB_COMPRESSION;
+    }
+    return openexr::ZIP_COMPRESSION;
+}
+
+// Returns a copy of interleaved pixel data with the order of its rows reversed.
+std::vector<float> flipRows(
+    const std::span<const float> pixelData,
+    const uint32_t width,
+    const uint32_t height,
+    const uint32_t valuesPerPixel) {
+    std::vector<float> flippedPixelData(pixelData.size());
+    const size_t rowValueCount = static_cast<size_t>(width) * valuesPerPixel;
+    for (uint32_t y = 0; y < height; ++y) {
+        const auto source = pixelData.begin() + static_cast<size_t>(height - 1 - y) * rowValueCount;
+        std::ranges::copy_n(source, rowValueCount, flippedPixelData.begin() + static_cast<size_t>(y) * rowValueCount);
+    }
+    return flippedPixelData;
+}
+
 Result<ExrImageData> loadSinglePartExr(openexr::MultiPartInputFile& inputFile, const std::string& path) {
     const auto& header = inputFile.header(0);
     const auto& dataWindow = header.dataWindow();
@@ -142,19 +203,23 @@ Result<ExrImageData> loadExr(const std::filesystem::path& imagePath) {
     }
 }
 
+Result<ExrCompression> parseExrCompression(const std::string_view name) {
+    for (const auto& [compressionName, compression] : kCompressionNames) {
+        if (compressionName == name) {
+            return compression;
+        }
+    }
+    return resultError("Unknown EXR compression '{}'", name);
+}
+
 Result<> saveExr(
     const std::filesystem::path& outputPath,
     const std::span<const float> hdrPixelData,
     const uint32_t width,
     const uint32_t height,
     const FlipAxis flipAxis) {
-    if (width == 0 || height == 0 || width > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
-        height > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
-        return resultError("Invalid EXR output dimensions {}x{} for {}", width, height, pathToUtf8(outputPath));
-    }
-
     const uint64_t expectedValueCount = static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * kRgbaChannelCount;
-    if (expectedValueCount > std::numeric_limits<size_t>::max() || hdrPixelData.size() != expectedValueCount) {
+    if (hdrPixelData.size() != expectedValueCount) {
         return resultError(
             "Invalid RGBA data for EXR output {}: {}x{} requires {} values, received {}",
             pathToUtf8(outputPath),
@@ -164,41 +229,110 @@ Result<> saveExr(
             hdrPixelData.size());
     }
 
-    std::vector<float> flippedPixelData;
-    std::span<const float> pixelData = hdrPixelData;
-    if (flipAxis == FlipAxis::Y) {
-        flippedPixelData.resize(hdrPixelData.size());
-        const size_t rowValueCount = static_cast<size_t>(width) * kRgbaChannelCount;
-        for (uint32_t y = 0; y < height; ++y) {
-            const auto source = hdrPixelData.begin() + static_cast<size_t>(height - 1 - y) * rowValueCount;
-            std::ranges::copy_n(
-                source, rowValueCount, flippedPixelData.begin() + static_cast<size_t>(y) * rowValueCount);
+    const std::array<ExrLayer, 1> layers = {
+        ExrLayer{.channelNames = {"R", "G", "B", "A"}, .pixelData = hdrPixelData},
+    };
+    return saveExr(outputPath, layers, width, height, {.tileSize = 0, .flipAxis = flipAxis});
+}
+
+Result<> saveExr(
+    const std::filesystem::path& outputPath,
+    const std::span<const ExrLayer> layers,
+    const uint32_t width,
+    const uint32_t height,
+    const ExrWriteOptions& options) {
+    const std::string path = pathToUtf8(outputPath);
+    if (width == 0 || height == 0 || width > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
+        height > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+        return resultError("Invalid EXR output dimensions {}x{} for {}", width, height, path);
+    }
+    if (layers.empty()) {
+        return resultError("No layers given for EXR output {}", path);
+    }
+
+    const uint64_t pixelCount = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    for (const auto& layer : layers) {
+        const uint64_t expectedValueCount = pixelCount * layer.valuesPerPixel;
+        if (layer.channelNames.empty() || layer.channelNames.size() > layer.valuesPerPixel ||
+            expectedValueCount > std::numeric_limits<size_t>::max() || layer.pixelData.size() != expectedValueCount) {
+            return resultError(
+                "Invalid data for layer '{}' of EXR output {}: {} channels from {}x{} pixels of {} values, received {}",
+                layer.name,
+                path,
+                layer.channelNames.size(),
+                width,
+                height,
+                layer.valuesPerPixel,
+                layer.pixelData.size());
+        }
+    }
+
+    std::vector<std::vector<float>> flippedPixelData(layers.size());
+    if (options.flipAxis == FlipAxis::Y) {
+        for (size_t i = 0; i < layers.size(); ++i) {
+            flippedPixelData[i] = flipRows(layers[i].pixelData, width, height, layers[i].valuesPerPixel);
         }
-        pixelData = flippedPixelData;
     }
 
-    const std::string path = pathToUtf8(outputPath);
     try {
-        openexr::Header header(static_cast<int>(width), static_cast<int>(height));
-        header.channels().insert("R", openexr::Channel(openexr::FLOAT));
-        header.channels().insert("G", openexr::Channel(openexr::FLOAT));
-        header.channels().insert("B", openexr::Channel(openexr::FLOAT));
-        header.channels().insert("A", openexr::Channel(openexr::FLOAT));
-
-        const size_t xStride = kRgbaChannelCount * sizeof(float);
-        const size_t yStride = static_cast<size_t>(width) * xStride;
-        openexr::FrameBuffer frameBuffer;
-        constexpr std::array<std::string_view, kRgbaChannelCount> channelNames = {"R", "G", "B", "A"};
-        for (size_t channelIndex = 0; channelIndex < channelNames.size(); ++channelIndex) {
-            frameBuffer.insert(
-                channelNames[channelIndex].data(),
-                openexr::Slice::Make(
-                    openexr::FLOAT, pixelData.data() + channelIndex, header.dataWindow(), xStride, yStride));
+        openexr::Header baseHeader(static_cast<int>(width), static_cast<int>(height));
+        baseHeader.compression() = toOpenExrCompression(options.compression);
+        const bool isTiled = options.tileSize > 0;
+        if (isTiled) {
+            baseHeader.setTileDescription(
+                openexr::TileDescription(options.tileSize, options.tileSize, openexr::ONE_LEVEL));
         }
 
-        openexr::OutputFile outputFile(path.c_str(), header);
-        outputFile.setFrameBuffer(frameBuffer);
-        outputFile.writePixels(static_cast<int>(height));
+        const size_t partCount = options.multiPart ? layers.size() : 1;
+        std::vector<openexr::Header> headers(partCount, baseHeader);
+        std::vector<openexr::FrameBuffer> frameBuffers(partCount);
+        for (size_t layerIndex = 0; layerIndex < layers.size(); ++layerIndex) {
+            const ExrLayer& layer = layers[layerIndex];
+            const size_t part = options.multiPart ? layerIndex : 0;
+            if (options.multiPart) {
+                headers[part].setName(layer.name.empty() ? "rgba" : layer.name);
+                headers[part].setType(isTiled ? openexr::TILEDIMAGE : openexr::SCANLINEIMAGE);
+            }
+
+            // OpenEXR converts the float frame buffer to half while compressing when the channel asks for it.
+            const float* pixelData =
+                options.flipAxis == FlipAxis::Y ? flippedPixelData[layerIndex].data() : layer.pixelData.data();
+            const openexr::PixelType pixelType =
+                layer.pixelType == ExrPixelType::Half ? openexr::HALF : openexr::FLOAT;
+            const size_t xStride = layer.valuesPerPixel * sizeof(float);
+            const size_t yStride = static_cast<size_t>(width) * xStride;
+            for (size_t channelIndex = 0; channelIndex < layer.channelNames.size(); ++channelIndex) {
+                const std::string channelName = layer.name.empty()
+                                                     ? layer.channelNames[channelIndex]
+                                                     : layer.name + "." + layer.channelNames[channelIndex];
+                headers[part].channels().insert(channelName, openexr::Channel(pixelType));
+                frameBuffers[part].insert(
+                    channelName,
+                    openexr::Slice::Make(
+                        openexr::FLOAT, pixelData + channelIndex, headers[part].dataWindow(), xStride, yStride));
+            }
+        }
+
+        const uint32_t threadCount =
+            options.threadCount > 0 ? options.threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+        // The file only queues blocks for as many threads as it is given, and the global pool runs them, so the pool
+        // needs at least that many threads or the blocks are compressed serially.
+        if (openexr::globalThreadCount() < static_cast<int>(threadCount)) {
+            openexr::setGlobalThreadCount(static_cast<int>(threadCount));
+        }
+        openexr::MultiPartOutputFile outputFile(
+            path.c_str(), headers.data(), static_cast<int>(headers.size()), false, static_cast<int>(threadCount));
+        for (size_t part = 0; part < partCount; ++part) {
+            if (isTiled) {
+                openexr::TiledOutputPart outputPart(outputFile, static_cast<int>(part));
+                outputPart.setFrameBuffer(frameBuffers[part]);
+                outputPart.writeTiles(0, outputPart.numXTiles(0) - 1, 0, outputPart.numYTiles(0) - 1);
+            } else {
+                openexr::OutputPart outputPart(outputFile, static_cast<int>(part));
+                outputPart.setFrameBuffer(frameBuffers[part]);
+                outputPart.writePixels(static_cast<int>(height));
+            }
+        }
     } catch (const std::exception& exception) {
         return resultError("Failed to save EXR file {}: {}", path, exception.what());
     }
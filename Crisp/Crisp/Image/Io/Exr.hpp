@@ -2,6 +2,8 @@
 
 #include <filesystem>
 #include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include <Crisp/Core/Result.hpp>
@@ -25,4 +27,37 @@ Result<> saveExr(
     uint32_t height,
     FlipAxis flipAxis = FlipAxis::None);
 
+enum class ExrPixelType : uint8_t { Half, Float };
+
+enum class ExrCompression : uint8_t { None, Rle, Zips, Zip, Piz, Pxr24, B44, B44a, Dwaa, Dwab };
+
+// Parses the lowercase name of a compression method, e.g. "zip" or "dwaa".
+Result<ExrCompression> parseExrCompression(std::string_view name);
+
+// A group of channels read from interleaved pixel data, e.g. the albedo of an RGBA buffer. Channel i of the layer is
+// value i of every pixel, and each pixel holds valuesPerPixel values. Channels are written as <name>.<channel>, or
+// unprefixed for a layer without a name.
+struct ExrLayer {
+    std::string name;
+    std::vector<std::string> channelNames;
+    std::span<const float> pixelData;
+    uint32_t valuesPerPixel{4};
+    ExrPixelType pixelType{ExrPixelType::Float};
+};
+
+struct ExrWriteOptions {
+    ExrCompression compression{ExrCompression::Zip};
+    uint32_t tileSize{64}; // Writes scanlines when 0.
+    bool multiPart{false}; // Writes every layer to its own part, named after the layer, instead of a single part.
+    uint32_t threadCount{0}; // Threads that compress blocks in parallel, all hardware threads when 0.
+    FlipAxis flipAxis{FlipAxis::None};
+};
+
+Result<> saveExr(
+    const std::filesystem::path& outputPath,
+    std::span<const ExrLayer> layers,
+    uint32_t width,
+    uint32_t height,
+    const ExrWriteOptions& options);
+
 } // namespace crisp
@@ -0,0 +1,101 @@
+#include <Crisp/Image/Io/Exr.hpp>
+
+#include <gmock/gmock.h>
+
+#include <array>
+#include <filesystem>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+constexpr uint32_t kWidth = 70;
+constexpr uint32_t kHeight = 33;
+
+std::filesystem::path getOutputPath(const std::string& name) {
+    return std::filesystem::path(::testing::TempDir()) / (name + ".exr");
+}
+
+// RGBA pixels whose channels encode their position, so that misplaced rows or channels are detected.
+std::vector<float> createRgba() {
+    std::vector<float> rgba;
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        for (uint32_t x = 0; x < kWidth; ++x) {
+            rgba.insert(rgba.end(), {static_cast<float>(x), static_cast<float>(y), 0.25f, 1.0f + 0.5f * x});
+        }
+    }
+    return rgba;
+}
+
+TEST(ExrTest, RgbaImageRoundTripsWithFlippedRows) {
+    const std::vector<float> rgba = createRgba();
+    const auto path = getOutputPath("rgba");
+    ASSERT_TRUE(saveExr(path, rgba, kWidth, kHeight, FlipAxis::Y).isValid());
+
+    const auto image = loadExr(path);
+    ASSERT_TRUE(image);
+    EXPECT_EQ(image->width, kWidth);
+    EXPECT_EQ(image->height, kHeight);
+    ASSERT_EQ(image->channelCount, 4u);
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        const size_t loaded = static_cast<size_t>(y) * kWidth * 4;
+        const size_t saved = static_cast<size_t>(kHeight - 1 - y) * kWidth * 4;
+        for (size_t i = 0; i < kWidth * 4; ++i) {
+            EXPECT_EQ(image->pixelData[loaded + i], rgba[saved + i]);
+        }
+    }
+}
+
+TEST(ExrTest, LayersAreWrittenAsPrefixedChannelsOfTiledHalfImage) {
+    const std::vector<float> rgba = createRgba();
+    const std::array<ExrLayer, 2> layers = {
+        ExrLayer{.channelNames = {"R", "G", "B", "A"}, .pixelData = rgba, .pixelType = ExrPixelType::Half},
+        ExrLayer{.name = "depth", .channelNames = {"Z"}, .pixelData = rgba, .pixelType = ExrPixelType::Float},
+    };
+    const auto path = getOutputPath("layers");
+    const ExrWriteOptions options{.compression = ExrCompression::Piz, .tileSize = 16, .threadCount = 4};
+    ASSERT_TRUE(saveExr(path, layers, kWidth, kHeight, options).isValid());
+
+    const auto image = loadExr(path);
+    ASSERT_TRUE(image);
+    ASSERT_EQ(image->channelCount, 5u);
+    for (size_t pixel = 0; pixel < static_cast<size_t>(kWidth) * kHeight; ++pixel) {
+        // Half floats represent the small integers and quarters exactly.
+        EXPECT_EQ(image->pixelData[pixel * 5], rgba[pixel * 4]);
+        EXPECT_EQ(image->pixelData[pixel * 5 + 1], rgba[pixel * 4 + 1]);
+        EXPECT_EQ(image->pixelData[pixel * 5 + 2], rgba[pixel * 4 + 2]);
+        EXPECT_EQ(image->pixelData[pixel * 5 + 3], rgba[pixel * 4 + 3]);
+        // The depth layer takes the first value of every pixel.
+        EXPECT_EQ(image->pixelData[pixel * 5 + 4], rgba[pixel * 4]);
+    }
+}
+
+TEST(ExrTest, MultiPartLayersAreWrittenAsSeparateParts) {
+    const std::vector<float> rgba = createRgba();
+    const std::array<ExrLayer, 2> layers = {
+        ExrLayer{.channelNames = {"R", "G", "B", "A"}, .pixelData = rgba},
+        ExrLayer{.name = "depth", .channelNames = {"Z"}, .pixelData = rgba},
+    };
+    const auto path = getOutputPath("parts");
+    const ExrWriteOptions options{.tileSize = 32, .multiPart = true, .threadCount = 2};
+    ASSERT_TRUE(saveExr(path, layers, kWidth, kHeight, options).isValid());
+
+    // Only single-part files are loaded back.
+    EXPECT_FALSE(loadExr(path));
+}
+
+TEST(ExrTest, LayerWithMismatchedDataIsRejected) {
+    const std::vector<float> rgba = createRgba();
+    const std::array<ExrLayer, 1> layers = {
+        ExrLayer{.name = "normal", .channelNames = {"X", "Y", "Z"}, .pixelData = rgba, .valuesPerPixel = 3},
+    };
+    EXPECT_FALSE(saveExr(getOutputPath("mismatch"), layers, kWidth, kHeight, ExrWriteOptions{}).isValid());
+}
+
+TEST(ExrTest, ParsesCompressionNames) {
+    EXPECT_EQ(*parseExrCompression("zip"), ExrCompression::Zip);
+    EXPECT_EQ(*parseExrCompression("dwaa"), ExrCompression::Dwaa);
+    EXPECT_EQ(*parseExrCompression("none"), ExrCompression::None);
+    EXPECT_FALSE(parseExrCompression("jpeg"));
+}
+} // namespace
+} // namespace crisp::test
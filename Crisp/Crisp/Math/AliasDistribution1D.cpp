@@ -0,0 +1,85 @@
+#include <Crisp/Math/AliasDistribution1D.hpp>
+
+#include <algorithm>
+
+namespace crisp {
+namespace {
+constexpr float kOneMinusEpsilon = 0x1.fffffep-1f;
+} // namespace
+
+AliasDistribution1D::AliasDistribution1D(const std::span<const float> weights)
+    : m_aliasTable(createAliasTable(weights))
+    , m_pmfs(weights.begin(), weights.end()) {
+    double sum = 0.0;
+    for (const float w : weights) {
+        sum += w;
+    }
+
+    m_sum = static_cast<float>(sum);
+    m_normFactor = sum > 0.0 ? static_cast<float>(1.0 / sum) : 0.0f;
+    for (float& pmf : m_pmfs) {
+        pmf *= m_normFactor;
+    }
+}
+
+size_t AliasDistribution1D::getSize() const {
+    return m_pmfs.size();
+}
+
+float AliasDistribution1D::operator[](const size_t index) const {
+    return m_pmfs[index];
+}
+
+float AliasDistribution1D::getSum() const {
+    return m_sum;
+}
+
+float AliasDistribution1D::getNormFactor() const {
+    return m_normFactor;
+}
+
+size_t AliasDistribution1D::sample(float sampleValue) const {
+    return sampleReuse(sampleValue);
+}
+
+size_t AliasDistribution1D::sample(float sampleValue, float& pmf) const {
+    return sampleReuse(sampleValue, pmf);
+}
+
+size_t AliasDistribution1D::sampleReuse(float& sampleValue) const {
+    const float scaled = sampleValue * static_cast<float>(m_aliasTable.size());
+    const size_t bin = std::min(static_cast<size_t>(scaled), m_aliasTable.size() - 1);
+    const AliasTableElement& element = m_aliasTable[bin];
+
+    // The fractional part is uniform within the bin, and so is each side of the tau split.
+    const float offset = std::min(scaled - static_cast<float>(bin), kOneMinusEpsilon);
+    if (offset < element.tau) {
+        sampleValue = std::min(offset / element.tau, kOneMinusEpsilon);
+        return bin;
+    }
+
+    sampleValue = std::min((offset - element.tau) / (1.0f - element.tau), kOneMinusEpsilon);
+    return element.j;
+}
+
+size_t AliasDistribution1D::sampleReuse(float& sampleValue, float& pmf) const {
+    const size_t index = sampleReuse(sampleValue);
+    pmf = m_pmfs[index];
+    return index;
+}
+
+float AliasDistribution1D::sampleContinuous(float sampleValue, float& pdf) const {
+    const size_t index = sampleReuse(sampleValue, pdf);
+    pdf *= static_cast<float>(m_pmfs.size());
+    return (static_cast<float>(index) + sampleValue) / static_cast<float>(m_pmfs.size());
+}
+
+float AliasDistribution1D::pdfContinuous(const float x) const {
+    const auto index = std::min(static_cast<size_t>(std::max(x, 0.0f) * m_pmfs.size()), m_pmfs.size() - 1);
+    return m_pmfs[index] * static_cast<float>(m_pmfs.size());
+}
+
+size_t AliasDistribution1D::getMemoryUsage() const {
+    return m_aliasTable.size() * sizeof(AliasTableElement) + m_pmfs.size() * sizeof(float);
+}
+} // namespace crisp
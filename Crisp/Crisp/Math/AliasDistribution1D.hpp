@@ -0,0 +1,44 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <Crisp/Math/AliasTable.hpp>
+
+namespace crisp {
+// Piecewise-constant distribution over a fixed set of weights that is sampled in constant time through an alias
+// table, as opposed to the binary search of Distribution1D. Weights need not be normalized; with a zero sum every
+// entry has zero probability.
+class AliasDistribution1D {
+public:
+    AliasDistribution1D() = default;
+    explicit AliasDistribution1D(std::span<const float> weights);
+
+    size_t getSize() const;
+
+    // Normalized probability of the entry.
+    float operator[](size_t index) const;
+
+    float getSum() const;
+    float getNormFactor() const;
+
+    size_t sample(float sampleValue) const;
+    size_t sample(float sampleValue, float& pmf) const;
+
+    // Also remaps the sample to a fresh uniform value in [0, 1) that can be used to place a point within the entry.
+    size_t sampleReuse(float& sampleValue) const;
+    size_t sampleReuse(float& sampleValue, float& pmf) const;
+
+    // Samples a point in [0, 1) with a density over the unit interval returned in pdf.
+    float sampleContinuous(float sampleValue, float& pdf) const;
+    float pdfContinuous(float x) const;
+
+    size_t getMemoryUsage() const;
+
+private:
+    AliasTable m_aliasTable;
+    std::vector<float> m_pmfs;
+    float m_sum{0.0f};
+    float m_normFactor{0.0f};
+};
+} // namespace crisp
@@ -0,0 +1,64 @@
+#include <Crisp/Math/AliasDistribution2D.hpp>
+
+#include <algorithm>
+
+namespace crisp {
+AliasDistribution2D::AliasDistribution2D(
+    const std::span<const float> weights, const size_t width, const size_t height) {
+    m_conditionals.reserve(height);
+    std::vector<float> rowSums(height);
+    for (size_t y = 0; y < height; ++y) {
+        m_conditionals.emplace_back(weights.subspan(y * width, width));
+        rowSums[y] = m_conditionals.back().getSum();
+    }
+    m_marginal = AliasDistribution1D(rowSums);
+}
+
+size_t AliasDistribution2D::getWidth() const {
+    return m_conditionals.empty() ? 0 : m_conditionals.front().getSize();
+}
+
+size_t AliasDistribution2D::getHeight() const {
+    return m_conditionals.size();
+}
+
+float AliasDistribution2D::getSum() const {
+    return m_marginal.getSum();
+}
+
+float AliasDistribution2D::getPmf(const size_t x, const size_t y) const {
+    return m_marginal[y] * m_conditionals[y][x];
+}
+
+glm::uvec2 AliasDistribution2D::sampleReuse(glm::vec2& sample, float& pmf) const {
+    float rowPmf = 0.0f;
+    float colPmf = 0.0f;
+    const size_t y = m_marginal.sampleReuse(sample.y, rowPmf);
+    const size_t x = m_conditionals[y].sampleReuse(sample.x, colPmf);
+    pmf = rowPmf * colPmf;
+    return {static_cast<uint32_t>(x), static_cast<uint32_t>(y)};
+}
+
+glm::vec2 AliasDistribution2D::sampleContinuous(glm::vec2 sample, float& pdf) const {
+    const glm::uvec2 cell = sampleReuse(sample, pdf);
+    const glm::vec2 size(getWidth(), getHeight());
+    pdf *= size.x * size.y;
+    return (glm::vec2(cell) + sample) / size;
+}
+
+float AliasDistribution2D::pdfContinuous(const glm::vec2& point) const {
+    const size_t width = getWidth();
+    const size_t height = getHeight();
+    const auto x = std::min(static_cast<size_t>(std::max(point.x, 0.0f) * width), width - 1);
+    const auto y = std::min(static_cast<size_t>(std::max(point.y, 0.0f) * height), height - 1);
+    return getPmf(x, y) * static_cast<float>(width * height);
+}
+
+size_t AliasDistribution2D::getMemoryUsage() const {
+    size_t bytes = m_marginal.getMemoryUsage();
+    for (const auto& conditional : m_conditionals) {
+        bytes += conditional.getMemoryUsage();
+    }
+    return bytes;
+}
+} // namespace crisp
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <Crisp/Math/AliasDistribution1D.hpp>
+#include <Crisp/Math/Headers.hpp>
+
+namespace crisp {
+// Piecewise-constant distribution over a row-major grid of weights, sampled in constant time by picking a row from
+// the marginal distribution and then a column from that row's conditional distribution.
+class AliasDistribution2D {
+public:
+    AliasDistribution2D() = default;
+    AliasDistribution2D(std::span<const float> weights, size_t width, size_t height);
+
+    size_t getWidth() const;
+    size_t getHeight() const;
+    float getSum() const;
+
+    // Normalized probability of the cell.
+    float getPmf(size_t x, size_t y) const;
+
+    // Picks a cell and remaps both sample dimensions to fresh uniform values within it.
+    glm::uvec2 sampleReuse(glm::vec2& sample, float& pmf) const;
+
+    // Samples a point in [0, 1)^2 with a density over the unit square returned in pdf.
+    glm::vec2 sampleContinuous(glm::vec2 sample, float& pdf) const;
+    float pdfContinuous(const glm::vec2& point) const;
+
+    size_t getMemoryUsage() const;
+
+private:
+    std::vector<AliasDistribution1D> m_conditionals;
+    AliasDistribution1D m_marginal;
+};
+} // namespace crisp
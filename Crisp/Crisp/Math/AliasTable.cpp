@@ -1,60 +1,45 @@
 #include <Crisp/Math/AliasTable.hpp>
 
-#include <algorithm>
-#include <map>
-
 namespace crisp {
-namespace {
-struct AliasTableConstructionElement {
-    float tau;
-    uint32_t i;
-    uint32_t j;
-};
-} // namespace
-
-AliasTable createAliasTable(const std::vector<float>& weights) {
-    float avgWeight = 0.0f;
+AliasTable createAliasTable(const std::span<const float> weights) {
+    double avgWeight = 0.0;
     for (const float w : weights) {
         avgWeight += w;
     }
-    avgWeight /= static_cast<float>(weights.size());
+    avgWeight /= static_cast<double>(weights.size());
 
-    std::multimap<float, uint32_t> sortedSamples;
+    // Each bin starts out with its weight relative to the average, in double precision so that the leftovers carried
+    // from bin to bin do not drift.
+    std::vector<double> scaled(weights.size());
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
     for (uint32_t i = 0; i < weights.size(); ++i) {
-        sortedSamples.insert({weights[i], i});
+        scaled[i] = avgWeight > 0.0 ? weights[i] / avgWeight : 1.0;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
     }
 
-    std::vector<AliasTableConstructionElement> tuples;
-    tuples.reserve(weights.size());
-    for (uint32_t i = 0; i < weights.size(); ++i) {
-        auto lowest = sortedSamples.begin();
-        auto highest = --sortedSamples.end();
-        const AliasTableConstructionElement el{
-            .tau = lowest->first / avgWeight,
-            .i = lowest->second,
-            .j = highest->second,
-        };
-        tuples.push_back(el);
-
-        if (sortedSamples.size() == 1) {
-            break;
+    AliasTable table(weights.size());
+    while (!small.empty() && !large.empty()) {
+        const uint32_t lowest = small.back();
+        small.pop_back();
+        const uint32_t highest = large.back();
+
+        table[lowest] = {static_cast<float>(scaled[lowest]), highest};
+        scaled[highest] -= 1.0 - scaled[lowest];
+        if (scaled[highest] < 1.0) {
+            large.pop_back();
+            small.push_back(highest);
         }
-
-        const float newWeightJ = highest->first - (avgWeight - lowest->first);
-
-        sortedSamples.erase(lowest);
-        sortedSamples.erase(highest);
-        sortedSamples.insert({newWeightJ, el.j});
     }
 
-    std::ranges::sort(tuples, [](const auto& a, const auto& b) { return a.i < b.i; });
-
-    std::vector<AliasTableElement> table;
-    table.reserve(tuples.size());
-    for (const auto& el : tuples) {
-        table.push_back({el.tau, el.j});
+    // Whatever remains is full up to rounding error.
+    for (const uint32_t i : small) {
+        table[i] = {1.0f, i};
+    }
+    for (const uint32_t i : large) {
+        table[i] = {1.0f, i};
     }
 
     return table;
 }
-} // namespace crisp
\ No newline at end of file
+} // namespace crisp
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace crisp {
@@ -11,5 +13,7 @@ struct AliasTableElement {
 
 using AliasTable = std::vector<AliasTableElement>;
 
-AliasTable createAliasTable(const std::vector<float>& weights);
-} // namespace crisp
\ No newline at end of file
+// Builds the table in linear time with Vose's method. Bin i keeps its own index with probability tau and yields j
+// otherwise, so a weight is picked with one uniform sample and at most one comparison.
+AliasTable createAliasTable(std::span<const float> weights);
+} // namespace crisp
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <Crisp/Math/AliasDistribution1D.hpp>
+#include <Crisp/Math/AliasDistribution2D.hpp>
+#include <Crisp/Math/Distribution1D.hpp>
+
+namespace crisp {
+namespace {
+constexpr size_t kSampleBatch = 4096;
+
+// Heavy-tailed weights, like the luminance of an HDR probe or the triangle areas of a scanned mesh.
+std::vector<float> createWeights(const size_t count) {
+    std::mt19937 engine(42);
+    std::lognormal_distribution<float> distribution(0.0f, 2.0f);
+    std::vector<float> weights(count);
+    for (float& w : weights) {
+        w = distribution(engine);
+    }
+    return weights;
+}
+
+std::vector<float> createSamples(const size_t count) {
+    std::mt19937 engine(7);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<float> samples(count);
+    for (float& s : samples) {
+        s = distribution(engine);
+    }
+    return samples;
+}
+
+void BM_CdfSample1D(benchmark::State& state) {
+    const std::vector<float> weights = createWeights(static_cast<size_t>(state.range(0)));
+    Distribution1D distribution(weights.size());
+    for (const float w : weights) {
+        distribution.append(w);
+    }
+    distribution.normalize();
+
+    const std::vector<float> samples = createSamples(kSampleBatch);
+    for (auto _ : state) {
+        for (float sample : samples) {
+            float pdf = 0.0f;
+            benchmark::DoNotOptimize(distribution.sampleReuse(sample, pdf));
+            benchmark::DoNotOptimize(sample);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kSampleBatch));
+}
+
+void BM_AliasSample1D(benchmark::State& state) {
+    const std::vector<float> weights = createWeights(static_cast<size_t>(state.range(0)));
+    const AliasDistribution1D distribution(weights);
+
+    const std::vector<float> samples = createSamples(kSampleBatch);
+    for (auto _ : state) {
+        for (float sample : samples) {
+            float pmf = 0.0f;
+            benchmark::DoNotOptimize(distribution.sampleReuse(sample, pmf));
+            benchmark::DoNotOptimize(sample);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kSampleBatch));
+}
+
+// Environment map layout: twice as wide as it is high.
+void BM_AliasSample2D(benchmark::State& state) {
+    const auto height = static_cast<size_t>(state.range(0));
+    const std::vector<float> weights = createWeights(2 * height * height);
+    const AliasDistribution2D distribution(weights, 2 * height, height);
+
+    const std::vector<float> samples = createSamples(2 * kSampleBatch);
+    for (auto _ : state) {
+        for (size_t i = 0; i < kSampleBatch; ++i) {
+            glm::vec2 sample(samples[2 * i], samples[2 * i + 1]);
+            float pmf = 0.0f;
+            benchmark::DoNotOptimize(distribution.sampleReuse(sample, pmf));
+            benchmark::DoNotOptimize(sample);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kSampleBatch));
+}
+} // namespace
+
+BENCHMARK(BM_CdfSample1D)->RangeMultiplier(16)->Range(1 << 8, 1 << 22);   // NOLINT
+BENCHMARK(BM_AliasSample1D)->RangeMultiplier(16)->Range(1 << 8, 1 << 22); // NOLINT
+BENCHMARK(BM_AliasSample2D)->RangeMultiplier(4)->Range(256, 4096);        // NOLINT
+
+} // namespace crisp
+
+BENCHMARK_MAIN(); // NOLINT
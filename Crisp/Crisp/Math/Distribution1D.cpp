@@ -1,6 +1,7 @@
 #include <Crisp/Math/Distribution1D.hpp>
 
 #include <algorithm>
+#include <cstddef>
 
 namespace crisp {
 Distribution1D::Distribution1D(size_t numEntries) {
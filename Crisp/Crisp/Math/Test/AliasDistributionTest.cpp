@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <Crisp/Math/AliasDistribution1D.hpp>
+#include <Crisp/Math/AliasDistribution2D.hpp>
+
+namespace crisp {
+namespace {
+TEST(AliasTableTest, BinsReproduceWeights) {
+    const std::vector<float> weights = {1.0f, 0.0f, 7.0f, 2.0f, 0.5f, 3.5f};
+    const AliasTable table = createAliasTable(weights);
+    ASSERT_EQ(table.size(), weights.size());
+
+    // Each bin contributes tau of its own probability and the rest of it to its alias.
+    std::vector<float> probabilities(weights.size(), 0.0f);
+    for (uint32_t i = 0; i < table.size(); ++i) {
+        probabilities[i] += table[i].tau / static_cast<float>(table.size());
+        probabilities[table[i].j] += (1.0f - table[i].tau) / static_cast<float>(table.size());
+    }
+    for (size_t i = 0; i < weights.size(); ++i) {
+        EXPECT_NEAR(probabilities[i], weights[i] / 14.0f, 1e-6f);
+    }
+}
+
+TEST(AliasDistribution1DTest, SampleFrequenciesMatchPmf) {
+    const std::vector<float> weights = {3.0f, 0.0f, 1.0f, 4.0f, 2.0f};
+    const AliasDistribution1D distribution(weights);
+    EXPECT_FLOAT_EQ(distribution.getSum(), 10.0f);
+
+    constexpr int kSampleCount = 1 << 16;
+    std::vector<int> counts(weights.size(), 0);
+    for (int i = 0; i < kSampleCount; ++i) {
+        float pmf = 0.0f;
+        const size_t index = distribution.sample((static_cast<float>(i) + 0.5f) / kSampleCount, pmf);
+        EXPECT_EQ(pmf, distribution[index]);
+        ++counts[index];
+    }
+    for (size_t i = 0; i < weights.size(); ++i) {
+        EXPECT_NEAR(static_cast<float>(counts[i]) / kSampleCount, weights[i] / 10.0f, 1e-4f);
+    }
+}
+
+TEST(AliasDistribution1DTest, ReusedSamplesAreUniformWithinEntry) {
+    const std::vector<float> weights = {1.0f, 5.0f, 2.0f};
+    const AliasDistribution1D distribution(weights);
+
+    constexpr int kSampleCount = 1 << 14;
+    std::vector<double> means(weights.size(), 0.0);
+    std::vector<int> counts(weights.size(), 0);
+    for (int i = 0; i < kSampleCount; ++i) {
+        float sample = (static_cast<float>(i) + 0.5f) / kSampleCount;
+        const size_t index = distribution.sampleReuse(sample);
+        ASSERT_GE(sample, 0.0f);
+        ASSERT_LT(sample, 1.0f);
+        means[index] += sample;
+        ++counts[index];
+    }
+    for (size_t i = 0; i < weights.size(); ++i) {
+        EXPECT_NEAR(means[i] / counts[i], 0.5, 1e-2);
+    }
+}
+
+TEST(AliasDistribution1DTest, ContinuousPdfMatchesQuery) {
+    const std::vector<float> weights = {0.5f, 2.0f, 1.0f, 0.5f};
+    const AliasDistribution1D distribution(weights);
+    for (int i = 0; i < 64; ++i) {
+        float pdf = 0.0f;
+        const float x = distribution.sampleContinuous((static_cast<float>(i) + 0.5f) / 64.0f, pdf);
+        EXPECT_FLOAT_EQ(distribution.pdfContinuous(x), pdf);
+    }
+}
+
+TEST(AliasDistribution1DTest, ZeroWeightsHaveZeroProbability) {
+    const std::vector<float> weights(4, 0.0f);
+    const AliasDistribution1D distribution(weights);
+    float pmf = 1.0f;
+    distribution.sample(0.3f, pmf);
+    EXPECT_EQ(pmf, 0.0f);
+    EXPECT_EQ(distribution.getNormFactor(), 0.0f);
+}
+
+TEST(AliasDistribution2DTest, SampleFrequenciesMatchPmf) {
+    constexpr size_t kWidth = 4;
+    constexpr size_t kHeight = 3;
+    const std::vector<float> weights = {1, 2, 0, 1, 0, 0, 0, 0, 3, 1, 4, 2};
+    const AliasDistribution2D distribution(weights, kWidth, kHeight);
+    EXPECT_FLOAT_EQ(distribution.getSum(), 14.0f);
+
+    constexpr int kSampleCount = 1024;
+    std::vector<int> counts(weights.size(), 0);
+    for (int j = 0; j < kSampleCount; ++j) {
+        for (int i = 0; i < kSampleCount; ++i) {
+            glm::vec2 sample((i + 0.5f) / kSampleCount, (j + 0.5f) / kSampleCount);
+            float pmf = 0.0f;
+            const glm::uvec2 cell = distribution.sampleReuse(sample, pmf);
+            EXPECT_FLOAT_EQ(pmf, distribution.getPmf(cell.x, cell.y));
+            ++counts[cell.y * kWidth + cell.x];
+        }
+    }
+    for (size_t i = 0; i < weights.size(); ++i) {
+        EXPECT_NEAR(static_cast<float>(counts[i]) / (kSampleCount * kSampleCount), weights[i] / 14.0f, 1e-3f);
+    }
+
+    float pdf = 0.0f;
+    const glm::vec2 point = distribution.sampleContinuous(glm::vec2(0.7f, 0.2f), pdf);
+    EXPECT_FLOAT_EQ(distribution.pdfContinuous(point), pdf);
+}
+} // namespace
+} // namespace crisp
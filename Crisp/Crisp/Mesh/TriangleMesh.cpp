@@ -301,6 +301,21 @@ glm::vec2 TriangleMesh::interpolateTexCoord(const uint32_t triangleId, const glm
     return barycentric.x * tc0 + barycentric.y * tc1 + barycentric.z * tc2;
 }
 
+void TriangleMesh::reserveSimdPadding() {
+    m_positions.reserve(m_positions.size() + 1);
+    m_triangles.reserve(m_triangles.size() + 1);
+}
+
+size_t TriangleMesh::getMemoryUsage() const {
+    size_t bytes = m_positions.capacity() * sizeof(glm::vec3) + m_normals.capacity() * sizeof(glm::vec3) +
+                   m_texCoords.capacity() * sizeof(glm::vec2) + m_tangents.capacity() * sizeof(glm::vec4) +
+                   m_triangles.capacity() * sizeof(glm::uvec3) + m_views.capacity() * sizeof(TriangleMeshView);
+    for (const auto& [name, attribute] : m_customAttributes) {
+        bytes += attribute.buffer.capacity();
+    }
+    return bytes;
+}
+
 uint32_t TriangleMesh::computeMaximumVertex(uint32_t firstTriangle, uint32_t triangleCount) const {
     CRISP_CHECK_GE_LT(firstTriangle, 0, m_triangles.size());
     CRISP_CHECK_LE(firstTriangle + triangleCount, m_triangles.size());
@@ -85,6 +85,13 @@ public:
 
     uint32_t computeMaximumVertex(uint32_t firstTriangle, uint32_t triangleCount) const;
 
+    // Grows the position and index storage so that a 16-byte load starting at the last element stays within the
+    // allocation. Consumers that read the arrays in place with SIMD loads, such as Embree shared buffers, need this.
+    void reserveSimdPadding();
+
+    // Bytes allocated for the vertex attributes, indices and views of the mesh.
+    size_t getMemoryUsage() const;
+
 private:
     std::vector<glm::vec3> m_positions;
     std::vector<glm::vec3> m_normals;
@@ -10,6 +10,10 @@ void BSDF::setTexture(std::shared_ptr<Texture<float>> texture) {}
 
 void BSDF::setTexture(std::shared_ptr<Texture<Spectrum>> texture) {}
 
+Spectrum BSDF::getAlbedo(const BSDF::Sample& /*bsdfSample*/) const {
+    return Spectrum(1.0f);
+}
+
 LobeFlags BSDF::getLobeType() const {
     return m_lobe;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Crisp/Math/Headers.hpp>
+#include <Crisp/PathTracer/Core/Intersection.hpp>
 #include <Crisp/PathTracer/Core/VariantMap.hpp>
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
 #include <Crisp/PathTracer/Spectra/Spectrum.hpp>
@@ -37,6 +38,10 @@ public:
 
         float eta;
 
+        // Texture footprint of the shading point, see Intersection.
+        glm::vec2 dUVdx{0.0f};
+        glm::vec2 dUVdy{0.0f};
+
         Sample()
             : p(0.0f)
             , uv(0.0f)
@@ -66,6 +71,18 @@ public:
             , measure(Measure::Unknown)
             , sampledLobe(Lobe::Passthrough)
             , eta(0.0f) {}
+
+        Sample(const Intersection& its, const glm::vec3& wi)
+            : Sample(its.p, its.uv, wi) {
+            dUVdx = its.dUVdx;
+            dUVdy = its.dUVdy;
+        }
+
+        Sample(const Intersection& its, const glm::vec3& wi, const glm::vec3& wo)
+            : Sample(its.p, its.uv, wi, wo) {
+            dUVdx = its.dUVdx;
+            dUVdy = its.dUVdy;
+        }
     };
 
     BSDF(LobeFlags lobeFlags);
@@ -81,6 +98,10 @@ public:
     virtual Spectrum sample(BSDF::Sample& bsdfSample, Sampler& sampler) const = 0;
     virtual float pdf(const BSDF::Sample& bsdfSample) const = 0;
 
+    // Reflectance at the sample's position, used as a feature to guide the denoiser. Non-diffuse BSDFs report white,
+    // so that the denoiser keeps their lighting separate from any texture.
+    virtual Spectrum getAlbedo(const BSDF::Sample& bsdfSample) const;
+
     LobeFlags getLobeType() const;
 
 protected:
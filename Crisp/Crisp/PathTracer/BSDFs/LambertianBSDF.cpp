@@ -23,7 +23,8 @@ Spectrum LambertianBSDF::eval(const BSDF::Sample& bsdfSample) const {
         return 0.0f;
     }
 
-    return m_albedo->eval(bsdfSample.uv) * InvPI<> * CoordinateFrame::cosTheta(bsdfSample.wo);
+    const Spectrum albedo = m_albedo->evalFiltered(bsdfSample.uv, bsdfSample.dUVdx, bsdfSample.dUVdy);
+    return albedo * InvPI<> * CoordinateFrame::cosTheta(bsdfSample.wo);
 }
 
 Spectrum LambertianBSDF::sample(BSDF::Sample& bsdfSample, Sampler& sampler) const {
@@ -35,7 +36,7 @@ Spectrum LambertianBSDF::sample(BSDF::Sample& bsdfSample, Sampler& sampler) cons
 
     // eval() / pdf() = albedo * invPI / (cosThetaO * invPI) * cosThetaO(subtension)
     // account for cosine subtension = just albedo
-    return m_albedo->eval(bsdfSample.uv);
+    return m_albedo->evalFiltered(bsdfSample.uv, bsdfSample.dUVdx, bsdfSample.dUVdy);
 }
 
 float LambertianBSDF::pdf(const BSDF::Sample& bsdfSample) const {
@@ -47,4 +48,8 @@ float LambertianBSDF::pdf(const BSDF::Sample& bsdfSample) const {
 
     return InvPI<> * cosThetaO;
 }
-} // namespace crisp
+
+Spectrum LambertianBSDF::getAlbedo(const BSDF::Sample& bsdfSample) const {
+    return m_albedo->evalFiltered(bsdfSample.uv, bsdfSample.dUVdx, bsdfSample.dUVdy);
+}
+} // namespace crisp
\ No newline at end of file
@@ -11,6 +11,7 @@ public:
     virtual Spectrum eval(const BSDF::Sample& bsdfSample) const override;
     virtual Spectrum sample(BSDF::Sample& bsdfSample, Sampler& sampler) const override;
     virtual float pdf(const BSDF::Sample& bsdfSample) const override;
+    virtual Spectrum getAlbedo(const BSDF::Sample& bsdfSample) const override;
 
 private:
     std::shared_ptr<Texture<Spectrum>> m_albedo;
@@ -88,4 +88,9 @@ float MicrofacetBSDF::pdf(const BSDF::Sample& bsdfSample) const {
 
     return specPdf + diffPdf;
 }
-} // namespace crisp
+
+Spectrum MicrofacetBSDF::getAlbedo(const BSDF::Sample& /*bsdfSample*/) const {
+    // The specular lobe reflects ks of the light without tinting it.
+    return m_kd + Spectrum(m_ks);
+}
+} // namespace crisp
\ No newline at end of file
@@ -13,6 +13,7 @@ public:
     virtual Spectrum eval(const BSDF::Sample& bsdfSample) const override;
     virtual Spectrum sample(BSDF::Sample& bsdfSample, Sampler& sampler) const override;
     virtual float pdf(const BSDF::Sample& bsdfSample) const override;
+    virtual Spectrum getAlbedo(const BSDF::Sample& bsdfSample) const override;
 
 private:
     float m_intIOR;
@@ -20,8 +20,10 @@ void OrenNayarBSDF::setTexture(std::shared_ptr<Texture<Spectrum>> texture) {
     m_reflectanceTexture = std::move(texture);
 }
 
-Spectrum OrenNayarBSDF::evaluateReflectance(const glm::vec2& uv) const {
-    return m_reflectanceTexture ? m_reflectanceTexture->eval(uv) : m_reflectance;
+Spectrum OrenNayarBSDF::evaluateReflectance(const BSDF::Sample& bsdfSample) const {
+    return m_reflectanceTexture
+               ? m_reflectanceTexture->evalFiltered(bsdfSample.uv, bsdfSample.dUVdx, bsdfSample.dUVdy)
+               : m_reflectance;
 }
 
 float OrenNayarBSDF::evaluateRoughnessFactor(const glm::vec3& wi, const glm::vec3& wo) const {
@@ -55,7 +57,7 @@ Spectrum OrenNayarBSDF::eval(const BSDF::Sample& bsdfSample) const {
         return 0.0f;
     }
 
-    return evaluateReflectance(bsdfSample.uv) * InvPI<> * evaluateRoughnessFactor(bsdfSample.wi, bsdfSample.wo) *
+    return evaluateReflectance(bsdfSample) * InvPI<> * evaluateRoughnessFactor(bsdfSample.wi, bsdfSample.wo) *
            cosThetaO;
 }
 
@@ -70,7 +72,7 @@ Spectrum OrenNayarBSDF::sample(BSDF::Sample& bsdfSample, Sampler& sampler) const
         return 0.0f;
     }
 
-    return evaluateReflectance(bsdfSample.uv) * evaluateRoughnessFactor(bsdfSample.wi, bsdfSample.wo);
+    return evaluateReflectance(bsdfSample) * evaluateRoughnessFactor(bsdfSample.wi, bsdfSample.wo);
 }
 
 float OrenNayarBSDF::pdf(const BSDF::Sample& bsdfSample) const {
@@ -82,4 +84,8 @@ float OrenNayarBSDF::pdf(const BSDF::Sample& bsdfSample) const {
 
     return InvPI<> * cosThetaO;
 }
-} // namespace crisp
+
+Spectrum OrenNayarBSDF::getAlbedo(const BSDF::Sample& bsdfSample) const {
+    return evaluateReflectance(bsdfSample);
+}
+} // namespace crisp
\ No newline at end of file
@@ -11,9 +11,10 @@ public:
     Spectrum eval(const BSDF::Sample& bsdfSample) const override;
     Spectrum sample(BSDF::Sample& bsdfSample, Sampler& sampler) const override;
     float pdf(const BSDF::Sample& bsdfSample) const override;
+    Spectrum getAlbedo(const BSDF::Sample& bsdfSample) const override;
 
 private:
-    Spectrum evaluateReflectance(const glm::vec2& uv) const;
+    Spectrum evaluateReflectance(const BSDF::Sample& bsdfSample) const;
     float evaluateRoughnessFactor(const glm::vec3& wi, const glm::vec3& wo) const;
 
     Spectrum m_reflectance;
@@ -1,11 +1,17 @@
 #include <Crisp/PathTracer/BSSRDFs/DipoleBSSRDF.hpp>
 
-#include <functional>
-#include <iostream>
-#include <random>
-#include <thread>
+#include <algorithm>
+#include <array>
+#include <unordered_map>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <Crisp/Core/Logger.hpp>
+#include <Crisp/Core/Timer.hpp>
 #include <Crisp/Math/Constants.hpp>
 #include <Crisp/Math/Octree.hpp>
 #include <Crisp/Math/Warp.hpp>
@@ -37,15 +43,8 @@ struct DipoleIrradianceQuery {
         , alpha(alpha) {}
 
     Spectrum operator()(float sqrDist) const {
-        Spectrum dPos = Spectrum(sqrDist) + zPos * zPos;
-        dPos.r = std::sqrt(dPos.r);
-        dPos.g = std::sqrt(dPos.g);
-        dPos.b = std::sqrt(dPos.b);
-
-        Spectrum dNeg = Spectrum(sqrDist) + zNeg * zNeg;
-        dNeg.r = std::sqrt(dNeg.r);
-        dNeg.g = std::sqrt(dNeg.g);
-        dNeg.b = std::sqrt(dNeg.b);
+        const Spectrum dPos = (Spectrum(sqrDist) + zPos * zPos).sqrt();
+        const Spectrum dNeg = (Spectrum(sqrDist) + zNeg * zNeg).sqrt();
 
         Spectrum c1 = zPos * (dPos * sigmaTr + Spectrum(1.0f));
         Spectrum c2 = zNeg * (dNeg * sigmaTr + Spectrum(1.0f));
@@ -73,80 +72,131 @@ struct SubsurfaceParams {
 static std::unordered_map<std::string, SubsurfaceParams> materials = {
     {"Ketchup", {{0.061f, 0.97f, 1.45f}, {0.18f, 0.07f, 0.03f}, 1.3f}}};
 
-struct IrradianceTask {
-    IrradianceTask(int numLightSamples, const pt::Scene* scene, const Integrator* integrator)
-        : numLightSamples(numLightSamples)
-        , scene(scene)
-        , integrator(integrator) {}
-
-    int numLightSamples;
-    const pt::Scene* scene;
-    const Integrator* integrator;
-
-    void operator()(
-        std::vector<IrradiancePoint>& out, const std::vector<SurfacePoint>& in, size_t start, size_t end) const {
-        std::default_random_engine engine(std::random_device{}());
-        std::uniform_real_distribution<float> distrib(0.0f, 1.0f);
-        auto sampler = SamplerFactory::create("independent", VariantMap());
-
-        for (size_t i = start; i < end; i++) {
-            Spectrum color(0.0f);
-            for (int s = 0; s < numLightSamples; s++) {
-                Light::Sample sample(in[i].p);
-                Intersection its;
-                its.p = in[i].p;
-                Spectrum lightVal = scene->sampleLight(its, *sampler, sample);
-                auto cosFactor = glm::dot(in[i].n, sample.wi);
-
-                if (!(cosFactor <= 0.0f || lightVal.isZero())) {
-                    color += cosFactor * lightVal;
-                }
+using SamplerPool = tbb::enumerable_thread_specific<std::unique_ptr<Sampler>>;
 
-                CoordinateFrame frame(in[i].n);
-                glm::vec3 dir =
-                    frame.toWorld(warp::squareToCosineHemisphere(glm::vec2(distrib(engine), distrib(engine))));
-                Ray3 ray(in[i].p, dir);
-
-                // TODO: Request ONLY INDIRECT
-                color += integrator->Li(scene, *sampler, ray, Illumination::Indirect) * PI<>;
-            }
+// Every point draws from its own sample stream, so the results do not depend on how TBB schedules the work.
+enum SampleStream : int32_t {
+    kCandidateStream = 0,
+    kIrradianceStream = 1,
+};
 
-            color /= static_cast<float>(numLightSamples);
-            out[i] = IrradiancePoint(in[i], color);
+constexpr size_t kGrainSize = 256;
+
+// Dart throwing on a grid with cells at least minDist wide, so that conflicting points lie in neighboring cells.
+// Cells are processed in 27 phases by their coordinates modulo 3: cells of one phase are never neighbors, so they
+// can accept their candidates in parallel, each in its original order. The result is deterministic.
+std::vector<SurfacePoint> selectPoissonDiskPoints(
+    const std::vector<SurfacePoint>& candidates, const BoundingBox3& bounds, const float minDist) {
+    constexpr uint32_t kAxisBits = 21;
+    const glm::vec3 extents = bounds.getExtents();
+    const float cellSize =
+        std::max(minDist, std::max({extents.x, extents.y, extents.z}) / static_cast<float>(1 << (kAxisBits - 1)));
+
+    const auto getCell = [&](const glm::vec3& p) {
+        return glm::clamp(glm::ivec3((p - bounds.min) / cellSize), glm::ivec3(0), glm::ivec3((1 << kAxisBits) - 1));
+    };
+    const auto getKey = [](const glm::ivec3& cell) {
+        return (static_cast<uint64_t>(cell.x) << (2 * kAxisBits)) | (static_cast<uint64_t>(cell.y) << kAxisBits) |
+               static_cast<uint64_t>(cell.z);
+    };
+
+    struct Candidate {
+        uint64_t key;
+        uint32_t index;
+    };
+    std::vector<Candidate> sorted(candidates.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, candidates.size(), kGrainSize), [&](const auto& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+            sorted[i] = {getKey(getCell(candidates[i].p)), static_cast<uint32_t>(i)};
+        }
+    });
+    tbb::parallel_sort(sorted.begin(), sorted.end(), [](const Candidate& a, const Candidate& b) {
+        return a.key < b.key || (a.key == b.key && a.index < b.index);
+    });
+
+    struct CellRange {
+        uint32_t begin;
+        uint32_t end;
+    };
+    std::unordered_map<uint64_t, CellRange> cells;
+    std::array<std::vector<glm::ivec3>, 27> phases;
+    for (uint32_t begin = 0, end = 0; begin < sorted.size(); begin = end) {
+        end = begin + 1;
+        while (end < sorted.size() && sorted[end].key == sorted[begin].key) {
+            ++end;
         }
+        cells.emplace(sorted[begin].key, CellRange{begin, end});
+        const glm::ivec3 cell = getCell(candidates[sorted[begin].index].p);
+        phases[(cell.x % 3) * 9 + (cell.y % 3) * 3 + cell.z % 3].push_back(cell);
     }
-};
 
-class Executor {
-public:
-    Executor(int numThreads)
-        : m_threads(numThreads) {}
-
-    template <typename OutType, typename InType, typename Func>
-    void map(std::vector<OutType>& out, const std::vector<InType>& in, Func&& f) {
-        size_t itemsPerThread = out.size() / m_threads.size();
-        size_t leftOver = out.size() % m_threads.size();
-        size_t addedLeftOver = 0;
-        for (size_t i = 0; i < m_threads.size(); i++) {
-            size_t start = i * itemsPerThread + addedLeftOver;
-            size_t end = start + itemsPerThread;
-            if (leftOver > 0) {
-                end++;
-                addedLeftOver++;
-                leftOver--;
+    const float minDist2 = minDist * minDist;
+    std::vector<uint8_t> accepted(sorted.size(), 0);
+    for (const auto& phaseCells : phases) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, phaseCells.size()), [&](const auto& range) {
+            for (size_t c = range.begin(); c != range.end(); ++c) {
+                const glm::ivec3 cell = phaseCells[c];
+                const CellRange own = cells.at(getKey(cell));
+                for (uint32_t i = own.begin; i < own.end; ++i) {
+                    const glm::vec3& p = candidates[sorted[i].index].p;
+                    bool conflict = false;
+                    for (int32_t n = 0; n < 27 && !conflict; ++n) {
+                        const glm::ivec3 neighbor = cell + glm::ivec3(n / 9 - 1, (n / 3) % 3 - 1, n % 3 - 1);
+                        if (glm::any(glm::lessThan(neighbor, glm::ivec3(0)))) {
+                            continue;
+                        }
+                        const auto iter = cells.find(getKey(neighbor));
+                        if (iter == cells.end()) {
+                            continue;
+                        }
+                        for (uint32_t j = iter->second.begin; j < iter->second.end && !conflict; ++j) {
+                            const glm::vec3 diff = candidates[sorted[j].index].p - p;
+                            conflict = accepted[j] && glm::dot(diff, diff) < minDist2;
+                        }
+                    }
+                    accepted[i] = !conflict;
+                }
             }
+        });
+    }
 
-            m_threads[i] = std::thread([&out, &in, f, start, end] { f(out, in, start, end); });
+    std::vector<SurfacePoint> points;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (accepted[i]) {
+            points.push_back(candidates[sorted[i].index]);
         }
+    }
+    return points;
+}
 
-        for (auto& thread : m_threads) {
-            thread.join();
+Spectrum estimateIrradiance(
+    const SurfacePoint& point,
+    const int numLightSamples,
+    const pt::Scene* scene,
+    const Integrator* integrator,
+    Sampler& sampler) {
+    const CoordinateFrame frame(point.n);
+    Spectrum color(0.0f);
+    for (int s = 0; s < numLightSamples; s++) {
+        Light::Sample sample(point.p);
+        Intersection its;
+        its.p = point.p;
+        Spectrum lightVal = scene->sampleLight(its, sampler, sample);
+        auto cosFactor = glm::dot(point.n, sample.wi);
+
+        if (!(cosFactor <= 0.0f || lightVal.isZero())) {
+            color += cosFactor * lightVal;
         }
+
+        glm::vec3 dir = frame.toWorld(warp::squareToCosineHemisphere(sampler.next2D()));
+        Ray3 ray(point.p, dir);
+
+        // TODO: Request ONLY INDIRECT
+        color += integrator->Li(scene, sampler, ray, Illumination::Indirect) * PI<>;
     }
 
-private:
-    std::vector<std::thread> m_threads;
-};
+    return color / static_cast<float>(numLightSamples);
+}
 } // namespace
 
 DipoleBSSRDF::DipoleBSSRDF(const VariantMap& /*params*/) {
@@ -179,10 +229,7 @@ DipoleBSSRDF::DipoleBSSRDF(const VariantMap& /*params*/) {
 
     float A = (1.0f + m_fdr) / (1.0f - m_fdr);
 
-    m_sigmaTr = m_sigmaA * m_sigmaPrimeT * 3.0f;
-    m_sigmaTr.r = std::sqrt(m_sigmaTr.r);
-    m_sigmaTr.g = std::sqrt(m_sigmaTr.g);
-    m_sigmaTr.b = std::sqrt(m_sigmaTr.b);
+    m_sigmaTr = (m_sigmaA * m_sigmaPrimeT * 3.0f).sqrt();
 
     m_alphaPrime = m_sigmaPrimeS / m_sigmaPrimeT;
 
@@ -191,73 +238,72 @@ DipoleBSSRDF::DipoleBSSRDF(const VariantMap& /*params*/) {
 }
 
 void DipoleBSSRDF::preprocess(const Shape* shape, const pt::Scene* scene) {
-    auto sampler = SamplerFactory::create("independent", VariantMap());
+    const Timer<std::chrono::duration<double>> totalTimer;
+    SamplerPool samplers([] { return SamplerFactory::create("independent", VariantMap()); });
 
     Ray3 dummy;
-    Spectrum value = scene->getCamera()->sampleRay(dummy, glm::vec2(0.0f, 0.0f), sampler->next2D());
+    Spectrum value = scene->getCamera()->sampleRay(dummy, glm::vec2(0.0f, 0.0f), samplers.local()->next2D());
     glm::vec3 cameraPos = dummy.o;
 
     BoundingBox3 shapeBounds = shape->getBoundingBox();
     float expandFactor = 0.001f * std::powf(shapeBounds.getVolume(), 1.0f / 3.0f);
     shapeBounds.expandBy(expandFactor);
-    m_octree = std::make_unique<Octree<SurfacePoint>>(shapeBounds);
 
-    Shape::Sample shapeSample(cameraPos);
-
-    std::vector<SurfacePoint> surfacePoints;
-    for (int i = 0; i < m_sampleTrials; i++) {
-        glm::vec2 sample = sampler->next2D();
-        shape->sampleSurface(shapeSample, *sampler);
-
-        PoissonCheck check(m_minDist, shapeSample.p);
-        m_octree->lookup(shapeSample.p, check);
-        if (!check.failed) {
-            glm::vec3 delta(m_minDist);
-            float area = PI<> * m_minDist * m_minDist / 4.0f;
-            SurfacePoint surfPt(shapeSample.p, shapeSample.n, area);
-            m_octree->add(surfPt, BoundingBox3(shapeSample.p - delta, shapeSample.p + delta));
-            surfacePoints.emplace_back(surfPt);
+    // Candidates are drawn in parallel and thinned to a Poisson disk set afterwards.
+    const float area = PI<> * m_minDist * m_minDist / 4.0f;
+    std::vector<SurfacePoint> candidates(m_sampleTrials);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, candidates.size(), kGrainSize), [&](const auto& range) {
+        Sampler& sampler = *samplers.local();
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+            sampler.startPixelSample(glm::ivec2(static_cast<int32_t>(i), kCandidateStream), 0);
+            Shape::Sample shapeSample(cameraPos);
+            shape->sampleSurface(shapeSample, sampler);
+            candidates[i] = SurfacePoint(shapeSample.p, shapeSample.n, area);
+            Spectrum::endSample();
         }
+    });
+    const std::vector<SurfacePoint> surfacePoints = selectPoissonDiskPoints(candidates, shapeBounds, m_minDist);
+    const double samplingTime = totalTimer.getElapsedTime();
 
-        if (i % (m_sampleTrials / 10) == 0) {
-            std::cout << static_cast<float>(i) / m_sampleTrials * 100.0f << "% complete...\n";
-        }
+    m_octree = std::make_unique<Octree<SurfacePoint>>(shapeBounds);
+    const glm::vec3 delta(m_minDist);
+    for (const auto& surfPt : surfacePoints) {
+        m_octree->add(surfPt, BoundingBox3(surfPt.p - delta, surfPt.p + delta));
     }
 
-    m_irrPts.resize(surfacePoints.size());
-    int numLightSamples = 16;
+    const Timer<std::chrono::duration<double>> irradianceTimer;
+    const int numLightSamples = 16;
     const Integrator* integrator = scene->getIntegrator();
-
-    unsigned int numThreads = std::thread::hardware_concurrency();
-    if (numThreads <= 1) {
-        IrradianceTask(numLightSamples, scene, integrator)(m_irrPts, surfacePoints, 0, surfacePoints.size());
-    } else {
-        Executor exec(numThreads);
-        exec.map(m_irrPts, surfacePoints, IrradianceTask(numLightSamples, scene, integrator));
-    }
-
-    float areaPerElement = 1.0f / shape->pdfSurface(Shape::Sample()) / m_irrPts.size();
-
-    for (int i = 0; i < m_irrPts.size(); i++) {
-        m_irrPts[i].area = areaPerElement;
-    }
-
-    std::cout << "Building the irradiance cache...\n";
-
-    m_ssOctree = std::make_unique<IrradianceTree>();
-    m_ssOctree->root = std::make_unique<IrradianceNode>();
-    for (const auto& pt : m_irrPts) {
-        m_ssOctree->boundingBox.expandBy(pt.p);
-    }
-
-    for (auto& pt : m_irrPts) {
-        m_ssOctree->root->insert(m_ssOctree->boundingBox, &pt);
-    }
-    m_ssOctree->root->initHierarchy();
-
-    Spectrum leafIrradiance = m_ssOctree->root->getLeafIrradiance();
-
-    std::cout << "LEAF: " << leafIrradiance.r << " " << leafIrradiance.g << " " << leafIrradiance.b << std::endl;
+    const float areaPerElement = 1.0f / shape->pdfSurface(Shape::Sample()) / static_cast<float>(surfacePoints.size());
+    std::vector<IrradiancePoint> irradiancePoints(surfacePoints.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, surfacePoints.size()), [&](const auto& range) {
+        Sampler& sampler = *samplers.local();
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+            sampler.startPixelSample(glm::ivec2(static_cast<int32_t>(i), kIrradianceStream), 0);
+            // The cache outlives the sample, so spectral estimates are stored as RGB and uplifted again when read.
+            const Spectrum irradiance =
+                estimateIrradiance(surfacePoints[i], numLightSamples, scene, integrator, sampler);
+            irradiancePoints[i] = IrradiancePoint(surfacePoints[i], Spectrum(irradiance.toRgb()));
+            irradiancePoints[i].area = areaPerElement;
+            Spectrum::endSample();
+        }
+    });
+    const double irradianceTime = irradianceTimer.getElapsedTime();
+
+    const Timer<std::chrono::duration<double>> treeTimer;
+    m_irradianceTree = std::make_unique<IrradianceTree>(std::move(irradiancePoints));
+    const double treeTime = treeTimer.getElapsedTime();
+
+    spdlog::info(
+        "Dipole BSSRDF: {} points from {} candidates in {:.3f} s (sampling {:.3f}, irradiance {:.3f}, tree {:.3f}).",
+        surfacePoints.size(),
+        candidates.size(),
+        totalTimer.getElapsedTime(),
+        samplingTime,
+        irradianceTime,
+        treeTime);
+    const glm::vec3 leafIrradiance = m_irradianceTree->getLeafIrradiance().toRgb();
+    spdlog::debug("Dipole BSSRDF total irradiance: {} {} {}", leafIrradiance.r, leafIrradiance.g, leafIrradiance.b);
 }
 
 Spectrum DipoleBSSRDF::eval(const Sample& sample) const {
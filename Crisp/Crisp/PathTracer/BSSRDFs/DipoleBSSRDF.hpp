@@ -35,7 +35,6 @@ private:
     float m_fdr;
 
     std::unique_ptr<Octree<SurfacePoint>> m_octree;
-    std::unique_ptr<IrradianceTree> m_ssOctree;
-    std::vector<IrradiancePoint> m_irrPts;
+    std::unique_ptr<IrradianceTree> m_irradianceTree;
 };
 } // namespace crisp
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include <Crisp/PathTracer/BSSRDFs/IrradianceTree.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace crisp {
+namespace {
+uint32_t getOctant(const glm::vec3& p, const glm::vec3& mid) {
+    return (p.x > mid.x ? 4 : 0) + (p.y > mid.y ? 2 : 0) + (p.z > mid.z ? 1 : 0);
+}
+
+BoundingBox3 getChildBound(const uint32_t child, const BoundingBox3& bounds, const glm::vec3& mid) {
+    BoundingBox3 bound;
+    bound.min.x = (child & 4) ? mid.x : bounds.min.x;
+    bound.min.y = (child & 2) ? mid.y : bounds.min.y;
+    bound.min.z = (child & 1) ? mid.z : bounds.min.z;
+    bound.max.x = (child & 4) ? bounds.max.x : mid.x;
+    bound.max.y = (child & 2) ? bounds.max.y : mid.y;
+    bound.max.z = (child & 1) ? bounds.max.z : mid.z;
+    return bound;
+}
+} // namespace
+
+IrradianceTree::IrradianceTree(std::vector<IrradiancePoint> points)
+    : m_points(std::move(points)) {
+    build();
+}
+
+const BoundingBox3& IrradianceTree::getBoundingBox() const {
+    return m_boundingBox;
+}
+
+std::span<const IrradianceTree::Node> IrradianceTree::getNodes() const {
+    return m_nodes;
+}
+
+std::span<const IrradiancePoint> IrradianceTree::getPoints() const {
+    return m_points;
+}
+
+Spectrum IrradianceTree::getLeafIrradiance() const {
+    Spectrum sum(0.0f);
+    for (const auto& point : m_points) {
+        sum += point.e;
+    }
+    return sum;
+}
+
+void IrradianceTree::build() {
+    if (m_points.empty()) {
+        return;
+    }
+
+    for (const auto& point : m_points) {
+        m_boundingBox.expandBy(point.p);
+    }
+
+    // Nodes are split in index order, which appends the children of each level after the previous one. The points
+    // of a split node are sorted by octant in place, so each child keeps a subrange of its parent's range.
+    struct PointRange {
+        uint32_t begin;
+        uint32_t end;
+    };
+    std::vector<PointRange> ranges{{0, static_cast<uint32_t>(m_points.size())}};
+    m_nodes.push_back({.bounds = m_boundingBox});
+
+    std::vector<uint32_t> levelOffsets{0};
+    std::vector<IrradiancePoint> scratch;
+    uint32_t levelEnd = 1;
+    uint32_t depth = 0;
+    for (uint32_t nodeIndex = 0; nodeIndex < m_nodes.size(); ++nodeIndex) {
+        if (nodeIndex == levelEnd) {
+            levelOffsets.push_back(nodeIndex);
+            levelEnd = static_cast<uint32_t>(m_nodes.size());
+            ++depth;
+        }
+
+        const auto [begin, end] = ranges[nodeIndex];
+        if (end - begin <= kMaxLeafPoints || depth == kMaxDepth) {
+            m_nodes[nodeIndex].offset = begin;
+            m_nodes[nodeIndex].pointCount = end - begin;
+            continue;
+        }
+
+        const BoundingBox3 bounds = m_nodes[nodeIndex].bounds;
+        const glm::vec3 mid = bounds.getCenter();
+        std::array<uint32_t, 8> counts{};
+        for (uint32_t i = begin; i < end; ++i) {
+            ++counts[getOctant(m_points[i].p, mid)];
+        }
+
+        std::array<uint32_t, 8> starts{};
+        uint8_t childMask = 0;
+        const auto firstChild = static_cast<uint32_t>(m_nodes.size());
+        for (uint32_t octant = 0, start = begin; octant < 8; ++octant) {
+            starts[octant] = start;
+            if (counts[octant] > 0) {
+                childMask |= static_cast<uint8_t>(1 << octant);
+                m_nodes.push_back({.bounds = getChildBound(octant, bounds, mid)});
+                ranges.push_back({start, start + counts[octant]});
+            }
+            start += counts[octant];
+        }
+        m_nodes[nodeIndex].offset = firstChild;
+        m_nodes[nodeIndex].childMask = childMask;
+
+        scratch.assign(m_points.begin() + begin, m_points.begin() + end);
+        for (const auto& point : scratch) {
+            m_points[starts[getOctant(point.p, mid)]++] = point;
+        }
+    }
+    levelOffsets.push_back(static_cast<uint32_t>(m_nodes.size()));
+
+    aggregate(levelOffsets);
+}
+
+void IrradianceTree::aggregate(const std::span<const uint32_t> levelOffsets) {
+    // Children always sit in the level below their parent, so the levels are finished bottom-up and the nodes within
+    // a level are independent of each other.
+    for (size_t level = levelOffsets.size() - 1; level > 0; --level) {
+        tbb::parallel_for(
+            tbb::blocked_range<uint32_t>(levelOffsets[level - 1], levelOffsets[level]),
+            [this](const tbb::blocked_range<uint32_t>& range) {
+                for (uint32_t nodeIndex = range.begin(); nodeIndex != range.end(); ++nodeIndex) {
+                    Node& node = m_nodes[nodeIndex];
+                    float weightSum = 0.0f;
+                    uint32_t count = 0;
+                    const auto accumulate = [&](const glm::vec3& p, const Spectrum& e, const float area) {
+                        const float weight = e.getLuminance();
+                        node.e += e;
+                        node.p += weight * p;
+                        node.sumArea += area;
+                        weightSum += weight;
+                        ++count;
+                    };
+
+                    if (node.isLeaf()) {
+                        for (uint32_t i = node.offset; i < node.offset + node.pointCount; ++i) {
+                            accumulate(m_points[i].p, m_points[i].e, m_points[i].area);
+                        }
+                    } else {
+                        const auto childCount = static_cast<uint32_t>(std::popcount(node.childMask));
+                        for (uint32_t i = node.offset; i < node.offset + childCount; ++i) {
+                            accumulate(m_nodes[i].p, m_nodes[i].e, m_nodes[i].sumArea);
+                        }
+                    }
+
+                    // Irradiance is the plain average of the points or children, as in pbrt's hierarchical
+                    // integration. Zero-irradiance subtrees fall back to the center of their bounds.
+                    if (weightSum > 0.0f) {
+                        node.p /= weightSum;
+                    } else {
+                        node.p = node.bounds.getCenter();
+                    }
+                    if (count > 0) {
+                        node.e /= static_cast<float>(count);
+                    }
+                }
+            });
+    }
+}
+} // namespace crisp
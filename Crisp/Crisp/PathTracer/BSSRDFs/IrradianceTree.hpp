@@ -3,7 +3,10 @@
 #include <Crisp/Math/BoundingBox.hpp>
 #include <Crisp/PathTracer/Spectra/Spectrum.hpp>
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace crisp {
@@ -60,204 +63,86 @@ struct IrradiancePoint {
     float rayEpsilon;
 };
 
-struct IrradianceNode {
-    glm::vec3 p;
-    bool isLeaf;
-    Spectrum e;
-    float sumArea;
-    std::array<std::unique_ptr<IrradianceNode>, 8> children;
-    std::array<IrradiancePoint*, 8> irrPts;
-
-    IrradianceNode()
-        : isLeaf(true)
-        , sumArea(0.0f) {
-        for (int i = 0; i < 8; i++) {
-            irrPts[i] = nullptr;
-            children[i] = nullptr;
+// Octree over the irradiance samples of a translucent shape, used to integrate the dipole response hierarchically.
+// Nodes are stored breadth-first in one array, with the children of a node next to each other, and the points are
+// reordered so that every leaf owns a contiguous range of them. Each node caches the luminance-weighted position,
+// average irradiance and total area of its subtree, so that distant subtrees can be evaluated as a single point.
+class IrradianceTree {
+public:
+    static constexpr uint32_t kMaxLeafPoints = 8;
+    // Coincident points cannot be separated, so subdivision stops at this depth regardless of the point count.
+    static constexpr uint32_t kMaxDepth = 24;
+
+    // Sized to a cache line, since queries visit nodes in an order that rarely matches the memory layout.
+    struct alignas(64) Node {
+        BoundingBox3 bounds;
+        glm::vec3 p{0.0f};
+        float sumArea{0.0f};
+        Spectrum e{0.0f};
+        uint32_t offset{0};     // Index of the first child for interior nodes, of the first point for leaves.
+        uint32_t pointCount{0}; // Zero for interior nodes.
+        uint8_t childMask{0};   // Octants that have a child, which are stored in increasing octant order.
+
+        bool isLeaf() const {
+            return childMask == 0;
         }
-    }
-
-    inline BoundingBox3 getChildBound(int child, const BoundingBox3& bounds, const glm::vec3& mid) {
-        BoundingBox3 bound;
-        bound.min.x = (child & 4) ? mid.x : bounds.min.x;
-        bound.min.y = (child & 2) ? mid.y : bounds.min.y;
-        bound.min.z = (child & 1) ? mid.z : bounds.min.z;
-        bound.max.x = (child & 4) ? bounds.max.x : mid.x;
-        bound.max.y = (child & 2) ? bounds.max.y : mid.y;
-        bound.max.z = (child & 1) ? bounds.max.z : mid.z;
-        return bound;
-    }
-
-    void insert(const BoundingBox3& nodeBounds, IrradiancePoint* point) {
-        glm::vec3 mid = nodeBounds.getCenter();
-        if (isLeaf) {
-            for (int i = 0; i < 8; i++) {
-                if (!irrPts[i]) {
-                    irrPts[i] = point;
-                    return;
-                }
-            }
-
-            isLeaf = false;
-            IrradiancePoint* localPts[8];
-            for (int i = 0; i < 8; i++) {
-                localPts[i] = irrPts[i];
-                children[i] = nullptr;
-            }
-
-            for (int i = 0; i < 8; i++) {
-                IrradiancePoint* currPt = localPts[i];
-
-                int child =
-                    (currPt->p.x > mid.x ? 4 : 0) + (currPt->p.y > mid.y ? 2 : 0) + (currPt->p.z > mid.z ? 1 : 0);
-                if (children[child] == nullptr) {
-                    children[child] = std::make_unique<IrradianceNode>();
-                }
+    };
 
-                BoundingBox3 childBounds = getChildBound(child, nodeBounds, mid);
-                children[child]->insert(childBounds, currPt);
-            }
-
-            int child = (point->p.x > mid.x ? 4 : 0) + (point->p.y > mid.y ? 2 : 0) + (point->p.z > mid.z ? 1 : 0);
-            if (children[child] == nullptr) {
-                children[child] = std::make_unique<IrradianceNode>();
-            }
+    IrradianceTree() = default;
+    explicit IrradianceTree(std::vector<IrradiancePoint> points);
 
-            BoundingBox3 childBounds = getChildBound(child, nodeBounds, mid);
-            children[child]->insert(childBounds, point);
-        }
-    }
-
-    Spectrum getLeafIrradiance() {
-        Spectrum sum(0.0f);
-        if (isLeaf) {
-            for (int i = 0; i < irrPts.size(); i++) {
-                if (!irrPts[i]) {
-                    break;
-                }
-                sum += irrPts[i]->e;
-            }
-        } else {
-            for (int i = 0; i < children.size(); i++) {
-                if (!children[i]) {
-                    continue;
-                }
-                sum += children[i]->getLeafIrradiance();
-            }
-        }
+    const BoundingBox3& getBoundingBox() const;
+    std::span<const Node> getNodes() const;
+    std::span<const IrradiancePoint> getPoints() const;
 
-        return sum;
-    }
-
-    Spectrum getTotalIrradiance() {
-        Spectrum sum(0.0f);
-        if (isLeaf) {
-            for (int i = 0; i < irrPts.size(); i++) {
-                if (!irrPts[i]) {
-                    break;
-                }
-                sum += irrPts[i]->e;
-            }
-        } else {
-            for (int i = 0; i < children.size(); i++) {
-                if (!children[i]) {
-                    continue;
-                }
-                sum += children[i]->getLeafIrradiance();
-            }
-
-            sum += e;
-        }
-
-        return sum;
-    }
-
-    void initHierarchy() {
-        if (isLeaf) {
-            float weightSum = 0.0f;
-            size_t i;
-            for (i = 0; i < 8; i++) {
-                if (!irrPts[i]) {
-                    break;
-                }
-                float weight = irrPts[i]->e.getLuminance();
-                e += irrPts[i]->e;
-                p += weight * irrPts[i]->p;
-                weightSum += weight;
-                sumArea += irrPts[i]->area;
-            }
-
-            if (weightSum > 0.0f) {
-                p /= weightSum;
-            }
-
-            if (i > 0) {
-                e /= static_cast<float>(i);
-            }
-        } else {
-            float weightSum = 0.0f;
-            size_t numChildren = 0;
-            for (uint32_t i = 0; i < 8; i++) {
-                if (!children[i]) {
-                    continue;
-                }
-                ++numChildren;
-                children[i]->initHierarchy();
-                float weight = children[i]->e.getLuminance();
-                e += children[i]->e;
-                p += weight * children[i]->p;
-                weightSum += weight;
-                sumArea += children[i]->sumArea;
-            }
-            if (weightSum > 0.0f) {
-                p /= weightSum;
-            }
-
-            if (numChildren > 0) {
-                e /= static_cast<float>(numChildren);
-            }
-        }
-    }
+    // Sum of the irradiance of all points.
+    Spectrum getLeafIrradiance() const;
 
+    // Integrates func(squared distance) * irradiance * area over the points around pt. Subtrees that are small
+    // relative to their distance from pt, by the solid angle estimate sumArea / distance^2 < maxError, are
+    // approximated by their aggregate.
     template <typename Func>
-    Spectrum Mo(const BoundingBox3& nodeBounds, const glm::vec3& pt, Func& func, float maxError) {
-        glm::vec3 diff = pt - p;
-        float sqrDist = glm::dot(diff, diff);
-        float distanceWeight = sumArea / sqrDist;
-        if (distanceWeight < maxError && !nodeBounds.contains(pt)) {
-            return func(sqrDist) * e * sumArea;
+    Spectrum Mo(const glm::vec3& pt, const Func& func, const float maxError) const {
+        Spectrum mo(0.0f);
+        if (m_nodes.empty()) {
+            return mo;
         }
 
-        Spectrum mo = 0.0f;
-        if (isLeaf) {
-            for (int i = 0; i < 8; i++) {
-                if (!irrPts[i]) {
-                    break;
+        // Each visited interior node replaces itself with at most eight children.
+        std::array<uint32_t, 7 * kMaxDepth + 1> stack; // NOLINT
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0) {
+            const Node& node = m_nodes[stack[--stackSize]];
+            const glm::vec3 diff = pt - node.p;
+            const float sqrDist = glm::dot(diff, diff);
+            if (node.sumArea < maxError * sqrDist && !node.bounds.contains(pt)) {
+                mo += func(sqrDist) * node.e * node.sumArea;
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                for (uint32_t i = node.offset; i < node.offset + node.pointCount; ++i) {
+                    const glm::vec3 diffC = m_points[i].p - pt;
+                    mo += func(glm::dot(diffC, diffC)) * m_points[i].e * m_points[i].area;
                 }
-
-                glm::vec3 diffC = irrPts[i]->p - pt;
-                float cSqrDist = glm::dot(diffC, diffC);
-
-                mo += func(cSqrDist) * irrPts[i]->e * irrPts[i]->area;
-            }
-        } else {
-            glm::vec3 mid = nodeBounds.getCenter();
-            for (int child = 0; child < 8; child++) {
-                if (!children[child]) {
-                    continue;
+            } else {
+                const auto childCount = static_cast<uint32_t>(std::popcount(node.childMask));
+                for (uint32_t i = 0; i < childCount; ++i) {
+                    stack[stackSize++] = node.offset + i;
                 }
-
-                BoundingBox3 childBounds = getChildBound(child, nodeBounds, mid);
-                mo += children[child]->Mo(childBounds, pt, func, maxError);
             }
         }
 
         return mo;
     }
-};
 
-struct IrradianceTree {
-    std::unique_ptr<IrradianceNode> root;
-    BoundingBox3 boundingBox;
+private:
+    void build();
+    void aggregate(std::span<const uint32_t> levelOffsets);
+
+    BoundingBox3 m_boundingBox;
+    std::vector<Node> m_nodes;
+    std::vector<IrradiancePoint> m_points;
 };
-} // namespace crisp
\ No newline at end of file
+} // namespace crisp
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <Crisp/PathTracer/LightSamplers/LightSamplerFactory.hpp>
+#include <Crisp/PathTracer/Lights/PointLight.hpp>
+#include <Crisp/PathTracer/Samplers/Independent.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace crisp {
+namespace {
+constexpr int32_t kLightCount = 512;
+constexpr int32_t kShadingPointCount = 256;
+
+// Small lights scattered over a large floor, with powers spanning three orders of magnitude. Every shading point is
+// lit mostly by the few lights close to it, which is where picking by power alone wastes most of its samples.
+struct ManyLightScene {
+    std::vector<std::unique_ptr<Light>> lights;
+    std::vector<Light*> lightPointers;
+    std::vector<glm::vec3> shadingPoints;
+    std::vector<double> reference;
+};
+
+const ManyLightScene& getScene() {
+    static const ManyLightScene scene = [] {
+        ManyLightScene result;
+        IndependentSampler sampler;
+        sampler.startPixelSample(glm::ivec2(0), 0);
+        for (int32_t i = 0; i < kLightCount; ++i) {
+            VariantMap parameters;
+            const glm::vec2 xz = (sampler.next2D() - 0.5f) * 100.0f;
+            parameters.insert("position", glm::vec3(xz.x, 0.5f + 2.0f * sampler.next1D(), xz.y));
+            parameters.insert("power", Spectrum(std::pow(10.0f, 3.0f * sampler.next1D())));
+            result.lights.push_back(std::make_unique<PointLight>(parameters));
+            result.lightPointers.push_back(result.lights.back().get());
+        }
+
+        // Irradiance on the floor, summed over all lights since there is no occlusion.
+        for (int32_t i = 0; i < kShadingPointCount; ++i) {
+            const glm::vec2 xz = (sampler.next2D() - 0.5f) * 100.0f;
+            result.shadingPoints.emplace_back(xz.x, 0.0f, xz.y);
+
+            double irradiance = 0.0;
+            for (const Light* light : result.lightPointers) {
+                Light::Sample lightSample(result.shadingPoints.back());
+                const float radiance = light->sample(lightSample, sampler).getLuminance();
+                irradiance += radiance * std::max(lightSample.wi.y, 0.0f);
+            }
+            result.reference.push_back(irradiance);
+        }
+        return result;
+    }();
+    return scene;
+}
+
+// Estimates the irradiance at every shading point with the given number of light samples and reports the relative
+// RMSE. Lower mse * time means less error at equal render time, which is the fair way to compare the samplers.
+void BM_ManyLights(benchmark::State& state, const std::string& type) {
+    const ManyLightScene& scene = getScene();
+    const auto lightSampler = LightSamplerFactory::create(type, VariantMap());
+    lightSampler->build(scene.lightPointers);
+
+    const auto sampleCount = static_cast<uint32_t>(state.range(0));
+    const glm::vec3 normal(0.0f, 1.0f, 0.0f);
+    IndependentSampler sampler;
+    double rmse = 0.0;
+    for (auto _ : state) {
+        double squaredError = 0.0;
+        for (int32_t i = 0; i < kShadingPointCount; ++i) {
+            const glm::vec3& p = scene.shadingPoints[i];
+            double sum = 0.0;
+            for (uint32_t s = 0; s < sampleCount; ++s) {
+                sampler.startPixelSample(glm::ivec2(i, 0), s);
+                float pmf = 0.0f;
+                const Light* light = lightSampler->sample(p, normal, sampler.next1D(), pmf);
+                if (!light) {
+                    continue;
+                }
+
+                Light::Sample lightSample(p);
+                const float radiance = light->sample(lightSample, sampler).getLuminance();
+                sum += radiance * std::max(lightSample.wi.y, 0.0f) / pmf;
+            }
+
+            const double error = (sum / sampleCount - scene.reference[i]) / scene.reference[i];
+            squaredError += error * error;
+        }
+        rmse = std::sqrt(squaredError / kShadingPointCount);
+        benchmark::DoNotOptimize(rmse);
+    }
+
+    state.counters["rmse"] = rmse;
+    // Rate of iterations / mse, inverted, gives mse times the seconds per iteration.
+    state.counters["mseTime"] = benchmark::Counter(static_cast<double>(state.iterations()) / (rmse * rmse),
+                                                   benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kShadingPointCount * sampleCount));
+}
+} // namespace
+
+BENCHMARK_CAPTURE(BM_ManyLights, Uniform, std::string("uniform"))->RangeMultiplier(4)->Range(1, 64); // NOLINT
+BENCHMARK_CAPTURE(BM_ManyLights, Power, std::string("power"))->RangeMultiplier(4)->Range(1, 64);     // NOLINT
+BENCHMARK_CAPTURE(BM_ManyLights, Bvh, std::string("bvh"))->RangeMultiplier(4)->Range(1, 64);         // NOLINT
+
+} // namespace crisp
+
+BENCHMARK_MAIN(); // NOLINT
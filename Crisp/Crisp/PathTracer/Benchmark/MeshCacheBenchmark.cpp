@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <Crisp/PathTracer/Shapes/MeshCache.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace crisp {
+namespace {
+constexpr int kGridSize = 512; // Quads per side, for half a million triangles.
+
+const std::filesystem::path& getBenchmarkDirectory() {
+    static const std::filesystem::path directory = std::filesystem::temp_directory_path() / "crisp-mesh-benchmark";
+    return directory;
+}
+
+// Writes a height field with normals and texture coordinates, as a scanned or sculpted OBJ would have.
+const std::filesystem::path& getGridMesh() {
+    static const std::filesystem::path path = [] {
+        std::filesystem::create_directories(getBenchmarkDirectory());
+        const auto gridPath = getBenchmarkDirectory() / "grid.obj";
+        std::ofstream file(gridPath);
+        constexpr int kVertexCount = kGridSize + 1;
+        for (int y = 0; y < kVertexCount; ++y) {
+            for (int x = 0; x < kVertexCount; ++x) {
+                const float u = static_cast<float>(x) / kGridSize;
+                const float v = static_cast<float>(y) / kGridSize;
+                file << "v " << u << ' ' << 0.1f * std::sin(10.0f * u) * std::cos(10.0f * v) << ' ' << v << '\n';
+                file << "vn 0 1 0\n";
+                file << "vt " << u << ' ' << v << '\n';
+            }
+        }
+        for (int y = 0; y < kGridSize; ++y) {
+            for (int x = 0; x < kGridSize; ++x) {
+                const int i = y * kVertexCount + x + 1;
+                const int j = i + kVertexCount;
+                file << "f " << i << '/' << i << '/' << i << ' ' << j << '/' << j << '/' << j << ' ' << j + 1 << '/'
+                     << j + 1 << '/' << j + 1 << '\n';
+                file << "f " << i << '/' << i << '/' << i << ' ' << j + 1 << '/' << j + 1 << '/' << j + 1 << ' '
+                     << i + 1 << '/' << i + 1 << '/' << i + 1 << '\n';
+            }
+        }
+        return gridPath;
+    }();
+    return path;
+}
+
+void BM_LoadObj(benchmark::State& state) {
+    const auto& path = getGridMesh();
+    for (auto _ : state) {
+        auto mesh = loadTriangleMesh(path);
+        benchmark::DoNotOptimize(mesh->getPositions().data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+
+// Loads from a warm cache file, which the first call writes.
+void BM_LoadCached(benchmark::State& state) {
+    const auto& path = getGridMesh();
+    const auto cacheDirectory = getBenchmarkDirectory() / "cache";
+    if (!loadCachedTriangleMesh(path, cacheDirectory)) {
+        state.SkipWithError("Failed to cache the grid mesh");
+        return;
+    }
+
+    for (auto _ : state) {
+        auto mesh = loadCachedTriangleMesh(path, cacheDirectory);
+        benchmark::DoNotOptimize(mesh->getPositions().data());
+        benchmark::ClobberMemory();
+    }
+    const auto cacheSize = std::filesystem::file_size(getMeshCachePath(path, cacheDirectory));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * cacheSize));
+}
+} // namespace
+
+BENCHMARK(BM_LoadObj)->Unit(benchmark::kMillisecond);    // NOLINT
+BENCHMARK(BM_LoadCached)->Unit(benchmark::kMillisecond); // NOLINT
+
+} // namespace crisp
+
+BENCHMARK_MAIN(); // NOLINT
@@ -0,0 +1,244 @@
+#include <benchmark/benchmark.h>
+
+#include <Crisp/PathTracer/Cameras/Camera.hpp>
+#include <Crisp/PathTracer/Core/Intersection.hpp>
+#include <Crisp/PathTracer/Core/JsonSceneParser.hpp>
+#include <Crisp/PathTracer/Core/Scene.hpp>
+#include <Crisp/PathTracer/ExternalAssetConfig.hpp>
+#include <Crisp/PathTracer/Integrators/IntegratorFactory.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+namespace crisp {
+namespace {
+// The error is measured on every fourth pixel in each direction, which keeps the reference affordable.
+constexpr int32_t kPixelStride = 4;
+constexpr uint32_t kReferenceSampleCount = 4096;
+// The reference takes its own samples, so that its noise is independent of the renders it is compared to.
+constexpr uint32_t kReferenceFirstSample = 1u << 20;
+constexpr int64_t kTimeBudgetSeconds = 30;
+
+constexpr const char* kCbox = "cbox-test-mis.json";
+constexpr const char* kCboxMaterials = "Nori-PA-4/cbox-mats.json";
+constexpr const char* kIndirectRoom = "indirect-room";
+
+struct GuidingWorkload {
+    std::unique_ptr<pt::Scene> scene;
+    std::vector<glm::ivec2> pixels;
+    std::vector<glm::vec3> reference;
+};
+
+// Writes the quad spanned by u and v from origin, facing along cross(u, v).
+void writeQuad(std::ofstream& file, const glm::vec3& origin, const glm::vec3& u, const glm::vec3& v, int32_t& first) {
+    for (const glm::vec3& p : {origin, origin + u, origin + u + v, origin + v}) {
+        file << "v " << p.x << ' ' << p.y << ' ' << p.z << '\n';
+    }
+    file << "f " << first << ' ' << first + 1 << ' ' << first + 2 << '\n';
+    file << "f " << first << ' ' << first + 2 << ' ' << first + 3 << '\n';
+    first += 4;
+}
+
+// Writes a diffuse room whose only light is a small sphere in a corner under the ceiling, hidden from the room by a
+// panel below it. Light reaches the room through the gap between the panel and the ceiling, so nearly all of it is
+// indirect, which is the case guiding is meant for, and the scene needs no external assets.
+std::filesystem::path writeIndirectRoomScene() {
+    const auto directory = std::filesystem::temp_directory_path() / "crisp-path-guiding-benchmark";
+    std::filesystem::create_directories(directory);
+
+    std::ofstream mesh(directory / "room.obj");
+    int32_t first = 1;
+    writeQuad(mesh, {-2.0f, 0.0f, -2.0f}, {0.0f, 0.0f, 4.0f}, {4.0f, 0.0f, 0.0f}, first); // Floor
+    writeQuad(mesh, {-2.0f, 3.0f, -2.0f}, {4.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 4.0f}, first); // Ceiling
+    writeQuad(mesh, {-2.0f, 0.0f, -2.0f}, {4.0f, 0.0f, 0.0f}, {0.0f, 3.0f, 0.0f}, first); // Back wall
+    writeQuad(mesh, {-2.0f, 0.0f, 2.0f}, {0.0f, 3.0f, 0.0f}, {4.0f, 0.0f, 0.0f}, first);  // Front wall
+    writeQuad(mesh, {-2.0f, 0.0f, -2.0f}, {0.0f, 3.0f, 0.0f}, {0.0f, 0.0f, 4.0f}, first); // Left wall
+    writeQuad(mesh, {2.0f, 0.0f, -2.0f}, {0.0f, 0.0f, 4.0f}, {0.0f, 3.0f, 0.0f}, first);  // Right wall
+    writeQuad(mesh, {0.8f, 2.6f, -2.0f}, {1.2f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.2f}, first);  // Panel below the light
+
+    const auto scenePath = directory / "indirect-room.json";
+    std::ofstream(scenePath) << R"({
+    "sampler": {"type": "independent", "samplesPerPixel": 1},
+    "camera": {
+        "type": "perspective",
+        "imageSize": [128, 128],
+        "fovY": 60.0,
+        "position": [0.0, 1.4, 1.8],
+        "target": [0.0, 1.2, -2.0],
+        "up": [0.0, 1.0, 0.0]
+    },
+    "shapes": [
+        {"type": "mesh", "filename": "room.obj", "bsdf": {"type": "lambertian", "reflectance": [0.7, 0.7, 0.7]}},
+        {"type": "sphere", "center": [1.4, 2.85, -1.4], "radius": 0.1,
+         "bsdf": {"type": "lambertian", "reflectance": [0.0, 0.0, 0.0]},
+         "light": {"type": "area", "radiance": [400.0, 400.0, 400.0]}}
+    ]
+})";
+    return scenePath;
+}
+
+void setIntegrator(pt::Scene& scene, const std::string& type) {
+    auto integrator = IntegratorFactory::create(type, VariantMap());
+    integrator->preprocess(&scene);
+    scene.setIntegrator(std::move(integrator));
+}
+
+// Adds sampleCount samples of every pixel to its sum, starting at firstSample.
+void renderPixels(
+    const pt::Scene& scene,
+    const std::vector<glm::ivec2>& pixels,
+    const uint32_t firstSample,
+    const uint32_t sampleCount,
+    std::vector<glm::vec3>& sums) {
+    const Camera& camera = *scene.getCamera();
+    tbb::enumerable_thread_specific<std::unique_ptr<Sampler>> samplers(
+        [&scene] { return scene.getSampler()->clone(); });
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pixels.size()), [&](const tbb::blocked_range<size_t>& range) {
+        Sampler& sampler = *samplers.local();
+        for (size_t i = range.begin(); i != range.end(); ++i) {
+            for (uint32_t s = firstSample; s < firstSample + sampleCount; ++s) {
+                sampler.startPixelSample(pixels[i], s);
+                std::array<float, 4> cameraSample; // Pixel position followed by aperture position
+                sampler.fill(cameraSample);
+                Ray3 ray;
+                const Spectrum response = camera.sampleRay(
+                    ray,
+                    glm::vec2(pixels[i].x + cameraSample[0], pixels[i].y + cameraSample[1]),
+                    glm::vec2(cameraSample[2], cameraSample[3]));
+                sums[i] += (response * scene.getIntegrator()->Li(&scene, sampler, ray)).toRgb();
+            }
+        }
+    });
+}
+
+// Loads the scene and renders the reference of its measured pixels with the MIS path tracer, once per scene.
+GuidingWorkload* getWorkload(benchmark::State& state, const std::string& sceneName) {
+    static std::map<std::string, GuidingWorkload> workloads;
+    if (const auto iter = workloads.find(sceneName); iter != workloads.end()) {
+        return &iter->second;
+    }
+
+    std::filesystem::path scenePath;
+    std::filesystem::path meshDirectory;
+    if (sceneName == kIndirectRoom) {
+        scenePath = writeIndirectRoomScene();
+        meshDirectory = scenePath.parent_path();
+    } else if (test::kExternalAssetDir.empty()) {
+        state.SkipWithError("Set CRISP_EXTERNAL_ASSET_DIR to the full Crisp Resources directory");
+        return nullptr;
+    } else {
+        scenePath = test::kExternalAssetDir / "VesperScenes" / sceneName;
+        meshDirectory = test::kExternalAssetDir / "Meshes";
+    }
+
+    auto sceneResult = JsonSceneParser().parse(scenePath, meshDirectory);
+    if (!sceneResult) {
+        state.SkipWithError("Failed to load the benchmark scene");
+        return nullptr;
+    }
+
+    GuidingWorkload workload{};
+    workload.scene = sceneResult.extract();
+    const glm::ivec2 imageSize = workload.scene->getCamera()->getImageSize();
+    for (int32_t y = kPixelStride / 2; y < imageSize.y; y += kPixelStride) {
+        for (int32_t x = kPixelStride / 2; x < imageSize.x; x += kPixelStride) {
+            workload.pixels.emplace_back(x, y);
+        }
+    }
+
+    setIntegrator(*workload.scene, "mis-path-tracer");
+    workload.reference.assign(workload.pixels.size(), glm::vec3(0.0f));
+    renderPixels(*workload.scene, workload.pixels, kReferenceFirstSample, kReferenceSampleCount, workload.reference);
+    for (glm::vec3& value : workload.reference) {
+        value /= static_cast<float>(kReferenceSampleCount);
+    }
+
+    return &workloads.emplace(sceneName, std::move(workload)).first->second;
+}
+
+// Renders the whole image in passes of one sample per pixel until the time budget, which includes the integrator's
+// preprocessing, runs out, and reports the RMSE of the measured pixels against the reference. Comparing the counters
+// of two integrators on the same scene and budget gives their equal-time error ratio.
+void BM_EqualTimeError(benchmark::State& state, const std::string& sceneName, const std::string& integratorType) {
+    GuidingWorkload* workload = getWorkload(state, sceneName);
+    if (!workload) {
+        return;
+    }
+
+    pt::Scene& scene = *workload->scene;
+    const glm::ivec2 imageSize = scene.getCamera()->getImageSize();
+    std::vector<glm::ivec2> imagePixels;
+    for (int32_t y = 0; y < imageSize.y; ++y) {
+        for (int32_t x = 0; x < imageSize.x; ++x) {
+            imagePixels.emplace_back(x, y);
+        }
+    }
+
+    const std::chrono::duration<double> budget(static_cast<double>(state.range(0)));
+    double rmse = 0.0;
+    uint32_t sampleCount = 0;
+    for (auto _ : state) {
+        const auto start = std::chrono::steady_clock::now();
+        setIntegrator(scene, integratorType);
+
+        std::vector<glm::vec3> sums(imagePixels.size(), glm::vec3(0.0f));
+        sampleCount = 0;
+        while (std::chrono::steady_clock::now() - start < budget) {
+            renderPixels(scene, imagePixels, sampleCount, 1, sums);
+            ++sampleCount;
+        }
+
+        double squaredError = 0.0;
+        for (size_t i = 0; i < workload->pixels.size(); ++i) {
+            const glm::ivec2 pixel = workload->pixels[i];
+            const glm::vec3 mean =
+                sums[static_cast<size_t>(pixel.y) * imageSize.x + pixel.x] / static_cast<float>(sampleCount);
+            const glm::vec3 error = mean - workload->reference[i];
+            squaredError += (error.r * error.r + error.g * error.g + error.b * error.b) / 3.0f;
+        }
+        rmse = std::sqrt(squaredError / static_cast<double>(workload->pixels.size()));
+    }
+
+    state.counters["rmse"] = rmse;
+    state.counters["spp"] = sampleCount;
+}
+} // namespace
+
+BENCHMARK_CAPTURE( // NOLINT
+    BM_EqualTimeError, indirect_room_mis, std::string(kIndirectRoom), std::string("mis-path-tracer"))
+    ->Arg(kTimeBudgetSeconds)
+    ->Iterations(1)
+    ->Unit(benchmark::kSecond);
+BENCHMARK_CAPTURE( // NOLINT
+    BM_EqualTimeError, indirect_room_guided, std::string(kIndirectRoom), std::string("guided-path-tracer"))
+    ->Arg(kTimeBudgetSeconds)
+    ->Iterations(1)
+    ->Unit(benchmark::kSecond);
+BENCHMARK_CAPTURE(BM_EqualTimeError, cbox_mis, std::string(kCbox), std::string("mis-path-tracer")) // NOLINT
+    ->Arg(kTimeBudgetSeconds)
+    ->Iterations(1)
+    ->Unit(benchmark::kSecond);
+BENCHMARK_CAPTURE(BM_EqualTimeError, cbox_guided, std::string(kCbox), std::string("guided-path-tracer")) // NOLINT
+    ->Arg(kTimeBudgetSeconds)
+    ->Iterations(1)
+    ->Unit(benchmark::kSecond);
+BENCHMARK_CAPTURE( // NOLINT
+    BM_EqualTimeError, cbox_mats_mis, std::string(kCboxMaterials), std::string("mis-path-tracer"))
+    ->Arg(kTimeBudgetSeconds)
+    ->Iterations(1)
+    ->Unit(benchmark::kSecond);
+BENCHMARK_CAPTURE( // NOLINT
+    BM_EqualTimeError, cbox_mats_guided, std::string(kCboxMaterials), std::string("guided-path-tracer"))
+    ->Arg(kTimeBudgetSeconds)
+    ->Iterations(1)
+    ->Unit(benchmark::kSecond);
+
+} // namespace crisp
+
+BENCHMARK_MAIN(); // NOLINT
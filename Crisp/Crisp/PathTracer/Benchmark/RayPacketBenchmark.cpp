@@ -0,0 +1,236 @@
+#include <benchmark/benchmark.h>
+
+#include <Crisp/PathTracer/Cameras/Camera.hpp>
+#include <Crisp/PathTracer/Core/Intersection.hpp>
+#include <Crisp/PathTracer/Core/JsonSceneParser.hpp>
+#include <Crisp/PathTracer/Core/Scene.hpp>
+#include <Crisp/PathTracer/ExternalAssetConfig.hpp>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+
+namespace crisp {
+namespace {
+constexpr int32_t kTileSize = 64;
+
+constexpr const char* kProceduralScene = "procedural";
+constexpr int32_t kTerrainSize = 256;   // Quads per side of the height field.
+constexpr int32_t kSphereGridSize = 8;  // Spheres per side of the grid that stands on the terrain.
+constexpr int32_t kSphereSegments = 24; // Longitudinal segments of each sphere, with half as many rings.
+
+void writeSphere(std::ofstream& file, const glm::vec3& center, const float radius, int32_t& vertexCount) {
+    constexpr int32_t kRings = kSphereSegments / 2;
+    const int32_t first = vertexCount + 1;
+    for (int32_t ring = 0; ring <= kRings; ++ring) {
+        const float theta = std::numbers::pi_v<float> * static_cast<float>(ring) / kRings;
+        for (int32_t segment = 0; segment < kSphereSegments; ++segment) {
+            const float phi = 2.0f * std::numbers::pi_v<float> * static_cast<float>(segment) / kSphereSegments;
+            const glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            const glm::vec3 p = center + radius * normal;
+            file << "v " << p.x << ' ' << p.y << ' ' << p.z << '\n';
+        }
+    }
+    vertexCount += (kRings + 1) * kSphereSegments;
+
+    for (int32_t ring = 0; ring < kRings; ++ring) {
+        for (int32_t segment = 0; segment < kSphereSegments; ++segment) {
+            const int32_t i = first + ring * kSphereSegments + segment;
+            const int32_t j = first + ring * kSphereSegments + (segment + 1) % kSphereSegments;
+            file << "f " << i << ' ' << j << ' ' << j + kSphereSegments << '\n';
+            file << "f " << i << ' ' << j + kSphereSegments << ' ' << i + kSphereSegments << '\n';
+        }
+    }
+}
+
+// Writes a scene of a rolling height field with a grid of tessellated spheres on it, about 170k triangles, so that the
+// comparison runs without the external assets. The camera looks down at it from an angle, so that primary rays hit
+// both and shadow rays are partly occluded by the spheres.
+std::filesystem::path writeProceduralScene() {
+    const auto directory = std::filesystem::temp_directory_path() / "crisp-ray-packet-benchmark";
+    std::filesystem::create_directories(directory);
+
+    std::ofstream mesh(directory / "terrain.obj");
+    constexpr int32_t kVertexCount = kTerrainSize + 1;
+    constexpr float kExtent = 16.0f;
+    for (int32_t y = 0; y < kVertexCount; ++y) {
+        for (int32_t x = 0; x < kVertexCount; ++x) {
+            const float u = static_cast<float>(x) / kTerrainSize - 0.5f;
+            const float v = static_cast<float>(y) / kTerrainSize - 0.5f;
+            const float height = 0.3f * std::sin(12.0f * u) * std::cos(9.0f * v);
+            mesh << "v " << kExtent * u << ' ' << height << ' ' << kExtent * v << '\n';
+        }
+    }
+    for (int32_t y = 0; y < kTerrainSize; ++y) {
+        for (int32_t x = 0; x < kTerrainSize; ++x) {
+            const int32_t i = y * kVertexCount + x + 1;
+            const int32_t j = i + kVertexCount;
+            mesh << "f " << i << ' ' << j << ' ' << j + 1 << '\n';
+            mesh << "f " << i << ' ' << j + 1 << ' ' << i + 1 << '\n';
+        }
+    }
+
+    int32_t vertexCount = kVertexCount * kVertexCount;
+    for (int32_t y = 0; y < kSphereGridSize; ++y) {
+        for (int32_t x = 0; x < kSphereGridSize; ++x) {
+            const glm::vec3 center(1.5f * (x - 3.5f), 0.8f, 1.5f * (y - 3.5f));
+            writeSphere(mesh, center, 0.6f, vertexCount);
+        }
+    }
+
+    const auto scenePath = directory / "procedural.json";
+    std::ofstream(scenePath) << R"({
+    "camera": {
+        "type": "perspective",
+        "imageSize": [512, 512],
+        "fovY": 50.0,
+        "position": [0.0, 5.0, 9.0],
+        "target": [0.0, 0.0, 0.0],
+        "up": [0.0, 1.0, 0.0]
+    },
+    "shapes": [
+        {"type": "mesh", "filename": "terrain.obj"}
+    ],
+    "lights": [
+        {"type": "point", "position": [0.0, 6.0, 0.0]}
+    ]
+})";
+    return scenePath;
+}
+
+struct RayWorkload {
+    std::unique_ptr<pt::Scene> scene;
+    std::vector<Ray3> primaryRays;
+    std::vector<Ray3> shadowRays;
+    size_t tileRayCount{0};
+};
+
+// Generates one primary ray through every pixel center, tile by tile as the renderer does, and one shadow ray from
+// each primary hit towards the center of the scene bounds.
+RayWorkload createWorkload(benchmark::State& state, const std::string& sceneName) {
+    RayWorkload workload{};
+    std::filesystem::path scenePath;
+    std::filesystem::path meshDirectory;
+    if (sceneName == kProceduralScene) {
+        static const std::filesystem::path proceduralScenePath = writeProceduralScene();
+        scenePath = proceduralScenePath;
+        meshDirectory = scenePath.parent_path();
+    } else if (test::kExternalAssetDir.empty()) {
+        state.SkipWithError("Set CRISP_EXTERNAL_ASSET_DIR to the full Crisp Resources directory");
+        return workload;
+    } else {
+        scenePath = test::kExternalAssetDir / "VesperScenes" / sceneName;
+        meshDirectory = test::kExternalAssetDir / "Meshes";
+    }
+
+    auto sceneResult = JsonSceneParser().parse(scenePath, meshDirectory);
+    if (!sceneResult) {
+        state.SkipWithError("Failed to load the benchmark scene");
+        return workload;
+    }
+    workload.scene = sceneResult.extract();
+
+    const Camera& camera = *workload.scene->getCamera();
+    const glm::ivec2 imageSize = camera.getImageSize();
+    for (int32_t tileY = 0; tileY < imageSize.y; tileY += kTileSize) {
+        for (int32_t tileX = 0; tileX < imageSize.x; tileX += kTileSize) {
+            for (int32_t y = tileY; y < std::min(tileY + kTileSize, imageSize.y); ++y) {
+                for (int32_t x = tileX; x < std::min(tileX + kTileSize, imageSize.x); ++x) {
+                    Ray3 ray;
+                    camera.sampleRay(ray, glm::vec2(x + 0.5f, y + 0.5f), glm::vec2(0.5f));
+                    workload.primaryRays.push_back(ray);
+                }
+            }
+        }
+    }
+    workload.tileRayCount = static_cast<size_t>(kTileSize) * kTileSize;
+
+    const glm::vec3 target = workload.scene->getBoundingBox().getCenter();
+    for (const auto& ray : workload.primaryRays) {
+        Intersection its;
+        if (workload.scene->rayIntersect(ray, its)) {
+            const glm::vec3 toTarget = target - its.p;
+            const float distance = glm::length(toTarget);
+            workload.shadowRays.emplace_back(
+                its.p, toTarget / distance, Ray3::Epsilon, distance * (1.0f - Ray3::Epsilon));
+        }
+    }
+
+    return workload;
+}
+
+void BM_PrimarySingle(benchmark::State& state, const std::string& sceneName) {
+    const RayWorkload workload = createWorkload(state, sceneName);
+    if (!workload.scene) {
+        return;
+    }
+
+    Intersection its;
+    for (auto _ : state) {
+        for (const auto& ray : workload.primaryRays) {
+            benchmark::DoNotOptimize(workload.scene->rayIntersect(ray, its));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * workload.primaryRays.size()));
+}
+
+void BM_PrimaryPacket(benchmark::State& state, const std::string& sceneName) {
+    const RayWorkload workload = createWorkload(state, sceneName);
+    if (!workload.scene) {
+        return;
+    }
+
+    const std::span<const Ray3> rays(workload.primaryRays);
+    std::vector<Intersection> hits(workload.tileRayCount);
+    for (auto _ : state) {
+        for (size_t first = 0; first < rays.size(); first += workload.tileRayCount) {
+            const size_t count = std::min(workload.tileRayCount, rays.size() - first);
+            workload.scene->rayIntersect(rays.subspan(first, count), std::span<Intersection>(hits).first(count));
+            benchmark::DoNotOptimize(hits.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * workload.primaryRays.size()));
+}
+
+void BM_ShadowSingle(benchmark::State& state, const std::string& sceneName) {
+    const RayWorkload workload = createWorkload(state, sceneName);
+    if (!workload.scene) {
+        return;
+    }
+
+    for (auto _ : state) {
+        for (const auto& ray : workload.shadowRays) {
+            benchmark::DoNotOptimize(workload.scene->rayIntersect(ray));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * workload.shadowRays.size()));
+}
+
+void BM_ShadowPacket(benchmark::State& state, const std::string& sceneName) {
+    const RayWorkload workload = createWorkload(state, sceneName);
+    if (!workload.scene) {
+        return;
+    }
+
+    std::vector<uint8_t> occluded(workload.shadowRays.size());
+    for (auto _ : state) {
+        workload.scene->rayIntersect(workload.shadowRays, occluded);
+        benchmark::DoNotOptimize(occluded.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * workload.shadowRays.size()));
+}
+} // namespace
+
+BENCHMARK_CAPTURE(BM_PrimarySingle, procedural, std::string(kProceduralScene))->Unit(benchmark::kMillisecond); // NOLINT
+BENCHMARK_CAPTURE(BM_PrimaryPacket, procedural, std::string(kProceduralScene))->Unit(benchmark::kMillisecond); // NOLINT
+BENCHMARK_CAPTURE(BM_ShadowSingle, procedural, std::string(kProceduralScene))->Unit(benchmark::kMillisecond);  // NOLINT
+BENCHMARK_CAPTURE(BM_ShadowPacket, procedural, std::string(kProceduralScene))->Unit(benchmark::kMillisecond);  // NOLINT
+BENCHMARK_CAPTURE(BM_PrimarySingle, cbox, std::string("cbox-test-mis.json"))->Unit(benchmark::kMillisecond); // NOLINT
+BENCHMARK_CAPTURE(BM_PrimaryPacket, cbox, std::string("cbox-test-mis.json"))->Unit(benchmark::kMillisecond); // NOLINT
+BENCHMARK_CAPTURE(BM_ShadowSingle, cbox, std::string("cbox-test-mis.json"))->Unit(benchmark::kMillisecond);  // NOLINT
+BENCHMARK_CAPTURE(BM_ShadowPacket, cbox, std::string("cbox-test-mis.json"))->Unit(benchmark::kMillisecond);  // NOLINT
+
+} // namespace crisp
+
+BENCHMARK_MAIN(); // NOLINT
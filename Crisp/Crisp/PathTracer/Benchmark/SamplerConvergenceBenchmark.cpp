@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <Crisp/Math/Constants.hpp>
+#include <Crisp/PathTracer/Samplers/Halton.hpp>
+#include <Crisp/PathTracer/Samplers/Independent.hpp>
+#include <Crisp/PathTracer/Samplers/Sobol.hpp>
+#include <Crisp/PathTracer/Samplers/Stratified.hpp>
+
+namespace crisp {
+namespace {
+constexpr int32_t kImageSize = 32;
+constexpr int32_t kReferenceResolution = 256;
+
+// Radiance reaching the camera through pixelSample, as a function of a second 2D sample standing in for light or
+// BSDF sampling. A curved edge crosses the image and the shading term integrates to one over the second sample, so
+// the exact pixel value is the pixel's coverage-weighted edge term alone.
+float evalEdge(const glm::vec2& pixelSample) {
+    const float edgeY = 0.37f * pixelSample.x + 5.3f + 2.0f * std::sin(0.2f * pixelSample.x);
+    return pixelSample.y < edgeY ? 1.0f : 0.25f;
+}
+
+float evalIntegrand(const glm::vec2& pixelSample, const glm::vec2& secondary) {
+    const float shading = (1.5f * secondary.x * secondary.x + 0.5f) * (1.0f + 0.5f * std::cos(PI<> * secondary.y));
+    return evalEdge(pixelSample) * shading;
+}
+
+// Integrates the edge term of every pixel on a dense midpoint grid.
+const std::vector<double>& getReferenceImage() {
+    static const std::vector<double> reference = [] {
+        std::vector<double> image(static_cast<size_t>(kImageSize) * kImageSize);
+        for (int32_t y = 0; y < kImageSize; ++y) {
+            for (int32_t x = 0; x < kImageSize; ++x) {
+                double sum = 0.0;
+                for (int32_t j = 0; j < kReferenceResolution; ++j) {
+                    for (int32_t i = 0; i < kReferenceResolution; ++i) {
+                        const glm::vec2 offset =
+                            (glm::vec2(i, j) + 0.5f) / static_cast<float>(kReferenceResolution);
+                        sum += evalEdge(glm::vec2(x, y) + offset);
+                    }
+                }
+                image[static_cast<size_t>(y) * kImageSize + x] =
+                    sum / (static_cast<double>(kReferenceResolution) * kReferenceResolution);
+            }
+        }
+        return image;
+    }();
+    return reference;
+}
+
+// Renders the analytic image at the given sample count and reports its RMSE against the reference, so the sample
+// count sweep of each sampler traces its convergence rate.
+template <typename SamplerType>
+void BM_Convergence(benchmark::State& state) {
+    const std::vector<double>& reference = getReferenceImage();
+    const auto sampleCount = static_cast<uint32_t>(state.range(0));
+
+    VariantMap parameters;
+    parameters.insert("samplesPerPixel", static_cast<int>(sampleCount));
+    SamplerType sampler(parameters);
+
+    double rmse = 0.0;
+    for (auto _ : state) {
+        sampler.prepare();
+        double squaredError = 0.0;
+        for (int32_t y = 0; y < kImageSize; ++y) {
+            for (int32_t x = 0; x < kImageSize; ++x) {
+                double sum = 0.0;
+                for (uint32_t s = 0; s < sampleCount; ++s) {
+                    sampler.startPixelSample(glm::ivec2(x, y), s);
+                    const glm::vec2 pixelSample = glm::vec2(x, y) + sampler.next2D();
+                    sum += evalIntegrand(pixelSample, sampler.next2D());
+                }
+
+                const double error = sum / sampleCount - reference[static_cast<size_t>(y) * kImageSize + x];
+                squaredError += error * error;
+            }
+        }
+        rmse = std::sqrt(squaredError / (static_cast<double>(kImageSize) * kImageSize));
+        benchmark::DoNotOptimize(rmse);
+    }
+
+    state.counters["rmse"] = rmse;
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kImageSize * kImageSize * sampleCount));
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Convergence, IndependentSampler)->RangeMultiplier(4)->Range(4, 1024); // NOLINT
+BENCHMARK_TEMPLATE(BM_Convergence, StratifiedSampler)->RangeMultiplier(4)->Range(4, 1024);  // NOLINT
+BENCHMARK_TEMPLATE(BM_Convergence, HaltonSampler)->RangeMultiplier(4)->Range(4, 1024);      // NOLINT
+BENCHMARK_TEMPLATE(BM_Convergence, SobolSampler)->RangeMultiplier(4)->Range(4, 1024);       // NOLINT
+
+} // namespace crisp
+
+BENCHMARK_MAIN(); // NOLINT
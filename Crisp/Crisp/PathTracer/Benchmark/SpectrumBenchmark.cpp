@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <Crisp/PathTracer/Spectra/RgbSpectrum.hpp>
+#include <Crisp/PathTracer/Spectra/SampledSpectrum.hpp>
+#include <Crisp/PathTracer/Spectra/SimdRgbSpectrum.hpp>
+
+#include <random>
+#include <vector>
+
+namespace crisp {
+namespace {
+constexpr int32_t kPathCount = 4096;
+constexpr int32_t kBounceCount = 8;
+constexpr uint32_t kRrDepth = 3;
+
+// Per-vertex inputs of a path tracer, drawn once so that every backend multiplies the same values.
+struct BounceInputs {
+    std::vector<glm::vec3> reflectances;
+    std::vector<glm::vec3> emissions;
+    std::vector<float> weights; // cos / pdf
+    std::vector<float> roulette;
+};
+
+const BounceInputs& getInputs() {
+    static const BounceInputs inputs = [] {
+        BounceInputs result;
+        std::mt19937 engine(7);
+        std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+        for (int32_t i = 0; i < kPathCount * kBounceCount; ++i) {
+            result.reflectances.emplace_back(distribution(engine), distribution(engine), distribution(engine));
+            const float emission = distribution(engine) < 0.1f ? 10.0f : 0.0f;
+            result.emissions.emplace_back(emission, 0.8f * emission, 0.6f * emission);
+            result.weights.push_back(0.5f + distribution(engine));
+            result.roulette.push_back(distribution(engine));
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+// The arithmetic of the bounce loop of the path tracers: emission weighted by the throughput, the BSDF applied to the
+// throughput and Russian roulette on its largest coefficient. Materials and lights hand out RGB values, as the scene
+// stores them, so the spectral backend also pays for uplifting them to each path's wavelengths.
+template <typename SpectrumType>
+void BM_BounceArithmetic(benchmark::State& state) {
+    const BounceInputs& inputs = getInputs();
+    for (auto _ : state) {
+        for (int32_t path = 0; path < kPathCount; ++path) {
+            SpectrumType::beginSample(glm::ivec2(path, 0), 0);
+            SpectrumType radiance(0.0f);
+            SpectrumType throughput(1.0f);
+            for (int32_t bounce = 0; bounce < kBounceCount; ++bounce) {
+                const size_t vertex = static_cast<size_t>(path) * kBounceCount + bounce;
+                radiance += throughput * SpectrumType(inputs.emissions[vertex]);
+                throughput *= SpectrumType(inputs.reflectances[vertex]) * inputs.weights[vertex];
+                if (static_cast<uint32_t>(bounce) > kRrDepth) {
+                    const float q = 1.0f - std::min(throughput.maxCoeff(), 0.99f);
+                    if (inputs.roulette[vertex] < q) {
+                        break;
+                    }
+                    throughput /= 1.0f - q;
+                }
+            }
+            benchmark::DoNotOptimize(radiance.toRgb());
+        }
+        SpectrumType::endSample();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kPathCount);
+}
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_BounceArithmetic, RgbSpectrum);     // NOLINT
+BENCHMARK_TEMPLATE(BM_BounceArithmetic, SimdRgbSpectrum); // NOLINT
+BENCHMARK_TEMPLATE(BM_BounceArithmetic, SampledSpectrum); // NOLINT
+
+} // namespace crisp
+
+BENCHMARK_MAIN(); // NOLINT
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <Crisp/PathTracer/TileScheduler.hpp>
+
+#include <tbb/global_control.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace crisp {
+namespace {
+constexpr glm::ivec2 kImageSize(768, 512);
+constexpr int kBlockSize = 64;
+constexpr int kThreadCount = 8;
+
+// Seconds that a pixel takes to render. Most of the frame is cheap, but a caustic in the top left corner, where the
+// spiral ends, costs twenty times as much, as do the pixels of a refractive object near the center.
+struct CostImage {
+    std::vector<double> pixelCosts;
+
+    CostImage()
+        : pixelCosts(static_cast<size_t>(kImageSize.x) * kImageSize.y) {
+        constexpr double kBaseCost = 0.5e-3 / (kBlockSize * kBlockSize);
+        for (int y = 0; y < kImageSize.y; ++y) {
+            for (int x = 0; x < kImageSize.x; ++x) {
+                const glm::vec2 p(x, y);
+                const bool isCaustic = glm::distance(p, glm::vec2(96.0f, 96.0f)) < 120.0f;
+                const bool isGlass = glm::distance(p, glm::vec2(kImageSize) * 0.5f) < 48.0f;
+                pixelCosts[static_cast<size_t>(y) * kImageSize.x + x] = kBaseCost * (isCaustic || isGlass ? 20.0 : 1.0);
+            }
+        }
+    }
+
+    double getCost(const ImageBlock::Descriptor& desc) const {
+        double cost = 0.0;
+        for (int y = desc.offset.y; y < desc.offset.y + desc.size.y; ++y) {
+            for (int x = desc.offset.x; x < desc.offset.x + desc.size.x; ++x) {
+                cost += pixelCosts[static_cast<size_t>(y) * kImageSize.x + x];
+            }
+        }
+        return cost;
+    }
+};
+
+// Renders a frame whose tiles sleep for their cost, so that the threads need no cores while they "render", and reports
+// the core time that threads spent without a tile between the start of the frame and the end of its last tile. Cost
+// ordering uses the exact costs, as a previous frame of a still camera would provide.
+void BM_TileScheduling(benchmark::State& state, const bool costOrdered, const int minTileSize) {
+    // The machine may have fewer cores than the threads simulated here, which is fine since sleeping threads idle them.
+    const tbb::global_control threadLimit(tbb::global_control::max_allowed_parallelism, kThreadCount);
+    tbb::task_arena arena(kThreadCount);
+
+    const CostImage costImage;
+    const auto blocks = TileScheduler::createSpiralBlocks(kImageSize, kBlockSize);
+    std::vector<size_t> pendingBlocks(blocks.size());
+    std::iota(pendingBlocks.begin(), pendingBlocks.end(), 0);
+    std::vector<double> costs;
+    if (costOrdered) {
+        for (const auto& block : blocks) {
+            costs.push_back(costImage.getCost(block));
+        }
+    }
+
+    TileScheduler scheduler;
+    double idleSeconds = 0.0;
+    double tileCount = 0.0;
+    for (auto _ : state) {
+        scheduler.reset(blocks, pendingBlocks, costs, kThreadCount, minTileSize);
+        std::atomic<int64_t> busyNanoseconds = 0;
+        std::atomic<int> tiles = 0;
+        const auto frameStart = std::chrono::steady_clock::now();
+        arena.execute([&] {
+            tbb::parallel_for(0, kThreadCount, [&](int /*task*/) {
+                while (const auto tile = scheduler.pop()) {
+                    const auto tileStart = std::chrono::steady_clock::now();
+                    std::this_thread::sleep_for(std::chrono::duration<double>(costImage.getCost(tile->desc)));
+                    busyNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::steady_clock::now() - tileStart)
+                                           .count();
+                    scheduler.finish(*tile);
+                    ++tiles;
+                }
+            });
+        });
+        const std::chrono::duration<double> frameTime = std::chrono::steady_clock::now() - frameStart;
+        const double frameSeconds = frameTime.count();
+        idleSeconds += kThreadCount * frameSeconds - static_cast<double>(busyNanoseconds) * 1e-9;
+        tileCount += tiles;
+    }
+
+    state.counters["idleCoreSeconds"] = benchmark::Counter(idleSeconds, benchmark::Counter::kAvgIterations);
+    state.counters["tiles"] = benchmark::Counter(tileCount, benchmark::Counter::kAvgIterations);
+}
+} // namespace
+
+BENCHMARK_CAPTURE(BM_TileScheduling, Spiral, false, 0)->UseRealTime();           // NOLINT
+BENCHMARK_CAPTURE(BM_TileScheduling, SpiralSplit, false, 16)->UseRealTime();      // NOLINT
+BENCHMARK_CAPTURE(BM_TileScheduling, CostOrdered, true, 0)->UseRealTime();       // NOLINT
+BENCHMARK_CAPTURE(BM_TileScheduling, CostOrderedSplit, true, 16)->UseRealTime(); // NOLINT
+
+} // namespace crisp
+
+BENCHMARK_MAIN(); // NOLINT
@@ -8,4 +8,10 @@ glm::ivec2 Camera::getImageSize() const {
 const ReconstructionFilter* Camera::getReconstructionFilter() const {
     return m_filter.get();
 }
+
+void Camera::approximateDpDxy(
+    const glm::vec3& /*p*/, const glm::vec3& /*n*/, glm::vec3& dpdx, glm::vec3& dpdy) const {
+    dpdx = glm::vec3(0.0f);
+    dpdy = glm::vec3(0.0f);
+}
 } // namespace crisp
\ No newline at end of file
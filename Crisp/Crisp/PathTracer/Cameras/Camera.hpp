@@ -13,6 +13,11 @@ public:
     virtual ~Camera() = default;
     virtual Spectrum sampleRay(Ray3& ray, const glm::vec2& samplePosition, const glm::vec2& apertureSample) const = 0;
 
+    // Approximates how far point p on a surface with normal n moves when the camera ray that sees it shifts by one
+    // pixel, by intersecting the ray differentials of a pixel with the tangent plane at p. The same footprint is used
+    // for hits after any number of bounces, as if the point were seen directly. Zero if the camera has no footprint.
+    virtual void approximateDpDxy(const glm::vec3& p, const glm::vec3& n, glm::vec3& dpdx, glm::vec3& dpdy) const;
+
     glm::ivec2 getImageSize() const;
     const ReconstructionFilter* getReconstructionFilter() const;
 
@@ -2,7 +2,7 @@
 
 #include <Crisp/Math/Operations.hpp>
 
-#include <Crisp/PathTracer/ReconstructionFilters/GaussianFilter.hpp>
+#include <Crisp/PathTracer/ReconstructionFilters/ReconstructionFilterFactory.hpp>
 
 namespace crisp {
 PerspectiveCamera::PerspectiveCamera(const VariantMap& params) {
@@ -18,7 +18,8 @@ PerspectiveCamera::PerspectiveCamera(const VariantMap& params) {
     auto position = params.get<glm::vec3>("position", {0, 0, 5});
     auto target = params.get<glm::vec3>("target", {0, 0, 0});
     auto up = params.get<glm::vec3>("up", {0, 1, 0});
-    m_cameraToWorld = Transform(glm::lookAt(position, target, up)).invert();
+    m_worldToCamera = Transform(glm::lookAt(position, target, up));
+    m_cameraToWorld = m_worldToCamera.invert();
 
     float aspect = m_imageSize.x / static_cast<float>(m_imageSize.y);
 
@@ -30,9 +31,14 @@ PerspectiveCamera::PerspectiveCamera(const VariantMap& params) {
 
     m_sampleToCamera = unprojection * mirror * screenShift * ndcScale;
 
-    if (!m_filter) {
-        m_filter = std::make_unique<GaussianFilter>();
-    }
+    m_filter = ReconstructionFilterFactory::create(params.get<std::string>("filter", "gaussian"));
+
+    const auto getDirection = [this](const glm::vec2& pixel) {
+        return glm::normalize(m_sampleToCamera.transformPoint(glm::vec3(pixel * m_invImageSize, 0.0f)));
+    };
+    const glm::vec2 center = glm::vec2(m_imageSize) * 0.5f;
+    m_dirDifferentialX = getDirection(center + glm::vec2(1.0f, 0.0f)) - getDirection(center);
+    m_dirDifferentialY = getDirection(center + glm::vec2(0.0f, 1.0f)) - getDirection(center);
 }
 
 Spectrum PerspectiveCamera::sampleRay(Ray3& ray, const glm::vec2& posSample, const glm::vec2& /*apertureSample*/) const {
@@ -48,4 +54,25 @@ Spectrum PerspectiveCamera::sampleRay(Ray3& ray, const glm::vec2& posSample, con
 
     return Spectrum(1.0f);
 }
+
+void PerspectiveCamera::approximateDpDxy(
+    const glm::vec3& p, const glm::vec3& n, glm::vec3& dpdx, glm::vec3& dpdy) const {
+    const glm::vec3 pCamera = m_worldToCamera.transformPoint(p);
+    const glm::vec3 nCamera = m_worldToCamera.transformNormal(n);
+    const glm::vec3 dir = glm::normalize(pCamera);
+    const float planeDistance = glm::dot(nCamera, pCamera);
+
+    // Offset rays leave from the camera origin, so each one meets the tangent plane at t = planeDistance / cos.
+    const auto intersectTangentPlane = [&](const glm::vec3& offset) {
+        const glm::vec3 offsetDir = glm::normalize(dir + offset);
+        const float cosTheta = glm::dot(nCamera, offsetDir);
+        if (std::abs(cosTheta) < 1e-6f) {
+            return glm::vec3(0.0f);
+        }
+        // transformDir() normalizes, while the offset must keep its length.
+        return glm::vec3(m_cameraToWorld.mat * glm::vec4(offsetDir * (planeDistance / cosTheta) - pCamera, 0.0f));
+    };
+    dpdx = intersectTangentPlane(m_dirDifferentialX);
+    dpdy = intersectTangentPlane(m_dirDifferentialY);
+}
 } // namespace crisp
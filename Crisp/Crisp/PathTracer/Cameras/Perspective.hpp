@@ -9,6 +9,8 @@ public:
     PerspectiveCamera(const VariantMap& params = VariantMap());
 
     virtual Spectrum sampleRay(Ray3& ray, const glm::vec2& posSample, const glm::vec2& apertureSample) const;
+    virtual void approximateDpDxy(
+        const glm::vec3& p, const glm::vec3& n, glm::vec3& dpdx, glm::vec3& dpdy) const override;
 
 private:
     glm::vec2 m_invImageSize;
@@ -19,5 +21,10 @@ private:
 
     Transform m_sampleToCamera;
     Transform m_cameraToWorld;
+    Transform m_worldToCamera;
+
+    // Change of the normalized camera-space ray direction across one pixel at the center of the image.
+    glm::vec3 m_dirDifferentialX;
+    glm::vec3 m_dirDifferentialY;
 };
 } // namespace crisp
@@ -0,0 +1,297 @@
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <tbb/global_control.h>
+
+#include <Crisp/Core/CommandLineParser.hpp>
+#include <Crisp/Core/Logger.hpp>
+#include <Crisp/Core/Timer.hpp>
+#include <Crisp/Image/Io/Exr.hpp>
+#include <Crisp/PathTracer/RayTracer.hpp>
+
+namespace crisp {
+namespace {
+CRISP_MAKE_LOGGER_MT("PathTracerCli");
+
+volatile std::sig_atomic_t gStopRequested = 0;
+
+void requestStop(int /*signal*/) {
+    gStopRequested = 1;
+}
+
+struct CliOptions {
+    std::filesystem::path scenePath;
+    std::filesystem::path resourceDir;
+    std::filesystem::path meshCacheDir;
+    std::filesystem::path textureCacheDir;
+    std::filesystem::path outputPath;
+    std::filesystem::path sampleCountOutputPath;
+    std::filesystem::path renderTimeOutputPath;
+    std::filesystem::path denoisedOutputPath;
+    std::filesystem::path albedoOutputPath;
+    std::filesystem::path normalOutputPath;
+    std::filesystem::path depthOutputPath;
+    std::filesystem::path statisticsOutputPath;
+    int32_t threadCount{0};
+    bool layeredOutput{false};
+    bool halfFloat{false};
+    std::string exrCompression{"zip"};
+    ExrWriteOptions exr{.flipAxis = FlipAxis::Y};
+    ProgressiveRenderSettings progressive{};
+    AdaptiveSamplingSettings adaptive{};
+    DenoiserSettings denoiser{};
+    CheckpointSettings checkpoint{};
+    std::string distributedRole{"local"};
+    DistributedRenderSettings distributed{};
+    TileSchedulingSettings tileScheduling{};
+};
+
+Result<DistributedRenderSettings::Role> parseDistributedRole(const std::string_view role) {
+    if (role == "local") {
+        return DistributedRenderSettings::Role::Local;
+    }
+    if (role == "coordinator") {
+        return DistributedRenderSettings::Role::Coordinator;
+    }
+    if (role == "worker") {
+        return DistributedRenderSettings::Role::Worker;
+    }
+    return resultError("Unknown distributed role {}", role);
+}
+
+Result<CliOptions> parseOptions(const int32_t argc, char** argv) {
+    CliOptions options{};
+
+    CommandLineParser parser;
+    parser.addOption("scene", options.scenePath, true);
+    parser.addOption("resources", options.resourceDir);
+    parser.addOption("mesh_cache", options.meshCacheDir);
+    parser.addOption("texture_cache", options.textureCacheDir);
+    parser.addOption("output", options.outputPath);
+    parser.addOption("threads", options.threadCount);
+    parser.addOption("progressive", options.progressive.enabled);
+    parser.addOption("samples_per_pass", options.progressive.samplesPerPass);
+    parser.addOption("target_spp", options.progressive.targetSamplesPerPixel);
+    parser.addOption("time_budget", options.progressive.timeBudget);
+    parser.addOption("convergence_threshold", options.progressive.convergenceThreshold);
+    parser.addOption("adaptive", options.adaptive.enabled);
+    parser.addOption("min_spp", options.adaptive.minSamplesPerPixel);
+    parser.addOption("max_spp", options.adaptive.maxSamplesPerPixel);
+    parser.addOption("adaptive_threshold", options.adaptive.errorThreshold);
+    parser.addOption("sample_count_output", options.sampleCountOutputPath);
+    parser.addOption("render_time_output", options.renderTimeOutputPath);
+    parser.addOption("cost_ordered_tiles", options.tileScheduling.costOrdered);
+    parser.addOption("prepass_stride", options.tileScheduling.prepassStride);
+    parser.addOption("min_tile_size", options.tileScheduling.minTileSize);
+    parser.addOption("denoise", options.denoiser.enabled);
+    parser.addOption("denoise_iterations", options.denoiser.iterations);
+    parser.addOption("denoised_output", options.denoisedOutputPath);
+    parser.addOption("albedo_output", options.albedoOutputPath);
+    parser.addOption("normal_output", options.normalOutputPath);
+    parser.addOption("depth_output", options.depthOutputPath);
+    parser.addOption("stats_output", options.statisticsOutputPath);
+    parser.addOption("aovs", options.layeredOutput);
+    parser.addOption("half", options.halfFloat);
+    parser.addOption("exr_compression", options.exrCompression);
+    parser.addOption("exr_tile_size", options.exr.tileSize);
+    parser.addOption("exr_multipart", options.exr.multiPart);
+    parser.addOption("checkpoint", options.checkpoint.path);
+    parser.addOption("checkpoint_interval", options.checkpoint.interval);
+    parser.addOption("resume", options.checkpoint.resume);
+    parser.addOption("distributed", options.distributedRole);
+    parser.addOption("host", options.distributed.host);
+    parser.addOption("port", options.distributed.port);
+    parser.addOption("bind", options.distributed.bindAddress);
+    parser.addOption("render_locally", options.distributed.renderLocally);
+    parser.addOption("worker_connections", options.distributed.workerConnections);
+    parser.addOption("worker_timeout", options.distributed.workerTimeout);
+    CRISP_TRY(parser.parse(argc, argv));
+    CRISP_TRY(options.exr.compression, parseExrCompression(options.exrCompression));
+    CRISP_TRY(options.distributed.role, parseDistributedRole(options.distributedRole));
+
+    // Scene files reference meshes relative to <resources>/Meshes; by default the scene is assumed to live in a
+    // subfolder of the resource directory, as the VesperScenes do.
+    if (options.resourceDir.empty()) {
+        options.resourceDir = options.scenePath.parent_path().parent_path();
+    }
+    if (options.outputPath.empty()) {
+        options.outputPath = options.scenePath.filename().replace_extension(".exr");
+    }
+    if (options.denoiser.enabled && options.denoisedOutputPath.empty()) {
+        options.denoisedOutputPath = options.outputPath;
+        options.denoisedOutputPath.replace_filename(options.outputPath.stem().string() + "_denoised.exr");
+    }
+
+    return options;
+}
+
+// Optional outputs are skipped when no path was given.
+Result<> writeImage(
+    const std::filesystem::path& path,
+    const std::vector<float>& data,
+    const glm::ivec2& imageSize,
+    const CliOptions& options) {
+    if (path.empty()) {
+        return kResultSuccess;
+    }
+
+    const std::array<ExrLayer, 1> layers = {ExrLayer{
+        .channelNames = {"R", "G", "B", "A"},
+        .pixelData = data,
+        .pixelType = options.halfFloat ? ExrPixelType::Half : ExrPixelType::Float,
+    }};
+    return saveExr(path, layers, static_cast<uint32_t>(imageSize.x), static_cast<uint32_t>(imageSize.y), options.exr);
+}
+
+Result<> renderScene(const CliOptions& options) {
+    std::unique_ptr<tbb::global_control> threadLimit;
+    if (options.threadCount > 0) {
+        threadLimit = std::make_unique<tbb::global_control>(
+            tbb::global_control::max_allowed_parallelism, static_cast<size_t>(options.threadCount));
+    }
+
+    RayTracer rayTracer;
+    CRISP_TRY(rayTracer.initializeScene(
+        options.scenePath, options.resourceDir, options.meshCacheDir, options.textureCacheDir));
+    rayTracer.setProgressiveSettings(options.progressive);
+    rayTracer.setAdaptiveSettings(options.adaptive);
+    rayTracer.setDenoiserSettings(options.denoiser);
+    rayTracer.setCheckpointSettings(options.checkpoint);
+    rayTracer.setDistributedSettings(options.distributed);
+    rayTracer.setTileSchedulingSettings(options.tileScheduling);
+
+    int32_t lastReportedPercent = 0;
+    rayTracer.setProgressUpdater([&lastReportedPercent](RayTracerUpdate&& update) {
+        // Invoked under the ray tracer's image lock, so the counter needs no further synchronization.
+        const int32_t percent = 100 * update.pixelsRendered / update.numPixels;
+        if (percent >= lastReportedPercent + 10) {
+            lastReportedPercent = percent;
+            CRISP_LOGI(
+                "Rendered {}% at {} spp ({:.2f} s of render time).",
+                percent,
+                update.samplesPerPixel,
+                update.totalTimeSpentRendering);
+        }
+    });
+
+    const glm::ivec2 imageSize = rayTracer.getImageSize();
+    CRISP_LOGI("Rendering {} at {}x{}.", options.scenePath.string(), imageSize.x, imageSize.y);
+    rayTracer.start();
+    if (!options.checkpoint.path.empty()) {
+        // Interrupted renders save a final checkpoint and still write their partial image.
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+        while (rayTracer.isRendering()) {
+            if (gStopRequested) {
+                rayTracer.stop();
+                CRISP_LOGI("Render stopped, continue it with --resume=true.");
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+    rayTracer.waitForCompletion();
+
+    // Workers hand their blocks to the coordinator, which writes the image.
+    if (options.distributed.role == DistributedRenderSettings::Role::Worker) {
+        const RayTracerStatistics stats = rayTracer.getStatistics();
+        CRISP_LOGI("Rendered {} samples with {} rays for the coordinator.", stats.samplesTaken, stats.raysTraced);
+        return kResultSuccess;
+    }
+
+    if (const auto outputDir = options.outputPath.parent_path(); !outputDir.empty()) {
+        std::filesystem::create_directories(outputDir);
+    }
+
+    const Timer<std::chrono::duration<double>> writeTimer;
+    if (options.layeredOutput) {
+        const ExrPixelType colorPixelType = options.halfFloat ? ExrPixelType::Half : ExrPixelType::Float;
+        CRISP_TRY(rayTracer.writeLayeredExr(options.outputPath, colorPixelType, options.exr));
+    } else {
+        CRISP_TRY(writeImage(options.outputPath, rayTracer.getImageData(), imageSize, options));
+    }
+    CRISP_TRY(writeImage(options.sampleCountOutputPath, rayTracer.getSampleCountData(), imageSize, options));
+    CRISP_TRY(writeImage(options.renderTimeOutputPath, rayTracer.getRenderTimeData(), imageSize, options));
+    CRISP_TRY(writeImage(options.denoisedOutputPath, rayTracer.getDenoisedImageData(), imageSize, options));
+    const FeatureImages features = rayTracer.getFeatureData();
+    CRISP_TRY(writeImage(options.albedoOutputPath, features.albedo, imageSize, options));
+    CRISP_TRY(writeImage(options.normalOutputPath, features.normal, imageSize, options));
+    CRISP_TRY(writeImage(options.depthOutputPath, features.depth, imageSize, options));
+    if (!options.statisticsOutputPath.empty()) {
+        CRISP_TRY(rayTracer.writeStatisticsReport(options.statisticsOutputPath));
+    }
+    const double writeTime = writeTimer.getElapsedTime();
+
+    const RayTracerStatistics stats = rayTracer.getStatistics();
+    CRISP_LOGI("Wrote {}.", options.outputPath.string());
+    CRISP_LOGI("Scene parse:      {:>10.3f} s", stats.sceneParseTime);
+    CRISP_LOGI("BVH commit:       {:>10.3f} s", stats.accelerationBuildTime);
+    CRISP_LOGI("Preprocess:       {:>10.3f} s", stats.preprocessTime);
+    CRISP_LOGI("Render:           {:>10.3f} s", stats.renderTime);
+    if (options.denoiser.enabled) {
+        CRISP_LOGI("Denoise:          {:>10.3f} s", stats.denoiseTime);
+    }
+    CRISP_LOGI("EXR write:        {:>10.3f} s", writeTime);
+    CRISP_LOGI("Samples:          {:>10}", stats.samplesTaken);
+    CRISP_LOGI("Rays:             {:>10}", stats.raysTraced);
+    if (stats.tileSplits > 0) {
+        CRISP_LOGI("Tile splits:      {:>10}", stats.tileSplits);
+    }
+    constexpr double kBytesToMiB = 1.0 / (1024.0 * 1024.0);
+    CRISP_LOGI(
+        "Shape memory:     {:>10.2f} MiB in {} shapes",
+        static_cast<double>(stats.shapeMemory) * kBytesToMiB,
+        stats.shapeCount);
+    CRISP_LOGI("BVH memory:       {:>10.2f} MiB", static_cast<double>(stats.accelerationMemory) * kBytesToMiB);
+    CRISP_LOGI("BVH peak memory:  {:>10.2f} MiB", static_cast<double>(stats.peakAccelerationMemory) * kBytesToMiB);
+    if (stats.textureTileMisses > 0) {
+        CRISP_LOGI(
+            "Texture tiles:    {:>10} hits, {} misses, {} evictions",
+            stats.textureTileHits,
+            stats.textureTileMisses,
+            stats.textureTileEvictions);
+        CRISP_LOGI("Texture peak mem: {:>10.2f} MiB", static_cast<double>(stats.peakTextureMemory) * kBytesToMiB);
+    }
+    if (stats.renderTime > 0.0) {
+        const double megaRaysPerSecond = static_cast<double>(stats.raysTraced) / stats.renderTime * 1e-6;
+        CRISP_LOGI("Throughput:       {:>10.3f} Mrays/s", megaRaysPerSecond);
+    }
+
+    return kResultSuccess;
+}
+} // namespace
+} // namespace crisp
+
+int main(int argc, char** argv) {
+    auto options = crisp::parseOptions(argc, argv);
+    if (!options) {
+        spdlog::error(
+            "Usage: {} --scene=<scene.json> [--resources=<dir>] [--mesh_cache=<dir>] [--texture_cache=<dir>] "
+            "[--output=<image.exr>] [--threads=<count>] "
+            "[--progressive=<bool>] [--samples_per_pass=<count>] [--target_spp=<count>] [--time_budget=<seconds>] "
+            "[--convergence_threshold=<error>] [--adaptive=<bool>] [--min_spp=<count>] [--max_spp=<count>] "
+            "[--adaptive_threshold=<error>] [--sample_count_output=<image.exr>] [--render_time_output=<image.exr>] "
+            "[--cost_ordered_tiles=<bool>] [--prepass_stride=<pixels>] [--min_tile_size=<pixels>] [--denoise=<bool>] "
+            "[--denoise_iterations=<count>] [--denoised_output=<image.exr>] [--albedo_output=<image.exr>] "
+            "[--normal_output=<image.exr>] [--depth_output=<image.exr>] [--stats_output=<report.json>] "
+            "[--aovs=<bool>] [--half=<bool>] "
+            "[--exr_compression=<none|rle|zips|zip|piz|pxr24|b44|b44a|dwaa|dwab>] [--exr_tile_size=<pixels>] "
+            "[--exr_multipart=<bool>] [--checkpoint=<file>] [--checkpoint_interval=<seconds>] [--resume=<bool>] "
+            "[--distributed=<local|coordinator|worker>] [--host=<address>] [--port=<port>] [--bind=<address>] "
+            "[--render_locally=<bool>] [--worker_connections=<count>] [--worker_timeout=<seconds>]",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!crisp::renderScene(*options).isValid()) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
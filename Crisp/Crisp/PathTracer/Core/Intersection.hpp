@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+
 #include <Crisp/Math/CoordinateFrame.hpp>
 #include <Crisp/Math/Headers.hpp>
 
@@ -14,6 +16,14 @@ struct Intersection {
     CoordinateFrame shFrame;  // Shading frame, formed by interpolated normal
     CoordinateFrame geoFrame; // Geometric frame, formed from surface orientation
 
+    // Partial derivatives of the position with respect to the UV coordinates; zero if the shape has none.
+    glm::vec3 dpdu{0.0f};
+    glm::vec3 dpdv{0.0f};
+
+    // Change of the UV coordinates across one pixel of the camera image, used to filter texture lookups.
+    glm::vec2 dUVdx{0.0f};
+    glm::vec2 dUVdy{0.0f};
+
     const Shape* shape; // Pointer to the underlying shape
 
     Intersection()
@@ -26,5 +36,28 @@ struct Intersection {
     inline glm::vec3 toWorld(const glm::vec3& dir) const {
         return shFrame.toWorld(dir);
     }
+
+    // Projects the position differentials of a pixel footprint onto the UV parameterization, in the least squares
+    // sense since dpdx and dpdy need not lie exactly in the plane spanned by dpdu and dpdv.
+    inline void computeUVDifferentials(const glm::vec3& dpdx, const glm::vec3& dpdy) {
+        const float ata00 = glm::dot(dpdu, dpdu);
+        const float ata01 = glm::dot(dpdu, dpdv);
+        const float ata11 = glm::dot(dpdv, dpdv);
+        const float det = ata00 * ata11 - ata01 * ata01;
+        if (!(std::abs(det) > 1e-12f)) {
+            dUVdx = dUVdy = glm::vec2(0.0f);
+            return;
+        }
+
+        const float invDet = 1.0f / det;
+        const auto solve = [&](const glm::vec3& dp) {
+            const float atb0 = glm::dot(dpdu, dp);
+            const float atb1 = glm::dot(dpdv, dp);
+            const glm::vec2 duv((ata11 * atb0 - ata01 * atb1) * invDet, (ata00 * atb1 - ata01 * atb0) * invDet);
+            return glm::clamp(duv, glm::vec2(-1e8f), glm::vec2(1e8f));
+        };
+        dUVdx = solve(dpdx);
+        dUVdy = solve(dpdy);
+    }
 };
 } // namespace crisp
@@ -7,17 +7,24 @@
 #include <Crisp/PathTracer/Core/Scene.hpp>
 #include <Crisp/PathTracer/Core/VariantMap.hpp>
 #include <Crisp/PathTracer/Integrators/IntegratorFactory.hpp>
+#include <Crisp/PathTracer/LightSamplers/LightSamplerFactory.hpp>
 #include <Crisp/PathTracer/Lights/LightFactory.hpp>
 #include <Crisp/PathTracer/Samplers/SamplerFactory.hpp>
+#include <Crisp/PathTracer/Shapes/Instance.hpp>
 #include <Crisp/PathTracer/Shapes/ShapeFactory.hpp>
 #include <Crisp/PathTracer/Textures/TextureFactory.hpp>
 
+#include <tbb/task_group.h>
+
 #include <algorithm>
 #include <array>
+#include <map>
 #include <span>
 #include <stdexcept>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace crisp {
 namespace {
@@ -46,8 +53,13 @@ constexpr std::array<std::string_view, 0> kNoNestedFields{};
 constexpr std::array kAmbientOcclusionParameters{
     ParameterSpec{"maxDistance", ParameterType::Float},
 };
+constexpr std::array kPathTracerParameters{
+    ParameterSpec{"maxDepth", ParameterType::Integer},
+    ParameterSpec{"rrDepth", ParameterType::Integer},
+};
 constexpr std::array kSamplerParameters{
     ParameterSpec{"samplesPerPixel", ParameterType::Integer},
+    ParameterSpec{"seed", ParameterType::Integer},
 };
 constexpr std::array kCameraParameters{
     ParameterSpec{"imageSize", ParameterType::IVec2},
@@ -58,11 +70,16 @@ constexpr std::array kCameraParameters{
     ParameterSpec{"target", ParameterType::Vec3},
     ParameterSpec{"up", ParameterType::Vec3},
     ParameterSpec{"mirrorHorizontally", ParameterType::Boolean},
+    ParameterSpec{"filter", ParameterType::String},
 };
 constexpr std::array kMeshParameters{
     ParameterSpec{"filename", ParameterType::String},
     ParameterSpec{"toWorld", ParameterType::Transform},
 };
+constexpr std::array kInstanceParameters{
+    ParameterSpec{"prototype", ParameterType::String},
+    ParameterSpec{"toWorld", ParameterType::Transform},
+};
 constexpr std::array kSphereParameters{
     ParameterSpec{"center", ParameterType::Vec3},
     ParameterSpec{"radius", ParameterType::Float},
@@ -114,7 +131,21 @@ constexpr std::array kEnvironmentLightParameters{
     ParameterSpec{"filename", ParameterType::String},
     ParameterSpec{"radianceScale", ParameterType::Float},
 };
+constexpr std::array kImageTextureParameters{
+    ParameterSpec{"filename", ParameterType::String},
+    ParameterSpec{"filter", ParameterType::String},
+    ParameterSpec{"wrap", ParameterType::String},
+    ParameterSpec{"linear", ParameterType::Boolean},
+};
+constexpr std::array kTextureCacheParameters{
+    ParameterSpec{"budgetMB", ParameterType::Float},
+    ParameterSpec{"directory", ParameterType::String},
+};
+constexpr std::array kMeshCacheParameters{
+    ParameterSpec{"directory", ParameterType::String},
+};
 constexpr std::array<std::string_view, 3> kShapeNestedFields{"bsdf", "bssrdf", "light"};
+constexpr std::array<std::string_view, 1> kInstanceNestedFields{"bsdf"};
 constexpr std::array<std::string_view, 1> kReflectanceTextureNestedFields{"reflectanceTexture"};
 
 const Json* findChild(const Json& node, const std::string_view name) {
@@ -260,6 +291,9 @@ std::span<const ParameterSpec> getParameterSpecs(const std::string_view type) {
         if (type == "ambient-occlusion") {
             return kAmbientOcclusionParameters;
         }
+        if (type == "mis-path-tracer" || type == "wavefront-path-tracer") {
+            return kPathTracerParameters;
+        }
         return kNoParameters;
     } else if constexpr (std::is_same_v<Type, Sampler>) {
         return kSamplerParameters;
@@ -324,8 +358,14 @@ std::span<const std::string_view> getNestedFields(const std::string_view type) {
     }
 }
 
+// Mesh files are resolved against the mesh directory, and cached only if a cache directory is given.
+struct MeshContext {
+    std::filesystem::path directory;
+    std::filesystem::path cacheDirectory;
+};
+
 template <typename Type, typename FactoryType>
-std::unique_ptr<Type> create(const Json* node, const std::filesystem::path& meshDirectory = {}) {
+std::unique_ptr<Type> create(const Json* node, const MeshContext& meshes = {}) {
     std::string type = "default";
     VariantMap params;
     if (node != nullptr) {
@@ -337,16 +377,25 @@ std::unique_ptr<Type> create(const Json* node, const std::filesystem::path& mesh
         if (params.contains("filename")) {
             std::filesystem::path meshPath{params.get<std::string>("filename")};
             if (meshPath.is_relative()) {
-                meshPath = meshDirectory / meshPath;
+                meshPath = meshes.directory / meshPath;
             }
             params.insert("filename", meshPath.string());
+            if (!meshes.cacheDirectory.empty()) {
+                params.insert("cacheDirectory", meshes.cacheDirectory.string());
+            }
         }
     }
     return FactoryType::create(type, params);
 }
 
+// Image textures share the scene's texture cache and resolve relative file names against the scene file directory.
+struct TextureContext {
+    std::shared_ptr<TextureCache> cache;
+    std::filesystem::path directory;
+};
+
 template <typename DataType>
-std::unique_ptr<Texture<DataType>> createTexture(const Json& node) {
+std::unique_ptr<Texture<DataType>> createTexture(const Json& node, const TextureContext& textures) {
     const std::string type = node.value("type", std::string("default"));
     constexpr auto valueType = std::is_same_v<DataType, Spectrum> ? ParameterType::Spectrum : ParameterType::Float;
     const std::array checkerboardParameters{
@@ -359,30 +408,196 @@ std::unique_ptr<Texture<DataType>> createTexture(const Json& node) {
 
     const std::span<const ParameterSpec> specs =
         type.starts_with("checkerboard") ? std::span<const ParameterSpec>(checkerboardParameters)
-        : type.starts_with("constant")
-            ? std::span<const ParameterSpec>(constantParameters)
-            : std::span<const ParameterSpec>(kNoParameters);
+        : type.starts_with("constant")   ? std::span<const ParameterSpec>(constantParameters)
+        : type.starts_with("image")      ? std::span<const ParameterSpec>(kImageTextureParameters)
+                                         : std::span<const ParameterSpec>(kNoParameters);
     VariantMap params;
     parseParameters(params, node, specs);
-    return TextureFactory::create<DataType>(type, params);
+    if (params.contains("filename")) {
+        std::filesystem::path imagePath{params.get<std::string>("filename")};
+        if (imagePath.is_relative()) {
+            imagePath = textures.directory / imagePath;
+        }
+        params.insert("filename", imagePath.string());
+    }
+    return TextureFactory::create<DataType>(type, params, textures.cache);
 }
 
 void validateSceneRoot(const Json& sceneNode) {
-    static constexpr std::array<std::string_view, 5> kSceneFields{"integrator", "sampler", "camera", "shapes", "lights"};
+    static constexpr std::array<std::string_view, 9> kSceneFields{
+        "integrator", "sampler", "camera", "lightSampler", "textureCache", "meshCache", "prototypes", "shapes",
+        "lights"};
     require(sceneNode.is_object(), "Scene JSON root must be an object");
     for (const auto& [name, value] : sceneNode.items()) {
         require(contains(kSceneFields, name), "Unknown scene field '" + name + "'");
-        if (name == "shapes" || name == "lights") {
+        if (name == "prototypes" || name == "shapes" || name == "lights") {
             require(value.is_array(), "Scene field '" + name + "' must be an array");
         } else {
             require(value.is_object(), "Scene field '" + name + "' must be an object");
         }
     }
 }
+using PrototypeMap = std::map<std::string, const ShapePrototype*, std::less<>>;
+using ShapeMap = std::unordered_map<const Json*, std::unique_ptr<Shape>>;
+
+void collectShapeNodes(const Json& shapes, std::vector<const Json*>& shapeNodes) {
+    for (const auto& shapeNode : shapes) {
+        if (shapeNode.is_object() && shapeNode.value("type", std::string("default")) != "instance") {
+            shapeNodes.push_back(&shapeNode);
+        }
+    }
+}
+
+// Creates the shapes of the scene and of its prototypes ahead of assembling them, all at once, since loading their
+// meshes takes most of the time spent parsing large scenes. The first exception thrown by any of them is rethrown.
+ShapeMap createShapes(const Json& document, const MeshContext& meshes) {
+    std::vector<const Json*> shapeNodes;
+    if (const auto* prototypeNodes = findChild(document, "prototypes")) {
+        for (const auto& prototypeNode : *prototypeNodes) {
+            const Json* shapes = prototypeNode.is_object() ? findChild(prototypeNode, "shapes") : nullptr;
+            if (shapes != nullptr && shapes->is_array()) {
+                collectShapeNodes(*shapes, shapeNodes);
+            }
+        }
+    }
+    if (const auto* shapes = findChild(document, "shapes")) {
+        collectShapeNodes(*shapes, shapeNodes);
+    }
+
+    std::vector<std::unique_ptr<Shape>> shapes(shapeNodes.size());
+    tbb::task_group tasks;
+    for (size_t i = 0; i < shapeNodes.size(); ++i) {
+        tasks.run([&shapes, &shapeNodes, &meshes, i] {
+            shapes[i] = create<Shape, ShapeFactory>(shapeNodes[i], meshes);
+        });
+    }
+    tasks.wait();
+
+    ShapeMap shapeMap;
+    for (size_t i = 0; i < shapeNodes.size(); ++i) {
+        shapeMap.emplace(shapeNodes[i], std::move(shapes[i]));
+    }
+    return shapeMap;
+}
+
+std::unique_ptr<BSDF> createShapeBsdf(const Json* bsdfNode, const TextureContext& textures) {
+    auto bsdf = create<BSDF, BSDFFactory>(bsdfNode);
+    if (bsdfNode != nullptr) {
+        if (const auto* texture = findChild(*bsdfNode, "reflectanceTexture")) {
+            bsdf->setTexture(createTexture<Spectrum>(*texture, textures));
+        }
+    }
+    return bsdf;
+}
+
+std::unique_ptr<Instance> createInstance(const Json& instanceNode, const PrototypeMap& prototypes) {
+    VariantMap params;
+    parseParameters(params, instanceNode, kInstanceParameters, kInstanceNestedFields);
+    require(params.contains("prototype"), "Instance requires a 'prototype' field");
+
+    const auto iter = prototypes.find(params.get<std::string>("prototype"));
+    require(iter != prototypes.end(), "Unknown prototype '" + params.get<std::string>("prototype") + "'");
+    require(
+        iter->second->getInstanceDepth() <= RTC_MAX_INSTANCE_LEVEL_COUNT,
+        "Prototype '" + iter->first + "' is nested deeper than the supported instance level count");
+    return std::make_unique<Instance>(params, iter->second);
+}
+
+// Adds the shapes to the prototype if one is given, or to the scene otherwise. Prototype shapes live in local space
+// and are shared by all instances, so they cannot be emitters or carry subsurface scattering.
+void addShapes(
+    const Json& shapes,
+    pt::Scene& scene,
+    ShapePrototype* prototype,
+    const PrototypeMap& prototypes,
+    ShapeMap& createdShapes,
+    const TextureContext& textures) {
+    for (const auto& shapeNode : shapes) {
+        if (shapeNode.value("type", std::string("default")) == "instance") {
+            // The instance BSDF is optional and overrides the prototype BSDFs only when present.
+            std::unique_ptr<BSDF> bsdf;
+            if (const auto* bsdfNode = findChild(shapeNode, "bsdf")) {
+                bsdf = createShapeBsdf(bsdfNode, textures);
+            }
+
+            auto instance = createInstance(shapeNode, prototypes);
+            if (prototype) {
+                prototype->addShape(std::move(instance), bsdf.get());
+            } else {
+                scene.addShape(std::move(instance), bsdf.get());
+            }
+            if (bsdf) {
+                scene.addBSDF(std::move(bsdf));
+            }
+            continue;
+        }
+
+        std::unique_ptr<Light> light;
+        if (const auto* lightNode = findChild(shapeNode, "light")) {
+            require(prototype == nullptr, "Prototype shapes cannot have a light");
+            light = create<Light, LightFactory>(lightNode);
+        }
+
+        std::unique_ptr<BSSRDF> bssrdf;
+        if (const auto* bssrdfNode = findChild(shapeNode, "bssrdf")) {
+            require(prototype == nullptr, "Prototype shapes cannot have a BSSRDF");
+            bssrdf = create<BSSRDF, BSSRDFFactory>(bssrdfNode);
+        }
+
+        auto bsdf = createShapeBsdf(findChild(shapeNode, "bsdf"), textures);
+
+        auto shape = std::move(createdShapes.at(&shapeNode));
+        shape->setBSSRDF(std::move(bssrdf));
+        if (prototype) {
+            prototype->addShape(std::move(shape), bsdf.get());
+        } else {
+            scene.addShape(std::move(shape), bsdf.get(), light.get());
+        }
+
+        if (light) {
+            scene.addLight(std::move(light));
+        }
+        scene.addBSDF(std::move(bsdf));
+    }
+}
+
+void addPrototypes(
+    const Json& prototypeNodes,
+    pt::Scene& scene,
+    PrototypeMap& prototypes,
+    ShapeMap& createdShapes,
+    const TextureContext& textures) {
+    static constexpr std::array<std::string_view, 2> kPrototypeFields{"name", "shapes"};
+    for (const auto& prototypeNode : prototypeNodes) {
+        require(prototypeNode.is_object(), "Prototype must be a JSON object");
+        for (const auto& [name, value] : prototypeNode.items()) {
+            require(contains(kPrototypeFields, name), "Unknown prototype field '" + name + "'");
+        }
+        const Json* nameNode = findChild(prototypeNode, "name");
+        const Json* shapes = findChild(prototypeNode, "shapes");
+        require(nameNode != nullptr && nameNode->is_string(), "Prototype requires a string 'name'");
+        require(shapes != nullptr && shapes->is_array(), "Prototype requires a 'shapes' array");
+
+        const auto name = nameNode->get<std::string>();
+        require(!prototypes.contains(name), "Duplicate prototype '" + name + "'");
+
+        // Prototypes may only instance those defined before them, which rules out cycles and ensures that every
+        // instanced Embree scene is committed before it is referenced.
+        ShapePrototype* prototype = scene.createPrototype();
+        addShapes(*shapes, scene, prototype, prototypes, createdShapes, textures);
+        prototype->commit();
+        prototypes.emplace(name, prototype);
+    }
+}
 } // namespace
 
 Result<std::unique_ptr<pt::Scene>> JsonSceneParser::parse(
-    const std::filesystem::path& sceneFilePath, const std::filesystem::path& meshDirectory) {
+    const std::filesystem::path& sceneFilePath,
+    const std::filesystem::path& meshDirectory,
+    const std::filesystem::path& meshCacheDirectory,
+    const std::filesystem::path& textureCacheDirectory) {
+    // Scene values are kept in RGB, whichever sample this thread was tracing before.
+    Spectrum::endSample();
     try {
         CRISP_TRY(
             auto document,
@@ -396,36 +611,37 @@ Result<std::unique_ptr<pt::Scene>> JsonSceneParser::parse(
         scene->setIntegrator(create<Integrator, IntegratorFactory>(findChild(document, "integrator")));
         scene->setSampler(create<Sampler, SamplerFactory>(findChild(document, "sampler")));
         scene->setCamera(create<Camera, CameraFactory>(findChild(document, "camera")));
+        if (const auto* lightSamplerNode = findChild(document, "lightSampler")) {
+            scene->setLightSampler(create<LightSampler, LightSamplerFactory>(lightSamplerNode));
+        }
 
-        if (const auto* shapes = findChild(document, "shapes")) {
-            for (const auto& shapeNode : *shapes) {
-                std::unique_ptr<Light> light;
-                if (const auto* lightNode = findChild(shapeNode, "light")) {
-                    light = create<Light, LightFactory>(lightNode);
-                }
-
-                std::unique_ptr<BSSRDF> bssrdf;
-                if (const auto* bssrdfNode = findChild(shapeNode, "bssrdf")) {
-                    bssrdf = create<BSSRDF, BSSRDFFactory>(bssrdfNode);
-                }
-
-                const Json* bsdfNode = findChild(shapeNode, "bsdf");
-                auto bsdf = create<BSDF, BSDFFactory>(bsdfNode);
-                if (bsdfNode != nullptr) {
-                    if (const auto* texture = findChild(*bsdfNode, "reflectanceTexture")) {
-                        bsdf->setTexture(createTexture<Spectrum>(*texture));
-                    }
-                }
+        VariantMap textureCacheParams;
+        if (const auto* textureCacheNode = findChild(document, "textureCache")) {
+            parseParameters(textureCacheParams, *textureCacheNode, kTextureCacheParameters);
+        }
+        if (!textureCacheDirectory.empty()) {
+            textureCacheParams.insert("directory", textureCacheDirectory.string());
+        }
+        scene->setTextureCache(std::make_shared<TextureCache>(textureCacheParams));
+        const TextureContext textures{scene->getTextureCache(), sceneFilePath.parent_path()};
+
+        MeshContext meshes{.directory = meshDirectory, .cacheDirectory = meshCacheDirectory};
+        if (const auto* meshCacheNode = findChild(document, "meshCache")) {
+            VariantMap meshCacheParams;
+            parseParameters(meshCacheParams, *meshCacheNode, kMeshCacheParameters);
+            if (meshes.cacheDirectory.empty()) {
+                meshes.cacheDirectory = meshCacheParams.get<std::string>("directory");
+            }
+        }
+        ShapeMap createdShapes = createShapes(document, meshes);
 
-                auto shape = create<Shape, ShapeFactory>(&shapeNode, meshDirectory);
-                shape->setBSSRDF(std::move(bssrdf));
-                scene->addShape(std::move(shape), bsdf.get(), light.get());
+        PrototypeMap prototypes;
+        if (const auto* prototypeNodes = findChild(document, "prototypes")) {
+            addPrototypes(*prototypeNodes, *scene, prototypes, createdShapes, textures);
+        }
 
-                if (light) {
-                    scene->addLight(std::move(light));
-                }
-                scene->addBSDF(std::move(bsdf));
-            }
+        if (const auto* shapes = findChild(document, "shapes")) {
+            addShapes(*shapes, *scene, nullptr, prototypes, createdShapes, textures);
         }
 
         if (const auto* lights = findChild(document, "lights")) {
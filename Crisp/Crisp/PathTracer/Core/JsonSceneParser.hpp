@@ -12,7 +12,13 @@ class Scene;
 
 class JsonSceneParser {
 public:
+    // Meshes are cached in meshCacheDirectory if it is given, or else in the directory of the scene's meshCache
+    // entry. They are not cached when neither names one. Texture pyramids are cached the same way, in
+    // textureCacheDirectory or the directory of the scene's textureCache entry, and built in memory otherwise.
     Result<std::unique_ptr<pt::Scene>> parse(
-        const std::filesystem::path& sceneFilePath, const std::filesystem::path& meshDirectory);
+        const std::filesystem::path& sceneFilePath,
+        const std::filesystem::path& meshDirectory,
+        const std::filesystem::path& meshCacheDirectory = {},
+        const std::filesystem::path& textureCacheDirectory = {});
 };
 } // namespace crisp
@@ -15,9 +15,8 @@ MipMap::MipMap(std::filesystem::path filePath) {
     for (uint32_t i = 0; i < exr.height; ++i) {
         for (uint32_t j = 0; i < exr.width; ++j) {
             const uint32_t idx = i * exr.width + j;
-            m_texels[idx].r = exr.pixelData[3 * idx + 0];
-            m_texels[idx].g = exr.pixelData[3 * idx + 1];
-            m_texels[idx].b = exr.pixelData[3 * idx + 2];
+            m_texels[idx] = Spectrum(
+                exr.pixelData[3 * idx + 0], exr.pixelData[3 * idx + 1], exr.pixelData[3 * idx + 2]);
         }
     }
 
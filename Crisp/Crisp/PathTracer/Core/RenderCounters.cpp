@@ -0,0 +1,172 @@
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace crisp {
+namespace {
+enum Slot : size_t {
+    PrimaryRays,
+    IntersectionRays,
+    ShadowRays,
+    RouletteTerminations,
+    InvalidSamples,
+    BsdfSamples,
+    PathLengths = BsdfSamples + RenderCounters::kLobeCount,
+    StageNanoseconds = PathLengths + RenderCounters::kPathLengthBinCount,
+    SlotCount = StageNanoseconds + RenderCounters::kStageCount,
+};
+
+// Aligned to keep the counters of different threads on different cache lines.
+struct alignas(64) ThreadCounters {
+    std::array<std::atomic<uint64_t>, SlotCount> slots{};
+
+    // Other threads only ever read the slots, so a relaxed load and store cannot lose an increment.
+    void add(const size_t slot, const uint64_t value) {
+        slots[slot].store(slots[slot].load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    uint64_t get(const size_t slot) const {
+        return slots[slot].load(std::memory_order_relaxed);
+    }
+};
+
+// Owns the counters of every thread that has recorded, including threads that have since exited.
+struct ThreadCounterRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadCounters>> threads;
+};
+
+ThreadCounterRegistry& getRegistry() {
+    static ThreadCounterRegistry registry;
+    return registry;
+}
+
+ThreadCounters& getThreadCounters() {
+    thread_local ThreadCounters* counters = [] {
+        ThreadCounterRegistry& registry = getRegistry();
+        std::lock_guard lock(registry.mutex);
+        return registry.threads.emplace_back(std::make_unique<ThreadCounters>()).get();
+    }();
+    return *counters;
+}
+} // namespace
+
+uint64_t RenderCounters::getRayCount() const {
+    return primaryRays + extensionRays + shadowRays;
+}
+
+uint64_t RenderCounters::getPathCount() const {
+    uint64_t count = 0;
+    for (const uint64_t binCount : pathLengths) {
+        count += binCount;
+    }
+    return count;
+}
+
+double RenderCounters::getMeanPathLength() const {
+    const uint64_t pathCount = getPathCount();
+    if (pathCount == 0) {
+        return 0.0;
+    }
+
+    double lengthSum = 0.0;
+    for (size_t i = 0; i < kPathLengthBinCount; ++i) {
+        lengthSum += static_cast<double>(i) * static_cast<double>(pathLengths[i]);
+    }
+    return lengthSum / static_cast<double>(pathCount);
+}
+
+RenderCounters RenderCounters::operator-(const RenderCounters& other) const {
+    RenderCounters result = *this;
+    result.primaryRays -= other.primaryRays;
+    result.extensionRays -= other.extensionRays;
+    result.shadowRays -= other.shadowRays;
+    for (size_t i = 0; i < kLobeCount; ++i) {
+        result.bsdfSamples[i] -= other.bsdfSamples[i];
+    }
+    for (size_t i = 0; i < kPathLengthBinCount; ++i) {
+        result.pathLengths[i] -= other.pathLengths[i];
+    }
+    result.russianRouletteTerminations -= other.russianRouletteTerminations;
+    result.invalidSamples -= other.invalidSamples;
+    for (size_t i = 0; i < kStageCount; ++i) {
+        result.stageSeconds[i] -= other.stageSeconds[i];
+    }
+    return result;
+}
+
+void RenderCounters::addPrimaryRays(const uint64_t count) {
+    getThreadCounters().add(PrimaryRays, count);
+}
+
+void RenderCounters::addIntersectionRays(const uint64_t count) {
+    getThreadCounters().add(IntersectionRays, count);
+}
+
+void RenderCounters::addShadowRays(const uint64_t count) {
+    getThreadCounters().add(ShadowRays, count);
+}
+
+void RenderCounters::addBsdfSample(const uint32_t lobe) {
+    const auto lobeIndex = static_cast<size_t>(std::countr_zero(lobe));
+    getThreadCounters().add(BsdfSamples + std::min(lobeIndex, kLobeCount - 1), 1);
+}
+
+void RenderCounters::addPath(const uint32_t bounces, const bool terminatedByRoulette) {
+    ThreadCounters& counters = getThreadCounters();
+    counters.add(PathLengths + std::min<size_t>(bounces, kPathLengthBinCount - 1), 1);
+    if (terminatedByRoulette) {
+        counters.add(RouletteTerminations, 1);
+    }
+}
+
+void RenderCounters::addInvalidSample() {
+    getThreadCounters().add(InvalidSamples, 1);
+}
+
+void RenderCounters::addStageTime(const RenderStage stage, const std::chrono::steady_clock::duration time) {
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+    getThreadCounters().add(StageNanoseconds + static_cast<size_t>(stage), static_cast<uint64_t>(nanoseconds));
+}
+
+uint64_t RenderCounters::getThreadRayCount() {
+    const ThreadCounters& counters = getThreadCounters();
+    return counters.get(IntersectionRays) + counters.get(ShadowRays);
+}
+
+RenderCounters RenderCounters::collect() {
+    std::array<uint64_t, SlotCount> totals{};
+    {
+        ThreadCounterRegistry& registry = getRegistry();
+        std::lock_guard lock(registry.mutex);
+        for (const auto& counters : registry.threads) {
+            for (size_t slot = 0; slot < SlotCount; ++slot) {
+                totals[slot] += counters->get(slot);
+            }
+        }
+    }
+
+    RenderCounters result;
+    result.primaryRays = totals[PrimaryRays];
+    // Camera rays are traced through the same queries as every other closest-hit ray.
+    result.extensionRays = totals[IntersectionRays] - std::min(totals[PrimaryRays], totals[IntersectionRays]);
+    result.shadowRays = totals[ShadowRays];
+    for (size_t i = 0; i < kLobeCount; ++i) {
+        result.bsdfSamples[i] = totals[BsdfSamples + i];
+    }
+    for (size_t i = 0; i < kPathLengthBinCount; ++i) {
+        result.pathLengths[i] = totals[PathLengths + i];
+    }
+    result.russianRouletteTerminations = totals[RouletteTerminations];
+    result.invalidSamples = totals[InvalidSamples];
+    for (size_t i = 0; i < kStageCount; ++i) {
+        result.stageSeconds[i] = static_cast<double>(totals[StageNanoseconds + i]) * 1e-9;
+    }
+    return result;
+}
+} // namespace crisp
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace crisp {
+// Parts of rendering the samples of a block that are timed separately. The stages after Accumulation are reported by
+// wavefront integrators, and their time is also part of Integration.
+enum class RenderStage : uint32_t {
+    CameraRays,   // Camera samples and ray generation.
+    PrimaryRays,  // Tracing the camera rays in packets.
+    Integration,  // The integrator, given the primary hits.
+    Accumulation, // Adding the estimates to the block.
+    Shading,      // Emission, next-event and BSDF sampling, and Russian roulette.
+    ShadowRays,
+    MisRays,
+    ExtensionRays,
+    Count,
+};
+
+// Ray, path and timing counters of the path tracer. Every thread records into counters of its own that only it writes,
+// so recording takes no locks and no atomic read-modify-write operations. collect() sums the counters of all threads
+// that recorded anything since the process started; the difference of two results covers the work in between.
+struct RenderCounters {
+    static constexpr size_t kLobeCount = 4;           // In the bit order of Lobe: passthrough, diffuse, glossy, delta.
+    static constexpr size_t kPathLengthBinCount = 17; // Paths of 0 to 15 bounces, the last bin holds longer ones.
+    static constexpr size_t kStageCount = static_cast<size_t>(RenderStage::Count);
+
+    uint64_t primaryRays{0};
+    uint64_t extensionRays{0}; // Closest-hit rays other than camera rays, including the BSDF rays of MIS.
+    uint64_t shadowRays{0};
+    std::array<uint64_t, kLobeCount> bsdfSamples{}; // BSDF samples that continue a path, by the lobe they chose.
+    std::array<uint64_t, kPathLengthBinCount> pathLengths{};
+    uint64_t russianRouletteTerminations{0};
+    uint64_t invalidSamples{0}; // Negative, NaN or infinite estimates rejected by ImageBlock::addSample.
+    std::array<double, kStageCount> stageSeconds{};
+
+    uint64_t getRayCount() const;
+    uint64_t getPathCount() const;
+    // Paths in the last histogram bin count with its lower bound.
+    double getMeanPathLength() const;
+
+    RenderCounters operator-(const RenderCounters& other) const;
+
+    static void addPrimaryRays(uint64_t count);
+    // Counts closest-hit rays, camera rays included.
+    static void addIntersectionRays(uint64_t count);
+    static void addShadowRays(uint64_t count);
+    // Records a valid BSDF sample, one that continues the path, by the single Lobe bit of its sampled lobe.
+    static void addBsdfSample(uint32_t lobe);
+    // Records a path that ended after the given number of bounces.
+    static void addPath(uint32_t bounces, bool terminatedByRoulette);
+    static void addInvalidSample();
+    static void addStageTime(RenderStage stage, std::chrono::steady_clock::duration time);
+
+    // Rays traced by the calling thread over its lifetime.
+    static uint64_t getThreadRayCount();
+
+    static RenderCounters collect();
+};
+
+// Adds the time from its construction to its destruction to a render stage.
+class ScopedRenderStage {
+public:
+    explicit ScopedRenderStage(const RenderStage stage)
+        : m_stage(stage)
+        , m_start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedRenderStage() {
+        RenderCounters::addStageTime(m_stage, std::chrono::steady_clock::now() - m_start);
+    }
+
+    ScopedRenderStage(const ScopedRenderStage&) = delete;
+    ScopedRenderStage& operator=(const ScopedRenderStage&) = delete;
+
+private:
+    RenderStage m_stage;
+    std::chrono::steady_clock::time_point m_start;
+};
+} // namespace crisp
@@ -3,16 +3,23 @@
 #include <Crisp/PathTracer/BSDFs/BSDF.hpp>
 #include <Crisp/PathTracer/Cameras/Perspective.hpp>
 #include <Crisp/PathTracer/Core/Intersection.hpp>
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
 #include <Crisp/PathTracer/Core/Scene.hpp>
 #include <Crisp/PathTracer/Integrators/Normals.hpp>
+#include <Crisp/PathTracer/LightSamplers/PowerLightSampler.hpp>
 #include <Crisp/PathTracer/Lights/Light.hpp>
 #include <Crisp/PathTracer/Lights/PointLight.hpp>
 #include <Crisp/PathTracer/Samplers/Independent.hpp>
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
+#include <Crisp/PathTracer/Shapes/Instance.hpp>
 #include <Crisp/PathTracer/Shapes/Mesh.hpp>
 #include <Crisp/PathTracer/Shapes/Shape.hpp>
+#include <Crisp/PathTracer/Textures/TextureCache.hpp>
 
 #include <Crisp/Core/Logger.hpp>
+#include <Crisp/Core/Timer.hpp>
+
+#include <array>
 
 namespace crisp {
 namespace {
@@ -21,23 +28,42 @@ auto logger = spdlog::stderr_color_mt("pt::Scene");
 void logEmbreeError(void*, RTCError code, const char* str) {
     CRISP_LOGE("Error code {} - {}", static_cast<uint32_t>(code), str);
 }
+
+template <typename RayPacket>
+void setPacketRay(RayPacket& packet, const size_t lane, const Ray3& ray) {
+    packet.org_x[lane] = ray.o.x;
+    packet.org_y[lane] = ray.o.y;
+    packet.org_z[lane] = ray.o.z;
+    packet.dir_x[lane] = ray.d.x;
+    packet.dir_y[lane] = ray.d.y;
+    packet.dir_z[lane] = ray.d.z;
+    packet.tnear[lane] = ray.minT;
+    packet.tfar[lane] = ray.maxT;
+    packet.mask[lane] = 0xFFFFFFFF;
+    packet.time[lane] = ray.time;
+    packet.flags[lane] = 0;
+}
 } // namespace
 
 namespace pt {
 Scene::Scene()
     : m_device(rtcNewDevice(nullptr))
-    , m_scene(rtcNewScene(m_device))
+    , m_scene(nullptr)
     , m_sampler(nullptr)
     , m_integrator(nullptr)
     , m_camera(nullptr)
     , m_envLight(nullptr)
     , m_imageSize{}
-    , m_boundingSphere{} {
+    , m_boundingSphere{}
+    , m_accelerationBuildTime(0.0) {
     rtcSetDeviceErrorFunction(m_device, logEmbreeError, this);
+    rtcSetDeviceMemoryMonitorFunction(m_device, &Scene::monitorEmbreeMemory, this);
+    m_scene = rtcNewScene(m_device);
 
     m_integrator = std::make_unique<NormalsIntegrator>();
     m_sampler = std::make_unique<IndependentSampler>();
     m_camera = std::make_unique<PerspectiveCamera>();
+    m_lightSampler = std::make_unique<PowerLightSampler>();
 
     m_imageSize = m_camera->getImageSize();
 }
@@ -74,6 +100,10 @@ void Scene::addShape(std::unique_ptr<Shape> shape, BSDF* bsdf, Light* light) {
     }
 }
 
+ShapePrototype* Scene::createPrototype() {
+    return m_prototypes.emplace_back(std::make_unique<ShapePrototype>(m_device)).get();
+}
+
 void Scene::addLight(std::unique_ptr<Light> light) {
     m_lights.emplace_back(std::move(light));
 }
@@ -87,15 +117,34 @@ void Scene::addBSDF(std::unique_ptr<BSDF> bsdf) {
     m_bsdfs.emplace_back(std::move(bsdf));
 }
 
+void Scene::setLightSampler(std::unique_ptr<LightSampler> lightSampler) {
+    m_lightSampler = std::move(lightSampler);
+}
+
+void Scene::setTextureCache(std::shared_ptr<TextureCache> textureCache) {
+    m_textureCache = std::move(textureCache);
+}
+
+const std::shared_ptr<TextureCache>& Scene::getTextureCache() const {
+    return m_textureCache;
+}
+
 void Scene::finishInitialization() {
     auto center = m_boundingBox.getCenter();
     auto radius = m_boundingBox.radius();
     m_boundingSphere = glm::vec4(center, radius);
-    if (m_envLight) {
-        m_envLight->setBoundingSphere(m_boundingSphere);
+
+    std::vector<Light*> lights;
+    lights.reserve(m_lights.size());
+    for (const auto& light : m_lights) {
+        light->setBoundingSphere(m_boundingSphere);
+        lights.push_back(light.get());
     }
+    m_lightSampler->build(lights);
 
+    const Timer<std::chrono::duration<double>> buildTimer;
     rtcCommitScene(m_scene);
+    m_accelerationBuildTime = buildTimer.getElapsedTime();
 
     int err = rtcGetDeviceError(m_device);
     if (err != RTC_ERROR_NONE) {
@@ -103,6 +152,38 @@ void Scene::finishInitialization() {
     }
 }
 
+double Scene::getAccelerationBuildTime() const {
+    return m_accelerationBuildTime;
+}
+
+SceneMemoryUsage Scene::getMemoryUsage() const {
+    SceneMemoryUsage usage{};
+    usage.shapeCount = m_shapes.size();
+    for (const auto& shape : m_shapes) {
+        usage.shapeBytes += shape->getMemoryUsage();
+    }
+    for (const auto& prototype : m_prototypes) {
+        usage.shapeBytes += prototype->getMemoryUsage();
+    }
+    usage.accelerationBytes = static_cast<size_t>(std::max<int64_t>(m_embreeMemory.load(), 0));
+    usage.peakAccelerationBytes = static_cast<size_t>(std::max<int64_t>(m_embreePeakMemory.load(), 0));
+    return usage;
+}
+
+bool Scene::monitorEmbreeMemory(void* userPtr, const ssize_t bytes, const bool /*post*/) {
+    // Embree reports allocations with a positive and deallocations with a negative byte count.
+    auto* scene = static_cast<Scene*>(userPtr);
+    const int64_t current = scene->m_embreeMemory.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = scene->m_embreePeakMemory.load(std::memory_order_relaxed);
+    while (current > peak && !scene->m_embreePeakMemory.compare_exchange_weak(peak, current)) {
+    }
+    return true;
+}
+
+uint64_t Scene::getThreadRayCount() {
+    return RenderCounters::getThreadRayCount();
+}
+
 const Sampler* Scene::getSampler() const {
     return m_sampler.get();
 }
@@ -119,26 +200,21 @@ std::vector<std::unique_ptr<Shape>>& Scene::getShapes() {
     return m_shapes;
 }
 
-Light* Scene::getRandomLight(float sample) const {
-    const auto numLights = m_lights.size();
-    if (numLights == 0) {
-        return nullptr;
-    }
-
-    const auto index = std::min(static_cast<size_t>(std::floor(static_cast<float>(numLights) * sample)), numLights - 1);
-    return m_lights[index].get();
+Light* Scene::pickLight(const glm::vec3& p, const glm::vec3& n, const float sample, float& pmf) const {
+    return m_lightSampler->sample(p, n, sample, pmf);
 }
 
-float Scene::getLightPdf() const {
-    return 1.0f / static_cast<float>(m_lights.size());
+float Scene::getLightPickPmf(const glm::vec3& p, const glm::vec3& n, const Light* light) const {
+    return m_lightSampler->pmf(p, n, light);
 }
 
 Light* Scene::getEnvironmentLight() const {
     return m_envLight;
 }
 
-Spectrum Scene::sampleLight(const Intersection& /*its*/, Sampler& sampler, Light::Sample& lightSample) const {
-    auto light = getRandomLight(sampler.next1D());
+Spectrum Scene::sampleLight(const Intersection& its, Sampler& sampler, Light::Sample& lightSample) const {
+    float pickPmf = 0.0f;
+    auto light = pickLight(its.p, its.shFrame.n, sampler.next1D(), pickPmf);
     if (!light) {
         return {0.0f};
     }
@@ -149,8 +225,8 @@ Spectrum Scene::sampleLight(const Intersection& /*its*/, Sampler& sampler, Light
         return {0.0f};
     }
 
-    lightContrib /= getLightPdf();
-    lightSample.pdf *= getLightPdf();
+    lightContrib /= pickPmf;
+    lightSample.pdf *= pickPmf;
     lightSample.light = light;
     return lightContrib;
 }
@@ -176,15 +252,17 @@ bool Scene::rayIntersect(const Ray3& ray, Intersection& its) const {
     rayHit.ray.flags = 0;
 
     rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+    rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
 
     rtcIntersect1(m_scene, &rayHit);
+    RenderCounters::addIntersectionRays(1);
 
     if (rayHit.hit.geomID != RTC_INVALID_GEOMETRY_ID) {
         its.tHit = rayHit.ray.tfar;
         its.uv.x = rayHit.hit.u;
         its.uv.y = rayHit.hit.v;
 
-        m_shapes[rayHit.hit.geomID]->fillIntersection(rayHit.hit.primID, ray, its);
+        fillIntersection(ray, rayHit.hit.instID, rayHit.hit.geomID, rayHit.hit.primID, its);
 
         return true;
     }
@@ -206,9 +284,90 @@ bool Scene::rayIntersect(const Ray3& shadowRay) const {
     rtcRay.time = shadowRay.time;
 
     rtcOccluded1(m_scene, &rtcRay);
+    RenderCounters::addShadowRays(1);
     return rtcRay.tfar < 0.0f;
 }
 
+void Scene::rayIntersect(const std::span<const Ray3> rays, const std::span<Intersection> its) const {
+    static_assert(kRayPacketSize == 8, "Packet tracing is implemented with rtcIntersect8.");
+    for (size_t first = 0; first < rays.size(); first += kRayPacketSize) {
+        const size_t laneCount = std::min(kRayPacketSize, rays.size() - first);
+
+        alignas(32) int32_t valid[kRayPacketSize]; // NOLINT
+        RTCRayHit8 packet;                         // NOLINT
+        for (size_t lane = 0; lane < kRayPacketSize; ++lane) {
+            valid[lane] = lane < laneCount ? -1 : 0;
+            if (lane < laneCount) {
+                setPacketRay(packet.ray, lane, rays[first + lane]);
+            }
+            packet.hit.geomID[lane] = RTC_INVALID_GEOMETRY_ID;
+            packet.hit.instID[0][lane] = RTC_INVALID_GEOMETRY_ID;
+        }
+
+        rtcIntersect8(valid, m_scene, &packet);
+
+        for (size_t lane = 0; lane < laneCount; ++lane) {
+            Intersection& hit = its[first + lane];
+            hit.shape = nullptr;
+            if (packet.hit.geomID[lane] != RTC_INVALID_GEOMETRY_ID) {
+                hit.tHit = packet.ray.tfar[lane];
+                hit.uv.x = packet.hit.u[lane];
+                hit.uv.y = packet.hit.v[lane];
+
+                std::array<unsigned int, RTC_MAX_INSTANCE_LEVEL_COUNT> instanceIds; // NOLINT
+                for (size_t level = 0; level < instanceIds.size(); ++level) {
+                    instanceIds[level] = packet.hit.instID[level][lane];
+                }
+                fillIntersection(
+                    rays[first + lane], instanceIds, packet.hit.geomID[lane], packet.hit.primID[lane], hit);
+            }
+        }
+    }
+
+    RenderCounters::addIntersectionRays(rays.size());
+}
+
+void Scene::rayIntersect(const std::span<const Ray3> shadowRays, const std::span<uint8_t> occluded) const {
+    for (size_t first = 0; first < shadowRays.size(); first += kRayPacketSize) {
+        const size_t laneCount = std::min(kRayPacketSize, shadowRays.size() - first);
+
+        alignas(32) int32_t valid[kRayPacketSize]; // NOLINT
+        RTCRay8 packet;                            // NOLINT
+        for (size_t lane = 0; lane < kRayPacketSize; ++lane) {
+            valid[lane] = lane < laneCount ? -1 : 0;
+            if (lane < laneCount) {
+                setPacketRay(packet, lane, shadowRays[first + lane]);
+            }
+        }
+
+        rtcOccluded8(valid, m_scene, &packet);
+
+        for (size_t lane = 0; lane < laneCount; ++lane) {
+            occluded[first + lane] = packet.tfar[lane] < 0.0f ? 1 : 0;
+        }
+    }
+
+    RenderCounters::addShadowRays(shadowRays.size());
+}
+
+void Scene::fillIntersection(
+    const Ray3& ray,
+    const std::span<const unsigned int> instanceIds,
+    const unsigned int geometryId,
+    const unsigned int primitiveId,
+    Intersection& its) const {
+    its.dpdu = its.dpdv = glm::vec3(0.0f);
+    fillInstancedIntersection(m_shapes, instanceIds, geometryId, primitiveId, ray, its);
+
+    its.dUVdx = its.dUVdy = glm::vec2(0.0f);
+    if (its.dpdu != glm::vec3(0.0f) || its.dpdv != glm::vec3(0.0f)) {
+        glm::vec3 dpdx;
+        glm::vec3 dpdy;
+        m_camera->approximateDpDxy(its.p, its.geoFrame.n, dpdx, dpdy);
+        its.computeUVDifferentials(dpdx, dpdy);
+    }
+}
+
 BoundingBox3 Scene::getBoundingBox() const {
     return m_boundingBox;
 }
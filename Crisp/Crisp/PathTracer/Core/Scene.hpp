@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <span>
 #include <vector>
 
 #pragma warning(push)
@@ -17,14 +19,24 @@
 
 namespace crisp {
 class Integrator;
+class LightSampler;
 class Sampler;
 class Camera;
 class Shape;
 class BSDF;
 class Mesh;
+class ShapePrototype;
+class TextureCache;
 
 namespace pt {
 
+struct SceneMemoryUsage {
+    size_t shapeCount{0};
+    size_t shapeBytes{0};            // Geometry and sampling data owned by the shapes, shared with Embree.
+    size_t accelerationBytes{0};     // Held by Embree after the commit, mostly the BVH.
+    size_t peakAccelerationBytes{0}; // Embree high-water mark, including temporary build memory.
+};
+
 class Scene {
 public:
     Scene();
@@ -34,19 +46,35 @@ public:
     void setSampler(std::unique_ptr<Sampler> sampler);
     void setCamera(std::unique_ptr<Camera> camera);
     void addShape(std::unique_ptr<Shape> shape, BSDF* bsdf, Light* light = nullptr);
+    // Creates an empty prototype on the scene device. Its shapes only become visible through instances.
+    ShapePrototype* createPrototype();
     void addLight(std::unique_ptr<Light> light);
     void addEnvironmentLight(std::unique_ptr<Light> light);
     void addBSDF(std::unique_ptr<BSDF> bsdf);
+    void setLightSampler(std::unique_ptr<LightSampler> lightSampler);
+    // Shared with the image textures, which keep it alive for as long as they reference its tiles.
+    void setTextureCache(std::shared_ptr<TextureCache> textureCache);
+    const std::shared_ptr<TextureCache>& getTextureCache() const;
 
     void finishInitialization();
 
+    // Wall-clock time, in seconds, spent committing the Embree scene in finishInitialization().
+    double getAccelerationBuildTime() const;
+
+    SceneMemoryUsage getMemoryUsage() const;
+
+    // Number of rays traced through rayIntersect() by the calling thread over its lifetime.
+    static uint64_t getThreadRayCount();
+
     const Sampler* getSampler() const;
     const Integrator* getIntegrator() const;
     const Camera* getCamera() const;
     std::vector<std::unique_ptr<Shape>>& getShapes();
 
-    Light* getRandomLight(float sample) const;
-    float getLightPdf() const;
+    // Chooses a light to sample for point p with surface normal n, zero for points in media. The probability of the
+    // choice is returned in pmf and must divide the light's contribution.
+    Light* pickLight(const glm::vec3& p, const glm::vec3& n, float sample, float& pmf) const;
+    float getLightPickPmf(const glm::vec3& p, const glm::vec3& n, const Light* light) const;
     Spectrum sampleLight(const Intersection& its, Sampler& sampler, Light::Sample& lightSample) const;
 
     Spectrum evalEnvLight(const Ray3& ray) const;
@@ -55,10 +83,28 @@ public:
     bool rayIntersect(const Ray3& ray, Intersection& its) const;
     bool rayIntersect(const Ray3& shadowRay) const;
 
+    // Batched variants that trace the rays in packets of kRayPacketSize so that Embree can traverse the BVH with
+    // all SIMD lanes busy. They are most effective for coherent rays, such as the primary rays of an image tile.
+    // A ray that misses leaves its intersection with a null shape.
+    void rayIntersect(std::span<const Ray3> rays, std::span<Intersection> its) const;
+    // Writes 1 for every shadow ray that is blocked and 0 otherwise.
+    void rayIntersect(std::span<const Ray3> shadowRays, std::span<uint8_t> occluded) const;
+
+    static constexpr size_t kRayPacketSize = 8;
+
     BoundingBox3 getBoundingBox() const;
     glm::vec4 getBoundingSphere() const;
 
 private:
+    static bool monitorEmbreeMemory(void* userPtr, ssize_t bytes, bool post);
+
+    void fillIntersection(
+        const Ray3& ray,
+        std::span<const unsigned int> instanceIds,
+        unsigned int geometryId,
+        unsigned int primitiveId,
+        Intersection& its) const;
+
     RTCDevice m_device;
     RTCScene m_scene;
 
@@ -66,9 +112,12 @@ private:
     std::unique_ptr<Integrator> m_integrator;
     std::unique_ptr<Camera> m_camera;
 
+    std::vector<std::unique_ptr<ShapePrototype>> m_prototypes;
     std::vector<std::unique_ptr<Shape>> m_shapes;
     std::vector<std::unique_ptr<Light>> m_lights;
     std::vector<std::unique_ptr<BSDF>> m_bsdfs;
+    std::unique_ptr<LightSampler> m_lightSampler;
+    std::shared_ptr<TextureCache> m_textureCache;
 
     Light* m_envLight;
 
@@ -76,6 +125,11 @@ private:
 
     glm::vec4 m_boundingSphere;
     BoundingBox3 m_boundingBox;
+
+    double m_accelerationBuildTime;
+
+    std::atomic<int64_t> m_embreeMemory{0};
+    std::atomic<int64_t> m_embreePeakMemory{0};
 };
 } // namespace pt
 } // namespace crisp
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <Crisp/PathTracer/Denoiser.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace crisp {
+namespace {
+// B3 spline, the scaling function of the a-trous wavelet transform.
+constexpr std::array<float, 5> kKernel = {1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+constexpr float kMinAlbedo = 1e-3f;
+constexpr float kEpsilon = 1e-4f;
+
+float getLuminance(const glm::vec3& color) {
+    return 0.2126f * color.r + 0.7152f * color.g + 0.0722f * color.b;
+}
+
+glm::vec3 loadPixel(const std::span<const float> image, const size_t pixel) {
+    return {image[pixel * 4], image[pixel * 4 + 1], image[pixel * 4 + 2]};
+}
+
+// Black albedo channels say nothing about the lighting, so their color is filtered as is.
+glm::vec3 getModulation(const glm::vec3& albedo) {
+    return glm::vec3(
+        albedo.r > kMinAlbedo ? albedo.r : 1.0f,
+        albedo.g > kMinAlbedo ? albedo.g : 1.0f,
+        albedo.b > kMinAlbedo ? albedo.b : 1.0f);
+}
+
+template <typename Func>
+void forEachRow(const glm::ivec2& size, const Func& func) {
+    tbb::parallel_for(tbb::blocked_range<int>(0, size.y), [&](const tbb::blocked_range<int>& rows) {
+        for (int y = rows.begin(); y != rows.end(); ++y) {
+            func(y);
+        }
+    });
+}
+} // namespace
+
+Denoiser::Denoiser(const DenoiserSettings& settings)
+    : m_settings(settings) {}
+
+std::vector<float> Denoiser::denoise(
+    const glm::ivec2& size, const std::span<const float> color, const FeatureImages& features) const {
+    const size_t pixelCount = static_cast<size_t>(size.x) * size.y;
+    std::vector<glm::vec3> albedo(pixelCount);
+    std::vector<glm::vec3> normal(pixelCount);
+    std::vector<float> depth(pixelCount);
+    std::vector<glm::vec3> irradiance(pixelCount);
+    forEachRow(size, [&](const int y) {
+        for (size_t pixel = static_cast<size_t>(y) * size.x; pixel < static_cast<size_t>(y + 1) * size.x; ++pixel) {
+            albedo[pixel] = loadPixel(features.albedo, pixel);
+            normal[pixel] = loadPixel(features.normal, pixel);
+            depth[pixel] = features.depth[pixel * 4];
+            irradiance[pixel] = loadPixel(color, pixel) / getModulation(albedo[pixel]);
+        }
+    });
+
+    // Colors are compared through a 3x3 mean, which is three times less noisy than single pixels and keeps the color
+    // weight from rejecting neighbors over noise alone.
+    std::vector<glm::vec3> guide(pixelCount);
+    std::vector<glm::vec3> filtered(pixelCount);
+    for (int iteration = 0; iteration < m_settings.iterations; ++iteration) {
+        const int step = 1 << iteration;
+        const float colorSigma = m_settings.colorSigma * std::exp2(-static_cast<float>(iteration));
+
+        forEachRow(size, [&](const int y) {
+            for (int x = 0; x < size.x; ++x) {
+                glm::vec3 sum(0.0f);
+                int count = 0;
+                for (int qy = std::max(y - 1, 0); qy <= std::min(y + 1, size.y - 1); ++qy) {
+                    for (int qx = std::max(x - 1, 0); qx <= std::min(x + 1, size.x - 1); ++qx) {
+                        sum += irradiance[static_cast<size_t>(qy) * size.x + qx];
+                        ++count;
+                    }
+                }
+                guide[static_cast<size_t>(y) * size.x + x] = sum / static_cast<float>(count);
+            }
+        });
+
+        forEachRow(size, [&](const int y) {
+            for (int x = 0; x < size.x; ++x) {
+                const size_t p = static_cast<size_t>(y) * size.x + x;
+                const float guideLuminance = getLuminance(guide[p]);
+                const bool isBackground = glm::dot(normal[p], normal[p]) == 0.0f;
+
+                glm::vec3 sum(0.0f);
+                float weightSum = 0.0f;
+                for (int ky = 0; ky < 5; ++ky) {
+                    const int qy = y + (ky - 2) * step;
+                    if (qy < 0 || qy >= size.y) {
+                        continue;
+                    }
+                    for (int kx = 0; kx < 5; ++kx) {
+                        const int qx = x + (kx - 2) * step;
+                        if (qx < 0 || qx >= size.x) {
+                            continue;
+                        }
+
+                        const size_t q = static_cast<size_t>(qy) * size.x + qx;
+                        const glm::vec3 colorDiff = guide[p] - guide[q];
+                        const float colorScale =
+                            colorSigma * (0.5f * (guideLuminance + getLuminance(guide[q])) + kEpsilon);
+                        const float colorWeight = std::exp(-glm::dot(colorDiff, colorDiff) / (colorScale * colorScale));
+
+                        const glm::vec3 albedoDiff = albedo[p] - albedo[q];
+                        const float albedoWeight = std::exp(
+                            -glm::dot(albedoDiff, albedoDiff) / (m_settings.albedoSigma * m_settings.albedoSigma));
+
+                        // Background pixels have no normal and only blend with each other.
+                        float normalWeight = isBackground == (glm::dot(normal[q], normal[q]) == 0.0f) ? 1.0f : 0.0f;
+                        if (!isBackground) {
+                            normalWeight *=
+                                std::pow(std::max(glm::dot(normal[p], normal[q]), 0.0f), m_settings.normalExponent);
+                        }
+
+                        const float depthScale = m_settings.depthSigma * static_cast<float>(step) * depth[p] + kEpsilon;
+                        const float depthWeight = std::exp(-std::abs(depth[p] - depth[q]) / depthScale);
+
+                        const float weight =
+                            kKernel[kx] * kKernel[ky] * colorWeight * albedoWeight * normalWeight * depthWeight;
+                        sum += weight * irradiance[q];
+                        weightSum += weight;
+                    }
+                }
+
+                // The center tap always has a positive weight, so the sum never vanishes.
+                filtered[p] = sum / weightSum;
+            }
+        });
+
+        std::swap(irradiance, filtered);
+    }
+
+    std::vector<float> result(pixelCount * 4);
+    forEachRow(size, [&](const int y) {
+        for (size_t pixel = static_cast<size_t>(y) * size.x; pixel < static_cast<size_t>(y + 1) * size.x; ++pixel) {
+            const glm::vec3 value = irradiance[pixel] * getModulation(albedo[pixel]);
+            result[pixel * 4] = value.r;
+            result[pixel * 4 + 1] = value.g;
+            result[pixel * 4 + 2] = value.b;
+            result[pixel * 4 + 3] = 1.0f;
+        }
+    });
+    return result;
+}
+} // namespace crisp
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <Crisp/Math/Headers.hpp>
+
+namespace crisp {
+struct DenoiserSettings {
+    bool enabled{false};
+    bool denoiseProgressivePasses{false}; // Also denoises the image streamed after every progressive pass.
+    int iterations{5};                    // The filter footprint doubles with every iteration.
+    float colorSigma{2.0f};               // Relative color difference at which neighbors lose most of their weight.
+    float albedoSigma{0.1f};
+    float normalExponent{64.0f};
+    float depthSigma{0.05f}; // Depth difference relative to the pixel's depth, per pixel of distance.
+};
+
+// Images of the first-hit features that guide the denoiser, each in the RGBA layout of the rendered image.
+struct FeatureImages {
+    std::vector<float> albedo;
+    std::vector<float> normal;
+    std::vector<float> depth;
+};
+
+// Edge-avoiding a-trous wavelet filter after Dammertz et al., a joint bilateral filter whose 5x5 taps spread out
+// with every iteration. Neighbors are weighted by how similar their color, albedo, normal and depth are to the pixel's.
+// The color is divided by the albedo before filtering and multiplied back afterwards, so texture detail is preserved
+// while the lighting is smoothed.
+class Denoiser {
+public:
+    explicit Denoiser(const DenoiserSettings& settings);
+
+    // Filters an RGBA image of the given size, returning the result in the same layout.
+    std::vector<float> denoise(
+        const glm::ivec2& size, std::span<const float> color, const FeatureImages& features) const;
+
+private:
+    DenoiserSettings m_settings;
+};
+} // namespace crisp
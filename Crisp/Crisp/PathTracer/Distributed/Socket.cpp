@@ -0,0 +1,269 @@
+#include <Crisp/PathTracer/Distributed/Socket.hpp>
+
+#include <cerrno>
+#include <utility>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace crisp {
+namespace {
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+using IoSize = int;
+
+int getLastSocketError() {
+    return WSAGetLastError();
+}
+
+void closeNativeSocket(const NativeSocket socket) {
+    closesocket(socket);
+}
+
+int pollSocket(pollfd& fd, const int timeoutMs) {
+    return WSAPoll(&fd, 1, timeoutMs);
+}
+
+// Winsock has to be started once per process before the first call.
+bool initializeSockets() {
+    static const bool isInitialized = [] {
+        WSADATA data{};
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return isInitialized;
+}
+#else
+using NativeSocket = int;
+using IoSize = size_t;
+
+int getLastSocketError() {
+    return errno;
+}
+
+void closeNativeSocket(const NativeSocket socket) {
+    ::close(socket);
+}
+
+int pollSocket(pollfd& fd, const int timeoutMs) {
+    return ::poll(&fd, 1, timeoutMs);
+}
+
+bool initializeSockets() {
+    return true;
+}
+#endif
+
+// Writing to a connection the peer has closed raises SIGPIPE on POSIX systems unless suppressed per call.
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+NativeSocket toNative(const intptr_t handle) {
+    return static_cast<NativeSocket>(handle);
+}
+} // namespace
+
+Socket::Socket(const intptr_t handle)
+    : m_handle(handle) {}
+
+Socket::~Socket() {
+    close();
+}
+
+Socket::Socket(Socket&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, -1))
+    , m_receiveTimeout(other.m_receiveTimeout) {}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_handle = std::exchange(other.m_handle, -1);
+        m_receiveTimeout = other.m_receiveTimeout;
+    }
+    return *this;
+}
+
+Result<Socket> Socket::connect(const std::string& host, const uint16_t port) {
+    if (!initializeSockets()) {
+        return resultError("Failed to initialize sockets");
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        return resultError("Failed to resolve {}", host);
+    }
+
+    Socket socket;
+    for (const addrinfo* address = addresses; address; address = address->ai_next) {
+        const NativeSocket handle = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (handle == toNative(-1)) {
+            continue;
+        }
+        if (::connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+            socket = Socket(static_cast<intptr_t>(handle));
+            break;
+        }
+        closeNativeSocket(handle);
+    }
+    freeaddrinfo(addresses);
+
+    if (!socket.isOpen()) {
+        return resultError("Failed to connect to {}:{}", host, port);
+    }
+
+    // Tiles are sent as one message each; waiting to coalesce them only adds latency.
+    const int noDelay = 1;
+    setsockopt(
+        toNative(socket.m_handle), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    return socket;
+}
+
+Result<> Socket::send(std::span<const std::byte> data) {
+    while (!data.empty()) {
+        const auto sent = ::send(
+            toNative(m_handle),
+            reinterpret_cast<const char*>(data.data()),
+            static_cast<IoSize>(data.size()),
+            kSendFlags);
+        if (sent <= 0) {
+            return resultError("Failed to send {} bytes, error {}", data.size(), getLastSocketError());
+        }
+        data = data.subspan(static_cast<size_t>(sent));
+    }
+    return kResultSuccess;
+}
+
+Result<> Socket::receive(std::span<std::byte> data) {
+    while (!data.empty()) {
+        if (m_receiveTimeout.count() > 0) {
+            pollfd fd{};
+            fd.fd = toNative(m_handle);
+            fd.events = POLLIN;
+            const int ready = pollSocket(fd, static_cast<int>(m_receiveTimeout.count()));
+            if (ready < 0) {
+                return resultError("Failed to wait for {} bytes, error {}", data.size(), getLastSocketError());
+            }
+            if (ready == 0) {
+                return resultError("Timed out after {} ms waiting for {} bytes", m_receiveTimeout.count(), data.size());
+            }
+        }
+
+        const auto received =
+            ::recv(toNative(m_handle), reinterpret_cast<char*>(data.data()), static_cast<IoSize>(data.size()), 0);
+        if (received == 0) {
+            return resultError("Connection closed by peer");
+        }
+        if (received < 0) {
+            return resultError("Failed to receive {} bytes, error {}", data.size(), getLastSocketError());
+        }
+        data = data.subspan(static_cast<size_t>(received));
+    }
+    return kResultSuccess;
+}
+
+void Socket::setReceiveTimeout(const std::chrono::milliseconds timeout) {
+    m_receiveTimeout = timeout;
+}
+
+bool Socket::isOpen() const {
+    return m_handle != -1;
+}
+
+void Socket::close() {
+    if (isOpen()) {
+        closeNativeSocket(toNative(m_handle));
+        m_handle = -1;
+    }
+}
+
+ListenSocket::~ListenSocket() = default;
+
+ListenSocket::ListenSocket(ListenSocket&& other) noexcept
+    : m_socket(std::move(other.m_socket))
+    , m_port(std::exchange(other.m_port, 0)) {}
+
+ListenSocket& ListenSocket::operator=(ListenSocket&& other) noexcept {
+    m_socket = std::move(other.m_socket);
+    m_port = std::exchange(other.m_port, 0);
+    return *this;
+}
+
+Result<ListenSocket> ListenSocket::listen(const uint16_t port, const std::string& bindAddress) {
+    if (!initializeSockets()) {
+        return resultError("Failed to initialize sockets");
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, bindAddress.c_str(), &address.sin_addr) != 1) {
+        return resultError("Invalid IPv4 bind address {}", bindAddress);
+    }
+
+    const NativeSocket handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == toNative(-1)) {
+        return resultError("Failed to create socket, error {}", getLastSocketError());
+    }
+
+    ListenSocket listener;
+    listener.m_socket = Socket(static_cast<intptr_t>(handle));
+
+    // A restarted coordinator can bind its port again while connections of the previous one are in TIME_WAIT.
+    const int reuseAddress = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuseAddress), sizeof(reuseAddress));
+
+    if (::bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(handle, SOMAXCONN) != 0) {
+        return resultError("Failed to listen on {}:{}, error {}", bindAddress, port, getLastSocketError());
+    }
+
+    socklen_t addressSize = sizeof(address);
+    if (getsockname(handle, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0) {
+        return resultError("Failed to query the port of the listening socket, error {}", getLastSocketError());
+    }
+    listener.m_port = ntohs(address.sin_port);
+    return listener;
+}
+
+Result<Socket> ListenSocket::accept(const std::chrono::milliseconds timeout) {
+    pollfd fd{};
+    fd.fd = toNative(m_socket.m_handle);
+    fd.events = POLLIN;
+    const int ready = pollSocket(fd, static_cast<int>(timeout.count()));
+    if (ready < 0) {
+        return resultError("Failed to wait for connections, error {}", getLastSocketError());
+    }
+    if (ready == 0) {
+        return Socket();
+    }
+
+    const NativeSocket handle = ::accept(toNative(m_socket.m_handle), nullptr, nullptr);
+    if (handle == toNative(-1)) {
+        return resultError("Failed to accept connection, error {}", getLastSocketError());
+    }
+
+    const int noDelay = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    return Socket(static_cast<intptr_t>(handle));
+}
+
+uint16_t ListenSocket::getPort() const {
+    return m_port;
+}
+} // namespace crisp
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include <Crisp/Core/Result.hpp>
+
+namespace crisp {
+// Blocking TCP connection, closed on destruction.
+class Socket {
+public:
+    Socket() = default;
+    ~Socket();
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+    Socket(Socket&& other) noexcept;
+    Socket& operator=(Socket&& other) noexcept;
+
+    static Result<Socket> connect(const std::string& host, uint16_t port);
+
+    // Both block until all of the data has been transferred or the connection fails. Receiving also fails once no
+    // data has arrived for the receive timeout.
+    Result<> send(std::span<const std::byte> data);
+    Result<> receive(std::span<std::byte> data);
+
+    // Zero waits indefinitely, which is the default.
+    void setReceiveTimeout(std::chrono::milliseconds timeout);
+
+    bool isOpen() const;
+    void close();
+
+private:
+    friend class ListenSocket;
+    explicit Socket(intptr_t handle);
+
+    intptr_t m_handle{-1};
+    std::chrono::milliseconds m_receiveTimeout{0};
+};
+
+// TCP socket accepting connections on one IPv4 interface, or on all of them for 0.0.0.0.
+class ListenSocket {
+public:
+    ListenSocket() = default;
+    ~ListenSocket();
+
+    ListenSocket(const ListenSocket&) = delete;
+    ListenSocket& operator=(const ListenSocket&) = delete;
+    ListenSocket(ListenSocket&& other) noexcept;
+    ListenSocket& operator=(ListenSocket&& other) noexcept;
+
+    // Port 0 binds to any free port, see getPort(). Only local processes can connect unless another address is given.
+    static Result<ListenSocket> listen(uint16_t port, const std::string& bindAddress = "127.0.0.1");
+
+    // Waits up to timeout for a connection and returns a closed socket if none arrived.
+    Result<Socket> accept(std::chrono::milliseconds timeout);
+
+    uint16_t getPort() const;
+
+private:
+    Socket m_socket;
+    uint16_t m_port{0};
+};
+} // namespace crisp
@@ -0,0 +1,35 @@
+#include <Crisp/PathTracer/Distributed/TileProtocol.hpp>
+
+namespace crisp {
+namespace {
+// Guards against allocating for a corrupted header; a tile of 64x64 pixels with a wide filter is well below 1 MiB.
+constexpr uint64_t kMaxPayloadSize = uint64_t{1} << 30;
+
+struct MessageHeader {
+    TileMessageType type;
+    uint32_t reserved;
+    uint64_t payloadSize;
+};
+} // namespace
+
+Result<> sendMessage(Socket& socket, const TileMessageType type, const std::span<const std::byte> payload) {
+    const MessageHeader header{type, 0, payload.size()};
+    CRISP_TRY(socket.send(std::as_bytes(std::span(&header, 1))));
+    return socket.send(payload);
+}
+
+Result<TileProtocolMessage> receiveMessage(Socket& socket) {
+    MessageHeader header{};
+    CRISP_TRY(socket.receive(std::as_writable_bytes(std::span(&header, 1))));
+    if (header.type > TileMessageType::Done || header.payloadSize > kMaxPayloadSize) {
+        return resultError(
+            "Received invalid message of type {} with {} bytes",
+            static_cast<uint32_t>(header.type),
+            header.payloadSize);
+    }
+
+    TileProtocolMessage message{.type = header.type, .payload = std::string(header.payloadSize, '\0')};
+    CRISP_TRY(socket.receive(std::as_writable_bytes(std::span(message.payload))));
+    return message;
+}
+} // namespace crisp
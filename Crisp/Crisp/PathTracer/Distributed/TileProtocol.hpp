@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+
+#include <Crisp/Core/Result.hpp>
+#include <Crisp/PathTracer/Distributed/Socket.hpp>
+
+namespace crisp {
+// Messages between a render coordinator and its workers. Every message is a fixed header followed by its payload, both
+// in native byte order, so coordinator and workers have to run on the same architecture.
+//
+// A worker opens one connection per render thread and sends Hello. The coordinator answers Welcome if the worker loaded
+// the same scene, or Reject otherwise. It then sends one Tile at a time, which the worker answers with a TileResult
+// holding the rendered image block, until it sends Done.
+//
+// Messages are sent as raw structs, so each one spells out its padding as reserved fields that are kept zero.
+constexpr uint32_t kTileProtocolVersion = 1;
+
+enum class TileMessageType : uint32_t { Hello, Welcome, Reject, Tile, TileResult, Done };
+
+struct HelloMessage {
+    uint32_t protocolVersion;
+    uint32_t reserved{0};
+    uint64_t sceneHash;
+};
+
+static_assert(sizeof(HelloMessage) == 16);
+
+// Sampling settings that the coordinator's tiles are rendered with.
+struct WelcomeMessage {
+    uint32_t adaptive;
+    int32_t minSamplesPerPixel;
+    int32_t maxSamplesPerPixel;
+    int32_t samplesPerPass;
+    float errorThreshold;
+};
+
+static_assert(sizeof(WelcomeMessage) == 20);
+
+struct TileMessage {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    uint32_t firstSample; // Ignored by adaptive sampling, which always starts from the first sample.
+    uint32_t sampleCount;
+};
+
+static_assert(sizeof(TileMessage) == 24);
+
+// Followed by the image block as written by ImageBlock::write.
+struct TileResultMessage {
+    uint64_t raysTraced;
+    float renderTime;
+    uint32_t reserved{0};
+};
+
+static_assert(sizeof(TileResultMessage) == 16);
+
+struct TileProtocolMessage {
+    TileMessageType type;
+    std::string payload;
+
+    // Interprets the start of the payload as a message struct.
+    template <typename T>
+    Result<T> read() const {
+        if (payload.size() < sizeof(T)) {
+            return resultError("Message of type {} is too short", static_cast<uint32_t>(type));
+        }
+        T message;
+        std::memcpy(&message, payload.data(), sizeof(T));
+        return message;
+    }
+};
+
+Result<> sendMessage(Socket& socket, TileMessageType type, std::span<const std::byte> payload);
+
+template <typename T>
+Result<> sendMessage(Socket& socket, const TileMessageType type, const T& message) {
+    return sendMessage(socket, type, std::as_bytes(std::span(&message, 1)));
+}
+
+Result<TileProtocolMessage> receiveMessage(Socket& socket);
+} // namespace crisp
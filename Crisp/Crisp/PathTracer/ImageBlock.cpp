@@ -1,9 +1,27 @@
 #include <Crisp/PathTracer/ImageBlock.hpp>
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
 #include <Crisp/PathTracer/ReconstructionFilters/ReconstructionFilter.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 namespace crisp {
+namespace {
+template <typename T>
+void writeValues(std::ostream& stream, const std::span<const T> values) {
+    stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+}
+
+template <typename T>
+bool readValues(std::istream& stream, const std::span<T> values) {
+    return static_cast<bool>(
+        stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size_bytes())));
+}
+} // namespace
+
 ImageBlock::ImageBlock() {}
 
 ImageBlock::ImageBlock(const glm::ivec2& size, const ReconstructionFilter* filter)
@@ -19,27 +37,24 @@ ImageBlock::~ImageBlock() {}
 
 void ImageBlock::initialize(const glm::ivec2& size, const ReconstructionFilter* filter) {
     m_size = size;
+    m_filter = filter;
+    m_isBoxFilter = !filter || filter->isBox();
     if (filter) {
-        m_filter = filter;
         m_borderSize = static_cast<int>(std::ceil(m_filter->getRadius() - 0.5f));
-        int wSize = static_cast<int>(std::ceil(2.0f * m_filter->getRadius())) + 1;
-        m_weights.resize(wSize);
-        for (auto& weightRow : m_weights) {
-            weightRow.resize(wSize);
-            for (auto& weight : weightRow) {
-                weight = 0.0f;
-            }
-        }
+        const auto footprint = static_cast<size_t>(std::ceil(2.0f * m_filter->getRadius())) + 1;
+        m_weightsX.assign(footprint, 0.0f);
+        m_weightsY.assign(footprint, 0.0f);
     } else {
         m_borderSize = 0;
-        m_filter = nullptr;
     }
 
-    m_pixels.clear();
-    m_pixels.resize(size.y + 2 * m_borderSize);
-    for (auto& pixelRow : m_pixels) {
-        pixelRow.resize(size.x + 2 * m_borderSize);
-    }
+    const glm::ivec2 fullSize = getFullSize();
+    m_stride = fullSize.x;
+    m_planeSize = static_cast<size_t>(fullSize.x) * fullSize.y;
+    m_channels.assign(m_planeSize * ChannelCount, 0.0f);
+
+    m_statistics.assign(static_cast<size_t>(size.x) * size.y, PixelStatistics{});
+    m_features.assign(static_cast<size_t>(size.x) * size.y, PixelFeatures{});
 }
 
 void ImageBlock::initialize(const glm::ivec2& offset, const glm::ivec2& size, const ReconstructionFilter* filter) {
@@ -48,11 +63,9 @@ void ImageBlock::initialize(const glm::ivec2& offset, const glm::ivec2& size, co
 }
 
 void ImageBlock::clear() {
-    for (auto& pixelRow : m_pixels) {
-        for (auto& pixel : pixelRow) {
-            pixel = WeightedSpectrum(0.0f);
-        }
-    }
+    std::fill(m_channels.begin(), m_channels.end(), 0.0f);
+    std::fill(m_statistics.begin(), m_statistics.end(), PixelStatistics{});
+    std::fill(m_features.begin(), m_features.end(), PixelFeatures{});
 }
 
 glm::ivec2 ImageBlock::getOffset() const {
@@ -64,56 +77,314 @@ glm::ivec2 ImageBlock::getSize() const {
 }
 
 glm::ivec2 ImageBlock::getFullSize() const {
-    return m_size + glm::ivec2(m_borderSize, m_borderSize);
+    return m_size + glm::ivec2(2 * m_borderSize);
 }
 
 void ImageBlock::addSample(const glm::vec2& pixelSample, const Spectrum& radiance) {
     if (!radiance.isValid()) {
-        std::cerr << "Integrator computed an invalid radiance value! ";
-        std::cerr << radiance << '\n';
+        RenderCounters::addInvalidSample();
+        return;
+    }
+
+    const int px = static_cast<int>(std::floor(pixelSample.x)) - m_offset.x;
+    const int py = static_cast<int>(std::floor(pixelSample.y)) - m_offset.y;
+    const bool insideBlock = px >= 0 && py >= 0 && px < m_size.x && py < m_size.y;
+    if (insideBlock) {
+        m_statistics[static_cast<size_t>(py) * m_size.x + px].add(radiance.getLuminance());
+    }
+
+    const glm::vec3 rgb = radiance.toRgb();
+    float* red = getPlane(Red);
+    float* green = getPlane(Green);
+    float* blue = getPlane(Blue);
+    float* weight = getPlane(Weight);
+
+    // The box filter gives the sample unit weight in its own pixel and none anywhere else.
+    if (m_isBoxFilter) {
+        if (insideBlock) {
+            const size_t idx = static_cast<size_t>(py + m_borderSize) * m_stride + px + m_borderSize;
+            red[idx] += rgb.r;
+            green[idx] += rgb.g;
+            blue[idx] += rgb.b;
+            weight[idx] += 1.0f;
+        }
         return;
     }
 
-    glm::vec2 pos(
+    const glm::vec2 pos(
         pixelSample.x - 0.5f - (m_offset.x - m_borderSize), pixelSample.y - 0.5f - (m_offset.y - m_borderSize));
+    const glm::ivec2 fullSize = getFullSize();
+    const float radius = m_filter->getRadius();
 
-    int xLo = std::max(0, static_cast<int>(std::ceil(pos.x - m_filter->getRadius())));
-    int yLo = std::max(0, static_cast<int>(std::ceil(pos.y - m_filter->getRadius())));
-    int xHi = std::min(
-        static_cast<int>(m_pixels.at(0).size() - 1), static_cast<int>(std::floor(pos.x + m_filter->getRadius())));
-    int yHi =
-        std::min(static_cast<int>(m_pixels.size() - 1), static_cast<int>(std::floor(pos.y + m_filter->getRadius())));
+    const int xLo = std::max(0, static_cast<int>(std::ceil(pos.x - radius)));
+    const int yLo = std::max(0, static_cast<int>(std::ceil(pos.y - radius)));
+    const int xHi = std::min(fullSize.x - 1, static_cast<int>(std::floor(pos.x + radius)));
+    const int yHi = std::min(fullSize.y - 1, static_cast<int>(std::floor(pos.y + radius)));
 
+    for (int x = xLo, wx = 0; x <= xHi; ++x, ++wx) {
+        m_weightsX[wx] = m_filter->evalDiscrete(x - pos.x);
+    }
     for (int y = yLo, wy = 0; y <= yHi; ++y, ++wy) {
-        for (int x = xLo, wx = 0; x <= xHi; ++x, ++wx) {
-            m_weights[wy][wx] = m_filter->evalDiscrete(x - pos.x, y - pos.y);
-        }
+        m_weightsY[wy] = m_filter->evalDiscrete(y - pos.y);
     }
 
     for (int y = yLo, wy = 0; y <= yHi; ++y, ++wy) {
+        const size_t rowOffset = static_cast<size_t>(y) * m_stride;
         for (int x = xLo, wx = 0; x <= xHi; ++x, ++wx) {
-            m_pixels[y][x] += WeightedSpectrum(radiance) * m_weights[wy][wx];
+            const float w = m_weightsX[wx] * m_weightsY[wy];
+            red[rowOffset + x] += rgb.r * w;
+            green[rowOffset + x] += rgb.g * w;
+            blue[rowOffset + x] += rgb.b * w;
+            weight[rowOffset + x] += w;
         }
     }
 }
 
-std::vector<float> ImageBlock::getRaw() {
-    std::vector<float> data;
-    data.reserve(m_size.x * m_size.y * 4); // 4th is padding (alpha)
-
-    for (int i = m_borderSize; i < m_borderSize + m_size.y; i++) {
-        for (int j = m_borderSize; j < m_borderSize + m_size.x; j++) {
-            auto rgb = m_pixels[i][j].toRgb();
-            data.push_back(rgb.r);
-            data.push_back(rgb.g);
-            data.push_back(rgb.b);
-            data.push_back(1.0f);
+void ImageBlock::addFeatures(
+    const glm::vec2& pixelSample, const Spectrum& albedo, const glm::vec3& normal, const float depth) {
+    const int px = static_cast<int>(std::floor(pixelSample.x)) - m_offset.x;
+    const int py = static_cast<int>(std::floor(pixelSample.y)) - m_offset.y;
+    if (px < 0 || py < 0 || px >= m_size.x || py >= m_size.y || !albedo.isValid()) {
+        return;
+    }
+
+    PixelFeatures& features = m_features[static_cast<size_t>(py) * m_size.x + px];
+    features.albedo += albedo.toRgb();
+    features.normal += normal;
+    features.depth += depth;
+    features.sampleCount += 1.0f;
+}
+
+void ImageBlock::put(const ImageBlock& block) {
+    // Both blocks are addressed in padded coordinates, whose origin lies at offset - border in the image.
+    const glm::ivec2 shift = (block.m_offset - glm::ivec2(block.m_borderSize)) - (m_offset - glm::ivec2(m_borderSize));
+    const glm::ivec2 fullSize = getFullSize();
+    const glm::ivec2 blockFullSize = block.getFullSize();
+    const int xBegin = std::max(0, -shift.x);
+    const int xEnd = std::min(blockFullSize.x, fullSize.x - shift.x);
+    const int yBegin = std::max(0, -shift.y);
+    const int yEnd = std::min(blockFullSize.y, fullSize.y - shift.y);
+
+    if (xBegin < xEnd) {
+        for (int c = 0; c < ChannelCount; ++c) {
+            const auto channel = static_cast<Channel>(c);
+            float* dst = getPlane(channel);
+            const float* src = block.getPlane(channel);
+            for (int y = yBegin; y < yEnd; ++y) {
+                float* dstRow = dst + static_cast<size_t>(y + shift.y) * m_stride + shift.x;
+                const float* srcRow = src + static_cast<size_t>(y) * block.m_stride;
+                for (int x = xBegin; x < xEnd; ++x) {
+                    dstRow[x] += srcRow[x];
+                }
+            }
+        }
+    }
+
+    const glm::ivec2 pixelShift = block.m_offset - m_offset;
+    for (int y = std::max(0, -pixelShift.y); y < std::min(block.m_size.y, m_size.y - pixelShift.y); ++y) {
+        for (int x = std::max(0, -pixelShift.x); x < std::min(block.m_size.x, m_size.x - pixelShift.x); ++x) {
+            const size_t dst = static_cast<size_t>(pixelShift.y + y) * m_size.x + pixelShift.x + x;
+            const size_t src = static_cast<size_t>(y) * block.m_size.x + x;
+            m_statistics[dst].merge(block.m_statistics[src]);
+
+            PixelFeatures& features = m_features[dst];
+            features.albedo += block.m_features[src].albedo;
+            features.normal += block.m_features[src].normal;
+            features.depth += block.m_features[src].depth;
+            features.sampleCount += block.m_features[src].sampleCount;
+        }
+    }
+}
+
+std::vector<float> ImageBlock::getRaw() const {
+    std::vector<float> data(static_cast<size_t>(m_size.x) * m_size.y * 4); // 4th is padding (alpha)
+    writeRgba(Descriptor(m_offset.x, m_offset.y, m_size.x, m_size.y), data, m_offset, m_size.x);
+    return data;
+}
+
+void ImageBlock::writeRgba(
+    const Descriptor& region, std::span<float> dst, const glm::ivec2& dstOrigin, const int dstWidth) const {
+    const glm::ivec2 begin = glm::max(region.offset, m_offset);
+    const glm::ivec2 end = glm::min(region.offset + region.size, m_offset + m_size);
+
+    const float* red = getPlane(Red);
+    const float* green = getPlane(Green);
+    const float* blue = getPlane(Blue);
+    const float* weight = getPlane(Weight);
+    for (int y = begin.y; y < end.y; ++y) {
+        const size_t srcRow = static_cast<size_t>(y - m_offset.y + m_borderSize) * m_stride + m_borderSize - m_offset.x;
+        for (int x = begin.x; x < end.x; ++x) {
+            const size_t src = srcRow + x;
+            const float invWeight = weight[src] != 0.0f ? 1.0f / weight[src] : 0.0f;
+            float* pixel = &dst[(static_cast<size_t>(y - dstOrigin.y) * dstWidth + x - dstOrigin.x) * 4];
+            pixel[0] = red[src] * invWeight;
+            pixel[1] = green[src] * invWeight;
+            pixel[2] = blue[src] * invWeight;
+            pixel[3] = 1.0f;
+        }
+    }
+}
+
+void ImageBlock::writeFeatures(
+    const Descriptor& region,
+    const std::span<float> albedo,
+    const std::span<float> normal,
+    const std::span<float> depth,
+    const glm::ivec2& dstOrigin,
+    const int dstWidth) const {
+    const glm::ivec2 begin = glm::max(region.offset, m_offset);
+    const glm::ivec2 end = glm::min(region.offset + region.size, m_offset + m_size);
+    for (int y = begin.y; y < end.y; ++y) {
+        for (int x = begin.x; x < end.x; ++x) {
+            const PixelFeatures& features = m_features[static_cast<size_t>(y - m_offset.y) * m_size.x + x - m_offset.x];
+            const float invCount = features.sampleCount > 0.0f ? 1.0f / features.sampleCount : 0.0f;
+            const float normalLength = glm::length(features.normal);
+            const glm::vec3 n = normalLength > 0.0f ? features.normal / normalLength : glm::vec3(0.0f);
+            const glm::vec3 a = features.albedo * invCount;
+            const float d = features.depth * invCount;
+
+            const size_t dst = (static_cast<size_t>(y - dstOrigin.y) * dstWidth + x - dstOrigin.x) * 4;
+            albedo[dst + 0] = a.r;
+            albedo[dst + 1] = a.g;
+            albedo[dst + 2] = a.b;
+            albedo[dst + 3] = 1.0f;
+            normal[dst + 0] = n.x;
+            normal[dst + 1] = n.y;
+            normal[dst + 2] = n.z;
+            normal[dst + 3] = 1.0f;
+            depth[dst + 0] = d;
+            depth[dst + 1] = d;
+            depth[dst + 2] = d;
+            depth[dst + 3] = 1.0f;
         }
     }
+}
+
+void ImageBlock::write(std::ostream& stream) const {
+    const std::array<int32_t, 5> layout = {m_offset.x, m_offset.y, m_size.x, m_size.y, m_borderSize};
+    writeValues<int32_t>(stream, layout);
+    writeValues<float>(stream, m_channels);
+    writeValues<PixelStatistics>(stream, m_statistics);
+    writeValues<PixelFeatures>(stream, m_features);
+}
+
+Result<> ImageBlock::read(std::istream& stream) {
+    std::array<int32_t, 5> layout{};
+    if (!readValues<int32_t>(stream, layout)) {
+        return resultError("Unexpected end of image block data");
+    }
+    if (layout != std::array<int32_t, 5>{m_offset.x, m_offset.y, m_size.x, m_size.y, m_borderSize}) {
+        return resultError(
+            "Image block data of size {}x{} at ({}, {}) with border {} does not match the block",
+            layout[2],
+            layout[3],
+            layout[0],
+            layout[1],
+            layout[4]);
+    }
+
+    std::vector<float> channels(m_channels.size());
+    std::vector<PixelStatistics> statistics(m_statistics.size());
+    std::vector<PixelFeatures> features(m_features.size());
+    if (!readValues<float>(stream, channels) || !readValues<PixelStatistics>(stream, statistics) ||
+        !readValues<PixelFeatures>(stream, features)) {
+        return resultError("Unexpected end of image block data");
+    }
+
+    m_channels = std::move(channels);
+    m_statistics = std::move(statistics);
+    m_features = std::move(features);
+    return kResultSuccess;
+}
+
+float* ImageBlock::getPlane(const Channel channel) {
+    return m_channels.data() + channel * m_planeSize;
+}
+
+const float* ImageBlock::getPlane(const Channel channel) const {
+    return m_channels.data() + channel * m_planeSize;
+}
+
+const ImageBlock::PixelStatistics& ImageBlock::getPixelStatistics(int x, int y) const {
+    return m_statistics[static_cast<size_t>(y) * m_size.x + x];
+}
+
+uint64_t ImageBlock::getTotalSampleCount() const {
+    uint64_t sampleCount = 0;
+    for (const auto& stats : m_statistics) {
+        sampleCount += stats.sampleCount;
+    }
+    return sampleCount;
+}
+
+std::vector<float> ImageBlock::getSampleCountRaw() const {
+    std::vector<float> data;
+    data.reserve(m_statistics.size() * 4);
+    for (const auto& stats : m_statistics) {
+        const auto sampleCount = static_cast<float>(stats.sampleCount);
+        data.push_back(sampleCount);
+        data.push_back(sampleCount);
+        data.push_back(sampleCount);
+        data.push_back(1.0f);
+    }
 
     return data;
 }
 
+std::vector<float> ImageBlock::getVarianceRaw() const {
+    std::vector<float> data;
+    data.reserve(m_statistics.size() * 4);
+    for (const auto& stats : m_statistics) {
+        const float variance = stats.getMeanVariance();
+        data.push_back(variance);
+        data.push_back(variance);
+        data.push_back(variance);
+        data.push_back(1.0f);
+    }
+
+    return data;
+}
+
+void ImageBlock::PixelStatistics::add(const float value) {
+    ++sampleCount;
+    const float delta = value - mean;
+    mean += delta / static_cast<float>(sampleCount);
+    m2 += delta * (value - mean);
+}
+
+void ImageBlock::PixelStatistics::merge(const PixelStatistics& other) {
+    if (other.sampleCount == 0) {
+        return;
+    }
+
+    // Chan et al.'s pairwise update, so that blocks rendered independently can be combined exactly.
+    const uint32_t combinedCount = sampleCount + other.sampleCount;
+    const float delta = other.mean - mean;
+    const float otherFraction = static_cast<float>(other.sampleCount) / static_cast<float>(combinedCount);
+    mean += delta * otherFraction;
+    m2 += other.m2 + delta * delta * static_cast<float>(sampleCount) * otherFraction;
+    sampleCount = combinedCount;
+}
+
+float ImageBlock::PixelStatistics::getMeanVariance() const {
+    if (sampleCount < 2) {
+        return 0.0f;
+    }
+
+    const float variance = m2 / static_cast<float>(sampleCount - 1);
+    return variance / static_cast<float>(sampleCount);
+}
+
+float ImageBlock::PixelStatistics::getRelativeError() const {
+    if (sampleCount < 2) {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    // Dark pixels would otherwise never converge in relative terms.
+    constexpr float kMinMean = 1e-3f;
+    return std::sqrt(getMeanVariance()) / std::max(mean, kMinMean);
+}
+
 ImageBlock::Descriptor::Descriptor(int xOffset, int yOffset, int width, int height) {
     offset = glm::ivec2(xOffset, yOffset);
     size = glm::ivec2(width, height);
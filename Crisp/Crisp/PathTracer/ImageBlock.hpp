@@ -1,7 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <iosfwd>
+#include <span>
 #include <vector>
 
+#include <Crisp/Core/Result.hpp>
+
 #include <Crisp/Math/Headers.hpp>
 
 #include <Crisp/PathTracer/Spectra/Spectrum.hpp>
@@ -9,6 +14,10 @@
 namespace crisp {
 class ReconstructionFilter;
 
+// Accumulates filtered samples of an image region. The weighted red, green, blue and weight channels are stored as
+// four contiguous planes that cover the region plus a border of the filter radius, so splatting a sample touches a
+// few short rows per channel. The first-hit features that guide the denoiser are averaged per pixel instead, since
+// blurring them across pixels would only soften the edges they are meant to preserve.
 class ImageBlock {
 public:
     struct Descriptor {
@@ -19,6 +28,21 @@ public:
         Descriptor();
     };
 
+    // Running luminance statistics of the samples generated inside a pixel, accumulated with Welford's algorithm.
+    struct PixelStatistics {
+        uint32_t sampleCount{0};
+        float mean{0.0f};
+        float m2{0.0f};
+
+        void add(float value);
+        void merge(const PixelStatistics& other);
+
+        // Variance of the mean luminance, zero until two samples have been taken.
+        float getMeanVariance() const;
+        // Standard error of the mean relative to the mean, infinite until two samples have been taken.
+        float getRelativeError() const;
+    };
+
     ImageBlock();
     ImageBlock(const glm::ivec2& size, const ReconstructionFilter* filter);
     ImageBlock(const glm::ivec2& offset, const glm::ivec2& size, const ReconstructionFilter* filter);
@@ -31,20 +55,75 @@ public:
 
     glm::ivec2 getOffset() const;
     glm::ivec2 getSize() const;
+    // Size including the border on every side.
     glm::ivec2 getFullSize() const;
 
     void addSample(const glm::vec2& pixelSample, const Spectrum& radiance);
 
-    std::vector<float> getRaw();
+    // Adds the albedo, shading normal and distance of the surface seen by a camera sample. Samples that escape the
+    // scene add zeros for all three.
+    void addFeatures(const glm::vec2& pixelSample, const Spectrum& albedo, const glm::vec3& normal, float depth);
+
+    // Accumulates the weighted samples of a block, including the part of its border that overlaps this block.
+    void put(const ImageBlock& block);
+
+    std::vector<float> getRaw() const;
+
+    // Writes the normalized RGBA values of a region, given in image coordinates and clipped to the block, into an RGBA
+    // buffer that is dstWidth pixels wide and whose first pixel lies at dstOrigin in the image.
+    void writeRgba(const Descriptor& region, std::span<float> dst, const glm::ivec2& dstOrigin, int dstWidth) const;
+
+    // Writes the averaged features of a region into three RGBA buffers laid out as for writeRgba. Normals are
+    // renormalized and the depth is replicated across RGB.
+    void writeFeatures(
+        const Descriptor& region,
+        std::span<float> albedo,
+        std::span<float> normal,
+        std::span<float> depth,
+        const glm::ivec2& dstOrigin,
+        int dstWidth) const;
+
+    // Statistics of pixel (x, y), relative to the block offset and excluding the border.
+    const PixelStatistics& getPixelStatistics(int x, int y) const;
+    uint64_t getTotalSampleCount() const;
+
+    // Per-pixel sample counts in the RGBA layout of getRaw, for inspection as an AOV.
+    std::vector<float> getSampleCountRaw() const;
+    // Per-pixel variance of the mean luminance in the same layout.
+    std::vector<float> getVarianceRaw() const;
+
+    // Writes the accumulated channels, statistics and features in binary form. read() restores them into a block that
+    // was initialized with the same offset, size and filter, and fails without modifying the block otherwise.
+    void write(std::ostream& stream) const;
+    Result<> read(std::istream& stream);
 
 private:
-    std::vector<std::vector<WeightedSpectrum>> m_pixels;
+    enum Channel { Red, Green, Blue, Weight, ChannelCount };
+
+    struct PixelFeatures {
+        glm::vec3 albedo{0.0f};
+        glm::vec3 normal{0.0f};
+        float depth{0.0f};
+        float sampleCount{0.0f};
+    };
+
+    float* getPlane(Channel channel);
+    const float* getPlane(Channel channel) const;
+
+    std::vector<float> m_channels;
+    size_t m_planeSize;
+    int m_stride;
     glm::ivec2 m_offset;
     glm::ivec2 m_size;
     int m_borderSize;
 
     const ReconstructionFilter* m_filter;
+    bool m_isBoxFilter;
+
+    std::vector<float> m_weightsX;
+    std::vector<float> m_weightsY;
 
-    std::vector<std::vector<float>> m_weights;
+    std::vector<PixelStatistics> m_statistics;
+    std::vector<PixelFeatures> m_features;
 };
 } // namespace crisp
\ No newline at end of file
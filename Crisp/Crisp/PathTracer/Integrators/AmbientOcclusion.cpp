@@ -18,9 +18,19 @@ AmbientOcclusionIntegrator::~AmbientOcclusionIntegrator() {}
 void AmbientOcclusionIntegrator::preprocess(pt::Scene* /*scene*/) {}
 
 Spectrum AmbientOcclusionIntegrator::Li(
-    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags /*illumFlags*/) const {
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
     Intersection its;
-    if (!scene->rayIntersect(ray, its)) {
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum AmbientOcclusionIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& ray,
+    const Intersection& its,
+    IlluminationFlags /*illumFlags*/) const {
+    if (!its.shape) {
         return Spectrum(1.0f);
     }
 
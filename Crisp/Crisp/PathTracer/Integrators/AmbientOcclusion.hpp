@@ -11,6 +11,12 @@ public:
     virtual void preprocess(pt::Scene* scene) override;
     virtual Spectrum Li(
         const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags flags = Illumination::Full) const override;
+    virtual Spectrum LiFromPrimaryHit(
+        const pt::Scene* scene,
+        Sampler& sampler,
+        Ray3& ray,
+        const Intersection& primaryIts,
+        IlluminationFlags flags = Illumination::Full) const override;
 
 private:
     float m_rayLength;
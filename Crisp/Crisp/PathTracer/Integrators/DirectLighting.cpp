@@ -14,9 +14,19 @@ DirectLightingIntegrator::DirectLightingIntegrator(const VariantMap& /*params*/)
 void DirectLightingIntegrator::preprocess(pt::Scene* /*scene*/) {}
 
 Spectrum DirectLightingIntegrator::Li(
-    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags /*illumFlags*/) const {
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
     Intersection its;
-    if (!scene->rayIntersect(ray, its)) {
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum DirectLightingIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& ray,
+    const Intersection& its,
+    IlluminationFlags /*illumFlags*/) const {
+    if (!its.shape) {
         return Spectrum{0.0f};
     }
 
@@ -29,7 +39,7 @@ Spectrum DirectLightingIntegrator::Li(
         return Spectrum{0.0f};
     }
 
-    BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
+    BSDF::Sample bsdfSample(its, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
     bsdfSample.measure = BSDF::Measure::SolidAngle;
     auto bsdfSpec = its.shape->getBSDF()->eval(bsdfSample);
 
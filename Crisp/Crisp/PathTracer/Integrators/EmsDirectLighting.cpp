@@ -14,9 +14,19 @@ EmsDirectLightingIntegrator::EmsDirectLightingIntegrator(const VariantMap& /*par
 void EmsDirectLightingIntegrator::preprocess(pt::Scene* /*scene*/) {}
 
 Spectrum EmsDirectLightingIntegrator::Li(
-    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags /*illumFlags*/) const {
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
     Intersection its;
-    if (!scene->rayIntersect(ray, its)) {
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum EmsDirectLightingIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& ray,
+    const Intersection& its,
+    IlluminationFlags /*illumFlags*/) const {
+    if (!its.shape) {
         return {0.0f};
     }
 
@@ -38,7 +48,7 @@ Spectrum EmsDirectLightingIntegrator::Li(
     }
 
     // Evaluate the BSDF at the intersection
-    BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
+    BSDF::Sample bsdfSample(its, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
     bsdfSample.eta = 1.0f;
     bsdfSample.measure = BSDF::Measure::SolidAngle;
     auto bsdfSpec = its.shape->getBSDF()->eval(bsdfSample);
@@ -0,0 +1,301 @@
+#include <Crisp/PathTracer/Integrators/GuidedPathTracer.hpp>
+
+#include <Crisp/Core/Logger.hpp>
+#include <Crisp/Core/Timer.hpp>
+#include <Crisp/PathTracer/BSDFs/BSDF.hpp>
+#include <Crisp/PathTracer/BSSRDFs/BSSRDF.hpp>
+#include <Crisp/PathTracer/Cameras/Camera.hpp>
+#include <Crisp/PathTracer/Core/Intersection.hpp>
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
+#include <Crisp/PathTracer/Core/Scene.hpp>
+#include <Crisp/PathTracer/Samplers/Sampler.hpp>
+#include <Crisp/PathTracer/Shapes/Shape.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+namespace crisp {
+namespace {
+// Training samples start far past the sample indices of any render, so that they are independent of the image.
+constexpr uint32_t kTrainingSampleOffset = 1u << 24;
+// Vertices past this many are not learned from, which only happens on long paths carrying little radiance.
+constexpr uint32_t kMaxGuidingVertices = 32;
+
+inline float miWeight(float pdf1, float pdf2) {
+    pdf1 *= pdf1;
+    pdf2 *= pdf2;
+    return pdf1 / (pdf1 + pdf2);
+}
+
+// A vertex of a training path, together with the radiance that reached it from the direction it sampled.
+struct GuidingVertex {
+    DTree* tree;
+    glm::vec3 direction;
+    float woPdf;
+    Spectrum throughput; // Path weight from the vertex to the current end of the path.
+    Spectrum radiance;
+};
+
+struct GuidingPath {
+    std::array<GuidingVertex, kMaxGuidingVertices> vertices;
+    uint32_t vertexCount{0};
+
+    void addRadiance(const Spectrum& radiance) {
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            vertices[i].radiance += vertices[i].throughput * radiance;
+        }
+    }
+
+    void applyWeight(const Spectrum& weight) {
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            vertices[i].throughput *= weight;
+        }
+    }
+
+    // Splats the incident radiance estimate of every vertex into the tree it was sampled from.
+    void record() const {
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            vertices[i].tree->record(vertices[i].direction, vertices[i].radiance.getLuminance() / vertices[i].woPdf);
+        }
+    }
+};
+} // namespace
+
+GuidedPathTracerIntegrator::GuidedPathTracerIntegrator(const VariantMap& attribs) {
+    m_rrDepth = static_cast<unsigned int>(attribs.get<int>("rrDepth", 5));
+    m_maxDepth = static_cast<unsigned int>(attribs.get<int>("maxDepth", std::numeric_limits<int>::max()));
+    m_trainingIterations = attribs.get<int>("trainingIterations", 5);
+    m_spatialThreshold = attribs.get<float>("spatialThreshold", 12000.0f);
+    m_directionalThreshold = attribs.get<float>("directionalThreshold", 0.01f);
+    m_bsdfSamplingFraction = std::clamp(attribs.get<float>("bsdfSamplingFraction", 0.5f), 0.0f, 1.0f);
+}
+
+GuidedPathTracerIntegrator::~GuidedPathTracerIntegrator() {}
+
+void GuidedPathTracerIntegrator::preprocess(pt::Scene* scene) {
+    for (auto& shape : scene->getShapes()) {
+        if (shape->getBSSRDF()) {
+            shape->getBSSRDF()->preprocess(shape.get(), scene);
+        }
+    }
+
+    m_sdTree = std::make_unique<SDTree>(scene->getBoundingBox());
+    train(scene);
+}
+
+Spectrum GuidedPathTracerIntegrator::Li(
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags /*illumFlags*/) const {
+    Intersection its;
+    scene->rayIntersect(ray, its);
+    return tracePath(scene, sampler, ray, its, false);
+}
+
+Spectrum GuidedPathTracerIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& ray,
+    const Intersection& primaryIts,
+    IlluminationFlags /*illumFlags*/) const {
+    return tracePath(scene, sampler, ray, primaryIts, false);
+}
+
+void GuidedPathTracerIntegrator::train(const pt::Scene* scene) {
+    const Camera* camera = scene->getCamera();
+    const glm::ivec2 imageSize = camera->getImageSize();
+    tbb::enumerable_thread_specific<std::unique_ptr<Sampler>> samplers(
+        [scene] { return scene->getSampler()->clone(); });
+
+    uint32_t firstSample = kTrainingSampleOffset;
+    for (int iteration = 0; iteration < m_trainingIterations; ++iteration) {
+        const Timer<std::chrono::duration<double>> iterationTimer;
+        const uint32_t sampleCount = 1u << iteration;
+        tbb::parallel_for(tbb::blocked_range<int>(0, imageSize.y), [&](const tbb::blocked_range<int>& rows) {
+            Sampler& sampler = *samplers.local();
+            for (int y = rows.begin(); y != rows.end(); ++y) {
+                for (int x = 0; x < imageSize.x; ++x) {
+                    for (uint32_t s = 0; s < sampleCount; ++s) {
+                        sampler.startPixelSample(glm::ivec2(x, y), firstSample + s);
+                        std::array<float, 4> cameraSample; // Pixel position followed by aperture position
+                        sampler.fill(cameraSample);
+                        Ray3 ray;
+                        camera->sampleRay(
+                            ray,
+                            glm::vec2(x + cameraSample[0], y + cameraSample[1]),
+                            glm::vec2(cameraSample[2], cameraSample[3]));
+                        Intersection its;
+                        scene->rayIntersect(ray, its);
+                        tracePath(scene, sampler, ray, its, true);
+                    }
+                }
+            }
+        });
+        firstSample += sampleCount;
+
+        // Leaves see twice as many samples every iteration but may only keep sqrt(2) times as many, so they shrink as
+        // the estimates they hold become less noisy.
+        const auto spatialThreshold =
+            static_cast<uint64_t>(m_spatialThreshold * std::sqrt(static_cast<float>(sampleCount)));
+        m_sdTree->refine(spatialThreshold, m_directionalThreshold);
+        spdlog::info(
+            "Path guiding: training iteration {} ({} spp) in {:.3f} s, {} spatial leaves.",
+            iteration,
+            sampleCount,
+            iterationTimer.getElapsedTime(),
+            m_sdTree->getLeafCount());
+    }
+}
+
+Spectrum GuidedPathTracerIntegrator::tracePath(
+    const pt::Scene* scene, Sampler& sampler, const Ray3& r, const Intersection& primaryIts, const bool record) const {
+    Spectrum L(0.0f);
+    Spectrum throughput(1.0f);
+    Ray3 ray(r);
+    unsigned int bounces = 0;
+    bool terminatedByRoulette = false;
+    GuidingPath guidingPath;
+
+    // The vertex the ray left from, to weigh the emission it finds against next-event estimation there.
+    bool hasPrevVertexNee = false;
+    bool isPrevVertexRecorded = false;
+    float prevWoPdf = 0.0f;
+    glm::vec3 prevP(0.0f);
+    glm::vec3 prevN(0.0f);
+
+    Intersection its = primaryIts;
+    bool foundIntersection = its.shape != nullptr;
+
+    while (true) {
+        const Light* light = foundIntersection ? its.shape->getLight() : scene->getEnvironmentLight();
+        if (light) {
+            Light::Sample lightSample =
+                foundIntersection ? Light::Sample(ray.o, its.p, its.shFrame.n) : Light::Sample(ray.o, ray(1.0f), ray.d);
+            lightSample.wi = ray.d;
+            const Spectrum Le = light->eval(lightSample);
+            if (!Le.isZero()) {
+                float weight = 1.0f;
+                if (hasPrevVertexNee) {
+                    const float lightPdf = light->pdf(lightSample) * scene->getLightPickPmf(prevP, prevN, light);
+                    weight = miWeight(prevWoPdf, lightPdf);
+                }
+
+                L += throughput * Le * weight;
+                if (record) {
+                    // Earlier vertices see the emission as part of the MIS estimate at the previous vertex, while
+                    // the previous vertex itself learns all of the radiance arriving from its direction.
+                    guidingPath.addRadiance(Le * weight);
+                    if (isPrevVertexRecorded) {
+                        GuidingVertex& vertex = guidingPath.vertices[guidingPath.vertexCount - 1];
+                        vertex.radiance += vertex.throughput * Le * (1.0f - weight);
+                    }
+                }
+            }
+        }
+
+        if (!foundIntersection || bounces >= m_maxDepth) {
+            break;
+        }
+
+        // Only BSDFs without delta lobes are guided, since their directions can be sampled and evaluated anywhere.
+        const BSDF* bsdf = its.shape->getBSDF();
+        const bool isSmooth = !(bsdf->getLobeType() & Lobe::Delta);
+        SDTree::Leaf* leaf = isSmooth && m_sdTree ? &m_sdTree->getLeaf(its.p) : nullptr;
+        const bool isGuided = leaf && leaf->sampling.getRadianceSum() > 0.0f;
+        const float bsdfFraction = isGuided ? m_bsdfSamplingFraction : 1.0f;
+        const auto getWoPdf = [&](const float bsdfPdf, const glm::vec3& wo) {
+            return isGuided ? bsdfFraction * bsdfPdf + (1.0f - bsdfFraction) * leaf->sampling.pdf(wo) : bsdfPdf;
+        };
+
+        if (isSmooth) {
+            Light::Sample lightSample(its.p);
+            const Spectrum Li = scene->sampleLight(its, sampler, lightSample);
+            if (lightSample.pdf > 0.0f && !Li.isZero() && !scene->rayIntersect(lightSample.shadowRay)) {
+                BSDF::Sample bsdfSample(its, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
+                bsdfSample.measure = BSDF::Measure::SolidAngle;
+                bsdfSample.eta = 1.0f;
+                const Spectrum f = bsdf->eval(bsdfSample);
+                if (!f.isZero()) {
+                    const float weight =
+                        lightSample.light->isDelta()
+                            ? 1.0f
+                            : miWeight(lightSample.pdf, getWoPdf(bsdf->pdf(bsdfSample), lightSample.wi));
+                    L += throughput * f * Li * weight;
+                    if (record) {
+                        guidingPath.addRadiance(f * Li * weight);
+                    }
+                }
+            }
+        }
+
+        BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
+        Spectrum weight(0.0f);
+        float woPdf = 0.0f;
+        if (isGuided && sampler.next1D() >= bsdfFraction) {
+            const glm::vec3 wo = leaf->sampling.sample(sampler.next2D());
+            bsdfSample.wo = its.toLocal(wo);
+            bsdfSample.measure = BSDF::Measure::SolidAngle;
+            bsdfSample.eta = 1.0f;
+            woPdf = getWoPdf(bsdf->pdf(bsdfSample), wo);
+            if (woPdf > 0.0f) {
+                weight = bsdf->eval(bsdfSample) / woPdf;
+            }
+        } else {
+            const Spectrum f = bsdf->sample(bsdfSample, sampler);
+            if (!f.isZero() && bsdfSample.pdf > 0.0f) {
+                RenderCounters::addBsdfSample(static_cast<uint32_t>(bsdfSample.sampledLobe));
+                // The BSDF returns its value divided by its own density, which is rescaled to that of the mixture.
+                woPdf = getWoPdf(bsdfSample.pdf, its.toWorld(bsdfSample.wo));
+                weight = f * (bsdfSample.pdf / woPdf);
+            }
+        }
+
+        if (weight.isZero() || woPdf == 0.0f) {
+            break;
+        }
+
+        throughput *= weight;
+        guidingPath.applyWeight(weight);
+        ray = Ray3(its.p, its.toWorld(bsdfSample.wo));
+
+        hasPrevVertexNee = isSmooth;
+        isPrevVertexRecorded = record && leaf && guidingPath.vertexCount < kMaxGuidingVertices;
+        prevWoPdf = woPdf;
+        prevP = its.p;
+        prevN = its.shFrame.n;
+        if (isPrevVertexRecorded) {
+            guidingPath.vertices[guidingPath.vertexCount++] = {
+                .tree = &leaf->building,
+                .direction = ray.d,
+                .woPdf = woPdf,
+                .throughput = Spectrum(1.0f),
+                .radiance = Spectrum(0.0f),
+            };
+        }
+
+        if (bounces > m_rrDepth) {
+            float q = 1.0f - std::min(throughput.maxCoeff(), 0.99f);
+            if (sampler.next1D() < q) {
+                terminatedByRoulette = true;
+                break;
+            }
+
+            throughput /= (1.0f - q);
+            guidingPath.applyWeight(Spectrum(1.0f / (1.0f - q)));
+        }
+
+        bounces++;
+        foundIntersection = scene->rayIntersect(ray, its);
+    }
+
+    if (record) {
+        guidingPath.record();
+    }
+
+    RenderCounters::addPath(bounces, terminatedByRoulette);
+    return L;
+}
+} // namespace crisp
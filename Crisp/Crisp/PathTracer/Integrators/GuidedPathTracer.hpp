@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Crisp/PathTracer/Integrators/Integrator.hpp>
+#include <Crisp/PathTracer/Integrators/SDTree.hpp>
+
+#include <memory>
+
+namespace crisp {
+struct Intersection;
+
+// Path tracer that learns the incident radiance of the scene in an SD-tree before rendering, after Mueller et al.,
+// "Practical Path Guiding for Efficient Light-Transport Simulation". Preprocessing traces the image in training
+// iterations of doubling sample counts, each recording the radiance its paths find into the tree that the next one
+// samples from. Paths then continue in a direction drawn from the BSDF with probability bsdfSamplingFraction and from
+// the learned distribution otherwise, and emission found along them is combined with next-event estimation by
+// multiple importance sampling against that mixture.
+class GuidedPathTracerIntegrator : public Integrator {
+public:
+    GuidedPathTracerIntegrator(const VariantMap& attributes);
+    virtual ~GuidedPathTracerIntegrator();
+
+    virtual void preprocess(pt::Scene* scene) override;
+    virtual Spectrum Li(
+        const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags flags = Illumination::Full) const override;
+    virtual Spectrum LiFromPrimaryHit(
+        const pt::Scene* scene,
+        Sampler& sampler,
+        Ray3& ray,
+        const Intersection& primaryIts,
+        IlluminationFlags flags = Illumination::Full) const override;
+
+private:
+    void train(const pt::Scene* scene);
+    Spectrum tracePath(
+        const pt::Scene* scene, Sampler& sampler, const Ray3& ray, const Intersection& primaryIts, bool record) const;
+
+    unsigned int m_rrDepth;
+    unsigned int m_maxDepth;
+    int m_trainingIterations;
+    float m_spatialThreshold;     // Samples a spatial leaf may record in a 1 spp iteration before it is split.
+    float m_directionalThreshold; // Fraction of a leaf's radiance above which a directional quadrant is subdivided.
+    float m_bsdfSamplingFraction;
+
+    std::unique_ptr<SDTree> m_sdTree;
+};
+} // namespace crisp
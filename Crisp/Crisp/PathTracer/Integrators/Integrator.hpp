@@ -1,7 +1,11 @@
 #pragma once
 
+#include <span>
+
 #include <Crisp/Math/Ray.hpp>
+#include <Crisp/PathTracer/Core/Intersection.hpp>
 #include <Crisp/PathTracer/Core/VariantMap.hpp>
+#include <Crisp/PathTracer/Samplers/Sampler.hpp>
 #include <Crisp/PathTracer/Spectra/Spectrum.hpp>
 #include <Crisp/Utils/BitFlags.hpp>
 
@@ -9,7 +13,6 @@ namespace crisp {
 namespace pt {
 class Scene;
 } // namespace pt
-class Sampler;
 
 enum class Illumination { Direct = 1 << 0, Indirect = 1 << 1, Full = Direct | Indirect };
 DECLARE_BITFLAG(Illumination);
@@ -21,5 +24,32 @@ public:
     virtual void preprocess(pt::Scene* scene) = 0;
     virtual Spectrum Li(
         const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags flags = Illumination::Full) const = 0;
+
+    // Same as Li, but for a camera ray whose first intersection was already traced, e.g. as part of a ray packet.
+    // primaryIts has a null shape if the ray missed. Integrators that cannot reuse the hit trace the ray again.
+    virtual Spectrum LiFromPrimaryHit(
+        const pt::Scene* scene,
+        Sampler& sampler,
+        Ray3& ray,
+        const Intersection& /*primaryIts*/,
+        IlluminationFlags flags = Illumination::Full) const {
+        return Li(scene, sampler, ray, flags);
+    }
+
+    // Evaluates a batch of camera rays, e.g. all primary rays of an image block, given their first intersections.
+    // sampleStates holds where each ray's sample sequence continues once its camera sample was drawn. The default
+    // integrates the rays one by one; wavefront integrators advance all of their paths together.
+    virtual void LiBatch(
+        const pt::Scene* scene,
+        Sampler& sampler,
+        std::span<const SampleState> sampleStates,
+        std::span<Ray3> rays,
+        std::span<const Intersection> primaryHits,
+        std::span<Spectrum> radiance) const {
+        for (size_t i = 0; i < rays.size(); ++i) {
+            sampler.setSampleState(sampleStates[i]);
+            radiance[i] = LiFromPrimaryHit(scene, sampler, rays[i], primaryHits[i]);
+        }
+    }
 };
 } // namespace crisp
\ No newline at end of file
@@ -3,11 +3,13 @@
 #include <Crisp/PathTracer/Integrators/AmbientOcclusion.hpp>
 #include <Crisp/PathTracer/Integrators/DirectLighting.hpp>
 #include <Crisp/PathTracer/Integrators/EmsDirectLighting.hpp>
+#include <Crisp/PathTracer/Integrators/GuidedPathTracer.hpp>
 #include <Crisp/PathTracer/Integrators/MatsDirectLighting.hpp>
 #include <Crisp/PathTracer/Integrators/MisDirectLighting.hpp>
 #include <Crisp/PathTracer/Integrators/MisPathTracer.hpp>
 #include <Crisp/PathTracer/Integrators/Normals.hpp>
 #include <Crisp/PathTracer/Integrators/PathTracer.hpp>
+#include <Crisp/PathTracer/Integrators/WavefrontPathTracer.hpp>
 
 namespace crisp {
 std::unique_ptr<Integrator> IntegratorFactory::create(std::string type, VariantMap parameters) {
@@ -27,6 +29,10 @@ std::unique_ptr<Integrator> IntegratorFactory::create(std::string type, VariantM
         return std::make_unique<PathTracerIntegrator>(parameters);
     } else if (type == "mis-path-tracer") {
         return std::make_unique<MisPathTracerIntegrator>(parameters);
+    } else if (type == "guided-path-tracer") {
+        return std::make_unique<GuidedPathTracerIntegrator>(parameters);
+    } else if (type == "wavefront-path-tracer") {
+        return std::make_unique<WavefrontPathTracerIntegrator>(parameters);
     } else {
         std::cerr
             << "Unknown integrator type \"" << type << "\" requested! Creating default normals integrator" << std::endl;
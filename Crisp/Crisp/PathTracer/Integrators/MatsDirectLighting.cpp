@@ -16,9 +16,19 @@ MatsDirectLightingIntegrator::~MatsDirectLightingIntegrator() {}
 void MatsDirectLightingIntegrator::preprocess(pt::Scene* /*scene*/) {}
 
 Spectrum MatsDirectLightingIntegrator::Li(
-    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags /*illumFlags*/) const {
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
     Intersection its;
-    if (!scene->rayIntersect(ray, its)) {
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum MatsDirectLightingIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& ray,
+    const Intersection& its,
+    IlluminationFlags /*illumFlags*/) const {
+    if (!its.shape) {
         return Spectrum(0.0f);
     }
 
@@ -29,7 +39,7 @@ Spectrum MatsDirectLightingIntegrator::Li(
         L += its.shape->getLight()->eval(sample);
     }
 
-    BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d));
+    BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
     auto bsdfSpec = its.shape->getBSDF()->sample(bsdfSample, sampler);
 
     Intersection sampledRayIts;
@@ -13,5 +13,11 @@ public:
     virtual void preprocess(pt::Scene* scene) override;
     virtual Spectrum Li(
         const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags flags = Illumination::Full) const override;
+    virtual Spectrum LiFromPrimaryHit(
+        const pt::Scene* scene,
+        Sampler& sampler,
+        Ray3& ray,
+        const Intersection& primaryIts,
+        IlluminationFlags flags = Illumination::Full) const override;
 };
 } // namespace crisp
\ No newline at end of file
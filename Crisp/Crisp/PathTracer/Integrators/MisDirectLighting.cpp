@@ -26,9 +26,19 @@ MisDirectLightingIntegrator::MisDirectLightingIntegrator(const VariantMap& /*par
 void MisDirectLightingIntegrator::preprocess(pt::Scene* /*scene*/) {}
 
 Spectrum MisDirectLightingIntegrator::Li(
-    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags /*illumFlags*/) const {
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
     Intersection its;
-    if (!scene->rayIntersect(ray, its)) {
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum MisDirectLightingIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& ray,
+    const Intersection& its,
+    IlluminationFlags /*illumFlags*/) const {
+    if (!its.shape) {
         return scene->evalEnvLight(ray);
     }
 
@@ -53,7 +63,7 @@ Spectrum MisDirectLightingIntegrator::lightImportanceSample(
         return Spectrum::zero();
     }
 
-    BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
+    BSDF::Sample bsdfSample(its, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
     bsdfSample.measure = BSDF::Measure::SolidAngle;
     bsdfSample.eta = 1.0f;
     auto f = its.shape->getBSDF()->eval(bsdfSample);
@@ -68,7 +78,7 @@ Spectrum MisDirectLightingIntegrator::lightImportanceSample(
 
 Spectrum MisDirectLightingIntegrator::bsdfImportanceSample(
     const pt::Scene* scene, Sampler& sampler, const Ray3& ray, const Intersection& its) {
-    BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d));
+    BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
     const auto f = its.shape->getBSDF()->sample(bsdfSample, sampler);
     if (f.isZero()) {
         return Spectrum::zero();
@@ -96,8 +106,9 @@ Spectrum MisDirectLightingIntegrator::bsdfImportanceSample(
     }
 
     const float pdfBsdf = bsdfSample.pdf;
-    const float pdfLight =
-        bsdfSample.sampledLobe == Lobe::Delta ? 0.0f : hitLight->pdf(lightSam) * scene->getLightPdf();
+    const float pdfLight = bsdfSample.sampledLobe == Lobe::Delta
+                               ? 0.0f
+                               : hitLight->pdf(lightSam) * scene->getLightPickPmf(its.p, its.shFrame.n, hitLight);
     return f * Li * powerHeuristic(pdfBsdf, pdfLight);
 }
 } // namespace crisp
\ No newline at end of file
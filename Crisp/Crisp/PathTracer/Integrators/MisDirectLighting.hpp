@@ -16,6 +16,12 @@ public:
         Sampler& sampler,
         Ray3& ray,
         IlluminationFlags flags = Illumination::Full) const override;
+    virtual Spectrum LiFromPrimaryHit(
+        const pt::Scene* scene,
+        Sampler& sampler,
+        Ray3& ray,
+        const Intersection& primaryIts,
+        IlluminationFlags flags = Illumination::Full) const override;
 
 private:
     static Spectrum lightImportanceSample(
@@ -3,6 +3,7 @@
 #include <Crisp/PathTracer/BSDFs/BSDF.hpp>
 #include <Crisp/PathTracer/BSSRDFs/BSSRDF.hpp>
 #include <Crisp/PathTracer/Core/Intersection.hpp>
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
 #include <Crisp/PathTracer/Core/Scene.hpp>
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
 #include <Crisp/PathTracer/Shapes/Shape.hpp>
@@ -23,7 +24,7 @@ Spectrum estimateDirect(
     Light::Sample lightSample(its.p);
     Spectrum Li = light.sample(lightSample, sampler);
     if (lightSample.pdf > 0.0f && !Li.isZero() && !scene.rayIntersect(lightSample.shadowRay)) {
-        BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
+        BSDF::Sample bsdfSample(its, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
         bsdfSample.measure = BSDF::Measure::SolidAngle;
         bsdfSample.eta = 1.0f;
         Spectrum f = its.shape->getBSDF()->eval(bsdfSample);
@@ -35,7 +36,7 @@ Spectrum estimateDirect(
     }
 
     if (!light.isDelta()) {
-        BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d));
+        BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
         Spectrum f = its.shape->getBSDF()->sample(bsdfSample, sampler);
         bool sampledSpecular = bsdfSample.sampledLobe == Lobe::Delta;
 
@@ -87,13 +88,12 @@ Spectrum estimateDirect(
 
 Spectrum uniformSampleOneLight(const pt::Scene& scene, Sampler& sampler, const Ray3& ray, const Intersection& its) {
     Light::Sample lightSample(its.p);
-    auto light = scene.getRandomLight(sampler.next1D());
+    float pickPdf = 0.0f;
+    auto light = scene.pickLight(its.p, its.shFrame.n, sampler.next1D(), pickPdf);
     if (!light) {
         return Spectrum(0.0f);
     }
 
-    float pickPdf = scene.getLightPdf();
-
     return estimateDirect(scene, sampler, ray, its, *light, false) / pickPdf;
 }
 } // namespace
@@ -114,18 +114,29 @@ void MisPathTracerIntegrator::preprocess(pt::Scene* scene) {
 }
 
 Spectrum MisPathTracerIntegrator::Li(
-    const pt::Scene* scene, Sampler& sampler, Ray3& r, IlluminationFlags /*illumFlags*/) const {
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
+    Intersection its;
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum MisPathTracerIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& r,
+    const Intersection& primaryIts,
+    IlluminationFlags /*illumFlags*/) const {
     Spectrum L(0.0f);
     Spectrum throughput(1.0f);
     Ray3 ray(r);
     unsigned int bounces = 0;
     bool specularBounce = false;
+    bool terminatedByRoulette = false;
 
-    Intersection its;
+    Intersection its = primaryIts;
+    bool foundIntersection = its.shape != nullptr;
 
     while (true) {
-        bool foundIntersection = scene->rayIntersect(ray, its);
-
         if (bounces == 0 || specularBounce) {
             if (foundIntersection) {
                 if (auto light = its.shape->getLight()) {
@@ -147,11 +158,12 @@ Spectrum MisPathTracerIntegrator::Li(
             L += throughput * lightMis;
         }
 
-        BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d));
+        BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
         Spectrum f = its.shape->getBSDF()->sample(bsdfSample, sampler);
         if (f.isZero() || bsdfSample.pdf == 0.0f) {
             break;
         }
+        RenderCounters::addBsdfSample(static_cast<uint32_t>(bsdfSample.sampledLobe));
 
         throughput *= f;
 
@@ -162,6 +174,7 @@ Spectrum MisPathTracerIntegrator::Li(
         if (bounces > m_rrDepth) {
             float q = 1.0f - std::min(throughput.maxCoeff(), 0.99f);
             if (sampler.next1D() < q) {
+                terminatedByRoulette = true;
                 break;
             }
 
@@ -169,8 +182,10 @@ Spectrum MisPathTracerIntegrator::Li(
         }
 
         bounces++;
+        foundIntersection = scene->rayIntersect(ray, its);
     }
 
+    RenderCounters::addPath(bounces, terminatedByRoulette);
     return L;
 }
 
@@ -182,7 +197,7 @@ Spectrum MisPathTracerIntegrator::lightImportanceSample(
         return Spectrum(0.0f);
     }
 
-    BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
+    BSDF::Sample bsdfSample(its, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
     bsdfSample.measure = BSDF::Measure::SolidAngle;
     bsdfSample.eta = 1.0f;
     Spectrum f = its.shape->getBSDF()->eval(bsdfSample);
@@ -197,7 +212,7 @@ Spectrum MisPathTracerIntegrator::lightImportanceSample(
 
 Spectrum MisPathTracerIntegrator::bsdfImportanceSample(
     const pt::Scene* scene, Sampler& sampler, const Ray3& ray, const Intersection& its, Path& path) const {
-    BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d));
+    BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
     Spectrum f = its.shape->getBSDF()->sample(bsdfSample, sampler);
     if (f.isZero()) {
         return {0.0f};
@@ -227,7 +242,8 @@ Spectrum MisPathTracerIntegrator::bsdfImportanceSample(
     Spectrum Li = hitLight->eval(lightSample);
 
     float pdfBsdf = bsdfSample.pdf;
-    float pdfLight = path.isSpecular ? 0.0f : hitLight->pdf(lightSample) * scene->getLightPdf();
+    float pdfLight =
+        path.isSpecular ? 0.0f : hitLight->pdf(lightSample) * scene->getLightPickPmf(its.p, its.shFrame.n, hitLight);
     return f * Li * miWeight(pdfBsdf, pdfLight);
 }
 } // namespace crisp
\ No newline at end of file
@@ -15,17 +15,22 @@ NormalsIntegrator::~NormalsIntegrator() {}
 void NormalsIntegrator::preprocess(pt::Scene* /*scene*/) {}
 
 Spectrum NormalsIntegrator::Li(
-    const pt::Scene* scene, Sampler& /*sampler*/, Ray3& ray, IlluminationFlags /*illumFlags*/) const {
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
     Intersection its;
-    if (!scene->rayIntersect(ray, its)) {
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum NormalsIntegrator::LiFromPrimaryHit(
+    const pt::Scene* /*scene*/,
+    Sampler& /*sampler*/,
+    Ray3& /*ray*/,
+    const Intersection& its,
+    IlluminationFlags /*illumFlags*/) const {
+    if (!its.shape) {
         return Spectrum(0.0f);
     }
 
-    Spectrum color;
-    color.r = std::fabsf(its.shFrame.n.x);
-    color.g = std::fabsf(its.shFrame.n.y);
-    color.b = std::fabsf(its.shFrame.n.z);
-
-    return color;
+    return Spectrum(glm::abs(its.shFrame.n));
 }
 } // namespace crisp
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <Crisp/PathTracer/BSDFs/BSDF.hpp>
 #include <Crisp/PathTracer/BSSRDFs/BSSRDF.hpp>
 #include <Crisp/PathTracer/Core/Intersection.hpp>
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
 #include <Crisp/PathTracer/Core/Scene.hpp>
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
 #include <Crisp/PathTracer/Shapes/Shape.hpp>
@@ -15,15 +16,28 @@ PathTracerIntegrator::~PathTracerIntegrator() {}
 void PathTracerIntegrator::preprocess(pt::Scene* /*scene*/) {}
 
 Spectrum PathTracerIntegrator::Li(
-    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags /*illumFlags*/) const {
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
+    Intersection its;
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum PathTracerIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& ray,
+    const Intersection& primaryIts,
+    IlluminationFlags /*illumFlags*/) const {
     Spectrum L(0.0f);
     Spectrum throughput(1.0f);
 
-    Intersection its;
+    Intersection its = primaryIts;
+    bool foundIntersection = its.shape != nullptr;
     unsigned int numBounces = 0;
     while (true) {
-        if (!scene->rayIntersect(ray, its)) {
+        if (!foundIntersection) {
             L += throughput * scene->evalEnvLight(ray);
+            RenderCounters::addPath(numBounces, false);
             return L;
         }
 
@@ -32,8 +46,9 @@ Spectrum PathTracerIntegrator::Li(
             L += throughput * its.shape->getLight()->eval(lightSample);
         }
 
-        BSDF::Sample bsdfSample(its.p, its.uv, its.toLocal(-ray.d));
+        BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
         throughput *= its.shape->getBSDF()->sample(bsdfSample, sampler);
+        RenderCounters::addBsdfSample(static_cast<uint32_t>(bsdfSample.sampledLobe));
 
         ray = Ray3(its.p, its.toWorld(bsdfSample.wo));
 
@@ -44,9 +59,12 @@ Spectrum PathTracerIntegrator::Li(
             if (sampler.next1D() > q) {
                 throughput /= 1.0f - q;
             } else {
+                RenderCounters::addPath(numBounces, true);
                 break;
             }
         }
+
+        foundIntersection = scene->rayIntersect(ray, its);
     }
 
     return L;
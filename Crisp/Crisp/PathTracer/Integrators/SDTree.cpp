@@ -0,0 +1,310 @@
+#include <Crisp/PathTracer/Integrators/SDTree.hpp>
+
+#include <Crisp/Math/Constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <tbb/parallel_for.h>
+
+namespace crisp {
+namespace {
+constexpr uint32_t kNoSource = std::numeric_limits<uint32_t>::max();
+
+// Quadrants are numbered x + 2y, where x and y tell whether the point lies in the upper half of the axis.
+uint32_t getQuadrant(const glm::vec2& p) {
+    return (p.x >= 0.5f ? 1u : 0u) + (p.y >= 0.5f ? 2u : 0u);
+}
+
+glm::vec2 getQuadrantOrigin(const uint32_t quadrant) {
+    return 0.5f * glm::vec2(quadrant & 1u, quadrant >> 1u);
+}
+
+float getMaxExtent(const BoundingBox3& bounds) {
+    const glm::vec3 extents = bounds.max - bounds.min;
+    return std::max({extents.x, extents.y, extents.z});
+}
+} // namespace
+
+DTree::Node::Node(const Node& other)
+    : children(other.children) {
+    for (uint32_t i = 0; i < 4; ++i) {
+        sums[i].store(other.sums[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+DTree::Node& DTree::Node::operator=(const Node& other) {
+    for (uint32_t i = 0; i < 4; ++i) {
+        sums[i].store(other.sums[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    children = other.children;
+    return *this;
+}
+
+std::array<float, 4> DTree::Node::loadSums() const {
+    std::array<float, 4> values{};
+    for (uint32_t i = 0; i < 4; ++i) {
+        values[i] = sums[i].load(std::memory_order_relaxed);
+    }
+    return values;
+}
+
+float DTree::Node::getSum() const {
+    const std::array<float, 4> values = loadSums();
+    return values[0] + values[1] + values[2] + values[3];
+}
+
+DTree::DTree()
+    : m_nodes(1) {}
+
+DTree::DTree(const DTree& other)
+    : m_nodes(other.m_nodes)
+    , m_sampleCount(other.getSampleCount()) {}
+
+DTree& DTree::operator=(const DTree& other) {
+    m_nodes = other.m_nodes;
+    m_sampleCount.store(other.getSampleCount(), std::memory_order_relaxed);
+    return *this;
+}
+
+void DTree::record(const glm::vec3& direction, const float radiance) {
+    m_sampleCount.fetch_add(1, std::memory_order_relaxed);
+    if (!(radiance > 0.0f) || !std::isfinite(radiance)) {
+        return;
+    }
+
+    glm::vec2 p = toCanonical(direction);
+    uint32_t index = 0;
+    while (true) {
+        Node& node = m_nodes[index];
+        const uint32_t quadrant = getQuadrant(p);
+        node.sums[quadrant].fetch_add(radiance, std::memory_order_relaxed);
+        if (node.children[quadrant] == 0) {
+            break;
+        }
+
+        p = 2.0f * (p - getQuadrantOrigin(quadrant));
+        index = node.children[quadrant];
+    }
+}
+
+float DTree::pdf(const glm::vec3& direction) const {
+    glm::vec2 p = toCanonical(direction);
+    float density = 1.0f;
+    uint32_t index = 0;
+    while (true) {
+        // Sampling stays uniform within nodes that saw no radiance.
+        const Node& node = m_nodes[index];
+        const float sum = node.getSum();
+        if (sum <= 0.0f) {
+            break;
+        }
+
+        const uint32_t quadrant = getQuadrant(p);
+        density *= 4.0f * node.sums[quadrant].load(std::memory_order_relaxed) / sum;
+        if (node.children[quadrant] == 0) {
+            break;
+        }
+
+        p = 2.0f * (p - getQuadrantOrigin(quadrant));
+        index = node.children[quadrant];
+    }
+
+    return density * InvFourPI<>;
+}
+
+glm::vec3 DTree::sample(glm::vec2 sample) const {
+    glm::vec2 origin(0.0f);
+    float scale = 1.0f;
+    uint32_t index = 0;
+    while (true) {
+        const Node& node = m_nodes[index];
+        const std::array<float, 4> sums = node.loadSums();
+        const float sum = sums[0] + sums[1] + sums[2] + sums[3];
+        if (sum <= 0.0f) {
+            break;
+        }
+
+        // Picks the column of quadrants first and the quadrant within it second, rescaling the sample after each
+        // choice so that it can be reused by the next level.
+        uint32_t quadrant = 0;
+        float lowerFraction = 0.0f;
+        const float leftFraction = (sums[0] + sums[2]) / sum;
+        if (sample.x < leftFraction) {
+            sample.x /= leftFraction;
+            lowerFraction = sums[0] / (sums[0] + sums[2]);
+        } else {
+            sample.x = (sample.x - leftFraction) / (1.0f - leftFraction);
+            lowerFraction = sums[1] / (sums[1] + sums[3]);
+            quadrant |= 1u;
+        }
+
+        if (sample.y < lowerFraction) {
+            sample.y /= lowerFraction;
+        } else {
+            sample.y = (sample.y - lowerFraction) / (1.0f - lowerFraction);
+            quadrant |= 2u;
+        }
+
+        origin += scale * getQuadrantOrigin(quadrant);
+        scale *= 0.5f;
+        if (node.children[quadrant] == 0) {
+            break;
+        }
+
+        index = node.children[quadrant];
+    }
+
+    const glm::vec2 local = glm::clamp(sample, 0.0f, 1.0f - std::numeric_limits<float>::epsilon());
+    return toDirection(origin + scale * local);
+}
+
+uint64_t DTree::getSampleCount() const {
+    return m_sampleCount.load(std::memory_order_relaxed);
+}
+
+float DTree::getRadianceSum() const {
+    return m_nodes[0].getSum();
+}
+
+size_t DTree::getNodeCount() const {
+    return m_nodes.size();
+}
+
+void DTree::refine(const float subdivisionThreshold, const uint32_t maxDepth) {
+    std::vector<Node> nodes(1);
+    const float total = getRadianceSum();
+    if (total > 0.0f) {
+        // Quadrants that were leaves but need subdividing start out with their radiance spread evenly, which keeps
+        // subdividing them until a quarter of it falls below the threshold.
+        struct Entry {
+            uint32_t node;
+            uint32_t source;
+            std::array<float, 4> sums;
+            uint32_t depth;
+        };
+
+        std::vector<Entry> stack;
+        stack.push_back({.node = 0, .source = 0, .sums = m_nodes[0].loadSums(), .depth = 1});
+        while (!stack.empty()) {
+            const Entry entry = stack.back();
+            stack.pop_back();
+            for (uint32_t i = 0; i < 4; ++i) {
+                if (entry.depth >= maxDepth || entry.sums[i] <= subdivisionThreshold * total) {
+                    continue;
+                }
+
+                Entry child{.node = static_cast<uint32_t>(nodes.size()), .source = kNoSource, .depth = entry.depth + 1};
+                const uint32_t source = entry.source == kNoSource ? 0 : m_nodes[entry.source].children[i];
+                if (source != 0) {
+                    child.source = source;
+                    child.sums = m_nodes[source].loadSums();
+                } else {
+                    child.sums.fill(0.25f * entry.sums[i]);
+                }
+
+                nodes[entry.node].children[i] = child.node;
+                nodes.emplace_back();
+                stack.push_back(child);
+            }
+        }
+    }
+
+    m_nodes = std::move(nodes);
+    m_sampleCount.store(0, std::memory_order_relaxed);
+}
+
+glm::vec2 DTree::toCanonical(const glm::vec3& direction) {
+    const float cosTheta = std::clamp(direction.z, -1.0f, 1.0f);
+    float phi = std::atan2(direction.y, direction.x);
+    if (phi < 0.0f) {
+        phi += 2.0f * PI<>;
+    }
+
+    return glm::clamp(
+        glm::vec2(0.5f * (cosTheta + 1.0f), phi * InvTwoPI<>),
+        0.0f,
+        1.0f - std::numeric_limits<float>::epsilon());
+}
+
+glm::vec3 DTree::toDirection(const glm::vec2& canonical) {
+    const float cosTheta = 2.0f * canonical.x - 1.0f;
+    const float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+    const float phi = 2.0f * PI<> * canonical.y;
+    return {sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta};
+}
+
+SDTree::SDTree(const BoundingBox3& bounds)
+    : m_origin(bounds.min)
+    , m_size(std::max(getMaxExtent(bounds), std::numeric_limits<float>::epsilon()))
+    , m_nodes(1)
+    , m_leaves(1) {
+    // A cube, so that the splits cycling through the axes keep the cells close to cubes as well.
+    m_origin -= 0.01f * m_size;
+    m_size *= 1.02f;
+}
+
+SDTree::Leaf& SDTree::getLeaf(const glm::vec3& p) {
+    return m_leaves[findLeaf(p)];
+}
+
+const SDTree::Leaf& SDTree::getLeaf(const glm::vec3& p) const {
+    return m_leaves[findLeaf(p)];
+}
+
+size_t SDTree::getLeafCount() const {
+    return m_leaves.size();
+}
+
+void SDTree::refine(const uint64_t spatialThreshold, const float directionalThreshold) {
+    const uint64_t threshold = std::max<uint64_t>(spatialThreshold, 1);
+    std::vector<uint64_t> sampleCounts(m_nodes.size(), 0);
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].isLeaf()) {
+            sampleCounts[i] = m_leaves[m_nodes[i].leaf].building.getSampleCount();
+        }
+    }
+
+    // New nodes are appended, so the loop visits the children of a split leaf as well.
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (!m_nodes[i].isLeaf() || sampleCounts[i] <= threshold) {
+            continue;
+        }
+
+        const auto firstChild = static_cast<uint32_t>(m_nodes.size());
+        const uint32_t leaf = m_nodes[i].leaf;
+        const uint32_t depth = m_nodes[i].depth + 1;
+        m_nodes[i].children = {firstChild, firstChild + 1};
+
+        Leaf copy = m_leaves[leaf];
+        m_nodes.push_back({.leaf = leaf, .depth = depth});
+        m_nodes.push_back({.leaf = static_cast<uint32_t>(m_leaves.size()), .depth = depth});
+        m_leaves.push_back(std::move(copy));
+        sampleCounts.insert(sampleCounts.end(), 2, sampleCounts[i] / 2);
+    }
+
+    tbb::parallel_for(size_t{0}, m_leaves.size(), [&](const size_t i) {
+        m_leaves[i].sampling = m_leaves[i].building;
+        m_leaves[i].building.refine(directionalThreshold);
+    });
+}
+
+uint32_t SDTree::findLeaf(const glm::vec3& p) const {
+    glm::vec3 local = glm::clamp((p - m_origin) / m_size, 0.0f, 1.0f);
+    uint32_t index = 0;
+    while (!m_nodes[index].isLeaf()) {
+        const Node& node = m_nodes[index];
+        const uint32_t axis = node.depth % 3;
+        if (local[axis] < 0.5f) {
+            local[axis] *= 2.0f;
+            index = node.children[0];
+        } else {
+            local[axis] = 2.0f * local[axis] - 1.0f;
+            index = node.children[1];
+        }
+    }
+
+    return m_nodes[index].leaf;
+}
+} // namespace crisp
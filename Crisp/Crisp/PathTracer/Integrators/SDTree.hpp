@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Crisp/Math/BoundingBox.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace crisp {
+// Quadtree over the directions at a point, after Mueller et al., "Practical Path Guiding for Efficient Light-Transport
+// Simulation". Directions map to the unit square through the area-preserving cylindrical coordinates
+// ((cos theta + 1) / 2, phi / 2 pi), so a density over the square is 4 pi times the density over the sphere. Every
+// node stores the radiance recorded in each of its quadrants, and directions are sampled proportionally to it.
+// Recording only adds to the sums atomically, so any number of threads can train a tree without locks.
+class DTree {
+public:
+    static constexpr uint32_t kMaxDepth = 20;
+
+    DTree();
+    DTree(const DTree& other);
+    DTree& operator=(const DTree& other);
+
+    // Adds a radiance estimate to every node on the path of the world-space direction. Thread-safe.
+    void record(const glm::vec3& direction, float radiance);
+
+    // Solid angle density of sample(), uniform until radiance has been recorded.
+    float pdf(const glm::vec3& direction) const;
+    glm::vec3 sample(glm::vec2 sample) const;
+
+    uint64_t getSampleCount() const;
+    float getRadianceSum() const;
+    size_t getNodeCount() const;
+
+    // Rebuilds the tree so that every quadrant holding more than the given fraction of the recorded radiance is a
+    // subdivided node, and all others are leaves. The recorded radiance and sample count are cleared.
+    void refine(float subdivisionThreshold, uint32_t maxDepth = kMaxDepth);
+
+    static glm::vec2 toCanonical(const glm::vec3& direction);
+    static glm::vec3 toDirection(const glm::vec2& canonical);
+
+private:
+    struct Node {
+        std::array<std::atomic<float>, 4> sums{};
+        std::array<uint32_t, 4> children{}; // Zero for quadrants that are leaves, since the root is nobody's child.
+
+        Node() = default;
+        Node(const Node& other);
+        Node& operator=(const Node& other);
+
+        std::array<float, 4> loadSums() const;
+        float getSum() const;
+    };
+
+    std::vector<Node> m_nodes;
+    std::atomic<uint64_t> m_sampleCount{0};
+};
+
+// Binary tree over the scene bounds that splits the bounds in half along the x, y and z axes in turn. Each leaf owns
+// the directional tree sampled during the current training iteration, and the one recording radiance for the next.
+class SDTree {
+public:
+    struct Leaf {
+        DTree sampling;
+        DTree building;
+    };
+
+    explicit SDTree(const BoundingBox3& bounds);
+
+    Leaf& getLeaf(const glm::vec3& p);
+    const Leaf& getLeaf(const glm::vec3& p) const;
+    size_t getLeafCount() const;
+
+    // Ends a training iteration. Leaves that recorded more than spatialThreshold samples are split until the samples,
+    // assumed to be spread evenly, fall below it. The recorded trees then become the sampling trees, and the
+    // recording trees are refined to match the radiance they saw.
+    void refine(uint64_t spatialThreshold, float directionalThreshold);
+
+private:
+    struct Node {
+        std::array<uint32_t, 2> children{}; // Zero for leaves.
+        uint32_t leaf{0};
+        uint32_t depth{0};
+
+        bool isLeaf() const {
+            return children[0] == 0;
+        }
+    };
+
+    uint32_t findLeaf(const glm::vec3& p) const;
+
+    glm::vec3 m_origin;
+    float m_size;
+    std::vector<Node> m_nodes;
+    std::vector<Leaf> m_leaves;
+};
+} // namespace crisp
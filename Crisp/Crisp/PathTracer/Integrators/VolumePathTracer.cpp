@@ -59,7 +59,7 @@ Spectrum evalTransmittance(
 
         auto bsdf = its.shape->getBSDF();
         glm::vec3 localWi = its.shFrame.toLocal(shadowRay.d);
-        BSDF::Sample sample(its.p, its.uv, localWi, -localWi);
+        BSDF::Sample sample(its, localWi, -localWi);
         transmittance *= bsdf->eval(sample);
 
         medium = resolveNextMedium(its, dir);
@@ -77,7 +77,9 @@ Spectrum evalTransmittance(
 
 Spectrum sampleLightFromMedium(
     Light::Sample& lightSample, const pt::Scene* scene, const Medium* medium, Sampler& sampler) {
-    auto light = scene->getRandomLight(sampler.next1D());
+    // Points in a medium have no surface normal to weigh the lights by.
+    float pickPmf = 0.0f;
+    auto light = scene->pickLight(lightSample.ref, glm::vec3(0.0f), sampler.next1D(), pickPmf);
     if (!light) {
         return Spectrum(0.0f);
     }
@@ -88,8 +90,8 @@ Spectrum sampleLightFromMedium(
     }
 
     lightContrib *= evalTransmittance(scene, lightSample.ref, false, lightSample.p, true, medium, sampler);
-    lightContrib /= scene->getLightPdf();
-    lightSample.pdf *= scene->getLightPdf();
+    lightContrib /= pickPmf;
+    lightSample.pdf *= pickPmf;
     lightSample.light = light;
     return lightContrib;
 }
@@ -0,0 +1,426 @@
+#include <Crisp/PathTracer/Integrators/WavefrontPathTracer.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <typeindex>
+#include <typeinfo>
+
+#include <Crisp/PathTracer/BSDFs/BSDF.hpp>
+#include <Crisp/PathTracer/BSSRDFs/BSSRDF.hpp>
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
+#include <Crisp/PathTracer/Core/Scene.hpp>
+#include <Crisp/PathTracer/Samplers/Sampler.hpp>
+#include <Crisp/PathTracer/Shapes/Shape.hpp>
+
+namespace crisp {
+namespace {
+inline float miWeight(float pdf1, float pdf2) {
+    pdf1 *= pdf1;
+    pdf2 *= pdf2;
+    return pdf1 / (pdf1 + pdf2);
+}
+
+// Paths that are still being traced. Index k of every array refers to the same path.
+struct PathQueue {
+    std::vector<uint32_t> pathIds; // Index of the radiance estimate the path contributes to
+    std::vector<Ray3> rays;
+    std::vector<Intersection> hits;
+    std::vector<Spectrum> throughputs;
+    std::vector<uint32_t> bounces;
+    std::vector<uint8_t> specularBounces;
+    std::vector<SampleState> sampleStates; // Where the path's sample sequence continues
+
+    void clear() {
+        pathIds.clear();
+        rays.clear();
+        hits.clear();
+        throughputs.clear();
+        bounces.clear();
+        specularBounces.clear();
+        sampleStates.clear();
+    }
+
+    size_t size() const {
+        return pathIds.size();
+    }
+
+    void push(
+        const uint32_t pathId,
+        const Ray3& ray,
+        const Intersection& its,
+        const Spectrum& throughput,
+        const uint32_t bounce,
+        const bool specularBounce,
+        const SampleState& sampleState) {
+        pathIds.push_back(pathId);
+        rays.push_back(ray);
+        hits.push_back(its);
+        throughputs.push_back(throughput);
+        bounces.push_back(bounce);
+        specularBounces.push_back(specularBounce ? 1 : 0);
+        sampleStates.push_back(sampleState);
+    }
+
+    // Moves path k into slot dst, used to compact the queue in place.
+    void move(const size_t k, const size_t dst) {
+        pathIds[dst] = pathIds[k];
+        rays[dst] = rays[k];
+        throughputs[dst] = throughputs[k];
+        bounces[dst] = bounces[k];
+        specularBounces[dst] = specularBounces[k];
+        sampleStates[dst] = sampleStates[k];
+    }
+
+    void resize(const size_t count) {
+        pathIds.resize(count);
+        rays.resize(count);
+        hits.resize(count);
+        throughputs.resize(count);
+        bounces.resize(count);
+        specularBounces.resize(count);
+        sampleStates.resize(count);
+    }
+};
+
+// Light-sampled connections. The contribution already includes throughput, BSDF, MIS weight and light pick pdf and
+// is added if the shadow ray turns out to be unoccluded.
+struct ShadowQueue {
+    std::vector<uint32_t> pathIds;
+    std::vector<Ray3> rays;
+    std::vector<Spectrum> contributions;
+    std::vector<uint8_t> occluded;
+
+    void clear() {
+        pathIds.clear();
+        rays.clear();
+        contributions.clear();
+    }
+};
+
+// BSDF-sampled rays of the MIS direct lighting estimate, weighted against the light that was picked for the vertex.
+struct MisQueue {
+    std::vector<uint32_t> pathIds;
+    std::vector<Ray3> rays;
+    std::vector<Intersection> hits;
+    std::vector<Spectrum> weightedBsdfs; // Throughput * f / lightPickPdf
+    std::vector<float> bsdfPdfs;
+    std::vector<uint8_t> sampledSpecular;
+    std::vector<const Light*> lights;
+    std::vector<SampleState> sampleStates; // Identifies the camera sample, and with it the spectrum's wavelengths
+
+    void clear() {
+        pathIds.clear();
+        rays.clear();
+        weightedBsdfs.clear();
+        bsdfPdfs.clear();
+        sampledSpecular.clear();
+        lights.clear();
+        sampleStates.clear();
+    }
+};
+
+struct WavefrontQueues {
+    PathQueue current;
+    PathQueue next;
+    ShadowQueue shadow;
+    MisQueue mis;
+    std::vector<uint32_t> shadeOrder;
+};
+
+// Adds emission seen directly by the camera or through a specular bounce, and selects the paths that go on to be
+// shaded. The selection is sorted by BSDF type so that the shading stage runs one BSDF implementation at a time.
+void gatherEmission(
+    const pt::Scene& scene,
+    const PathQueue& paths,
+    const unsigned int maxDepth,
+    std::span<Spectrum> radiance,
+    std::vector<uint32_t>& shadeOrder) {
+    shadeOrder.clear();
+    for (uint32_t k = 0; k < paths.size(); ++k) {
+        const Intersection& its = paths.hits[k];
+        const Ray3& ray = paths.rays[k];
+        const bool foundIntersection = its.shape != nullptr;
+        if (paths.bounces[k] == 0 || paths.specularBounces[k]) {
+            Spectrum::beginSample(paths.sampleStates[k].pixel, paths.sampleStates[k].sampleIndex);
+            if (foundIntersection) {
+                if (auto light = its.shape->getLight()) {
+                    Light::Sample lightSample(ray.o, its.p, its.shFrame.n);
+                    radiance[paths.pathIds[k]] += paths.throughputs[k] * light->eval(lightSample);
+                }
+            } else {
+                radiance[paths.pathIds[k]] += paths.throughputs[k] * scene.evalEnvLight(ray);
+            }
+        }
+
+        if (foundIntersection && paths.bounces[k] < maxDepth) {
+            shadeOrder.push_back(k);
+        } else {
+            RenderCounters::addPath(paths.bounces[k], false);
+        }
+    }
+
+    // Shapes that share a BSDF type run the same code even when their instances differ, so the type is the key.
+    const auto getBsdfType = [&paths](const uint32_t k) {
+        return std::type_index(typeid(*paths.hits[k].shape->getBSDF()));
+    };
+    std::stable_sort(shadeOrder.begin(), shadeOrder.end(), [&getBsdfType](const uint32_t a, const uint32_t b) {
+        return getBsdfType(a) < getBsdfType(b);
+    });
+}
+
+// Picks one light and queues both halves of the MIS estimate for it.
+void sampleDirectLighting(
+    const pt::Scene& scene,
+    Sampler& sampler,
+    const uint32_t pathId,
+    const Ray3& ray,
+    const Intersection& its,
+    const Spectrum& throughput,
+    ShadowQueue& shadowQueue,
+    MisQueue& misQueue) {
+    float pickPmf = 0.0f;
+    const Light* light = scene.pickLight(its.p, its.shFrame.n, sampler.next1D(), pickPmf);
+    if (!light) {
+        return;
+    }
+
+    const BSDF* bsdf = its.shape->getBSDF();
+    const Spectrum weightedThroughput = throughput / pickPmf;
+
+    Light::Sample lightSample(its.p);
+    const Spectrum Li = light->sample(lightSample, sampler);
+    if (lightSample.pdf > 0.0f && !Li.isZero()) {
+        BSDF::Sample bsdfSample(its, its.toLocal(-ray.d), its.toLocal(lightSample.wi));
+        bsdfSample.measure = BSDF::Measure::SolidAngle;
+        bsdfSample.eta = 1.0f;
+        const Spectrum f = bsdf->eval(bsdfSample);
+        const float bsdfPdf = bsdf->pdf(bsdfSample);
+        if (!f.isZero() && bsdfPdf > 0.0f) {
+            const float weight = light->isDelta() ? 1.0f : miWeight(lightSample.pdf, bsdfPdf);
+            shadowQueue.pathIds.push_back(pathId);
+            shadowQueue.rays.push_back(lightSample.shadowRay);
+            shadowQueue.contributions.push_back(weightedThroughput * f * Li * weight);
+        }
+    }
+
+    if (!light->isDelta()) {
+        BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
+        const Spectrum f = bsdf->sample(bsdfSample, sampler);
+        if (!f.isZero() && bsdfSample.pdf > 0.0f) {
+            misQueue.pathIds.push_back(pathId);
+            misQueue.rays.emplace_back(its.p, its.toWorld(bsdfSample.wo));
+            misQueue.weightedBsdfs.push_back(weightedThroughput * f);
+            misQueue.bsdfPdfs.push_back(bsdfSample.pdf);
+            misQueue.sampledSpecular.push_back(bsdfSample.sampledLobe == Lobe::Delta ? 1 : 0);
+            misQueue.lights.push_back(light);
+            misQueue.sampleStates.push_back(sampler.getSampleState());
+        }
+    }
+}
+
+// Runs next-event estimation and samples the continuation direction of every selected path.
+void shade(
+    const pt::Scene& scene,
+    Sampler& sampler,
+    const PathQueue& paths,
+    const std::vector<uint32_t>& shadeOrder,
+    WavefrontQueues& queues) {
+    queues.next.clear();
+    queues.shadow.clear();
+    queues.mis.clear();
+    for (const uint32_t k : shadeOrder) {
+        const Intersection& its = paths.hits[k];
+        const Ray3& ray = paths.rays[k];
+        const BSDF* bsdf = its.shape->getBSDF();
+        sampler.setSampleState(paths.sampleStates[k]);
+
+        if (!(bsdf->getLobeType() & Lobe::Delta)) {
+            sampleDirectLighting(
+                scene, sampler, paths.pathIds[k], ray, its, paths.throughputs[k], queues.shadow, queues.mis);
+        }
+
+        BSDF::Sample bsdfSample(its, its.toLocal(-ray.d));
+        const Spectrum f = bsdf->sample(bsdfSample, sampler);
+        if (f.isZero() || bsdfSample.pdf == 0.0f) {
+            RenderCounters::addPath(paths.bounces[k], false);
+            continue;
+        }
+        RenderCounters::addBsdfSample(static_cast<uint32_t>(bsdfSample.sampledLobe));
+
+        queues.next.pathIds.push_back(paths.pathIds[k]);
+        queues.next.rays.emplace_back(its.p, its.toWorld(bsdfSample.wo));
+        queues.next.throughputs.push_back(paths.throughputs[k] * f);
+        queues.next.bounces.push_back(paths.bounces[k]);
+        queues.next.specularBounces.push_back(bsdfSample.sampledLobe == Lobe::Delta ? 1 : 0);
+        queues.next.sampleStates.push_back(sampler.getSampleState());
+    }
+}
+
+// Terminates paths probabilistically past rrDepth bounces and compacts the survivors in place.
+void russianRoulette(Sampler& sampler, const unsigned int rrDepth, PathQueue& paths) {
+    size_t survivors = 0;
+    for (size_t k = 0; k < paths.size(); ++k) {
+        if (paths.bounces[k] > rrDepth) {
+            const float q = 1.0f - std::min(paths.throughputs[k].maxCoeff(), 0.99f);
+            sampler.setSampleState(paths.sampleStates[k]);
+            if (sampler.next1D() < q) {
+                RenderCounters::addPath(paths.bounces[k], true);
+                continue;
+            }
+            paths.sampleStates[k] = sampler.getSampleState();
+
+            paths.throughputs[k] /= (1.0f - q);
+        }
+
+        paths.move(k, survivors);
+        ++paths.bounces[survivors];
+        ++survivors;
+    }
+
+    paths.resize(survivors);
+}
+
+void connectShadowRays(const pt::Scene& scene, ShadowQueue& shadowQueue, std::span<Spectrum> radiance) {
+    shadowQueue.occluded.resize(shadowQueue.rays.size());
+    scene.rayIntersect(shadowQueue.rays, shadowQueue.occluded);
+    for (size_t k = 0; k < shadowQueue.rays.size(); ++k) {
+        if (!shadowQueue.occluded[k]) {
+            radiance[shadowQueue.pathIds[k]] += shadowQueue.contributions[k];
+        }
+    }
+}
+
+void traceMisRays(const pt::Scene& scene, MisQueue& misQueue, std::span<Spectrum> radiance) {
+    misQueue.hits.resize(misQueue.rays.size());
+    scene.rayIntersect(misQueue.rays, misQueue.hits);
+
+    const Light* envLight = scene.getEnvironmentLight();
+    for (size_t k = 0; k < misQueue.rays.size(); ++k) {
+        const Ray3& bsdfRay = misQueue.rays[k];
+        const Intersection& bsdfIts = misQueue.hits[k];
+        const Light* light = misQueue.lights[k];
+        const bool foundIntersection = bsdfIts.shape != nullptr;
+        Spectrum::beginSample(misQueue.sampleStates[k].pixel, misQueue.sampleStates[k].sampleIndex);
+
+        float weight = 1.0f;
+        if (!misQueue.sampledSpecular[k]) {
+            if (!foundIntersection) {
+                if (!envLight) {
+                    continue;
+                }
+
+                Light::Sample envLightSample(bsdfRay.o, bsdfIts.p, bsdfIts.shFrame.n);
+                envLightSample.wi = bsdfRay.d;
+                weight = miWeight(misQueue.bsdfPdfs[k], envLight->pdf(envLightSample));
+            } else if (bsdfIts.shape->getLight() == light) {
+                Light::Sample lightSample(bsdfRay.o, bsdfIts.p, bsdfIts.shFrame.n);
+                lightSample.wi = bsdfRay.d;
+                weight = miWeight(misQueue.bsdfPdfs[k], light->pdf(lightSample));
+            } else {
+                continue;
+            }
+        }
+
+        Spectrum bLi(0.0f);
+        if (foundIntersection) {
+            if (bsdfIts.shape->getLight() == light) {
+                Light::Sample lightSample(bsdfRay.o, bsdfIts.p, bsdfIts.shFrame.n);
+                lightSample.wi = bsdfRay.d;
+                bLi = light->eval(lightSample);
+            }
+        } else if (envLight) {
+            Light::Sample lightSample(bsdfRay.o, bsdfIts.p, bsdfIts.shFrame.n);
+            lightSample.wi = bsdfRay.d;
+            bLi = envLight->eval(lightSample);
+        }
+
+        if (!bLi.isZero()) {
+            radiance[misQueue.pathIds[k]] += misQueue.weightedBsdfs[k] * bLi * weight;
+        }
+    }
+}
+
+void extend(const pt::Scene& scene, PathQueue& paths) {
+    paths.hits.resize(paths.rays.size());
+    scene.rayIntersect(paths.rays, paths.hits);
+}
+} // namespace
+
+WavefrontPathTracerIntegrator::WavefrontPathTracerIntegrator(const VariantMap& attribs) {
+    m_rrDepth = static_cast<unsigned int>(attribs.get<int>("rrDepth", 5));
+    m_maxDepth = static_cast<unsigned int>(attribs.get<int>("maxDepth", std::numeric_limits<int>::max()));
+}
+
+WavefrontPathTracerIntegrator::~WavefrontPathTracerIntegrator() {}
+
+void WavefrontPathTracerIntegrator::preprocess(pt::Scene* scene) {
+    for (auto& shape : scene->getShapes()) {
+        if (shape->getBSSRDF()) {
+            shape->getBSSRDF()->preprocess(shape.get(), scene);
+        }
+    }
+}
+
+Spectrum WavefrontPathTracerIntegrator::Li(
+    const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags illumFlags) const {
+    Intersection its;
+    scene->rayIntersect(ray, its);
+    return LiFromPrimaryHit(scene, sampler, ray, its, illumFlags);
+}
+
+Spectrum WavefrontPathTracerIntegrator::LiFromPrimaryHit(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    Ray3& ray,
+    const Intersection& primaryIts,
+    IlluminationFlags /*illumFlags*/) const {
+    Spectrum radiance(0.0f);
+    const SampleState sampleState = sampler.getSampleState();
+    LiBatch(
+        scene,
+        sampler,
+        std::span(&sampleState, 1),
+        std::span(&ray, 1),
+        std::span(&primaryIts, 1),
+        std::span(&radiance, 1));
+    return radiance;
+}
+
+void WavefrontPathTracerIntegrator::LiBatch(
+    const pt::Scene* scene,
+    Sampler& sampler,
+    std::span<const SampleState> sampleStates,
+    std::span<Ray3> rays,
+    std::span<const Intersection> primaryHits,
+    std::span<Spectrum> radiance) const {
+    thread_local WavefrontQueues queues;
+
+    queues.current.clear();
+    for (uint32_t i = 0; i < rays.size(); ++i) {
+        radiance[i] = Spectrum(0.0f);
+        queues.current.push(i, rays[i], primaryHits[i], Spectrum(1.0f), 0, false, sampleStates[i]);
+    }
+
+    while (queues.current.size() > 0) {
+        {
+            const ScopedRenderStage stage(RenderStage::Shading);
+            gatherEmission(*scene, queues.current, m_maxDepth, radiance, queues.shadeOrder);
+            shade(*scene, sampler, queues.current, queues.shadeOrder, queues);
+            russianRoulette(sampler, m_rrDepth, queues.next);
+        }
+        {
+            const ScopedRenderStage stage(RenderStage::ShadowRays);
+            connectShadowRays(*scene, queues.shadow, radiance);
+        }
+        {
+            const ScopedRenderStage stage(RenderStage::MisRays);
+            traceMisRays(*scene, queues.mis, radiance);
+        }
+        {
+            const ScopedRenderStage stage(RenderStage::ExtensionRays);
+            extend(*scene, queues.next);
+        }
+        std::swap(queues.current, queues.next);
+    }
+}
+} // namespace crisp
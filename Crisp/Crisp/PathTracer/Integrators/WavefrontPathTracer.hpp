@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Crisp/PathTracer/Integrators/Integrator.hpp>
+
+namespace crisp {
+
+// Breadth-first variant of MisPathTracerIntegrator. All paths of a batch advance one bounce at a time through
+// separate stages that operate on structure-of-arrays queues: emission gathering, shading sorted by BSDF type,
+// Russian roulette, batched shadow connections, batched MIS rays and the batched extension of the surviving paths.
+// It evaluates the same estimator as MisPathTracerIntegrator, only the order in which samples are drawn differs.
+class WavefrontPathTracerIntegrator : public Integrator {
+public:
+    WavefrontPathTracerIntegrator(const VariantMap& attributes);
+    virtual ~WavefrontPathTracerIntegrator();
+
+    virtual void preprocess(pt::Scene* scene) override;
+    virtual Spectrum Li(
+        const pt::Scene* scene, Sampler& sampler, Ray3& ray, IlluminationFlags flags = Illumination::Full) const override;
+    virtual Spectrum LiFromPrimaryHit(
+        const pt::Scene* scene,
+        Sampler& sampler,
+        Ray3& ray,
+        const Intersection& primaryIts,
+        IlluminationFlags flags = Illumination::Full) const override;
+    virtual void LiBatch(
+        const pt::Scene* scene,
+        Sampler& sampler,
+        std::span<const SampleState> sampleStates,
+        std::span<Ray3> rays,
+        std::span<const Intersection> primaryHits,
+        std::span<Spectrum> radiance) const override;
+
+private:
+    unsigned int m_rrDepth;
+    unsigned int m_maxDepth;
+};
+} // namespace crisp
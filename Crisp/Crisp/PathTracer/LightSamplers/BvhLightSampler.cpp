@@ -0,0 +1,221 @@
+#include <Crisp/PathTracer/LightSamplers/BvhLightSampler.hpp>
+
+#include <Crisp/Math/Constants.hpp>
+#include <Crisp/PathTracer/Lights/Light.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace crisp {
+namespace {
+constexpr int kBucketCount = 12;
+
+// Splits below this depth fall back to halving the light count, which keeps every bit trail within 64 bits.
+constexpr int kMaxSahDepth = 32;
+
+constexpr float kOneMinusEpsilon = 0x1.fffffep-1f;
+
+// Surface area heuristic extended with the solid angle of the emission, after Conty Estevez and Kulla.
+float evaluateSplitCost(const LightBounds& bounds, const BoundingBox3& parentBounds, const int axis) {
+    if (bounds.phi == 0.0f) {
+        return 0.0f;
+    }
+
+    const float thetaO = std::acos(std::clamp(bounds.cosThetaO, -1.0f, 1.0f));
+    const float thetaE = std::acos(std::clamp(bounds.cosThetaE, -1.0f, 1.0f));
+    const float thetaW = std::min(thetaO + thetaE, PI<>);
+    const float sinThetaO = std::sqrt(std::max(1.0f - bounds.cosThetaO * bounds.cosThetaO, 0.0f));
+    const float solidAngle = 2.0f * PI<> * (1.0f - bounds.cosThetaO) +
+                             PI<> / 2.0f *
+                                 (2.0f * thetaW * sinThetaO - std::cos(thetaO - 2.0f * thetaW) -
+                                  2.0f * thetaO * sinThetaO + bounds.cosThetaO);
+
+    // Penalizes thin slabs, which would otherwise look cheap because of their small surface area.
+    const glm::vec3 extents = parentBounds.getExtents();
+    const float aspect = extents[axis] > 0.0f ? parentBounds.getMaximumExtent() / extents[axis] : 1.0f;
+    return bounds.phi * solidAngle * aspect * bounds.bounds.getSurfaceArea();
+}
+} // namespace
+
+BvhLightSampler::BvhLightSampler(const VariantMap& /*params*/) {}
+
+void BvhLightSampler::build(const std::span<Light* const> lights) {
+    m_lights.clear();
+    m_infiniteLights.clear();
+    m_nodes.clear();
+    m_bitTrails.clear();
+
+    std::vector<BuildLight> boundedLights;
+    for (Light* light : lights) {
+        const std::optional<LightBounds> bounds = light->getBounds();
+        if (!bounds) {
+            m_infiniteLights.push_back(light);
+        } else if (bounds->phi > 0.0f) {
+            boundedLights.push_back({static_cast<uint32_t>(m_lights.size()), *bounds});
+            m_lights.push_back(light);
+        }
+    }
+
+    if (!boundedLights.empty()) {
+        m_nodes.reserve(2 * boundedLights.size() - 1);
+        buildNodes(boundedLights, 0, 0);
+    }
+}
+
+uint32_t BvhLightSampler::buildNodes(const std::span<BuildLight> lights, const uint64_t bitTrail, const int depth) {
+    const auto nodeIndex = static_cast<uint32_t>(m_nodes.size());
+    if (lights.size() == 1) {
+        m_nodes.push_back({lights.front().bounds, lights.front().lightIndex, true});
+        m_bitTrails.emplace(m_lights[lights.front().lightIndex], bitTrail);
+        return nodeIndex;
+    }
+
+    BoundingBox3 bounds;
+    BoundingBox3 centroidBounds;
+    for (const auto& light : lights) {
+        bounds.expandBy(light.bounds.bounds);
+        centroidBounds.expandBy(light.bounds.bounds.getCenter());
+    }
+
+    // Bucketed SAH over the centroids of the light bounds, on every axis with a non-degenerate extent.
+    float minCost = std::numeric_limits<float>::infinity();
+    int minCostAxis = -1;
+    int minCostBucket = -1;
+    const glm::vec3 centroidExtents = centroidBounds.getExtents();
+    const auto getBucket = [&](const BuildLight& light, const int axis) {
+        const float offset = (light.bounds.bounds.getCenter()[axis] - centroidBounds.min[axis]) / centroidExtents[axis];
+        return std::min(static_cast<int>(offset * kBucketCount), kBucketCount - 1);
+    };
+    for (int axis = 0; axis < 3 && depth < kMaxSahDepth; ++axis) {
+        if (centroidExtents[axis] <= 0.0f) {
+            continue;
+        }
+
+        std::array<LightBounds, kBucketCount> buckets{};
+        for (const auto& light : lights) {
+            LightBounds& bucket = buckets[getBucket(light, axis)];
+            bucket = merge(bucket, light.bounds);
+        }
+
+        for (int split = 0; split < kBucketCount - 1; ++split) {
+            LightBounds below{};
+            LightBounds above{};
+            for (int i = 0; i <= split; ++i) {
+                below = merge(below, buckets[i]);
+            }
+            for (int i = split + 1; i < kBucketCount; ++i) {
+                above = merge(above, buckets[i]);
+            }
+
+            const float cost = evaluateSplitCost(below, bounds, axis) + evaluateSplitCost(above, bounds, axis);
+            if (cost > 0.0f && cost < minCost) {
+                minCost = cost;
+                minCostAxis = axis;
+                minCostBucket = split;
+            }
+        }
+    }
+
+    size_t mid = 0;
+    if (minCostAxis != -1) {
+        const auto iter = std::partition(lights.begin(), lights.end(), [&](const BuildLight& light) {
+            return getBucket(light, minCostAxis) <= minCostBucket;
+        });
+        mid = static_cast<size_t>(iter - lights.begin());
+    }
+    if (mid == 0 || mid == lights.size()) {
+        mid = lights.size() / 2;
+        const int axis = bounds.getMajorAxis();
+        std::nth_element(lights.begin(), lights.begin() + mid, lights.end(), [axis](const auto& a, const auto& b) {
+            return a.bounds.bounds.getCenter()[axis] < b.bounds.bounds.getCenter()[axis];
+        });
+    }
+
+    m_nodes.push_back({});
+    buildNodes(lights.subspan(0, mid), bitTrail, depth + 1);
+    const uint32_t secondChild = buildNodes(lights.subspan(mid), bitTrail | (uint64_t{1} << depth), depth + 1);
+    m_nodes[nodeIndex] = {
+        merge(m_nodes[nodeIndex + 1].bounds, m_nodes[secondChild].bounds),
+        secondChild,
+        false,
+    };
+    return nodeIndex;
+}
+
+float BvhLightSampler::getInfiniteLightProbability() const {
+    const size_t boundedCount = m_nodes.empty() ? 0 : 1;
+    const size_t totalCount = m_infiniteLights.size() + boundedCount;
+    return totalCount == 0 ? 0.0f : static_cast<float>(m_infiniteLights.size()) / static_cast<float>(totalCount);
+}
+
+Light* BvhLightSampler::sample(const glm::vec3& p, const glm::vec3& n, float u, float& pmf) const {
+    const float infiniteProbability = getInfiniteLightProbability();
+    if (u < infiniteProbability) {
+        const auto count = static_cast<float>(m_infiniteLights.size());
+        const auto index = std::min(static_cast<size_t>(u / infiniteProbability * count), m_infiniteLights.size() - 1);
+        pmf = infiniteProbability / count;
+        return m_infiniteLights[index];
+    }
+
+    if (m_nodes.empty()) {
+        return nullptr;
+    }
+
+    u = std::min((u - infiniteProbability) / (1.0f - infiniteProbability), kOneMinusEpsilon);
+    float nodePmf = 1.0f - infiniteProbability;
+    uint32_t nodeIndex = 0;
+    while (!m_nodes[nodeIndex].isLeaf) {
+        const uint32_t children[2] = {nodeIndex + 1, m_nodes[nodeIndex].childOrLightIndex};
+        const float importance0 = m_nodes[children[0]].bounds.importance(p, n);
+        const float importance1 = m_nodes[children[1]].bounds.importance(p, n);
+        if (importance0 == 0.0f && importance1 == 0.0f) {
+            return nullptr;
+        }
+
+        const float probability0 = importance0 / (importance0 + importance1);
+        if (u < probability0) {
+            nodeIndex = children[0];
+            u = std::min(u / probability0, kOneMinusEpsilon);
+            nodePmf *= probability0;
+        } else {
+            nodeIndex = children[1];
+            u = std::min((u - probability0) / (1.0f - probability0), kOneMinusEpsilon);
+            nodePmf *= 1.0f - probability0;
+        }
+    }
+
+    // A lone light at the root has no sibling to be weighed against, so its importance is checked here instead.
+    const Node& leaf = m_nodes[nodeIndex];
+    if (nodeIndex == 0 && leaf.bounds.importance(p, n) == 0.0f) {
+        return nullptr;
+    }
+    pmf = nodePmf;
+    return m_lights[leaf.childOrLightIndex];
+}
+
+float BvhLightSampler::pmf(const glm::vec3& p, const glm::vec3& n, const Light* light) const {
+    const auto trail = m_bitTrails.find(light);
+    if (trail == m_bitTrails.end()) {
+        const bool isInfinite = std::ranges::find(m_infiniteLights, light) != m_infiniteLights.end();
+        return isInfinite ? getInfiniteLightProbability() / static_cast<float>(m_infiniteLights.size()) : 0.0f;
+    }
+
+    uint64_t bitTrail = trail->second;
+    float pmf = 1.0f - getInfiniteLightProbability();
+    uint32_t nodeIndex = 0;
+    while (!m_nodes[nodeIndex].isLeaf) {
+        const uint32_t children[2] = {nodeIndex + 1, m_nodes[nodeIndex].childOrLightIndex};
+        const float importance0 = m_nodes[children[0]].bounds.importance(p, n);
+        const float importance1 = m_nodes[children[1]].bounds.importance(p, n);
+        if (importance0 == 0.0f && importance1 == 0.0f) {
+            return 0.0f;
+        }
+
+        const uint32_t child = bitTrail & 1;
+        pmf *= (child == 0 ? importance0 : importance1) / (importance0 + importance1);
+        nodeIndex = children[child];
+        bitTrail >>= 1;
+    }
+    return nodeIndex == 0 && m_nodes[0].bounds.importance(p, n) == 0.0f ? 0.0f : pmf;
+}
+} // namespace crisp
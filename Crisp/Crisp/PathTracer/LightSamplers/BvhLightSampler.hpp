@@ -0,0 +1,44 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <Crisp/PathTracer/Core/VariantMap.hpp>
+#include <Crisp/PathTracer/LightSamplers/LightSampler.hpp>
+#include <Crisp/PathTracer/Lights/LightBounds.hpp>
+
+namespace crisp {
+// Importance samples lights with respect to the shading point by descending a BVH over their spatial and directional
+// bounds, choosing each child in proportion to its estimated contribution. Lights at infinity are picked uniformly
+// with the same probability as the whole tree.
+class BvhLightSampler : public LightSampler {
+public:
+    BvhLightSampler(const VariantMap& params = VariantMap());
+
+    virtual void build(std::span<Light* const> lights) override;
+    virtual Light* sample(const glm::vec3& p, const glm::vec3& n, float u, float& pmf) const override;
+    virtual float pmf(const glm::vec3& p, const glm::vec3& n, const Light* light) const override;
+
+private:
+    struct Node {
+        LightBounds bounds;
+        uint32_t childOrLightIndex; // Second child of an interior node, whose first child follows it directly.
+        bool isLeaf;
+    };
+
+    struct BuildLight {
+        uint32_t lightIndex;
+        LightBounds bounds;
+    };
+
+    uint32_t buildNodes(std::span<BuildLight> lights, uint64_t bitTrail, int depth);
+    float getInfiniteLightProbability() const;
+
+    std::vector<Light*> m_lights;
+    std::vector<Light*> m_infiniteLights;
+    std::vector<Node> m_nodes;
+
+    // Path from the root to the leaf of each bounded light, one bit per level with 1 for the second child.
+    std::unordered_map<const Light*, uint64_t> m_bitTrails;
+};
+} // namespace crisp
@@ -0,0 +1,5 @@
+#include <Crisp/PathTracer/LightSamplers/LightSampler.hpp>
+
+namespace crisp {
+LightSampler::~LightSampler() {}
+} // namespace crisp
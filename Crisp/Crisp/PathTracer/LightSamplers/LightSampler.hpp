@@ -0,0 +1,25 @@
+#pragma once
+
+#include <span>
+
+#include <Crisp/Math/Headers.hpp>
+
+namespace crisp {
+class Light;
+
+// Chooses which light to sample for direct lighting at a shading point.
+class LightSampler {
+public:
+    virtual ~LightSampler();
+
+    // Called once the scene is complete, so that lights can report their power and bounds.
+    virtual void build(std::span<Light* const> lights) = 0;
+
+    // Picks a light for point p with surface normal n, which is zero for points in participating media. Returns
+    // nullptr if no light can contribute, and the probability of the choice in pmf otherwise.
+    virtual Light* sample(const glm::vec3& p, const glm::vec3& n, float u, float& pmf) const = 0;
+
+    // Probability with which sample() picks the light for the same point and normal.
+    virtual float pmf(const glm::vec3& p, const glm::vec3& n, const Light* light) const = 0;
+};
+} // namespace crisp
@@ -0,0 +1,23 @@
+#include <Crisp/PathTracer/LightSamplers/LightSamplerFactory.hpp>
+
+#include <Crisp/PathTracer/LightSamplers/BvhLightSampler.hpp>
+#include <Crisp/PathTracer/LightSamplers/PowerLightSampler.hpp>
+#include <Crisp/PathTracer/LightSamplers/UniformLightSampler.hpp>
+
+#include <iostream>
+
+namespace crisp {
+std::unique_ptr<LightSampler> LightSamplerFactory::create(std::string type, VariantMap parameters) {
+    if (type == "uniform") {
+        return std::make_unique<UniformLightSampler>(parameters);
+    } else if (type == "power") {
+        return std::make_unique<PowerLightSampler>(parameters);
+    } else if (type == "bvh") {
+        return std::make_unique<BvhLightSampler>(parameters);
+    } else {
+        std::cerr << "Unknown light sampler type \"" << type << "\" requested! Creating default power light sampler"
+                  << std::endl;
+        return std::make_unique<PowerLightSampler>(parameters);
+    }
+}
+} // namespace crisp
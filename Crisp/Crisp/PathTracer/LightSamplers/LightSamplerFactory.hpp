@@ -0,0 +1,14 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <Crisp/PathTracer/Core/VariantMap.hpp>
+#include <Crisp/PathTracer/LightSamplers/LightSampler.hpp>
+
+namespace crisp {
+class LightSamplerFactory {
+public:
+    static std::unique_ptr<LightSampler> create(std::string type, VariantMap parameters);
+};
+} // namespace crisp
@@ -0,0 +1,50 @@
+#include <Crisp/PathTracer/LightSamplers/PowerLightSampler.hpp>
+
+#include <Crisp/PathTracer/Lights/Light.hpp>
+
+#include <algorithm>
+
+namespace crisp {
+PowerLightSampler::PowerLightSampler(const VariantMap& /*params*/) {}
+
+void PowerLightSampler::build(const std::span<Light* const> lights) {
+    m_lights.assign(lights.begin(), lights.end());
+    m_lightIndices.clear();
+    m_pmfs.clear();
+    m_aliasTable.clear();
+    if (m_lights.empty()) {
+        return;
+    }
+
+    float totalPower = 0.0f;
+    for (uint32_t i = 0; i < m_lights.size(); ++i) {
+        m_pmfs.push_back(std::max(m_lights[i]->getPower().getLuminance(), 0.0f));
+        totalPower += m_pmfs.back();
+        m_lightIndices.emplace(m_lights[i], i);
+    }
+
+    // Without any measurable power there is nothing to prefer, so fall back to uniform selection.
+    for (float& pmf : m_pmfs) {
+        pmf = totalPower > 0.0f ? pmf / totalPower : 1.0f / static_cast<float>(m_lights.size());
+    }
+    m_aliasTable = createAliasTable(m_pmfs);
+}
+
+Light* PowerLightSampler::sample(const glm::vec3& /*p*/, const glm::vec3& /*n*/, const float u, float& pmf) const {
+    if (m_lights.empty()) {
+        return nullptr;
+    }
+
+    const float scaled = u * static_cast<float>(m_aliasTable.size());
+    const auto bin = std::min(static_cast<uint32_t>(scaled), static_cast<uint32_t>(m_aliasTable.size() - 1));
+    const AliasTableElement& element = m_aliasTable[bin];
+    const uint32_t index = scaled - static_cast<float>(bin) < element.tau ? bin : element.j;
+    pmf = m_pmfs[index];
+    return pmf > 0.0f ? m_lights[index] : nullptr;
+}
+
+float PowerLightSampler::pmf(const glm::vec3& /*p*/, const glm::vec3& /*n*/, const Light* light) const {
+    const auto iter = m_lightIndices.find(light);
+    return iter == m_lightIndices.end() ? 0.0f : m_pmfs[iter->second];
+}
+} // namespace crisp
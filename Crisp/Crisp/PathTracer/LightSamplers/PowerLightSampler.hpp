@@ -0,0 +1,26 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <Crisp/Math/AliasTable.hpp>
+#include <Crisp/PathTracer/Core/VariantMap.hpp>
+#include <Crisp/PathTracer/LightSamplers/LightSampler.hpp>
+
+namespace crisp {
+// Picks lights in proportion to their emitted power, in constant time through an alias table.
+class PowerLightSampler : public LightSampler {
+public:
+    PowerLightSampler(const VariantMap& params = VariantMap());
+
+    virtual void build(std::span<Light* const> lights) override;
+    virtual Light* sample(const glm::vec3& p, const glm::vec3& n, float u, float& pmf) const override;
+    virtual float pmf(const glm::vec3& p, const glm::vec3& n, const Light* light) const override;
+
+private:
+    std::vector<Light*> m_lights;
+    std::vector<float> m_pmfs;
+    AliasTable m_aliasTable;
+    std::unordered_map<const Light*, uint32_t> m_lightIndices;
+};
+} // namespace crisp
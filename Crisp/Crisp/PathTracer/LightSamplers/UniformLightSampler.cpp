@@ -0,0 +1,25 @@
+#include <Crisp/PathTracer/LightSamplers/UniformLightSampler.hpp>
+
+#include <algorithm>
+
+namespace crisp {
+UniformLightSampler::UniformLightSampler(const VariantMap& /*params*/) {}
+
+void UniformLightSampler::build(const std::span<Light* const> lights) {
+    m_lights.assign(lights.begin(), lights.end());
+}
+
+Light* UniformLightSampler::sample(const glm::vec3& /*p*/, const glm::vec3& /*n*/, const float u, float& pmf) const {
+    if (m_lights.empty()) {
+        return nullptr;
+    }
+
+    const auto index = std::min(static_cast<size_t>(u * static_cast<float>(m_lights.size())), m_lights.size() - 1);
+    pmf = 1.0f / static_cast<float>(m_lights.size());
+    return m_lights[index];
+}
+
+float UniformLightSampler::pmf(const glm::vec3& /*p*/, const glm::vec3& /*n*/, const Light* /*light*/) const {
+    return m_lights.empty() ? 0.0f : 1.0f / static_cast<float>(m_lights.size());
+}
+} // namespace crisp
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+
+#include <Crisp/PathTracer/Core/VariantMap.hpp>
+#include <Crisp/PathTracer/LightSamplers/LightSampler.hpp>
+
+namespace crisp {
+class UniformLightSampler : public LightSampler {
+public:
+    UniformLightSampler(const VariantMap& params = VariantMap());
+
+    virtual void build(std::span<Light* const> lights) override;
+    virtual Light* sample(const glm::vec3& p, const glm::vec3& n, float u, float& pmf) const override;
+    virtual float pmf(const glm::vec3& p, const glm::vec3& n, const Light* light) const override;
+
+private:
+    std::vector<Light*> m_lights;
+};
+} // namespace crisp
@@ -74,4 +74,19 @@ Spectrum AreaLight::samplePhoton(Ray3& ray, Sampler& sampler) const {
 bool AreaLight::isDelta() const {
     return false;
 }
+
+Spectrum AreaLight::getPower() const {
+    return m_radiance * PI<> * m_shape->getSurfaceArea();
+}
+
+std::optional<LightBounds> AreaLight::getBounds() const {
+    const DirectionCone normals = m_shape->getNormalBounds();
+    LightBounds bounds{};
+    bounds.bounds = m_shape->getBoundingBox();
+    bounds.w = normals.w;
+    bounds.phi = getPower().getLuminance();
+    bounds.cosThetaO = normals.cosTheta;
+    bounds.cosThetaE = 0.0f;
+    return bounds;
+}
 } // namespace crisp
\ No newline at end of file
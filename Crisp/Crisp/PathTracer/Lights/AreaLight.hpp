@@ -13,6 +13,8 @@ public:
 
     virtual Spectrum samplePhoton(Ray3& ray, Sampler& sampler) const override;
     virtual bool isDelta() const override;
+    virtual Spectrum getPower() const override;
+    virtual std::optional<LightBounds> getBounds() const override;
 
 private:
     Spectrum m_radiance;
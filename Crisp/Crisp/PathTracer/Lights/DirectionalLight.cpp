@@ -6,6 +6,7 @@ namespace crisp {
 DirectionalLight::DirectionalLight(const VariantMap& params) {
     m_direction = params.get<glm::vec3>("direction", glm::vec3(1.0f, -1.0f, 0.0f));
     m_power = params.get("power", Spectrum(500.0f));
+    m_sceneRadius = 0.0f;
 }
 
 DirectionalLight::~DirectionalLight() {}
@@ -34,4 +35,13 @@ Spectrum DirectionalLight::samplePhoton(Ray3& /*ray*/, Sampler& /*sampler*/) con
 bool DirectionalLight::isDelta() const {
     return true;
 }
+
+void DirectionalLight::setBoundingSphere(const glm::vec4& sphereParams) {
+    m_sceneRadius = sphereParams.w;
+}
+
+Spectrum DirectionalLight::getPower() const {
+    // The irradiance falls onto the disk of the scene's bounding sphere.
+    return m_power * PI<> * m_sceneRadius * m_sceneRadius;
+}
 } // namespace crisp
\ No newline at end of file
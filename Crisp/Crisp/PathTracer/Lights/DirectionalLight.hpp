@@ -14,9 +14,12 @@ public:
 
     virtual Spectrum samplePhoton(Ray3& ray, Sampler& sampler) const override;
     virtual bool isDelta() const override;
+    virtual Spectrum getPower() const override;
+    virtual void setBoundingSphere(const glm::vec4& sphereParams) override;
 
 private:
     glm::vec3 m_direction;
     Spectrum m_power;
+    float m_sceneRadius;
 };
 } // namespace crisp
\ No newline at end of file
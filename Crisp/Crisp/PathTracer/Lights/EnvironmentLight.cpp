@@ -1,6 +1,5 @@
 #include <Crisp/PathTracer/Lights/EnvironmentLight.hpp>
 
-#include <Crisp/Math/Distribution1D.hpp>
 #include <Crisp/Math/Operations.hpp>
 #include <Crisp/Math/Warp.hpp>
 
@@ -13,13 +12,6 @@
 
 namespace crisp {
 namespace {
-inline uint32_t sampleReuse(float* cdf, uint32_t size, float& sample) {
-    float* entry = std::lower_bound(cdf, cdf + size + 1, sample);
-    uint32_t index = std::min((uint32_t)std::max((ptrdiff_t)0, entry - cdf - 1), size - 1);
-    sample = (sample - cdf[index]) / (cdf[index + 1] - cdf[index]);
-    return index;
-}
-
 float intervalToTent(float sample) {
     float sign;
 
@@ -48,79 +40,18 @@ EnvironmentLight::EnvironmentLight(const VariantMap& params) {
     int w = m_probe->getWidth();
     int h = m_probe->getHeight();
 
-    size_t numEntries = (w + 1) * h;
-
-    m_cdfCols.resize(numEntries);
-    m_cdfRows.resize(h + 1);
+    // Pixels are picked in proportion to their luminance times the solid angle they cover.
+    std::vector<float> weights(static_cast<size_t>(w) * h);
     m_rowWeights.resize(h);
-
-    size_t colPos = 0;
-    size_t rowPos = 0;
-    float rowSum = 0.0f;
-
-    m_cdfRows[rowPos++] = 0;
     for (int y = 0; y < h; y++) {
-        float colSum = 0.0f;
-
-        m_cdfCols[colPos++] = 0;
+        m_rowWeights[y] = std::sin((y + 0.5f) * PI<> / h);
         for (int x = 0; x < w; x++) {
-            Spectrum val = m_probe->fetch(x, y);
-
-            colSum += val.getLuminance();
-            m_cdfCols[colPos++] = colSum;
+            weights[static_cast<size_t>(y) * w + x] = m_probe->fetch(x, y).getLuminance() * m_rowWeights[y];
         }
-
-        float normalization = 1.0f / colSum;
-        for (int x = 1; x < w; x++) {
-            m_cdfCols[colPos - x - 1] *= normalization;
-        }
-        m_cdfCols[colPos - 1] = 1.0f;
-
-        float weight = std::sin((y + 0.5f) * PI<> / h);
-        m_rowWeights[y] = weight;
-        rowSum += colSum * weight;
-        m_cdfRows[rowPos++] = rowSum;
     }
+    m_distribution = AliasDistribution2D(weights, w, h);
 
-    float normalization = 1.0f / rowSum;
-    for (int y = 1; y < h; y++) {
-        m_cdfRows[rowPos - y - 1] *= normalization;
-    }
-    m_cdfRows[rowPos - 1] = 1.0f;
-
-    m_normalization = 1.0f / (rowSum * (2.0f * PI<> / w) * (PI<> / h));
-
-    //// h pdfs for individual rows
-    // m_phiPdfs.resize(h);
-    //
-    //// pdf for row pdfs
-    // m_thetaPdf.reserve(h);
-    //
-    // m_rowWeights.resize(h);
-    //
-    // for (int i = 0; i < h; i++)
-    //{
-    //     auto& phiPdf = m_phiPdfs[i];
-    //     phiPdf.reserve(w);
-    //
-    //     float theta = (i + 0.5f) * PI / static_cast<float>(h);
-    //     float sinTheta = std::sinf(theta);
-    //
-    //     float v = static_cast<float>(i) / h;
-    //
-    //     for (int j = 0; j < w; j++)
-    //     {
-    //         float u = static_cast<float>(j) / w;
-    //         phiPdf.append(m_probe->evalLerp(u, v).getLuminance() * sinTheta);
-    //     }
-    //
-    //     m_rowWeights[i] = sinTheta;
-    //
-    //     float sum = phiPdf.normalize();
-    //     m_thetaPdf.append(sum);
-    // }
-    //
-    // auto sum = m_thetaPdf.normalize();
+    m_normalization = 1.0f / (m_distribution.getSum() * (2.0f * PI<> / w) * (PI<> / h));
 
     m_pixelSize = glm::vec2(2 * PI<> / w, PI<> / h);
 
@@ -148,11 +79,11 @@ Spectrum EnvironmentLight::eval(const Light::Sample& sample) const {
 
 Spectrum EnvironmentLight::sample(Light::Sample& sample, Sampler& sampler) const {
     glm::vec2 point = sampler.next2D();
-    uint32_t row = sampleReuse((float*)&m_cdfRows[0], m_probe->getHeight(), point.y);
-    uint32_t col = sampleReuse((float*)&m_cdfCols[0] + row * (m_probe->getWidth() + 1), m_probe->getWidth(), point.x);
+    float pixelPmf = 0.0f;
+    const glm::uvec2 pixel = m_distribution.sampleReuse(point, pixelPmf);
 
     glm::vec2 scramble = squareToTent(point);
-    glm::vec2 pos = glm::vec2((float)col, (float)row) + scramble;
+    glm::vec2 pos = glm::vec2(pixel) + scramble;
 
     int xPos = (int)std::floor(pos.x);
     int yPos = (int)std::floor(pos.y);
@@ -187,24 +118,6 @@ Spectrum EnvironmentLight::sample(Light::Sample& sample, Sampler& sampler) const
     sample.shadowRay = Ray3(sample.ref, sample.wi, Ray3::Epsilon, m_sceneRadius * 2.0f);
 
     return val / pdf;
-    // auto point = sampler.next2D();
-    //
-    // float scPdf;
-    // auto contS = sampleContinuous(point, scPdf);
-    //
-    // auto theta = PI * contS.y;
-    // auto phi = PI * (2.0f * contS.x - 1.0f);
-    //
-    // auto sinTheta = std::sinf(theta);
-    //
-    // sample.wi.x = sinTheta * sinf(phi);
-    // sample.wi.y = cosf(theta);
-    // sample.wi.z = -sinTheta * cosf(phi);
-    // sample.pdf = scPdf * InvTwoPI / sinTheta;
-    //
-    // sample.shadowRay = Ray3(sample.ref, sample.wi, Ray3::Epsilon, m_sceneRadius * 2.0f);
-    //
-    // return m_scale * m_probe->evalLerp(contS.x, contS.y) / sample.pdf;
 }
 
 float EnvironmentLight::pdf(const Light::Sample& sample) const {
@@ -236,13 +149,6 @@ float EnvironmentLight::pdf(const Light::Sample& sample) const {
     pdf /= std::max(std::abs(sinTheta), Ray3::Epsilon);
 
     return pdf;
-    // float theta = acosf(sample.wi.y);
-    // float u = (1.0f + atan2(sample.wi.x, -sample.wi.z) * InvPI) * 0.5f;
-    // float v = theta * InvPI;
-    //
-    // float p = distributionPdf(u, v);
-    //
-    // return p * InvTwoPI / sin(theta);
 }
 
 Spectrum EnvironmentLight::samplePhoton(Ray3& /*ray*/, Sampler& /*sampler*/) const {
@@ -262,25 +168,7 @@ bool EnvironmentLight::isDelta() const {
     return false;
 }
 
-glm::vec2 EnvironmentLight::sampleContinuous(const glm::vec2& /*point*/, float& /*pdf*/) const {
-    // float uPdf = 0.0f;
-    // float vPdf = 0.0f;
-    // size_t vOffset = 0;
-    //
-    // glm::vec2 result;
-    // result.y = m_thetaPdf.sampleContinuous(point.x, vPdf, vOffset);
-    // result.x = m_phiPdfs[vOffset].sampleContinuous(point.y, uPdf);
-    //
-    // pdf = uPdf * vPdf;
-    // return result;
-    return {0.0f, 0.0f};
-}
-
-float EnvironmentLight::distributionPdf(float /*u*/, float /*v*/) const {
-    // int uOffset = clamp(int(u * m_phiPdfs[0].getSize()), 0, int(m_phiPdfs[0].getSize() - 1));
-    // int vOffset = clamp(int(v * m_thetaPdf.getSize()), 0, int(m_thetaPdf.getSize() - 1));
-    //
-    // return m_phiPdfs[vOffset][uOffset];
-    return 0.0f;
+Spectrum EnvironmentLight::getPower() const {
+    return m_power;
 }
 } // namespace crisp
@@ -3,7 +3,7 @@
 #include <memory>
 #include <vector>
 
-#include <Crisp/Math/Distribution1D.hpp>
+#include <Crisp/Math/AliasDistribution2D.hpp>
 #include <Crisp/PathTracer/Core/MipMap.hpp>
 #include <Crisp/PathTracer/Lights/Light.hpp>
 #include <Crisp/PathTracer/Spectra/Spectrum.hpp>
@@ -22,24 +22,18 @@ public:
 
     virtual void setBoundingSphere(const glm::vec4& sphereParams) override;
     virtual bool isDelta() const override;
+    virtual Spectrum getPower() const override;
 
 private:
-    glm::vec2 sampleContinuous(const glm::vec2& point, float& pdf) const;
-    float distributionPdf(float u, float v) const;
-
     std::unique_ptr<MipMap> m_probe;
     float m_scale;
 
-    std::vector<float> m_cdfCols;
-    std::vector<float> m_cdfRows;
-
-    // std::vector<Distribution1D> m_phiPdfs;
-    // Distribution1D m_thetaPdf;
+    AliasDistribution2D m_distribution;
     std::vector<float> m_rowWeights;
     float m_normalization;
     glm::vec2 m_pixelSize;
 
-    RgbSpectrum m_power;
+    Spectrum m_power;
 
     glm::vec3 m_sceneCenter;
     float m_sceneRadius;
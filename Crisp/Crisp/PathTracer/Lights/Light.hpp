@@ -1,7 +1,10 @@
 #pragma once
 
+#include <optional>
+
 #include <Crisp/Math/Ray.hpp>
 #include <Crisp/PathTracer/Core/VariantMap.hpp>
+#include <Crisp/PathTracer/Lights/LightBounds.hpp>
 #include <Crisp/PathTracer/Spectra/Spectrum.hpp>
 
 namespace crisp {
@@ -63,6 +66,14 @@ public:
     virtual Spectrum samplePhoton(Ray3& ray, Sampler& sampler) const = 0;
     virtual bool isDelta() const = 0;
 
+    // Total emitted power, which weighs the lights against each other when one is picked for sampling.
+    virtual Spectrum getPower() const = 0;
+
+    // Extent of the emission for spatial light selection. Lights at infinity reach every point and have none.
+    virtual std::optional<LightBounds> getBounds() const {
+        return std::nullopt;
+    }
+
 protected:
     Shape* m_shape;
 };
@@ -0,0 +1,117 @@
+#include <Crisp/PathTracer/Lights/LightBounds.hpp>
+
+#include <Crisp/Math/Constants.hpp>
+
+namespace crisp {
+namespace {
+float safeSqrt(const float x) {
+    return std::sqrt(std::max(x, 0.0f));
+}
+
+float safeAcos(const float x) {
+    return std::acos(std::clamp(x, -1.0f, 1.0f));
+}
+
+// cos(max(0, a - b)) and sin(max(0, a - b)) from the sines and cosines of a and b.
+float cosSubClamped(const float sinA, const float cosA, const float sinB, const float cosB) {
+    return cosA > cosB ? 1.0f : cosA * cosB + sinA * sinB;
+}
+
+float sinSubClamped(const float sinA, const float cosA, const float sinB, const float cosB) {
+    return cosA > cosB ? 0.0f : sinA * cosB - cosA * sinB;
+}
+
+// Cosine of the half-angle of the cone of directions from p that contains the box.
+float boundSubtendedDirections(const BoundingBox3& bounds, const glm::vec3& p) {
+    const glm::vec3 center = bounds.getCenter();
+    const float radiusSquared = glm::length2(bounds.max - center);
+    const float distanceSquared = glm::length2(p - center);
+    if (distanceSquared < radiusSquared) {
+        return -1.0f;
+    }
+    return safeSqrt(1.0f - radiusSquared / distanceSquared);
+}
+} // namespace
+
+DirectionCone merge(const DirectionCone& a, const DirectionCone& b) {
+    if (a.isEmpty()) {
+        return b;
+    }
+    if (b.isEmpty()) {
+        return a;
+    }
+
+    // Keep either cone if it already contains the other.
+    const float thetaA = safeAcos(a.cosTheta);
+    const float thetaB = safeAcos(b.cosTheta);
+    const float thetaD = safeAcos(glm::dot(a.w, b.w));
+    if (std::min(thetaD + thetaB, PI<>) <= thetaA) {
+        return a;
+    }
+    if (std::min(thetaD + thetaA, PI<>) <= thetaB) {
+        return b;
+    }
+
+    const float thetaO = (thetaA + thetaD + thetaB) * 0.5f;
+    if (thetaO >= PI<>) {
+        return DirectionCone::createEntireSphere();
+    }
+
+    // Rotate the axis of a towards b so that the merged cone just touches the far edges of both.
+    const glm::vec3 axis = glm::cross(a.w, b.w);
+    if (glm::length2(axis) == 0.0f) {
+        return DirectionCone::createEntireSphere();
+    }
+    const glm::vec3 w = glm::vec3(glm::rotate(thetaO - thetaA, glm::normalize(axis)) * glm::vec4(a.w, 0.0f));
+    return {w, std::cos(thetaO)};
+}
+
+float LightBounds::importance(const glm::vec3& p, const glm::vec3& n) const {
+    const glm::vec3 center = bounds.getCenter();
+    const float distanceSquared = std::max(glm::length2(p - center), glm::length(bounds.getExtents()) * 0.5f);
+    const glm::vec3 wi = glm::normalize(p - center);
+
+    // Angle between the cone axis and p, reduced by the normal spread and the angular size of the bounds.
+    float cosThetaW = glm::dot(w, wi);
+    if (twoSided) {
+        cosThetaW = std::abs(cosThetaW);
+    }
+    const float sinThetaW = safeSqrt(1.0f - cosThetaW * cosThetaW);
+    const float cosThetaB = boundSubtendedDirections(bounds, p);
+    const float sinThetaB = safeSqrt(1.0f - cosThetaB * cosThetaB);
+    const float sinThetaO = safeSqrt(1.0f - cosThetaO * cosThetaO);
+    const float cosThetaX = cosSubClamped(sinThetaW, cosThetaW, sinThetaO, cosThetaO);
+    const float sinThetaX = sinSubClamped(sinThetaW, cosThetaW, sinThetaO, cosThetaO);
+    const float cosThetaP = cosSubClamped(sinThetaX, cosThetaX, sinThetaB, cosThetaB);
+    if (cosThetaP <= cosThetaE) {
+        return 0.0f;
+    }
+
+    float result = phi * cosThetaP / distanceSquared;
+    if (n != glm::vec3(0.0f)) {
+        const float cosThetaI = std::abs(glm::dot(wi, n));
+        const float sinThetaI = safeSqrt(1.0f - cosThetaI * cosThetaI);
+        result *= cosSubClamped(sinThetaI, cosThetaI, sinThetaB, cosThetaB);
+    }
+    return std::max(result, 0.0f);
+}
+
+LightBounds merge(const LightBounds& a, const LightBounds& b) {
+    if (a.phi == 0.0f) {
+        return b;
+    }
+    if (b.phi == 0.0f) {
+        return a;
+    }
+
+    const DirectionCone cone = merge(DirectionCone{a.w, a.cosThetaO}, DirectionCone{b.w, b.cosThetaO});
+    LightBounds result{};
+    result.bounds = a.bounds.merge(b.bounds);
+    result.w = cone.w;
+    result.phi = a.phi + b.phi;
+    result.cosThetaO = cone.cosTheta;
+    result.cosThetaE = std::min(a.cosThetaE, b.cosThetaE);
+    result.twoSided = a.twoSided || b.twoSided;
+    return result;
+}
+} // namespace crisp
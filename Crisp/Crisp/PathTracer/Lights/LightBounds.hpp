@@ -0,0 +1,42 @@
+#pragma once
+
+#include <limits>
+
+#include <Crisp/Math/BoundingBox.hpp>
+#include <Crisp/Math/Headers.hpp>
+
+namespace crisp {
+// A cone of directions around an axis; cosTheta of -1 covers the entire sphere.
+struct DirectionCone {
+    glm::vec3 w{0.0f, 0.0f, 1.0f};
+    float cosTheta{std::numeric_limits<float>::infinity()};
+
+    bool isEmpty() const {
+        return cosTheta == std::numeric_limits<float>::infinity();
+    }
+
+    static DirectionCone createEntireSphere() {
+        return {glm::vec3(0.0f, 0.0f, 1.0f), -1.0f};
+    }
+};
+
+// Smallest cone that contains both cones.
+DirectionCone merge(const DirectionCone& a, const DirectionCone& b);
+
+// Spatial and directional extent of the light emitted by one or more emitters, after Conty Estevez and Kulla,
+// "Importance Sampling of Many Lights with Adaptive Tree Splitting", 2018.
+struct LightBounds {
+    BoundingBox3 bounds;
+    glm::vec3 w{0.0f, 0.0f, 1.0f}; // Axis of the cone containing all surface normals.
+    float phi{0.0f};                // Emitted power.
+    float cosThetaO{-1.0f};         // Spread of the surface normals around w.
+    float cosThetaE{0.0f};          // Spread of the emission around each surface normal.
+    bool twoSided{false};
+
+    // Conservative estimate of the light reaching point p with surface normal n. A zero normal, as for points in
+    // participating media, ignores the foreshortening at p.
+    float importance(const glm::vec3& p, const glm::vec3& n) const;
+};
+
+LightBounds merge(const LightBounds& a, const LightBounds& b);
+} // namespace crisp
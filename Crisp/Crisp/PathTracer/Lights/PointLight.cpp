@@ -38,4 +38,17 @@ Spectrum PointLight::samplePhoton(Ray3& /*ray*/, Sampler& /*sampler*/) const {
 bool PointLight::isDelta() const {
     return true;
 }
+
+Spectrum PointLight::getPower() const {
+    return m_power;
+}
+
+std::optional<LightBounds> PointLight::getBounds() const {
+    LightBounds bounds{};
+    bounds.bounds = BoundingBox3(m_position);
+    bounds.phi = m_power.getLuminance();
+    bounds.cosThetaO = -1.0f;
+    bounds.cosThetaE = 0.0f;
+    return bounds;
+}
 } // namespace crisp
\ No newline at end of file
@@ -3,14 +3,14 @@
 #include <algorithm>
 #include <map>
 
-#include <Crisp/PathTracer/Spectra/RgbSpectrum.hpp>
+#include <Crisp/PathTracer/Spectra/Spectrum.hpp>
 
 namespace crisp {
 enum class IndexOfRefraction : uint8_t { Vacuum, Air, Ice, Water, Glass, Sapphire, Diamond };
 
 struct ComplexIOR {
-    RgbSpectrum eta;
-    RgbSpectrum k;
+    Spectrum eta;
+    Spectrum k;
 };
 
 class Fresnel {
@@ -149,34 +149,34 @@ public:
         return iter->second;
     }
 
-    static RgbSpectrum conductor(float cosThetaI, const ComplexIOR& ior) {
-        RgbSpectrum squareTerm = ior.eta * ior.eta + ior.k * ior.k;
+    static Spectrum conductor(float cosThetaI, const ComplexIOR& ior) {
+        Spectrum squareTerm = ior.eta * ior.eta + ior.k * ior.k;
         float cosTheta2 = cosThetaI * cosThetaI;
-        RgbSpectrum etaCosTheta = 2.0f * ior.eta * cosThetaI;
+        Spectrum etaCosTheta = 2.0f * ior.eta * cosThetaI;
 
-        RgbSpectrum Rp = (squareTerm * cosTheta2 - etaCosTheta + 1) / (squareTerm * cosTheta2 + etaCosTheta + 1);
+        Spectrum Rp = (squareTerm * cosTheta2 - etaCosTheta + 1) / (squareTerm * cosTheta2 + etaCosTheta + 1);
 
-        RgbSpectrum Rs = (squareTerm + cosTheta2 - etaCosTheta) / (squareTerm + cosTheta2 + etaCosTheta);
+        Spectrum Rs = (squareTerm + cosTheta2 - etaCosTheta) / (squareTerm + cosTheta2 + etaCosTheta);
 
         return (Rs + Rp) * 0.5f;
     }
 
-    static RgbSpectrum conductorFull(float cosThetaI, const ComplexIOR& ior) {
+    static Spectrum conductorFull(float cosThetaI, const ComplexIOR& ior) {
         float cosTheta2 = cosThetaI * cosThetaI;
         float sinTheta2 = 1.0f - cosTheta2;
-        glm::vec3 eta2(ior.eta.r * ior.eta.r, ior.eta.g * ior.eta.g, ior.eta.b * ior.eta.b);
-        glm::vec3 k2(ior.k.r * ior.k.r, ior.k.g * ior.k.g, ior.k.b * ior.k.b);
-
-        glm::vec3 t0 = eta2 - k2 - sinTheta2;
-        glm::vec3 a2b2 = sqrt(t0 * t0 + 4.0f * eta2 * k2);
-        glm::vec3 t1 = a2b2 + cosTheta2;
-        glm::vec3 a = sqrt(0.5f * (a2b2 + t0));
-        glm::vec3 t2 = 2.0f * a * cosThetaI;
-        glm::vec3 Rs = (t1 - t2) / (t1 + t2);
-
-        glm::vec3 t3 = cosTheta2 * a2b2 + sinTheta2 * sinTheta2;
-        glm::vec3 t4 = t2 * sinTheta2;
-        glm::vec3 Rp = Rs * (t3 - t4) / (t3 + t4);
+        Spectrum eta2 = ior.eta * ior.eta;
+        Spectrum k2 = ior.k * ior.k;
+
+        Spectrum t0 = eta2 - k2 - sinTheta2;
+        Spectrum a2b2 = (t0 * t0 + 4.0f * eta2 * k2).sqrt();
+        Spectrum t1 = a2b2 + cosTheta2;
+        Spectrum a = (0.5f * (a2b2 + t0)).sqrt();
+        Spectrum t2 = 2.0f * a * cosThetaI;
+        Spectrum Rs = (t1 - t2) / (t1 + t2);
+
+        Spectrum t3 = cosTheta2 * a2b2 + sinTheta2 * sinTheta2;
+        Spectrum t4 = t2 * sinTheta2;
+        Spectrum Rp = Rs * (t3 - t4) / (t3 + t4);
 
         return (Rp + Rs) * 0.5f;
     }
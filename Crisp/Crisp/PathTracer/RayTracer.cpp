@@ -1,19 +1,37 @@
 #include <Crisp/PathTracer/RayTracer.hpp>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <pmmintrin.h>
+#include <sstream>
+#include <thread>
+#include <tuple>
 #include <xmmintrin.h>
 
 #include <tbb/blocked_range.h>
-#include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
 
 #include <Crisp/Core/Logger.hpp>
+#include <Crisp/Core/Timer.hpp>
+#include <Crisp/IO/FileUtils.hpp>
+#include <Crisp/IO/JsonUtils.hpp>
+#include <Crisp/PathTracer/BSDFs/BSDF.hpp>
 #include <Crisp/PathTracer/Cameras/Camera.hpp>
+#include <Crisp/PathTracer/Core/Intersection.hpp>
 #include <Crisp/PathTracer/Core/JsonSceneParser.hpp>
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
 #include <Crisp/PathTracer/Core/Scene.hpp>
+#include <Crisp/PathTracer/Distributed/Socket.hpp>
+#include <Crisp/PathTracer/Distributed/TileProtocol.hpp>
 #include <Crisp/PathTracer/Integrators/Integrator.hpp>
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
+#include <Crisp/PathTracer/Shapes/Shape.hpp>
+#include <Crisp/PathTracer/Textures/TextureCache.hpp>
 
 
 namespace crisp {
@@ -21,6 +39,191 @@ namespace {
 const int DefaultImageWidth = 800;
 const int DefaultImageHeight = 600;
 const int BlockSize = 64;
+
+// Workers are often launched together with the coordinator and may have to wait for it to start listening.
+constexpr int kWorkerConnectAttempts = 30;
+constexpr auto kWorkerConnectInterval = std::chrono::seconds(1);
+constexpr auto kWorkerPollInterval = std::chrono::milliseconds(50);
+
+using SamplerPool = tbb::enumerable_thread_specific<std::unique_ptr<Sampler>>;
+
+// Mean relative difference between the image of all passes and the image of every other pass.
+float estimateRelativeError(const std::vector<float>& allPasses, const std::vector<float>& evenPasses) {
+    double errorSum = 0.0;
+    for (size_t i = 0; i < allPasses.size(); i += 4) {
+        const float all = (allPasses[i] + allPasses[i + 1] + allPasses[i + 2]) / 3.0f;
+        const float even = (evenPasses[i] + evenPasses[i + 1] + evenPasses[i + 2]) / 3.0f;
+        errorSum += std::abs(all - even) / (all + 1e-2f);
+    }
+    return static_cast<float>(errorSum / static_cast<double>(allPasses.size() / 4));
+}
+
+// Per-thread storage for the camera rays of one image block, reused across blocks to avoid reallocating.
+struct PrimaryRayBatch {
+    std::vector<glm::vec2> pixelSamples;
+    std::vector<SampleState> sampleStates;
+    std::vector<Spectrum> responses;
+    std::vector<Ray3> rays;
+    std::vector<Intersection> hits;
+    std::vector<Spectrum> radiance;
+
+    void resize(const size_t rayCount) {
+        pixelSamples.resize(rayCount);
+        sampleStates.resize(rayCount);
+        responses.resize(rayCount);
+        rays.resize(rayCount);
+        hits.resize(rayCount);
+        radiance.resize(rayCount);
+    }
+};
+
+FeatureImages createFeatureImages(const glm::ivec2& size) {
+    const size_t valueCount = static_cast<size_t>(size.x) * size.y * 4;
+    return {
+        .albedo = std::vector<float>(valueCount, 0.0f),
+        .normal = std::vector<float>(valueCount, 0.0f),
+        .depth = std::vector<float>(valueCount, 0.0f),
+    };
+}
+
+// Records the surface seen by a camera ray for the denoiser.
+void addFeatures(ImageBlock& block, const glm::vec2& pixelSample, const Ray3& ray, const Intersection& its) {
+    if (!its.shape) {
+        block.addFeatures(pixelSample, Spectrum(0.0f), glm::vec3(0.0f), 0.0f);
+        return;
+    }
+
+    const BSDF* bsdf = its.shape->getBSDF();
+    const Spectrum albedo = bsdf ? bsdf->getAlbedo(BSDF::Sample(its, its.toLocal(-ray.d))) : Spectrum(1.0f);
+    block.addFeatures(pixelSample, albedo, its.shFrame.n, its.tHit);
+}
+
+// Copies an RGBA block into the matching region of an RGBA image that is imageWidth pixels wide.
+void copyBlock(
+    const std::vector<float>& blockData,
+    const ImageBlock::Descriptor& desc,
+    std::vector<float>& image,
+    const int imageWidth) {
+    for (int y = 0; y < desc.size.y; ++y) {
+        const size_t dstOffset = (static_cast<size_t>(desc.offset.y + y) * imageWidth + desc.offset.x) * 4;
+        const size_t srcOffset = static_cast<size_t>(y) * desc.size.x * 4;
+        std::copy_n(blockData.begin() + srcOffset, desc.size.x * 4, image.begin() + dstOffset);
+    }
+}
+
+// Takes sample sampleIndex in each of the given block-local pixels. Camera rays are generated for all of them first,
+// traced as packets, and only then handed to the integrator as a batch. Rays sharing a packet are coherent as long as
+// the pixels are listed in row-major order.
+void samplePixels(
+    ImageBlock& block,
+    Sampler& sampler,
+    const pt::Scene* scene,
+    const std::vector<glm::ivec2>& pixels,
+    const uint32_t sampleIndex) {
+    const glm::ivec2 offset = block.getOffset();
+    const Camera* camera = scene->getCamera();
+    const Integrator* integrator = scene->getIntegrator();
+
+    thread_local PrimaryRayBatch batch;
+    batch.resize(pixels.size());
+
+    {
+        const ScopedRenderStage stage(RenderStage::CameraRays);
+        for (size_t idx = 0; idx < pixels.size(); ++idx) {
+            const glm::ivec2 pixel = pixels[idx] + offset;
+            sampler.startPixelSample(pixel, sampleIndex);
+            std::array<float, 4> cameraSample; // Pixel position followed by aperture position
+            sampler.fill(cameraSample);
+            batch.pixelSamples[idx] = glm::vec2(pixel.x + cameraSample[0], pixel.y + cameraSample[1]);
+            const glm::vec2 apertureSample(cameraSample[2], cameraSample[3]);
+            batch.responses[idx] = camera->sampleRay(batch.rays[idx], batch.pixelSamples[idx], apertureSample);
+            batch.sampleStates[idx] = sampler.getSampleState();
+        }
+    }
+
+    {
+        const ScopedRenderStage stage(RenderStage::PrimaryRays);
+        scene->rayIntersect(batch.rays, batch.hits);
+        RenderCounters::addPrimaryRays(pixels.size());
+        for (size_t idx = 0; idx < pixels.size(); ++idx) {
+            Spectrum::beginSample(batch.sampleStates[idx].pixel, sampleIndex);
+            addFeatures(block, batch.pixelSamples[idx], batch.rays[idx], batch.hits[idx]);
+        }
+    }
+
+    {
+        const ScopedRenderStage stage(RenderStage::Integration);
+        integrator->LiBatch(scene, sampler, batch.sampleStates, batch.rays, batch.hits, batch.radiance);
+    }
+
+    // Spectral estimates are converted to RGB with the wavelengths of their own sample.
+    const ScopedRenderStage stage(RenderStage::Accumulation);
+    for (size_t idx = 0; idx < pixels.size(); ++idx) {
+        Spectrum::beginSample(batch.sampleStates[idx].pixel, sampleIndex);
+        block.addSample(batch.pixelSamples[idx], batch.responses[idx] * batch.radiance[idx]);
+    }
+}
+
+Result<> validateCheckpoint(const RenderCheckpoint& checkpoint, const RenderCheckpoint& expected) {
+    if (checkpoint.mode != expected.mode) {
+        return resultError("it was written by a render in a different mode");
+    }
+    if (checkpoint.sceneHash != expected.sceneHash) {
+        return resultError("the scene has changed since it was written");
+    }
+    if (checkpoint.finishedBlocks.size() != expected.finishedBlocks.size()) {
+        return resultError("it was written for a different image size");
+    }
+    // Progressive renders may be resumed with a different target, the sample count of blocks is fixed.
+    if (checkpoint.mode != RenderCheckpoint::Mode::Progressive && checkpoint.sampleCount != expected.sampleCount) {
+        return resultError("it was written with {} samples per pixel", checkpoint.sampleCount);
+    }
+    return kResultSuccess;
+}
+
+// Lists every stride-th pixel of a block in both directions, in row-major order.
+std::vector<glm::ivec2> createPixelList(const glm::ivec2& size, const int stride = 1) {
+    std::vector<glm::ivec2> pixels;
+    pixels.reserve(static_cast<size_t>((size.x + stride - 1) / stride) * ((size.y + stride - 1) / stride));
+    for (int y = 0; y < size.y; y += stride) {
+        for (int x = 0; x < size.x; x += stride) {
+            pixels.emplace_back(x, y);
+        }
+    }
+    return pixels;
+}
+
+// Adds the seconds spent on a tile to its pixels in an RGBA image that is imageWidth pixels wide.
+void writeRenderTime(
+    const ImageBlock::Descriptor& desc, const float renderTime, std::vector<float>& image, const int imageWidth) {
+    const float pixelTime = renderTime / static_cast<float>(desc.size.x * desc.size.y);
+    for (int y = 0; y < desc.size.y; ++y) {
+        for (int x = 0; x < desc.size.x; ++x) {
+            const size_t offset = (static_cast<size_t>(desc.offset.y + y) * imageWidth + desc.offset.x + x) * 4;
+            image[offset] = image[offset + 1] = image[offset + 2] = pixelTime;
+            image[offset + 3] = 1.0f;
+        }
+    }
+}
+
+constexpr std::array<const char*, RenderCounters::kStageCount> kRenderStageNames = {
+    "cameraRays", "primaryRays", "integration", "accumulation", "shading", "shadowRays", "misRays", "extensionRays"};
+constexpr std::array<const char*, RenderCounters::kLobeCount> kLobeNames = {"passthrough", "diffuse", "glossy", "delta"};
+
+void logRenderCounters(const RenderCounters& counters, const double renderTime) {
+    const double megaRaysPerSecond =
+        renderTime > 0.0 ? static_cast<double>(counters.getRayCount()) / renderTime * 1e-6 : 0.0;
+    spdlog::info(
+        "{:.3f} Mrays/s: {} primary, {} extension and {} shadow rays, {} paths of mean length {:.2f}, "
+        "{} invalid samples.",
+        megaRaysPerSecond,
+        counters.primaryRays,
+        counters.extensionRays,
+        counters.shadowRays,
+        counters.getPathCount(),
+        counters.getMeanPathLength(),
+        counters.invalidSamples);
+}
 } // namespace
 
 RayTracer::RayTracer()
@@ -36,22 +239,48 @@ RayTracer::~RayTracer() {
     stop();
 }
 
-void RayTracer::initializeScene(
-    const std::filesystem::path& sceneFilePath, const std::filesystem::path& resourceDirectory) {
+Result<> RayTracer::initializeScene(
+    const std::filesystem::path& sceneFilePath,
+    const std::filesystem::path& resourceDirectory,
+    const std::filesystem::path& meshCacheDirectory,
+    const std::filesystem::path& textureCacheDirectory) {
     if (m_renderStatus == RenderStatus::Busy) {
-        return;
+        return resultError("Cannot load {} while a render is in progress.", sceneFilePath.string());
     }
 
+    const Timer<std::chrono::duration<double>> parseTimer;
     JsonSceneParser jsonParser;
-    auto sceneResult = jsonParser.parse(sceneFilePath, resourceDirectory / "Meshes");
+    auto sceneResult =
+        jsonParser.parse(sceneFilePath, resourceDirectory / "Meshes", meshCacheDirectory, textureCacheDirectory);
     if (!sceneResult) {
         m_scene.reset();
-        return;
+        return resultError("Failed to load scene {}: {}", sceneFilePath.string(), sceneResult.getError());
     }
 
     m_scene = sceneResult.extract();
+    const auto sceneFile = fileToString(sceneFilePath);
+    m_sceneHash = sceneFile ? std::hash<std::string>{}(*sceneFile) : 0;
     m_image.initialize(m_scene->getCamera()->getImageSize(), m_scene->getCamera()->getReconstructionFilter());
     m_image.clear();
+
+    const glm::ivec2 imageSize = m_image.getSize();
+    m_imageData.assign(static_cast<size_t>(imageSize.x) * imageSize.y * 4, 0.0f);
+    m_sampleCountData.assign(static_cast<size_t>(imageSize.x) * imageSize.y * 4, 0.0f);
+    m_varianceData.assign(static_cast<size_t>(imageSize.x) * imageSize.y * 4, 0.0f);
+    m_renderTimeData.assign(static_cast<size_t>(imageSize.x) * imageSize.y * 4, 0.0f);
+    m_featureData = createFeatureImages(imageSize);
+    m_denoisedData.clear();
+
+    m_statistics = {};
+    m_statistics.accelerationBuildTime = m_scene->getAccelerationBuildTime();
+    m_statistics.sceneParseTime = parseTimer.getElapsedTime() - m_statistics.accelerationBuildTime;
+
+    const pt::SceneMemoryUsage memoryUsage = m_scene->getMemoryUsage();
+    m_statistics.shapeCount = memoryUsage.shapeCount;
+    m_statistics.shapeMemory = memoryUsage.shapeBytes;
+    m_statistics.accelerationMemory = memoryUsage.accelerationBytes;
+    m_statistics.peakAccelerationMemory = memoryUsage.peakAccelerationBytes;
+    return kResultSuccess;
 }
 
 void RayTracer::start() {
@@ -59,64 +288,73 @@ void RayTracer::start() {
         return;
     }
 
+    // The previous render has finished on its own, reclaim its thread before launching a new one.
+    if (m_renderThread.joinable()) {
+        m_renderThread.join();
+    }
+
     m_blocksRendered = 0;
     m_pixelsRendered = 0;
     m_timeSpentRendering = 0.0f;
+    m_statistics.preprocessTime = 0.0;
+    m_statistics.renderTime = 0.0;
+    m_statistics.denoiseTime = 0.0;
+    m_statistics.raysTraced = 0;
+    m_statistics.samplesTaken = 0;
+    m_statistics.tileSplits = 0;
+    m_statistics.counters = {};
+    m_denoisedData.clear();
 
     m_renderStatus = RenderStatus::Busy;
     m_renderThread = std::thread([this] {
-        auto size = m_image.getSize();
-        generateImageBlocks(size.x, size.y);
-
         spdlog::info("Using {} thread(s).", tbb::this_task_arena::max_concurrency());
 
-        tbb::concurrent_vector<std::unique_ptr<Sampler>> samplers(m_totalBlocks);
-        for (auto& it : samplers) {
-            it = m_scene->getSampler()->clone();
-        }
-
-        auto renderImageBlocks = [&](const tbb::blocked_range<int>& range) {
-            for (int i = range.begin(); i < range.end(); ++i) {
-                if (m_renderStatus == RenderStatus::Interrupted) {
-                    break;
-                }
-
-                ImageBlock::Descriptor desc;
-                if (m_descriptorQueue.try_pop(desc)) {
-                    auto t1 = std::chrono::high_resolution_clock::now();
-                    ImageBlock currBlock(desc.offset, desc.size, m_scene->getCamera()->getReconstructionFilter());
-                    renderBlock(currBlock, *samplers.at(i), m_scene.get());
-                    auto t2 = std::chrono::high_resolution_clock::now();
-                    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
-
-                    RayTracerUpdate update;
-                    update.x = desc.offset.x;
-                    update.y = desc.offset.y;
-                    update.width = desc.size.x;
-                    update.height = desc.size.y;
-                    update.data = currBlock.getRaw();
-                    updateProgress(std::move(update), duration / 1'000'000'000.0f);
-                }
-            }
-        };
-
-        tbb::blocked_range<int> range(0, static_cast<int>(m_descriptorQueue.unsafe_size()));
-
+        const Timer<std::chrono::duration<double>> preprocessTimer;
         const_cast<Integrator*>(m_scene->getIntegrator())->preprocess(m_scene.get());
+        const double preprocessTime = preprocessTimer.getElapsedTime();
+        spdlog::info("Preprocessed scene in {:.3f} s.", preprocessTime);
+        const RenderCounters countersBefore = RenderCounters::collect();
 
         auto t1 = std::chrono::high_resolution_clock::now();
-        tbb::parallel_for(range, renderImageBlocks);
+        m_renderStartTime = std::chrono::steady_clock::now();
+        m_lastCheckpointTime = m_renderStartTime;
+        m_restoredRenderTime = 0.0;
+        if (m_distributedSettings.role == DistributedRenderSettings::Role::Worker) {
+            runWorker();
+        } else if (m_progressiveSettings.enabled) {
+            if (m_distributedSettings.role == DistributedRenderSettings::Role::Coordinator) {
+                spdlog::warn("Progressive renders are not distributed, rendering without workers.");
+            }
+            renderProgressive();
+        } else {
+            renderImageBlocks();
+        }
         auto t2 = std::chrono::high_resolution_clock::now();
 
         auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+        if (m_denoiserSettings.enabled && m_renderStatus != RenderStatus::Interrupted &&
+            m_distributedSettings.role != DistributedRenderSettings::Role::Worker) {
+            denoiseImage();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_imageMutex);
+            m_statistics.preprocessTime = preprocessTime;
+            m_statistics.renderTime = duration / 1'000'000'000.0;
+            m_statistics.counters = RenderCounters::collect() - countersBefore;
+            if (const auto& textureCache = m_scene->getTextureCache()) {
+                const TextureCache::Statistics textureStatistics = textureCache->getStatistics();
+                m_statistics.textureTileHits = textureStatistics.hits;
+                m_statistics.textureTileMisses = textureStatistics.misses;
+                m_statistics.textureTileEvictions = textureStatistics.evictions;
+                m_statistics.peakTextureMemory = textureStatistics.peakResidentBytes;
+            }
+        }
 
         spdlog::info("Finished rendering scene in {} s.", duration / 1'000'000'000.0);
+        logRenderCounters(m_statistics.counters, duration / 1'000'000'000.0);
 
-        if (m_renderStatus != RenderStatus::Interrupted) {
-            m_renderThread.detach();
-        }
-
-        m_renderStatus = RenderStatus::Done;
+        RenderStatus expected = RenderStatus::Busy;
+        m_renderStatus.compare_exchange_strong(expected, RenderStatus::Done);
     });
 }
 
@@ -126,25 +364,218 @@ void RayTracer::stop() {
         m_renderThread.join();
         m_renderStatus = RenderStatus::Free;
         spdlog::info("Rendering cancelled.");
+    } else if (m_renderThread.joinable()) {
+        m_renderThread.join();
+    }
+}
+
+void RayTracer::waitForCompletion() {
+    if (m_renderThread.joinable()) {
+        m_renderThread.join();
     }
 }
 
+bool RayTracer::isRendering() const {
+    return m_renderStatus == RenderStatus::Busy;
+}
+
+void RayTracer::setProgressiveSettings(const ProgressiveRenderSettings& settings) {
+    m_progressiveSettings = settings;
+}
+
+void RayTracer::setAdaptiveSettings(const AdaptiveSamplingSettings& settings) {
+    m_adaptiveSettings = settings;
+}
+
+void RayTracer::setDenoiserSettings(const DenoiserSettings& settings) {
+    m_denoiserSettings = settings;
+}
+
+void RayTracer::setCheckpointSettings(const CheckpointSettings& settings) {
+    m_checkpointSettings = settings;
+}
+
+void RayTracer::setDistributedSettings(const DistributedRenderSettings& settings) {
+    m_distributedSettings = settings;
+}
+
+void RayTracer::setTileSchedulingSettings(const TileSchedulingSettings& settings) {
+    m_tileSchedulingSettings = settings;
+}
+
 void RayTracer::setImageSize(int width, int height) {
     m_image.initialize(glm::ivec2(width, height), nullptr);
+    m_imageData.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    m_sampleCountData.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    m_varianceData.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    m_renderTimeData.assign(static_cast<size_t>(width) * height * 4, 0.0f);
+    m_featureData = createFeatureImages(glm::ivec2(width, height));
+    m_denoisedData.clear();
 }
 
 glm::ivec2 RayTracer::getImageSize() const {
     return m_image.getSize();
 }
 
+std::vector<float> RayTracer::getImageData() const {
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    return m_imageData;
+}
+
+std::vector<float> RayTracer::getSampleCountData() const {
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    return m_sampleCountData;
+}
+
+std::vector<float> RayTracer::getVarianceData() const {
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    return m_varianceData;
+}
+
+FeatureImages RayTracer::getFeatureData() const {
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    return m_featureData;
+}
+
+std::vector<float> RayTracer::getRenderTimeData() const {
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    return m_renderTimeData;
+}
+
+std::vector<float> RayTracer::getDenoisedImageData() const {
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    return m_denoisedData;
+}
+
+RayTracerStatistics RayTracer::getStatistics() const {
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    return m_statistics;
+}
+
+Result<> RayTracer::writeLayeredExr(
+    const std::filesystem::path& path, const ExrPixelType colorPixelType, const ExrWriteOptions& options) const {
+    std::vector<float> imageData;
+    std::vector<float> denoisedData;
+    std::vector<float> varianceData;
+    std::vector<float> sampleCountData;
+    std::vector<float> renderTimeData;
+    FeatureImages features;
+    {
+        std::lock_guard<std::mutex> lock(m_imageMutex);
+        imageData = m_imageData;
+        denoisedData = m_denoisedData;
+        varianceData = m_varianceData;
+        sampleCountData = m_sampleCountData;
+        renderTimeData = m_renderTimeData;
+        features = m_featureData;
+    }
+
+    const auto createLayer = [](std::string name,
+                                std::vector<std::string> channelNames,
+                                const std::vector<float>& data,
+                                const ExrPixelType pixelType) {
+        return ExrLayer{
+            .name = std::move(name),
+            .channelNames = std::move(channelNames),
+            .pixelData = data,
+            .pixelType = pixelType,
+        };
+    };
+
+    std::vector<ExrLayer> layers;
+    layers.push_back(createLayer("", {"R", "G", "B", "A"}, imageData, colorPixelType));
+    if (!denoisedData.empty()) {
+        layers.push_back(createLayer("denoised", {"R", "G", "B"}, denoisedData, colorPixelType));
+    }
+    layers.push_back(createLayer("albedo", {"R", "G", "B"}, features.albedo, colorPixelType));
+    layers.push_back(createLayer("normal", {"X", "Y", "Z"}, features.normal, colorPixelType));
+    layers.push_back(createLayer("depth", {"Z"}, features.depth, ExrPixelType::Float));
+    layers.push_back(createLayer("variance", {"Y"}, varianceData, ExrPixelType::Float));
+    layers.push_back(createLayer("sampleCount", {"Y"}, sampleCountData, ExrPixelType::Float));
+    layers.push_back(createLayer("renderTime", {"Y"}, renderTimeData, ExrPixelType::Float));
+
+    const glm::ivec2 size = m_image.getSize();
+    return saveExr(path, layers, static_cast<uint32_t>(size.x), static_cast<uint32_t>(size.y), options);
+}
+
+Result<> RayTracer::writeStatisticsReport(const std::filesystem::path& path) const {
+    const RayTracerStatistics stats = getStatistics();
+    const RenderCounters& counters = stats.counters;
+
+    nlohmann::json report;
+    report["renderTime"] = stats.renderTime;
+    report["samples"] = stats.samplesTaken;
+    report["rays"] = {
+        {"primary", counters.primaryRays},
+        {"extension", counters.extensionRays},
+        {"shadow", counters.shadowRays},
+        {"total", counters.getRayCount()},
+        {"megaRaysPerSecond",
+         stats.renderTime > 0.0 ? static_cast<double>(counters.getRayCount()) / stats.renderTime * 1e-6 : 0.0},
+    };
+    for (size_t i = 0; i < RenderCounters::kLobeCount; ++i) {
+        report["bsdfSamples"][kLobeNames[i]] = counters.bsdfSamples[i];
+    }
+    report["paths"] = {
+        {"count", counters.getPathCount()},
+        {"meanLength", counters.getMeanPathLength()},
+        {"lengthHistogram", counters.pathLengths},
+        {"russianRouletteTerminations", counters.russianRouletteTerminations},
+    };
+    report["invalidSamples"] = counters.invalidSamples;
+    // Thread seconds, which add up to more than the render time when several threads render.
+    for (size_t i = 0; i < RenderCounters::kStageCount; ++i) {
+        report["stageSeconds"][kRenderStageNames[i]] = counters.stageSeconds[i];
+    }
+    return stringToFile(path, report.dump(4));
+}
+
 void RayTracer::setProgressUpdater(std::function<void(RayTracerUpdate&&)> callback) {
     m_progressUpdater = callback;
 }
 
-void RayTracer::updateProgress(RayTracerUpdate&& update, float blockRenderTime) {
+void RayTracer::updateProgress(
+    const ImageBlock& block, const ScheduledTile& tile, float blockRenderTime, uint64_t raysTraced) {
+    const ImageBlock::Descriptor desc(block.getOffset().x, block.getOffset().y, block.getSize().x, block.getSize().y);
+    const uint64_t samplesTaken = block.getTotalSampleCount();
+    const std::vector<float> sampleCountData = block.getSampleCountRaw();
+
+    RayTracerUpdate update;
+    update.x = desc.offset.x;
+    update.y = desc.offset.y;
+    update.width = desc.size.x;
+    update.height = desc.size.y;
+    update.samplesPerPixel = static_cast<int>(samplesTaken / (static_cast<uint64_t>(desc.size.x) * desc.size.y));
+    update.data.resize(static_cast<size_t>(desc.size.x) * desc.size.y * 4);
+    update.albedo.resize(update.data.size());
+    update.normal.resize(update.data.size());
+    update.depth.resize(update.data.size());
+
     std::lock_guard<std::mutex> lock(m_imageMutex);
 
-    m_blocksRendered++;
+    // Merging the border as well lets samples near a block edge contribute to the neighboring pixels. Those may
+    // belong to blocks that were already reported, so the image buffer is refreshed over the whole footprint.
+    m_image.put(block);
+    const int imageWidth = m_image.getSize().x;
+    const glm::ivec2 border = (block.getFullSize() - block.getSize()) / 2;
+    const ImageBlock::Descriptor footprint(
+        desc.offset.x - border.x, desc.offset.y - border.y, desc.size.x + 2 * border.x, desc.size.y + 2 * border.y);
+    m_image.writeRgba(footprint, m_imageData, glm::ivec2(0), imageWidth);
+    m_image.writeRgba(desc, update.data, desc.offset, desc.size.x);
+    m_image.writeFeatures(
+        desc, m_featureData.albedo, m_featureData.normal, m_featureData.depth, glm::ivec2(0), imageWidth);
+    m_image.writeFeatures(desc, update.albedo, update.normal, update.depth, desc.offset, desc.size.x);
+    copyBlock(sampleCountData, desc, m_sampleCountData, imageWidth);
+    copyBlock(block.getVarianceRaw(), desc, m_varianceData, imageWidth);
+    writeRenderTime(desc, blockRenderTime, m_renderTimeData, imageWidth);
+    m_statistics.raysTraced += raysTraced;
+    m_statistics.samplesTaken += samplesTaken;
+    if (m_tileScheduler.finish(tile)) {
+        m_checkpoint.finishedBlocks[tile.blockIndex] = 1;
+        m_blocksRendered++;
+    }
+    writeCheckpointIfDue(nullptr);
+
     m_pixelsRendered += update.width * update.height;
     m_timeSpentRendering += blockRenderTime;
     update.totalTimeSpentRendering = m_timeSpentRendering;
@@ -156,110 +587,628 @@ void RayTracer::updateProgress(RayTracerUpdate&& update, float blockRenderTime)
     }
 }
 
+void RayTracer::renderImageBlocks() {
+    auto size = m_image.getSize();
+    m_image.clear();
+    m_checkpoint = {
+        .mode = m_adaptiveSettings.enabled ? RenderCheckpoint::Mode::AdaptiveBlocks : RenderCheckpoint::Mode::Blocks,
+        .sceneHash = m_sceneHash,
+        .sampleCount = static_cast<uint32_t>(m_scene->getSampler()->getSampleCount()),
+        .finishedBlocks = std::vector<uint8_t>(createBlockDescriptors(size.x, size.y).size(), 0),
+    };
+    if (m_checkpointSettings.resume) {
+        restoreCheckpoint(nullptr);
+    }
+    generateImageBlocks(size.x, size.y);
+
+    // Samplers are addressed by pixel and sample index, so each thread can reuse one for all of its blocks.
+    SamplerPool samplers([this] { return m_scene->getSampler()->clone(); });
+    tbb::enumerable_thread_specific<ImageBlock> blocks;
+
+    // Every task keeps taking tiles until the queue is empty, which it only is once the last tiles have been split.
+    auto renderTiles = [&](int /*task*/) {
+        while (m_renderStatus != RenderStatus::Interrupted) {
+            const std::optional<ScheduledTile> tile = m_tileScheduler.pop();
+            if (!tile) {
+                break;
+            }
+
+            const ImageBlock::Descriptor& desc = tile->desc;
+            const uint64_t raysBefore = pt::Scene::getThreadRayCount();
+            auto t1 = std::chrono::high_resolution_clock::now();
+            ImageBlock& currBlock = blocks.local();
+            currBlock.initialize(desc.offset, desc.size, m_scene->getCamera()->getReconstructionFilter());
+            Sampler& sampler = *samplers.local();
+            if (m_adaptiveSettings.enabled) {
+                // A block cut short would be resumed as finished, so it is dropped and rendered again instead.
+                if (!renderBlockAdaptive(currBlock, sampler, m_scene.get(), m_adaptiveSettings)) {
+                    break;
+                }
+            } else {
+                renderBlock(currBlock, sampler, m_scene.get(), 0, sampler.getSampleCount());
+            }
+            auto t2 = std::chrono::high_resolution_clock::now();
+            const uint64_t raysTraced = pt::Scene::getThreadRayCount() - raysBefore;
+            auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+            updateProgress(currBlock, *tile, duration / 1'000'000'000.0f, raysTraced);
+        }
+    };
+
+    const auto renderLocalBlocks = [&] {
+        tbb::parallel_for(0, tbb::this_task_arena::max_concurrency(), renderTiles);
+    };
+    if (m_distributedSettings.role == DistributedRenderSettings::Role::Coordinator) {
+        coordinateWorkers(renderLocalBlocks);
+    } else {
+        renderLocalBlocks();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_imageMutex);
+        m_statistics.tileSplits = m_tileScheduler.getSplitCount();
+        if (m_renderStatus == RenderStatus::Interrupted && !m_checkpointSettings.path.empty()) {
+            writeCheckpoint(nullptr);
+        }
+    }
+}
+
+void RayTracer::renderProgressive() {
+    const glm::ivec2 size = m_image.getSize();
+    const ReconstructionFilter* filter = m_scene->getCamera()->getReconstructionFilter();
+    const int numPixels = size.x * size.y;
+
+    const int targetSampleCount = m_progressiveSettings.targetSamplesPerPixel > 0
+                                      ? m_progressiveSettings.targetSamplesPerPixel
+                                      : static_cast<int>(m_scene->getSampler()->getSampleCount());
+    const int samplesPerPass = std::max(m_progressiveSettings.samplesPerPass, 1);
+
+    // Every other pass is also accumulated separately; the difference between the two images is a cheap estimate of
+    // the remaining Monte Carlo noise.
+    ImageBlock evenPasses(size, filter);
+    evenPasses.clear();
+    m_image.clear();
+
+    const std::vector<ImageBlock::Descriptor> descriptors = createBlockDescriptors(size.x, size.y);
+    SamplerPool samplers([this] { return m_scene->getSampler()->clone(); });
+    tbb::enumerable_thread_specific<ImageBlock> blocks;
+
+    m_checkpoint = {
+        .mode = RenderCheckpoint::Mode::Progressive,
+        .sceneHash = m_sceneHash,
+        .sampleCount = static_cast<uint32_t>(m_scene->getSampler()->getSampleCount()),
+        .finishedBlocks = std::vector<uint8_t>(descriptors.size(), 0),
+    };
+    int firstPass = 0;
+    int samplesRendered = 0;
+    if (m_checkpointSettings.resume && restoreCheckpoint(&evenPasses)) {
+        firstPass = m_checkpoint.passesRendered;
+        samplesRendered = m_checkpoint.samplesRendered;
+    }
+
+    const Timer<std::chrono::duration<double>> budgetTimer;
+    for (int pass = firstPass; samplesRendered < targetSampleCount; ++pass) {
+        // A pass that was in flight when the checkpoint was written is finished with the sample count it started with.
+        const bool isPassInFlight =
+            std::ranges::find(m_checkpoint.finishedBlocks, uint8_t{1}) != m_checkpoint.finishedBlocks.end();
+        const int passSampleCount = isPassInFlight ? m_checkpoint.passSampleCount
+                                                   : std::min(samplesPerPass, targetSampleCount - samplesRendered);
+        const bool isEvenPass = pass % 2 == 0;
+        {
+            std::lock_guard<std::mutex> lock(m_imageMutex);
+            m_checkpoint.passSampleCount = passSampleCount;
+        }
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, descriptors.size()), [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); ++i) {
+                if (m_renderStatus == RenderStatus::Interrupted) {
+                    break;
+                }
+
+                // Flags of other blocks change concurrently, but each block's own flag only in this iteration.
+                if (m_checkpoint.finishedBlocks[i]) {
+                    continue;
+                }
+
+                const ImageBlock::Descriptor& desc = descriptors[i];
+                const uint64_t raysBefore = pt::Scene::getThreadRayCount();
+                ImageBlock& block = blocks.local();
+                block.initialize(desc.offset, desc.size, filter);
+                renderBlock(block, *samplers.local(), m_scene.get(), samplesRendered, passSampleCount);
+
+                std::lock_guard<std::mutex> lock(m_imageMutex);
+                m_image.put(block);
+                if (isEvenPass) {
+                    evenPasses.put(block);
+                }
+                m_statistics.raysTraced += pt::Scene::getThreadRayCount() - raysBefore;
+                m_statistics.samplesTaken += static_cast<uint64_t>(desc.size.x) * desc.size.y * passSampleCount;
+                m_checkpoint.finishedBlocks[i] = 1;
+                writeCheckpointIfDue(&evenPasses);
+            }
+        });
+
+        if (m_renderStatus == RenderStatus::Interrupted) {
+            if (!m_checkpointSettings.path.empty()) {
+                std::lock_guard<std::mutex> lock(m_imageMutex);
+                writeCheckpoint(&evenPasses);
+            }
+            break;
+        }
+
+        samplesRendered += passSampleCount;
+        const double elapsedTime = m_restoredRenderTime + budgetTimer.getElapsedTime();
+
+        float relativeError = std::numeric_limits<float>::infinity();
+        RayTracerUpdate update;
+        {
+            std::lock_guard<std::mutex> lock(m_imageMutex);
+            m_checkpoint.passesRendered = pass + 1;
+            m_checkpoint.samplesRendered = samplesRendered;
+            std::ranges::fill(m_checkpoint.finishedBlocks, uint8_t{0});
+            refreshImageData();
+            if (pass > 0) {
+                relativeError = estimateRelativeError(m_imageData, evenPasses.getRaw());
+            }
+
+            update.x = 0;
+            update.y = 0;
+            update.width = size.x;
+            update.height = size.y;
+            update.samplesPerPixel = samplesRendered;
+            update.numPixels = numPixels;
+            update.pixelsRendered =
+                static_cast<int>(static_cast<int64_t>(numPixels) * samplesRendered / targetSampleCount);
+            update.totalTimeSpentRendering = static_cast<float>(elapsedTime);
+            update.data = m_imageData;
+            update.albedo = m_featureData.albedo;
+            update.normal = m_featureData.normal;
+            update.depth = m_featureData.depth;
+        }
+
+        // The copies in the update are denoised without holding the image, which readers may want in the meantime.
+        if (m_denoiserSettings.enabled && m_denoiserSettings.denoiseProgressivePasses) {
+            FeatureImages features{
+                .albedo = std::move(update.albedo),
+                .normal = std::move(update.normal),
+                .depth = std::move(update.depth),
+            };
+            update.denoisedData = Denoiser(m_denoiserSettings).denoise(size, update.data, features);
+            update.albedo = std::move(features.albedo);
+            update.normal = std::move(features.normal);
+            update.depth = std::move(features.depth);
+        }
+        if (m_progressUpdater) {
+            m_progressUpdater(std::move(update));
+        }
+
+        spdlog::debug(
+            "Pass {}: {} spp after {:.3f} s, estimated relative error {:.5f}.",
+            pass,
+            samplesRendered,
+            elapsedTime,
+            relativeError);
+
+        if (m_progressiveSettings.timeBudget > 0.0 && elapsedTime >= m_progressiveSettings.timeBudget) {
+            spdlog::info("Time budget of {} s reached at {} spp.", m_progressiveSettings.timeBudget, samplesRendered);
+            break;
+        }
+
+        if (relativeError < m_progressiveSettings.convergenceThreshold) {
+            spdlog::info("Converged to relative error {:.5f} at {} spp.", relativeError, samplesRendered);
+            break;
+        }
+    }
+}
+
+void RayTracer::denoiseImage() {
+    const Timer<std::chrono::duration<double>> denoiseTimer;
+    const glm::ivec2 size = m_image.getSize();
+    std::vector<float> denoisedData = Denoiser(m_denoiserSettings).denoise(size, getImageData(), getFeatureData());
+    const double denoiseTime = denoiseTimer.getElapsedTime();
+    spdlog::info("Denoised image in {:.3f} s.", denoiseTime);
+
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    m_denoisedData = std::move(denoisedData);
+    m_statistics.denoiseTime = denoiseTime;
+}
+
+std::vector<ImageBlock::Descriptor> RayTracer::createBlockDescriptors(int width, int height) {
+    return TileScheduler::createSpiralBlocks(glm::ivec2(width, height), BlockSize);
+}
+
 void RayTracer::generateImageBlocks(int width, int height) {
-    m_descriptorQueue.clear();
-    int numRows = (height - 1) / BlockSize + 1;
-    int numCols = (width - 1) / BlockSize + 1;
-
-    std::vector<ImageBlock::Descriptor> descriptors;
-    int currRow = 0;
-    int currCol = 0;
-    while (currRow < height) {
-        int currHeight = BlockSize;
-        if (currRow + BlockSize > height) {
-            currHeight = height - currRow;
-        }
-
-        currCol = 0;
-        while (currCol < width) {
-            int currWidth = BlockSize;
-            if (currCol + BlockSize > width) {
-                currWidth = width - currCol;
+    m_blockDescriptors = createBlockDescriptors(width, height);
+    m_blocksRendered = 0;
+    m_pixelsRendered = 0;
+    std::vector<size_t> pendingBlocks;
+    for (size_t i = 0; i < m_blockDescriptors.size(); ++i) {
+        if (m_checkpoint.finishedBlocks[i]) {
+            m_blocksRendered++;
+            m_pixelsRendered += m_blockDescriptors[i].size.x * m_blockDescriptors[i].size.y;
+        } else {
+            pendingBlocks.push_back(i);
+        }
+    }
+
+    const std::vector<double> costs =
+        m_tileSchedulingSettings.costOrdered ? estimateBlockCosts(pendingBlocks) : std::vector<double>();
+    {
+        std::lock_guard<std::mutex> lock(m_imageMutex);
+        std::ranges::fill(m_renderTimeData, 0.0f);
+    }
+
+    // A checkpoint flags whole blocks, so it could not tell which parts of a split block are already in the image.
+    const int minTileSize = m_checkpointSettings.path.empty() ? m_tileSchedulingSettings.minTileSize : 0;
+    m_tileScheduler.reset(
+        m_blockDescriptors, pendingBlocks, costs, tbb::this_task_arena::max_concurrency(), minTileSize);
+    m_totalBlocks = static_cast<int>(m_blockDescriptors.size());
+}
+
+std::vector<double> RayTracer::estimateBlockCosts(const std::vector<size_t>& pendingBlocks) {
+    std::vector<double> costs(m_blockDescriptors.size(), 0.0);
+    bool hasPreviousFrame = true;
+    {
+        std::lock_guard<std::mutex> lock(m_imageMutex);
+        const int imageWidth = m_image.getSize().x;
+        for (const size_t index : pendingBlocks) {
+            const ImageBlock::Descriptor& desc = m_blockDescriptors[index];
+            for (int y = desc.offset.y; y < desc.offset.y + desc.size.y; ++y) {
+                for (int x = desc.offset.x; x < desc.offset.x + desc.size.x; ++x) {
+                    costs[index] += m_renderTimeData[(static_cast<size_t>(y) * imageWidth + x) * 4];
+                }
             }
+            hasPreviousFrame = hasPreviousFrame && costs[index] > 0.0;
+        }
+    }
+    if (hasPreviousFrame) {
+        spdlog::info("Ordering blocks by the render time of the previous frame.");
+        return costs;
+    }
 
-            ImageBlock::Descriptor desc(currCol, currRow, currWidth, currHeight);
-            descriptors.push_back(desc);
+    const int stride = m_tileSchedulingSettings.prepassStride;
+    if (stride <= 0) {
+        return {};
+    }
 
-            currCol += BlockSize;
+    // The pre-pass takes sample 0 of its pixels again, and its samples are discarded rather than kept in the image.
+    const Timer<std::chrono::duration<double>> prepassTimer;
+    SamplerPool samplers([this] { return m_scene->getSampler()->clone(); });
+    tbb::enumerable_thread_specific<ImageBlock> blocks;
+    std::atomic<uint64_t> prepassRays{0};
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pendingBlocks.size()), [&](const tbb::blocked_range<size_t>& r) {
+        for (size_t i = r.begin(); i < r.end(); ++i) {
+            const ImageBlock::Descriptor& desc = m_blockDescriptors[pendingBlocks[i]];
+            ImageBlock& block = blocks.local();
+            block.initialize(desc.offset, desc.size, m_scene->getCamera()->getReconstructionFilter());
+            block.clear();
+            Sampler& sampler = *samplers.local();
+            sampler.prepare();
+            const Timer<std::chrono::duration<double>> blockTimer;
+            const uint64_t raysBefore = pt::Scene::getThreadRayCount();
+            samplePixels(block, sampler, m_scene.get(), createPixelList(desc.size, stride), 0);
+            costs[pendingBlocks[i]] = blockTimer.getElapsedTime();
+            prepassRays.fetch_add(pt::Scene::getThreadRayCount() - raysBefore, std::memory_order_relaxed);
         }
+    });
+    {
+        // The pre-pass is part of the render time, so its rays count towards the ray throughput as well.
+        std::lock_guard<std::mutex> lock(m_imageMutex);
+        m_statistics.raysTraced += prepassRays.load(std::memory_order_relaxed);
+    }
+    spdlog::info("Estimated the cost of {} blocks in {:.3f} s.", pendingBlocks.size(), prepassTimer.getElapsedTime());
+    return costs;
+}
+
+void RayTracer::refreshImageData() {
+    const glm::ivec2 size = m_image.getSize();
+    const ImageBlock::Descriptor imageDesc(0, 0, size.x, size.y);
+    m_image.writeRgba(imageDesc, m_imageData, glm::ivec2(0), size.x);
+    m_image.writeFeatures(
+        imageDesc, m_featureData.albedo, m_featureData.normal, m_featureData.depth, glm::ivec2(0), size.x);
+    m_sampleCountData = m_image.getSampleCountRaw();
+    m_varianceData = m_image.getVarianceRaw();
+}
+
+void RayTracer::writeCheckpoint(const ImageBlock* evenPasses) {
+    const auto now = std::chrono::steady_clock::now();
+    m_checkpoint.renderTime =
+        m_restoredRenderTime + std::chrono::duration<double>(now - m_renderStartTime).count();
+
+    const Timer<std::chrono::duration<double>> writeTimer;
+    const auto result = writeRenderCheckpoint(m_checkpointSettings.path, m_checkpoint, m_image, evenPasses);
+    if (result.isValid()) {
+        spdlog::info(
+            "Wrote checkpoint {} in {:.3f} s.", m_checkpointSettings.path.string(), writeTimer.getElapsedTime());
+    }
+    m_lastCheckpointTime = std::chrono::steady_clock::now();
+}
+
+void RayTracer::writeCheckpointIfDue(const ImageBlock* evenPasses) {
+    if (m_checkpointSettings.path.empty() ||
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - m_lastCheckpointTime).count() <
+            m_checkpointSettings.interval) {
+        return;
+    }
+    writeCheckpoint(evenPasses);
+}
 
-        currRow += BlockSize;
+bool RayTracer::restoreCheckpoint(ImageBlock* evenPasses) {
+    const std::filesystem::path& path = m_checkpointSettings.path;
+    if (!std::filesystem::exists(path)) {
+        spdlog::info("No checkpoint found at {}, starting a new render.", path.string());
+        return false;
     }
 
-    std::vector<std::vector<unsigned int>> indexMat(numRows, std::vector<unsigned>(numCols));
-    for (int i = 0; i < numRows; ++i) {
-        for (int j = 0; j < numCols; ++j) {
-            indexMat[i][j] = i * numCols + j;
+    auto checkpoint = readRenderCheckpoint(path, m_image, evenPasses);
+    const Result<> validation =
+        checkpoint ? validateCheckpoint(*checkpoint, m_checkpoint) : resultError("{}", checkpoint.getError());
+    if (!validation.isValid()) {
+        spdlog::warn("Cannot resume from {}: {}. Starting a new render.", path.string(), validation.getError());
+        m_image.clear();
+        if (evenPasses) {
+            evenPasses->clear();
         }
+        return false;
     }
 
-    std::vector<unsigned int> indices;
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    m_checkpoint = checkpoint.extract();
+    m_restoredRenderTime = m_checkpoint.renderTime;
+    refreshImageData();
+    spdlog::info("Resuming render from {} after {:.3f} s of rendering.", path.string(), m_restoredRenderTime);
+    return true;
+}
 
-    int i;
-    int k = 0;
-    int l = 0;
-    int m = numRows;
-    int n = numCols;
+bool RayTracer::isImageComplete() const {
+    std::lock_guard<std::mutex> lock(m_imageMutex);
+    return m_blocksRendered == m_totalBlocks;
+}
 
-    while (k < m && l < n) {
-        for (i = l; i < n; ++i) {
-            indices.push_back(indexMat[k][i]);
+void RayTracer::coordinateWorkers(const std::function<void()>& renderLocalBlocks) {
+    auto listenResult = ListenSocket::listen(m_distributedSettings.port, m_distributedSettings.bindAddress);
+    if (!listenResult) {
+        spdlog::warn("Rendering without workers: {}", listenResult.getError());
+        renderLocalBlocks();
+        return;
+    }
+    ListenSocket listener = listenResult.extract();
+    spdlog::info("Accepting workers on {}:{}.", m_distributedSettings.bindAddress, listener.getPort());
+
+    std::atomic<bool> isAccepting = true;
+    std::thread acceptThread([this, &listener, &isAccepting] {
+        std::vector<std::thread> connections;
+        while (isAccepting) {
+            auto socket = listener.accept(kWorkerPollInterval);
+            if (!socket) {
+                break;
+            }
+            if (socket->isOpen()) {
+                connections.emplace_back([this, connection = socket.extract()]() mutable {
+                    // Failures are logged where they occur, and the block in flight is queued again.
+                    std::ignore = serveWorker(connection);
+                });
+            }
         }
-        k++;
-        for (i = k; i < m; ++i) {
-            indices.push_back(indexMat[i][n - 1]);
+        for (auto& connection : connections) {
+            connection.join();
         }
-        n--;
+    });
+
+    // Blocks of workers that disconnect are queued again and picked up by the remaining workers or the local threads.
+    while (!isImageComplete() && m_renderStatus != RenderStatus::Interrupted) {
+        if (m_distributedSettings.renderLocally) {
+            renderLocalBlocks();
+        }
+        std::this_thread::sleep_for(kWorkerPollInterval);
+    }
+
+    isAccepting = false;
+    acceptThread.join();
+}
+
+Result<> RayTracer::serveWorker(Socket& socket) {
+    // A stalled worker would otherwise hold its block, and the coordinator, until the connection drops.
+    socket.setReceiveTimeout(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::duration<double>(m_distributedSettings.workerTimeout)));
+    CRISP_TRY(const auto hello, receiveMessage(socket));
+    CRISP_TRY(const auto helloMessage, hello.read<HelloMessage>());
+    if (hello.type != TileMessageType::Hello || helloMessage.protocolVersion != kTileProtocolVersion ||
+        helloMessage.sceneHash != m_sceneHash) {
+        const std::string reason = "the worker runs a different version or loaded a different scene";
+        CRISP_TRY(sendMessage(socket, TileMessageType::Reject, std::as_bytes(std::span(reason))));
+        return resultError("Rejected worker: {}", reason);
+    }
 
-        if (k < m) {
-            for (i = n - 1; i >= l; --i) {
-                indices.push_back(indexMat[m - 1][i]);
+    const WelcomeMessage welcome{
+        .adaptive = m_adaptiveSettings.enabled ? 1u : 0u,
+        .minSamplesPerPixel = m_adaptiveSettings.minSamplesPerPixel,
+        .maxSamplesPerPixel = m_adaptiveSettings.maxSamplesPerPixel,
+        .samplesPerPass = m_adaptiveSettings.samplesPerPass,
+        .errorThreshold = m_adaptiveSettings.errorThreshold,
+    };
+    CRISP_TRY(sendMessage(socket, TileMessageType::Welcome, welcome));
+
+    const ReconstructionFilter* filter = m_scene->getCamera()->getReconstructionFilter();
+    const auto sampleCount = static_cast<uint32_t>(m_scene->getSampler()->getSampleCount());
+    ImageBlock block;
+    while (true) {
+        const std::optional<ScheduledTile> scheduledTile =
+            m_renderStatus == RenderStatus::Interrupted ? std::nullopt : m_tileScheduler.pop();
+        if (!scheduledTile) {
+            if (m_renderStatus == RenderStatus::Interrupted || isImageComplete()) {
+                return sendMessage(socket, TileMessageType::Done, std::span<const std::byte>());
             }
-            m--;
+            // Blocks of other workers may still be queued again.
+            std::this_thread::sleep_for(kWorkerPollInterval);
+            continue;
         }
 
-        if (l < n) {
-            for (i = m - 1; i >= k; --i) {
-                indices.push_back(indexMat[i][l]);
+        const ImageBlock::Descriptor& desc = scheduledTile->desc;
+        const TileMessage tile{desc.offset.x, desc.offset.y, desc.size.x, desc.size.y, 0, sampleCount};
+        auto result = [&]() -> Result<TileResultMessage> {
+            CRISP_TRY(sendMessage(socket, TileMessageType::Tile, tile));
+            CRISP_TRY(const auto reply, receiveMessage(socket));
+            if (reply.type != TileMessageType::TileResult) {
+                return resultError("Expected a tile result, received message {}", static_cast<uint32_t>(reply.type));
             }
-            l++;
+            CRISP_TRY(const auto tileResult, reply.read<TileResultMessage>());
+            std::istringstream stream(reply.payload.substr(sizeof(TileResultMessage)));
+            block.initialize(desc.offset, desc.size, filter);
+            CRISP_TRY(block.read(stream));
+            return tileResult;
+        }();
+        if (!result) {
+            m_tileScheduler.push(*scheduledTile);
+            return resultError(
+                "Lost worker while it rendered block {}: {}", scheduledTile->blockIndex, result.getError());
         }
+
+        updateProgress(block, *scheduledTile, result->renderTime, result->raysTraced);
     }
+}
 
-    for (auto idx = 0; idx < indices.size() / 2; ++idx) {
-        std::swap(indices[idx], indices[indices.size() - 1 - idx]);
+void RayTracer::runWorker() {
+    const int connectionCount = m_distributedSettings.workerConnections > 0
+                                    ? m_distributedSettings.workerConnections
+                                    : tbb::this_task_arena::max_concurrency();
+    spdlog::info(
+        "Rendering blocks for {}:{} on {} connection(s).",
+        m_distributedSettings.host,
+        m_distributedSettings.port,
+        connectionCount);
+
+    // Every connection renders one block at a time on its own thread, so the connection count sets the parallelism.
+    std::vector<std::thread> connections;
+    for (int i = 0; i < connectionCount; ++i) {
+        connections.emplace_back([this] {
+            // Failures are logged where they occur.
+            std::ignore = runWorkerConnection();
+        });
+    }
+    for (auto& connection : connections) {
+        connection.join();
     }
+}
 
-    for (auto idx : indices) {
-        m_descriptorQueue.push(descriptors[idx]);
+Result<> RayTracer::runWorkerConnection() {
+    const std::string& host = m_distributedSettings.host;
+    const uint16_t port = m_distributedSettings.port;
+    Result<Socket> connectResult = Socket::connect(host, port);
+    for (int attempt = 1; !connectResult && attempt < kWorkerConnectAttempts; ++attempt) {
+        if (m_renderStatus == RenderStatus::Interrupted) {
+            return kResultSuccess;
+        }
+        std::this_thread::sleep_for(kWorkerConnectInterval);
+        connectResult = Socket::connect(host, port);
     }
+    CRISP_TRY(auto socket, std::move(connectResult));
 
-    m_blocksRendered = 0;
-    m_pixelsRendered = 0;
-    m_totalBlocks = static_cast<int>(m_descriptorQueue.unsafe_size());
+    const HelloMessage hello{.protocolVersion = kTileProtocolVersion, .sceneHash = m_sceneHash};
+    CRISP_TRY(sendMessage(socket, TileMessageType::Hello, hello));
+    CRISP_TRY(const auto reply, receiveMessage(socket));
+    if (reply.type != TileMessageType::Welcome) {
+        return resultError("The coordinator at {}:{} rejected this worker: {}", host, port, reply.payload);
+    }
+    CRISP_TRY(const auto welcome, reply.read<WelcomeMessage>());
+    const AdaptiveSamplingSettings adaptiveSettings{
+        .enabled = welcome.adaptive != 0,
+        .minSamplesPerPixel = welcome.minSamplesPerPixel,
+        .maxSamplesPerPixel = welcome.maxSamplesPerPixel,
+        .samplesPerPass = welcome.samplesPerPass,
+        .errorThreshold = welcome.errorThreshold,
+    };
+
+    const std::unique_ptr<Sampler> sampler = m_scene->getSampler()->clone();
+    const ReconstructionFilter* filter = m_scene->getCamera()->getReconstructionFilter();
+    ImageBlock block;
+    while (m_renderStatus != RenderStatus::Interrupted) {
+        CRISP_TRY(const auto message, receiveMessage(socket));
+        if (message.type == TileMessageType::Done) {
+            break;
+        }
+        CRISP_TRY(const auto tile, message.read<TileMessage>());
+
+        const Timer<std::chrono::duration<double>> tileTimer;
+        const uint64_t raysBefore = pt::Scene::getThreadRayCount();
+        block.initialize(glm::ivec2(tile.x, tile.y), glm::ivec2(tile.width, tile.height), filter);
+        if (adaptiveSettings.enabled) {
+            if (!renderBlockAdaptive(block, *sampler, m_scene.get(), adaptiveSettings)) {
+                break;
+            }
+        } else {
+            renderBlock(block, *sampler, m_scene.get(), tile.firstSample, tile.sampleCount);
+        }
+        const TileResultMessage result{
+            .raysTraced = pt::Scene::getThreadRayCount() - raysBefore,
+            .renderTime = static_cast<float>(tileTimer.getElapsedTime()),
+        };
+
+        std::ostringstream stream;
+        stream.write(reinterpret_cast<const char*>(&result), sizeof(result));
+        block.write(stream);
+        const std::string payload = std::move(stream).str();
+        CRISP_TRY(sendMessage(socket, TileMessageType::TileResult, std::as_bytes(std::span(payload))));
+
+        std::lock_guard<std::mutex> lock(m_imageMutex);
+        m_statistics.raysTraced += result.raysTraced;
+        m_statistics.samplesTaken += block.getTotalSampleCount();
+    }
+    return kResultSuccess;
 }
 
-void RayTracer::renderBlock(ImageBlock& block, Sampler& sampler, const pt::Scene* scene) {
+void RayTracer::renderBlock(
+    ImageBlock& block, Sampler& sampler, const pt::Scene* scene, size_t firstSampleIndex, size_t numSamples) {
     block.clear();
-    glm::ivec2 offset = block.getOffset();
+    sampler.prepare();
 
-    const Camera* camera = scene->getCamera();
-    const Integrator* integrator = scene->getIntegrator();
-    size_t numSamples = sampler.getSampleCount();
+    const std::vector<glm::ivec2> pixels = createPixelList(block.getSize());
+    for (size_t s = firstSampleIndex; s < firstSampleIndex + numSamples; ++s) {
+        samplePixels(block, sampler, scene, pixels, static_cast<uint32_t>(s));
+    }
+}
+
+bool RayTracer::renderBlockAdaptive(
+    ImageBlock& block, Sampler& sampler, const pt::Scene* scene, const AdaptiveSamplingSettings& settings) {
+    block.clear();
     sampler.prepare();
 
-    for (int y = 0; y < block.getFullSize().y; ++y) {
-        for (int x = 0; x < block.getFullSize().x; ++x) {
-            for (int s = 0; s < numSamples; s++) {
-                glm::vec2 pixelSample(x + offset.x + sampler.next1D(), y + offset.y + sampler.next1D());
-                glm::vec2 apertureSample = sampler.next2D();
+    const int minSampleCount = std::max(settings.minSamplesPerPixel, 2);
+    const int maxSampleCount = settings.maxSamplesPerPixel > 0
+                                   ? settings.maxSamplesPerPixel
+                                   : 4 * static_cast<int>(sampler.getSampleCount());
+    const int samplesPerPass = std::max(settings.samplesPerPass, 1);
 
-                Ray3 ray;
-                Spectrum response = camera->sampleRay(ray, pixelSample, apertureSample);
-                Spectrum radiance = integrator->Li(scene, sampler, ray);
-                block.addSample(pixelSample, response * radiance);
+    const std::vector<glm::ivec2> pixels = createPixelList(block.getSize());
+    for (int s = 0; s < minSampleCount; ++s) {
+        samplePixels(block, sampler, scene, pixels, s);
+    }
+
+    // A pixel's error only changes while it is being sampled, so once it drops out it stays out and all active pixels
+    // share the pass counter below.
+    std::vector<glm::ivec2> activePixels;
+    activePixels.reserve(pixels.size());
+    for (int sampleCount = minSampleCount; sampleCount < maxSampleCount;) {
+        if (m_renderStatus == RenderStatus::Interrupted) {
+            return false;
+        }
+
+        activePixels.clear();
+        for (const glm::ivec2& pixel : pixels) {
+            if (block.getPixelStatistics(pixel.x, pixel.y).getRelativeError() > settings.errorThreshold) {
+                activePixels.push_back(pixel);
             }
         }
+
+        if (activePixels.empty()) {
+            return true;
+        }
+
+        const int passSampleCount = std::min(samplesPerPass, maxSampleCount - sampleCount);
+        for (int s = sampleCount; s < sampleCount + passSampleCount; ++s) {
+            samplePixels(block, sampler, scene, activePixels, s);
+        }
+        sampleCount += passSampleCount;
     }
+    return true;
 }
 } // namespace crisp
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <functional>
 #include <mutex>
 #include <string>
 #include <thread>
 
-#include <tbb/concurrent_queue.h>
-
+#include <Crisp/Core/Result.hpp>
+#include <Crisp/Image/Io/Exr.hpp>
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
+#include <Crisp/PathTracer/Denoiser.hpp>
 #include <Crisp/PathTracer/ImageBlock.hpp>
 #include <Crisp/PathTracer/RayTracerUpdate.hpp>
+#include <Crisp/PathTracer/RenderCheckpoint.hpp>
+#include <Crisp/PathTracer/TileScheduler.hpp>
 
 namespace crisp {
 namespace pt {
@@ -18,39 +23,204 @@ class Scene;
 }
 
 class Sampler;
+class Socket;
+
+struct RayTracerStatistics {
+    double sceneParseTime{0.0};        // Seconds spent parsing the scene, excluding the BVH build.
+    double accelerationBuildTime{0.0}; // Seconds spent committing the Embree BVH.
+    double preprocessTime{0.0};        // Seconds spent in Integrator::preprocess.
+    double renderTime{0.0};            // Wall-clock seconds spent rendering image blocks.
+    double denoiseTime{0.0};           // Seconds spent denoising the final image.
+    size_t shapeCount{0};
+    size_t shapeMemory{0};            // Bytes of shape data, which Embree reads in place.
+    size_t accelerationMemory{0};     // Bytes held by Embree after the BVH commit.
+    size_t peakAccelerationMemory{0}; // Embree high-water mark in bytes, including build scratch memory.
+    uint64_t raysTraced{0};
+    uint64_t samplesTaken{0};
+    uint64_t textureTileHits{0};
+    uint64_t textureTileMisses{0}; // Tiles read from the texture cache files.
+    uint64_t textureTileEvictions{0};
+    size_t peakTextureMemory{0}; // Texture cache high-water mark in bytes.
+    size_t tileSplits{0};        // Tiles split at the end of a block render to keep all threads busy.
+    RenderCounters counters;     // Recorded while rendering, after the integrator preprocess.
+};
+
+struct ProgressiveRenderSettings {
+    bool enabled{false};
+    int samplesPerPass{1};
+    int targetSamplesPerPixel{0}; // Uses the sample count of the scene sampler when 0.
+    double timeBudget{0.0};       // Seconds, no limit when 0.
+    float convergenceThreshold{0.0f};
+};
+
+struct AdaptiveSamplingSettings {
+    bool enabled{false};
+    int minSamplesPerPixel{16};
+    int maxSamplesPerPixel{0}; // Uses four times the sample count of the scene sampler when 0.
+    int samplesPerPass{4};
+    float errorThreshold{0.01f};
+};
+
+struct CheckpointSettings {
+    std::filesystem::path path; // Checkpointing is disabled when empty.
+    double interval{300.0};     // Seconds between checkpoints.
+    bool resume{false};         // Continues the render saved at path, if it was started from the same scene.
+};
+
+// Block renders hand out the most expensive blocks first. Their cost is the render time of the previous frame when
+// the image size is unchanged, and is otherwise estimated by a pre-pass that takes one sample in every
+// prepassStride-th pixel of each block in both directions. Tiles are split down to minTileSize once the threads start
+// running out of work, unless the render is checkpointed.
+struct TileSchedulingSettings {
+    bool costOrdered{true};
+    int prepassStride{4}; // No pre-pass when 0, blocks without a previous frame then keep the spiral order.
+    int minTileSize{16};  // Tiles are never split when 0.
+};
+
+// Spreads the blocks of one frame over several processes. The coordinator renders the scene as usual and additionally
+// hands out blocks to every worker that connects, merging the blocks they send back into its image. Workers load the
+// same scene, render the blocks they are given and have no image of their own.
+struct DistributedRenderSettings {
+    enum class Role { Local, Coordinator, Worker };
+
+    Role role{Role::Local};
+    std::string host{"127.0.0.1"};        // Coordinator address that workers connect to.
+    uint16_t port{29170};                 // Coordinator port; the coordinator picks any free port when 0.
+    std::string bindAddress{"127.0.0.1"}; // Interface the coordinator listens on, 0.0.0.0 for all of them.
+    bool renderLocally{true};             // Whether the coordinator also renders blocks with its own threads.
+    int workerConnections{0};             // Blocks a worker renders at once, the TBB thread count when 0.
+    double workerTimeout{300.0};          // Seconds a worker may go silent before it is lost, no limit when 0.
+};
 
 class RayTracer {
 public:
     RayTracer();
     ~RayTracer();
 
-    void initializeScene(const std::filesystem::path& sceneFilePath, const std::filesystem::path& resourceDirectory);
+    // Meshes and textures are cached in the given directories, see JsonSceneParser::parse.
+    Result<> initializeScene(
+        const std::filesystem::path& sceneFilePath,
+        const std::filesystem::path& resourceDirectory,
+        const std::filesystem::path& meshCacheDirectory = {},
+        const std::filesystem::path& textureCacheDirectory = {});
     void start();
     void stop();
 
+    // Blocks the calling thread until the render started by start() has finished or was stopped.
+    void waitForCompletion();
+    bool isRendering() const;
+
+    // In progressive mode every pass adds samplesPerPass samples to all pixels and streams the whole image through the
+    // progress updater. Rendering stops at the target sample count, the time budget or once the estimated mean
+    // relative error falls below the convergence threshold, whichever comes first.
+    void setProgressiveSettings(const ProgressiveRenderSettings& settings);
+
+    // In adaptive mode every pixel of a block first receives minSamplesPerPixel samples. Afterwards only pixels whose
+    // relative standard error is still above the threshold are sampled further, up to maxSamplesPerPixel, and a block
+    // is done once none are left. Applies to block rendering; progressive passes always sample every pixel.
+    void setAdaptiveSettings(const AdaptiveSamplingSettings& settings);
+
+    // Denoises the final image once rendering has finished, and optionally the image of every progressive pass.
+    void setDenoiserSettings(const DenoiserSettings& settings);
+
+    // Periodically saves the accumulated image and the progress of the render, and once more when it is stopped. A
+    // resumed render skips the blocks and passes that were already finished and ends with the same image as a render
+    // that was never interrupted.
+    void setCheckpointSettings(const CheckpointSettings& settings);
+
+    // Applies to block rendering; progressive renders always run locally.
+    void setDistributedSettings(const DistributedRenderSettings& settings);
+
+    // Applies to block rendering; progressive passes render every block anyway.
+    void setTileSchedulingSettings(const TileSchedulingSettings& settings);
+
     void setImageSize(int width, int height);
     glm::ivec2 getImageSize() const;
 
+    // Returns the RGBA image assembled from all blocks rendered so far.
+    std::vector<float> getImageData() const;
+    // Returns the number of samples taken in each pixel, replicated across RGB.
+    std::vector<float> getSampleCountData() const;
+    // Returns the variance of each pixel's mean luminance, replicated across RGB.
+    std::vector<float> getVarianceData() const;
+    // Returns the first-hit albedo, shading normal and depth averaged over the samples of each pixel.
+    FeatureImages getFeatureData() const;
+    // Returns the seconds spent on each pixel, the render time of its tile spread evenly over the tile, replicated
+    // across RGB. Only block renders record it.
+    std::vector<float> getRenderTimeData() const;
+    // Returns the denoised image, which is empty unless denoising is enabled and a render has finished.
+    std::vector<float> getDenoisedImageData() const;
+    RayTracerStatistics getStatistics() const;
+
+    // Writes the image together with the denoised image, the features, the variance and the sample counts as layers of
+    // one EXR file. Color layers use the given pixel type; depth and sample counts are always written as floats.
+    Result<> writeLayeredExr(
+        const std::filesystem::path& path, ExrPixelType colorPixelType, const ExrWriteOptions& options) const;
+
+    // Writes the render counters of the last render as JSON.
+    Result<> writeStatisticsReport(const std::filesystem::path& path) const;
+
     void setProgressUpdater(std::function<void(RayTracerUpdate&&)> callback);
 
 private:
-    void updateProgress(RayTracerUpdate&& update, float blockRenderTime);
+    void updateProgress(
+        const ImageBlock& block, const ScheduledTile& tile, float blockRenderTime, uint64_t raysTraced);
+    static std::vector<ImageBlock::Descriptor> createBlockDescriptors(int width, int height);
     void generateImageBlocks(int width, int height);
-
-    void renderBlock(ImageBlock& block, Sampler& sampler, const pt::Scene* scene);
+    // Returns one cost per block descriptor, or nothing when the blocks should keep their spiral order.
+    std::vector<double> estimateBlockCosts(const std::vector<size_t>& pendingBlocks);
+    void refreshImageData();
+
+    // Both expect m_imageMutex to be held. The even pass image is only kept by progressive renders.
+    void writeCheckpoint(const ImageBlock* evenPasses);
+    void writeCheckpointIfDue(const ImageBlock* evenPasses);
+    bool restoreCheckpoint(ImageBlock* evenPasses);
+    bool isImageComplete() const;
+
+    void coordinateWorkers(const std::function<void()>& renderLocalBlocks);
+    Result<> serveWorker(Socket& socket);
+    void runWorker();
+    Result<> runWorkerConnection();
+
+    void renderImageBlocks();
+    void renderProgressive();
+    void renderBlock(
+        ImageBlock& block, Sampler& sampler, const pt::Scene* scene, size_t firstSampleIndex, size_t numSamples);
+    bool renderBlockAdaptive(
+        ImageBlock& block, Sampler& sampler, const pt::Scene* scene, const AdaptiveSamplingSettings& settings);
+    void denoiseImage();
 
     enum class RenderStatus { Free, Busy, Interrupted, Done };
 
     std::unique_ptr<pt::Scene> m_scene;
     ImageBlock m_image;
-    tbb::concurrent_queue<ImageBlock::Descriptor> m_descriptorQueue;
+    std::vector<ImageBlock::Descriptor> m_blockDescriptors;
+    TileScheduler m_tileScheduler;
+    uint64_t m_sceneHash{0};
 
     std::function<void(RayTracerUpdate&&)> m_progressUpdater;
+    ProgressiveRenderSettings m_progressiveSettings;
+    AdaptiveSamplingSettings m_adaptiveSettings;
+    DenoiserSettings m_denoiserSettings;
+    CheckpointSettings m_checkpointSettings;
+    DistributedRenderSettings m_distributedSettings;
+    TileSchedulingSettings m_tileSchedulingSettings;
 
     std::thread m_renderThread;
     std::atomic<RenderStatus> m_renderStatus;
     std::atomic<float> m_progress;
-    std::mutex m_imageMutex;
+    mutable std::mutex m_imageMutex;
+    std::vector<float> m_imageData;
+    std::vector<float> m_sampleCountData;
+    std::vector<float> m_varianceData;
+    std::vector<float> m_renderTimeData;
+    FeatureImages m_featureData;
+    std::vector<float> m_denoisedData;
+    RayTracerStatistics m_statistics;
+    RenderCheckpoint m_checkpoint;
+    std::chrono::steady_clock::time_point m_renderStartTime;
+    std::chrono::steady_clock::time_point m_lastCheckpointTime;
+    double m_restoredRenderTime{0.0};
 
     float m_timeSpentRendering;
     int m_pixelsRendered;
@@ -11,6 +11,15 @@ struct RayTracerUpdate {
     int y;
     int width;
     int height;
+    int samplesPerPixel;
     std::vector<float> data;
+
+    // First-hit albedo, shading normal and depth of the same region, in the RGBA layout of data.
+    std::vector<float> albedo;
+    std::vector<float> normal;
+    std::vector<float> depth;
+
+    // Denoised image of the same region, only filled for progressive passes with denoising enabled.
+    std::vector<float> denoisedData;
 };
 } // namespace crisp
\ No newline at end of file
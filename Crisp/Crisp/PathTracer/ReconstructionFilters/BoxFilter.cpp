@@ -0,0 +1,17 @@
+#include <Crisp/PathTracer/ReconstructionFilters/BoxFilter.hpp>
+
+namespace crisp {
+BoxFilter::BoxFilter() {
+    m_radius = 0.5f;
+
+    initLookupTable();
+}
+
+bool BoxFilter::isBox() const {
+    return true;
+}
+
+float BoxFilter::eval(float /*x*/) const {
+    return 1.0f;
+}
+} // namespace crisp
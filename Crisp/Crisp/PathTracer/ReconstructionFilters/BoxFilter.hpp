@@ -0,0 +1,12 @@
+#pragma once
+
+#include <Crisp/PathTracer/ReconstructionFilters/ReconstructionFilter.hpp>
+
+namespace crisp {
+class BoxFilter : public ReconstructionFilter {
+public:
+    BoxFilter();
+    virtual bool isBox() const override;
+    virtual float eval(float x) const override;
+};
+} // namespace crisp
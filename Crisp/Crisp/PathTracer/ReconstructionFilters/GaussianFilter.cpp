@@ -1,5 +1,6 @@
 #include <Crisp/PathTracer/ReconstructionFilters/GaussianFilter.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 namespace crisp {
@@ -10,10 +11,8 @@ GaussianFilter::GaussianFilter() {
     initLookupTable();
 }
 
-float GaussianFilter::eval(float x, float y) const {
+float GaussianFilter::eval(float x) const {
     float alpha = -1.0f / (2.0f * m_sigma * m_sigma);
-    float evalX = std::max(0.0f, std::exp(alpha * x * x) - std::exp(alpha * m_radius * m_radius));
-    float evalY = std::max(0.0f, std::exp(alpha * y * y) - std::exp(alpha * m_radius * m_radius));
-    return evalX * evalY;
+    return std::max(0.0f, std::exp(alpha * x * x) - std::exp(alpha * m_radius * m_radius));
 }
 } // namespace crisp
\ No newline at end of file
@@ -6,9 +6,9 @@ namespace crisp {
 class GaussianFilter : public ReconstructionFilter {
 public:
     GaussianFilter();
-    virtual float eval(float x, float y) const override;
+    virtual float eval(float x) const override;
 
 private:
     float m_sigma;
 };
-} // namespace crisp
\ No newline at end of file
+} // namespace crisp
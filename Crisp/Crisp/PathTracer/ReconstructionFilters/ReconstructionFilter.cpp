@@ -9,18 +9,16 @@ float ReconstructionFilter::getRadius() const {
     return m_radius;
 }
 
+bool ReconstructionFilter::isBox() const {
+    return false;
+}
+
 void ReconstructionFilter::initLookupTable() {
     for (int i = 0; i < FilterResolution; i++) {
-        for (int j = 0; j < FilterResolution; j++) {
-            float posX = m_radius * j / FilterResolution;
-            float posY = m_radius * i / FilterResolution;
-            m_lookupTable[i][j] = eval(posX, posY);
-        }
-    }
-    for (int i = 0; i < FilterResolution + 1; i++) {
-        m_lookupTable[i][FilterResolution] = m_lookupTable[FilterResolution][i] = 0.0f;
+        m_lookupTable[i] = eval(m_radius * i / FilterResolution);
     }
+    m_lookupTable[FilterResolution] = 0.0f;
 
     m_lookupFactor = FilterResolution / m_radius;
 }
-} // namespace crisp
\ No newline at end of file
+} // namespace crisp
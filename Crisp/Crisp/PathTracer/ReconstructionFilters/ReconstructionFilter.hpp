@@ -1,21 +1,26 @@
 #pragma once
 
 #include <array>
+#include <cmath>
 
 namespace crisp {
+// Reconstruction filters are separable: the weight of a sample at offset (x, y) from a pixel center is
+// eval(x) * eval(y), which lets ImageBlock splat with two short 1D weight arrays.
 class ReconstructionFilter {
 public:
     ReconstructionFilter();
     virtual ~ReconstructionFilter();
 
-    inline float evalDiscrete(float x, float y) const {
-        return m_lookupTable[static_cast<int>(std::abs(y) * m_lookupFactor)]
-                            [static_cast<int>(std::abs(x) * m_lookupFactor)];
+    inline float evalDiscrete(float x) const {
+        return m_lookupTable[static_cast<int>(std::abs(x) * m_lookupFactor)];
     }
 
     float getRadius() const;
 
-    virtual float eval(float x, float y) const = 0;
+    // A box filter of radius 0.5 gives every sample unit weight in the one pixel it falls into.
+    virtual bool isBox() const;
+
+    virtual float eval(float x) const = 0;
 
 protected:
     void initLookupTable();
@@ -23,7 +28,7 @@ protected:
     static const int FilterResolution = 32;
 
     float m_radius;
-    std::array<std::array<float, FilterResolution + 1>, FilterResolution + 1> m_lookupTable;
+    std::array<float, FilterResolution + 1> m_lookupTable;
     float m_lookupFactor;
 };
-} // namespace crisp
\ No newline at end of file
+} // namespace crisp
@@ -0,0 +1,20 @@
+#include <Crisp/PathTracer/ReconstructionFilters/ReconstructionFilterFactory.hpp>
+
+#include <iostream>
+
+#include <Crisp/PathTracer/ReconstructionFilters/BoxFilter.hpp>
+#include <Crisp/PathTracer/ReconstructionFilters/GaussianFilter.hpp>
+
+namespace crisp {
+std::unique_ptr<ReconstructionFilter> ReconstructionFilterFactory::create(const std::string& type) {
+    if (type == "gaussian") {
+        return std::make_unique<GaussianFilter>();
+    } else if (type == "box") {
+        return std::make_unique<BoxFilter>();
+    } else {
+        std::cerr << "Unknown reconstruction filter \"" << type << "\" requested! Creating default gaussian filter"
+                  << std::endl;
+        return std::make_unique<GaussianFilter>();
+    }
+}
+} // namespace crisp
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <Crisp/PathTracer/ReconstructionFilters/ReconstructionFilter.hpp>
+
+namespace crisp {
+class ReconstructionFilterFactory {
+public:
+    static std::unique_ptr<ReconstructionFilter> create(const std::string& type);
+};
+} // namespace crisp
@@ -0,0 +1,125 @@
+#include <Crisp/PathTracer/RenderCheckpoint.hpp>
+
+#include <array>
+#include <fstream>
+
+namespace crisp {
+namespace {
+constexpr std::array<char, 8> kMagic{'C', 'R', 'S', 'P', 'C', 'K', 'P', 'T'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    RenderCheckpoint::Mode mode;
+    uint64_t sceneHash;
+    uint32_t sampleCount;
+    int32_t passesRendered;
+    int32_t samplesRendered;
+    int32_t passSampleCount;
+    double renderTime;
+    uint64_t blockCount;
+};
+} // namespace
+
+Result<> writeRenderCheckpoint(
+    const std::filesystem::path& path,
+    const RenderCheckpoint& checkpoint,
+    const ImageBlock& image,
+    const ImageBlock* evenPasses) {
+    const bool isProgressive = checkpoint.mode == RenderCheckpoint::Mode::Progressive;
+    if (isProgressive != (evenPasses != nullptr)) {
+        return resultError("Progressive checkpoints need the even pass image, other modes do not have one");
+    }
+
+    const auto temporaryPath = std::filesystem::path(path).concat(".tmp");
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return resultError("Failed to create checkpoint file {}", temporaryPath.string());
+        }
+
+        const FileHeader header{
+            kMagic,
+            kVersion,
+            checkpoint.mode,
+            checkpoint.sceneHash,
+            checkpoint.sampleCount,
+            checkpoint.passesRendered,
+            checkpoint.samplesRendered,
+            checkpoint.passSampleCount,
+            checkpoint.renderTime,
+            checkpoint.finishedBlocks.size()};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(
+            reinterpret_cast<const char*>(checkpoint.finishedBlocks.data()),
+            static_cast<std::streamsize>(checkpoint.finishedBlocks.size()));
+        image.write(file);
+        if (evenPasses) {
+            evenPasses->write(file);
+        }
+
+        if (!file) {
+            return resultError("Failed to write checkpoint file {}", temporaryPath.string());
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        return resultError("Failed to move checkpoint file to {}: {}", path.string(), error.message());
+    }
+    return kResultSuccess;
+}
+
+Result<RenderCheckpoint> readRenderCheckpoint(
+    const std::filesystem::path& path, ImageBlock& image, ImageBlock* evenPasses) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return resultError("Failed to open checkpoint file {}", path.string());
+    }
+
+    FileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kMagic) {
+        return resultError("{} is not a checkpoint file", path.string());
+    }
+    if (header.version != kVersion) {
+        return resultError("Checkpoint file {} has version {}, expected {}", path.string(), header.version, kVersion);
+    }
+    const bool isProgressive = header.mode == RenderCheckpoint::Mode::Progressive;
+    if (isProgressive != (evenPasses != nullptr)) {
+        return resultError("Checkpoint file {} was written by a render in a different mode", path.string());
+    }
+
+    std::error_code error;
+    if (header.blockCount > std::filesystem::file_size(path, error) || error) {
+        return resultError("Checkpoint file {} is truncated", path.string());
+    }
+
+    RenderCheckpoint checkpoint{
+        .mode = header.mode,
+        .sceneHash = header.sceneHash,
+        .sampleCount = header.sampleCount,
+        .passesRendered = header.passesRendered,
+        .samplesRendered = header.samplesRendered,
+        .passSampleCount = header.passSampleCount,
+        .renderTime = header.renderTime,
+        .finishedBlocks = std::vector<uint8_t>(header.blockCount),
+    };
+    if (!file.read(
+            reinterpret_cast<char*>(checkpoint.finishedBlocks.data()),
+            static_cast<std::streamsize>(checkpoint.finishedBlocks.size()))) {
+        return resultError("Checkpoint file {} is truncated", path.string());
+    }
+
+    if (const auto result = image.read(file); !result.isValid()) {
+        return resultError("Failed to read checkpoint file {}: {}", path.string(), result.getError());
+    }
+    if (evenPasses) {
+        if (const auto result = evenPasses->read(file); !result.isValid()) {
+            return resultError("Failed to read checkpoint file {}: {}", path.string(), result.getError());
+        }
+    }
+    return checkpoint;
+}
+} // namespace crisp
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <Crisp/Core/Result.hpp>
+#include <Crisp/PathTracer/ImageBlock.hpp>
+
+namespace crisp {
+// State of an unfinished render, saved together with the accumulated image. Samplers are addressed by pixel and sample
+// index, so the samples already taken are all that is needed to continue with exactly the samples an uninterrupted
+// render would have taken.
+struct RenderCheckpoint {
+    enum class Mode : uint32_t { Blocks, AdaptiveBlocks, Progressive };
+
+    Mode mode{Mode::Blocks};
+    uint64_t sceneHash{0};   // Hash of the scene description the render was started from.
+    uint32_t sampleCount{0}; // Sample count of the scene sampler.
+
+    // Progressive mode: passes and samples per pixel that every block has finished, and the sample count of the pass
+    // that was in flight.
+    int32_t passesRendered{0};
+    int32_t samplesRendered{0};
+    int32_t passSampleCount{0};
+
+    double renderTime{0.0}; // Seconds spent rendering up to the checkpoint, over all resumed runs.
+
+    // One flag per block in the order of the block descriptors. Block modes flag the blocks that are done, progressive
+    // mode the blocks that have already finished the pass in flight.
+    std::vector<uint8_t> finishedBlocks;
+};
+
+// Writes the checkpoint with the accumulated image, and in progressive mode the image of every other pass as well. The
+// file is written next to path first and then moved over it, so a render killed while writing keeps its previous
+// checkpoint.
+Result<> writeRenderCheckpoint(
+    const std::filesystem::path& path,
+    const RenderCheckpoint& checkpoint,
+    const ImageBlock& image,
+    const ImageBlock* evenPasses);
+
+// Reads a checkpoint into blocks initialized with the size and filter of the render that wrote it.
+Result<RenderCheckpoint> readRenderCheckpoint(
+    const std::filesystem::path& path, ImageBlock& image, ImageBlock* evenPasses);
+} // namespace crisp
@@ -28,10 +28,12 @@ void FixedSampler::generate() {}
 void FixedSampler::advance() {}
 
 float FixedSampler::next1D() {
+    ++m_state.dimension;
     return nextFloat();
 }
 
 glm::vec2 FixedSampler::next2D() {
+    m_state.dimension += 2;
     return glm::vec2(nextFloat(), nextFloat());
 }
 
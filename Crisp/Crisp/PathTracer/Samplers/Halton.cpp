@@ -0,0 +1,43 @@
+#include <Crisp/PathTracer/Samplers/Halton.hpp>
+
+#include <Crisp/PathTracer/Samplers/LowDiscrepancy.hpp>
+
+namespace crisp {
+namespace {
+// Large bases stratify poorly at practical sample counts, so dimensions past the table reuse the bases with
+// independent scrambles instead of moving on to larger primes.
+constexpr std::array<uint32_t, 32> kPrimes{
+    2,  3,  5,  7,  11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+    59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131};
+} // namespace
+
+HaltonSampler::HaltonSampler(const VariantMap& attribs) {
+    m_sampleCount = attribs.get("samplesPerPixel", 64);
+    m_seed = static_cast<uint64_t>(attribs.get("seed", 0));
+}
+
+HaltonSampler::~HaltonSampler() {}
+
+std::unique_ptr<Sampler> HaltonSampler::clone() const {
+    return std::make_unique<HaltonSampler>(*this);
+}
+
+void HaltonSampler::prepare() {}
+
+void HaltonSampler::generate() {}
+
+void HaltonSampler::advance() {}
+
+float HaltonSampler::next1D() {
+    const uint32_t base = kPrimes[m_state.dimension % kPrimes.size()];
+    const float value =
+        lds::scrambledRadicalInverse(m_state.sampleIndex, base, lds::hashSampleState(m_state, m_seed));
+    ++m_state.dimension;
+    return value;
+}
+
+glm::vec2 HaltonSampler::next2D() {
+    const float x = next1D();
+    return glm::vec2(x, next1D());
+}
+} // namespace crisp
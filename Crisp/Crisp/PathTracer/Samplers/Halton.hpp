@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Crisp/PathTracer/Samplers/Sampler.hpp>
+
+namespace crisp {
+// Halton sequence with one prime base per dimension and per-pixel nested scrambling of the digits.
+class HaltonSampler : public Sampler {
+public:
+    HaltonSampler(const VariantMap& attribs = VariantMap());
+    ~HaltonSampler();
+
+    virtual std::unique_ptr<Sampler> clone() const override;
+
+    virtual void prepare() override;
+    virtual void generate() override;
+    virtual void advance() override;
+
+    virtual float next1D() override;
+    virtual glm::vec2 next2D() override;
+
+private:
+    uint64_t m_seed;
+};
+} // namespace crisp
@@ -1,40 +1,52 @@
 #include <Crisp/PathTracer/Samplers/Independent.hpp>
 
+#include <Crisp/PathTracer/Samplers/LowDiscrepancy.hpp>
+
 namespace crisp {
-IndependentSampler::IndependentSampler(const VariantMap& attribs)
-    : m_randomEngine(std::random_device()())
-    , m_distribution(0.0f, 1.0f) {
+IndependentSampler::IndependentSampler(const VariantMap& attribs) {
     m_sampleCount = attribs.get("samplesPerPixel", 64);
+    m_seed = static_cast<uint64_t>(attribs.get("seed", 0));
 }
 
 IndependentSampler::~IndependentSampler() {}
 
 std::unique_ptr<Sampler> IndependentSampler::clone() const {
-    std::unique_ptr<IndependentSampler> other = std::make_unique<IndependentSampler>();
-    other->m_randomEngine = m_randomEngine;
-    other->m_distribution = m_distribution;
-    other->m_sampleCount = m_sampleCount;
-
-    return other;
+    return std::make_unique<IndependentSampler>(*this);
 }
 
-void IndependentSampler::prepare() {
-    m_randomEngine.seed(std::random_device()());
-}
+void IndependentSampler::prepare() {}
 
 void IndependentSampler::generate() {}
 
 void IndependentSampler::advance() {}
 
 float IndependentSampler::next1D() {
-    return nextFloat();
+    ++m_state.dimension;
+    return m_random.nextFloat();
 }
 
 glm::vec2 IndependentSampler::next2D() {
-    return glm::vec2(nextFloat(), nextFloat());
+    m_state.dimension += 2;
+    const float x = m_random.nextFloat();
+    return glm::vec2(x, m_random.nextFloat());
 }
 
-float IndependentSampler::nextFloat() {
-    return m_distribution(m_randomEngine);
+void IndependentSampler::fill(const std::span<float> values) {
+    m_state.dimension += static_cast<uint32_t>(values.size());
+    for (float& value : values) {
+        value = m_random.nextFloat();
+    }
+}
+
+void IndependentSampler::setSampleState(const SampleState& state) {
+    Sampler::setSampleState(state);
+
+    // Each pixel sample draws from its own stream; restoring a later dimension only needs a short jump.
+    const uint64_t pixel = (static_cast<uint64_t>(static_cast<uint32_t>(state.pixel.x)) << 32) |
+                           static_cast<uint32_t>(state.pixel.y);
+    m_random.setSequence(lds::mixBits(pixel ^ lds::mixBits(m_seed + state.sampleIndex)), m_seed);
+    if (state.dimension > 0) {
+        m_random.advance(state.dimension);
+    }
 }
 } // namespace crisp
@@ -1,10 +1,11 @@
 #pragma once
 
-#include <random>
-
+#include <Crisp/PathTracer/Samplers/Pcg32.hpp>
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
 
 namespace crisp {
+// Uniform random numbers from a PCG32 stream selected by the pixel and sample index, so the values of a pixel sample
+// do not depend on which thread renders it or on what that thread rendered before.
 class IndependentSampler : public Sampler {
 public:
     IndependentSampler(const VariantMap& attribs = VariantMap());
@@ -18,11 +19,12 @@ public:
 
     virtual float next1D() override;
     virtual glm::vec2 next2D() override;
+    virtual void fill(std::span<float> values) override;
 
-private:
-    inline float nextFloat();
+    virtual void setSampleState(const SampleState& state) override;
 
-    std::default_random_engine m_randomEngine;
-    std::uniform_real_distribution<float> m_distribution;
+private:
+    uint64_t m_seed;
+    Pcg32 m_random;
 };
-} // namespace crisp
\ No newline at end of file
+} // namespace crisp
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <Crisp/PathTracer/Samplers/Sampler.hpp>
+
+namespace crisp::lds {
+// 64-bit finalizer with good avalanche behavior, used to derive independent seeds from sample coordinates.
+inline uint64_t mixBits(uint64_t v) {
+    v ^= v >> 31;
+    v *= 0x7fb5d329728ea185ull;
+    v ^= v >> 27;
+    v *= 0x81dadef4bc2dd44dull;
+    v ^= v >> 33;
+    return v;
+}
+
+inline uint64_t hashSampleState(const SampleState& state, const uint64_t seed) {
+    const uint64_t pixel = (static_cast<uint64_t>(static_cast<uint32_t>(state.pixel.x)) << 32) |
+                           static_cast<uint32_t>(state.pixel.y);
+    return mixBits(pixel ^ mixBits(seed + state.dimension));
+}
+
+// Maps the top 24 bits to [0, 1), so the result can never round up to 1.
+inline float toUnitFloat(const uint32_t bits) {
+    return static_cast<float>(bits >> 8) * 0x1p-24f;
+}
+
+inline float toUnitFloat(const uint64_t bits) {
+    return toUnitFloat(static_cast<uint32_t>(bits >> 32));
+}
+
+inline uint32_t reverseBits(uint32_t x) {
+    x = (x << 16) | (x >> 16);
+    x = ((x & 0x00ff00ffu) << 8) | ((x & 0xff00ff00u) >> 8);
+    x = ((x & 0x0f0f0f0fu) << 4) | ((x & 0xf0f0f0f0u) >> 4);
+    x = ((x & 0x33333333u) << 2) | ((x & 0xccccccccu) >> 2);
+    x = ((x & 0x55555555u) << 1) | ((x & 0xaaaaaaaau) >> 1);
+    return x;
+}
+
+// Hash-based base-2 Owen scrambling (Burley, "Practical Hash-based Owen Scrambling", 2020).
+inline uint32_t nestedUniformScramble(uint32_t x, const uint32_t seed) {
+    x = reverseBits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return reverseBits(x);
+}
+
+// Element i of a pseudo-random permutation of [0, length) selected by seed (Kensler, "Correlated Multi-Jittered
+// Sampling", 2013).
+inline uint32_t permutationElement(uint32_t i, const uint32_t length, const uint32_t seed) {
+    uint32_t w = length - 1;
+    w |= w >> 1;
+    w |= w >> 2;
+    w |= w >> 4;
+    w |= w >> 8;
+    w |= w >> 16;
+    do {
+        i ^= seed;
+        i *= 0xe170893du;
+        i ^= seed >> 16;
+        i ^= (i & w) >> 4;
+        i ^= seed >> 8;
+        i *= 0x0929eb3fu;
+        i ^= seed >> 23;
+        i ^= (i & w) >> 1;
+        i *= 1 | seed >> 27;
+        i *= 0x6935fa69u;
+        i ^= (i & w) >> 11;
+        i *= 0x74dcb303u;
+        i ^= (i & w) >> 2;
+        i *= 0x9e501cc3u;
+        i ^= (i & w) >> 2;
+        i *= 0xc860a3dfu;
+        i &= w;
+        i ^= i >> 5;
+    } while (i >= length);
+    return (i + seed) % length;
+}
+
+// Generator matrices of the first four Sobol dimensions, built from the Joe-Kuo primitive polynomials and initial
+// direction numbers. Higher dimensions are padded with independently scrambled copies of these four.
+inline constexpr uint32_t kSobolDimensionCount = 4;
+
+struct SobolDirections {
+    std::array<std::array<uint32_t, 32>, kSobolDimensionCount> v{};
+};
+
+consteval SobolDirections createSobolDirections() {
+    struct Polynomial {
+        uint32_t degree;
+        uint32_t coefficients;
+        std::array<uint32_t, 3> initial;
+    };
+    constexpr std::array<Polynomial, kSobolDimensionCount - 1> kPolynomials{{
+        {1, 0, {1, 0, 0}},
+        {2, 1, {1, 3, 0}},
+        {3, 1, {1, 3, 1}},
+    }};
+
+    SobolDirections directions{};
+    for (uint32_t k = 0; k < 32; ++k) {
+        directions.v[0][k] = 1u << (31 - k);
+    }
+
+    for (uint32_t d = 1; d < kSobolDimensionCount; ++d) {
+        const Polynomial& poly = kPolynomials[d - 1];
+        auto& v = directions.v[d];
+        for (uint32_t k = 0; k < poly.degree; ++k) {
+            v[k] = poly.initial[k] << (31 - k);
+        }
+        for (uint32_t k = poly.degree; k < 32; ++k) {
+            v[k] = v[k - poly.degree] ^ (v[k - poly.degree] >> poly.degree);
+            for (uint32_t j = 1; j < poly.degree; ++j) {
+                if ((poly.coefficients >> (poly.degree - 1 - j)) & 1) {
+                    v[k] ^= v[k - j];
+                }
+            }
+        }
+    }
+
+    return directions;
+}
+
+inline constexpr SobolDirections kSobolDirections = createSobolDirections();
+
+inline uint32_t sobol(uint32_t index, const uint32_t dimension) {
+    uint32_t result = 0;
+    for (uint32_t k = 0; index != 0; index >>= 1, ++k) {
+        if (index & 1) {
+            result ^= kSobolDirections.v[dimension][k];
+        }
+    }
+    return result;
+}
+
+// Radical inverse of index in the given base, with every digit shifted by an amount hashed from the output digits
+// before it. Such nested digit shifts keep the stratification of Owen scrambling at a fraction of the cost of full
+// per-digit permutations; base 2 uses the exact hash-based Owen scramble instead. Digits are generated until float
+// precision is exhausted.
+inline float scrambledRadicalInverse(uint64_t index, const uint32_t base, const uint64_t seed) {
+    if (base == 2) {
+        const uint32_t bits = reverseBits(static_cast<uint32_t>(index));
+        return toUnitFloat(nestedUniformScramble(bits, static_cast<uint32_t>(seed)));
+    }
+
+    const float invBase = 1.0f / static_cast<float>(base);
+    float invBaseM = 1.0f;
+    uint64_t reversedDigits = 0;
+    while (1.0f - static_cast<float>(base - 1) * invBaseM < 1.0f) {
+        const uint64_t next = index / base;
+        const auto digit = static_cast<uint32_t>(index - next * base);
+        const auto shift = static_cast<uint32_t>(((mixBits(seed ^ reversedDigits) >> 32) * base) >> 32);
+        reversedDigits = reversedDigits * base + (digit + shift) % base;
+        invBaseM *= invBase;
+        index = next;
+    }
+    return std::min(static_cast<float>(reversedDigits) * invBaseM, 0x1.fffffep-1f);
+}
+} // namespace crisp::lds
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace crisp {
+// PCG32 generator (O'Neill, "PCG: A Family of Simple Fast Space-Efficient Statistically Good Algorithms for Random
+// Number Generation", 2014). Sixteen bytes of state, 2^63 selectable streams, and O(log n) jumps to any position of a
+// stream, which lets samplers address their values by pixel, sample and dimension.
+class Pcg32 {
+public:
+    Pcg32() = default;
+    Pcg32(const uint64_t sequenceIndex, const uint64_t offset) {
+        setSequence(sequenceIndex, offset);
+    }
+
+    void setSequence(const uint64_t sequenceIndex, const uint64_t offset) {
+        m_state = 0u;
+        m_inc = (sequenceIndex << 1u) | 1u;
+        nextUint();
+        m_state += offset;
+        nextUint();
+    }
+
+    uint32_t nextUint() {
+        const uint64_t oldState = m_state;
+        m_state = oldState * kMultiplier + m_inc;
+        const auto xorShifted = static_cast<uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+        const auto rotation = static_cast<uint32_t>(oldState >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1u) & 31u));
+    }
+
+    // Uses the top 24 bits, so the result lies in [0, 1) without rounding up to 1.
+    float nextFloat() {
+        return static_cast<float>(nextUint() >> 8) * 0x1p-24f;
+    }
+
+    // Moves the generator delta steps forward in its stream (Brown, "Random Number Generation with Arbitrary Strides").
+    void advance(uint64_t delta) {
+        uint64_t accMult = 1u;
+        uint64_t accPlus = 0u;
+        uint64_t curMult = kMultiplier;
+        uint64_t curPlus = m_inc;
+        while (delta > 0) {
+            if (delta & 1) {
+                accMult *= curMult;
+                accPlus = accPlus * curMult + curPlus;
+            }
+            curPlus = (curMult + 1) * curPlus;
+            curMult *= curMult;
+            delta /= 2;
+        }
+        m_state = accMult * m_state + accPlus;
+    }
+
+private:
+    static constexpr uint64_t kMultiplier = 0x5851f42d4c957f2dull;
+
+    uint64_t m_state{0x853c49e6748fea9bull};
+    uint64_t m_inc{0xda3e39cb94b95bdbull};
+};
+} // namespace crisp
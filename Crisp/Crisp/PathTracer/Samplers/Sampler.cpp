@@ -1,12 +1,34 @@
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
 
+#include <Crisp/PathTracer/Spectra/Spectrum.hpp>
+
 namespace crisp {
 Sampler::Sampler()
     : m_sampleCount(0) {}
 
 Sampler::~Sampler() {}
 
+void Sampler::fill(const std::span<float> values) {
+    for (float& value : values) {
+        value = next1D();
+    }
+}
+
 size_t Sampler::getSampleCount() const {
     return m_sampleCount;
 }
-} // namespace crisp
\ No newline at end of file
+
+void Sampler::startPixelSample(const glm::ivec2& pixel, const uint32_t sampleIndex) {
+    setSampleState(SampleState{pixel, sampleIndex, 0});
+}
+
+void Sampler::setSampleState(const SampleState& state) {
+    m_state = state;
+    // Spectral backends draw the wavelengths of a camera sample when it is started or resumed.
+    Spectrum::beginSample(state.pixel, state.sampleIndex);
+}
+
+const SampleState& Sampler::getSampleState() const {
+    return m_state;
+}
+} // namespace crisp
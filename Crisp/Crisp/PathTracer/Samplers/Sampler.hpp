@@ -1,11 +1,20 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <span>
 
 #include <Crisp/Math/Headers.hpp>
 #include <Crisp/PathTracer/Core/VariantMap.hpp>
 
 namespace crisp {
+// Coordinates of the next value a sampler draws: the pixel, which of its samples, and the dimension within it.
+struct SampleState {
+    glm::ivec2 pixel{0, 0};
+    uint32_t sampleIndex{0};
+    uint32_t dimension{0};
+};
+
 class Sampler {
 public:
     Sampler();
@@ -20,9 +29,19 @@ public:
     virtual float next1D() = 0;
     virtual glm::vec2 next2D() = 0;
 
+    // Writes the next values.size() dimensions, equivalent to as many calls to next1D.
+    virtual void fill(std::span<float> values);
+
     virtual size_t getSampleCount() const;
 
+    // Deterministic samplers derive every value from the sample state alone, which makes an image independent of how
+    // its blocks are scheduled across threads. Interleaved paths save the state after drawing and restore it later.
+    void startPixelSample(const glm::ivec2& pixel, uint32_t sampleIndex);
+    virtual void setSampleState(const SampleState& state);
+    const SampleState& getSampleState() const;
+
 protected:
     size_t m_sampleCount;
+    SampleState m_state;
 };
-} // namespace crisp
\ No newline at end of file
+} // namespace crisp
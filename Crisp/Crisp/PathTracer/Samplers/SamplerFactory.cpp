@@ -1,8 +1,11 @@
 #include <Crisp/PathTracer/Samplers/SamplerFactory.hpp>
 
 #include <Crisp/PathTracer/Samplers/Fixed.hpp>
+#include <Crisp/PathTracer/Samplers/Halton.hpp>
 #include <Crisp/PathTracer/Samplers/Independent.hpp>
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
+#include <Crisp/PathTracer/Samplers/Sobol.hpp>
+#include <Crisp/PathTracer/Samplers/Stratified.hpp>
 
 namespace crisp {
 std::unique_ptr<Sampler> SamplerFactory::create(std::string type, VariantMap parameters) {
@@ -10,6 +13,12 @@ std::unique_ptr<Sampler> SamplerFactory::create(std::string type, VariantMap par
         return std::make_unique<IndependentSampler>(parameters);
     } else if (type == "fixed") {
         return std::make_unique<FixedSampler>(parameters);
+    } else if (type == "sobol") {
+        return std::make_unique<SobolSampler>(parameters);
+    } else if (type == "halton") {
+        return std::make_unique<HaltonSampler>(parameters);
+    } else if (type == "stratified") {
+        return std::make_unique<StratifiedSampler>(parameters);
     } else {
         std::cerr << "Unknown sampler type requested! Creating default independentSampler" << std::endl;
         return std::make_unique<IndependentSampler>(parameters);
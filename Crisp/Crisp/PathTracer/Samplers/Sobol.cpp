@@ -0,0 +1,42 @@
+#include <Crisp/PathTracer/Samplers/Sobol.hpp>
+
+#include <Crisp/PathTracer/Samplers/LowDiscrepancy.hpp>
+
+namespace crisp {
+SobolSampler::SobolSampler(const VariantMap& attribs) {
+    m_sampleCount = attribs.get("samplesPerPixel", 64);
+    m_seed = static_cast<uint64_t>(attribs.get("seed", 0));
+}
+
+SobolSampler::~SobolSampler() {}
+
+std::unique_ptr<Sampler> SobolSampler::clone() const {
+    return std::make_unique<SobolSampler>(*this);
+}
+
+void SobolSampler::prepare() {}
+
+void SobolSampler::generate() {}
+
+void SobolSampler::advance() {}
+
+float SobolSampler::next1D() {
+    // Dimensions are padded in groups of four: each group shuffles the sample index with its own seed, which keeps
+    // the groups decorrelated while every group stays a well-stratified 4D Sobol set.
+    const uint32_t group = m_state.dimension / lds::kSobolDimensionCount;
+    const uint32_t component = m_state.dimension % lds::kSobolDimensionCount;
+    const uint64_t groupSeed = lds::hashSampleState(SampleState{m_state.pixel, 0, group}, m_seed);
+
+    const uint32_t index = lds::nestedUniformScramble(m_state.sampleIndex, static_cast<uint32_t>(groupSeed));
+    const uint32_t value = lds::nestedUniformScramble(
+        lds::sobol(index, component), static_cast<uint32_t>(lds::mixBits(groupSeed + component)));
+
+    ++m_state.dimension;
+    return lds::toUnitFloat(value);
+}
+
+glm::vec2 SobolSampler::next2D() {
+    const float x = next1D();
+    return glm::vec2(x, next1D());
+}
+} // namespace crisp
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Crisp/PathTracer/Samplers/Sampler.hpp>
+
+namespace crisp {
+// Owen-scrambled Sobol sequence. Every pixel shuffles and scrambles the sequence with its own seed, so the value of a
+// dimension depends only on the pixel, the sample index and the dimension.
+class SobolSampler : public Sampler {
+public:
+    SobolSampler(const VariantMap& attribs = VariantMap());
+    ~SobolSampler();
+
+    virtual std::unique_ptr<Sampler> clone() const override;
+
+    virtual void prepare() override;
+    virtual void generate() override;
+    virtual void advance() override;
+
+    virtual float next1D() override;
+    virtual glm::vec2 next2D() override;
+
+private:
+    uint64_t m_seed;
+};
+} // namespace crisp
@@ -0,0 +1,57 @@
+#include <Crisp/PathTracer/Samplers/Stratified.hpp>
+
+#include <cmath>
+
+#include <Crisp/PathTracer/Samplers/LowDiscrepancy.hpp>
+
+namespace crisp {
+StratifiedSampler::StratifiedSampler(const VariantMap& attribs) {
+    m_sampleCount = attribs.get("samplesPerPixel", 64);
+    m_seed = static_cast<uint64_t>(attribs.get("seed", 0));
+}
+
+StratifiedSampler::~StratifiedSampler() {}
+
+std::unique_ptr<Sampler> StratifiedSampler::clone() const {
+    return std::make_unique<StratifiedSampler>(*this);
+}
+
+void StratifiedSampler::prepare() {}
+
+void StratifiedSampler::generate() {}
+
+void StratifiedSampler::advance() {}
+
+float StratifiedSampler::next1D() {
+    const auto strataCount = static_cast<uint32_t>(std::max<size_t>(m_sampleCount, 1));
+    const uint32_t round = m_state.sampleIndex / strataCount;
+    const uint64_t hash = lds::hashSampleState(m_state, m_seed + round);
+
+    const uint32_t stratum =
+        lds::permutationElement(m_state.sampleIndex % strataCount, strataCount, static_cast<uint32_t>(hash));
+    const float jitter = lds::toUnitFloat(lds::mixBits(hash ^ stratum));
+
+    ++m_state.dimension;
+    return std::min((static_cast<float>(stratum) + jitter) / static_cast<float>(strataCount), 0x1.fffffep-1f);
+}
+
+glm::vec2 StratifiedSampler::next2D() {
+    const auto sampleCount = static_cast<uint32_t>(std::max<size_t>(m_sampleCount, 1));
+    const auto strataX = static_cast<uint32_t>(std::sqrt(static_cast<float>(sampleCount)));
+    const uint32_t strataY = sampleCount / strataX;
+    const uint32_t strataCount = strataX * strataY;
+
+    const uint32_t round = m_state.sampleIndex / strataCount;
+    const uint64_t hash = lds::hashSampleState(m_state, m_seed + round);
+
+    const uint32_t stratum =
+        lds::permutationElement(m_state.sampleIndex % strataCount, strataCount, static_cast<uint32_t>(hash));
+    const uint64_t jitterHash = lds::mixBits(hash ^ stratum);
+    const glm::vec2 jitter(lds::toUnitFloat(jitterHash), lds::toUnitFloat(static_cast<uint32_t>(jitterHash)));
+
+    m_state.dimension += 2;
+    return glm::min(
+        (glm::vec2(stratum % strataX, stratum / strataX) + jitter) / glm::vec2(strataX, strataY),
+        glm::vec2(0x1.fffffep-1f));
+}
+} // namespace crisp
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Crisp/PathTracer/Samplers/Sampler.hpp>
+
+namespace crisp {
+// Jittered stratified sampling. Each dimension splits [0, 1) into samplesPerPixel strata (a near-square grid for 2D
+// samples) and visits them in a pseudo-random order derived from the pixel and dimension. Samples past the count
+// start a new round with a fresh order.
+class StratifiedSampler : public Sampler {
+public:
+    StratifiedSampler(const VariantMap& attribs = VariantMap());
+    ~StratifiedSampler();
+
+    virtual std::unique_ptr<Sampler> clone() const override;
+
+    virtual void prepare() override;
+    virtual void generate() override;
+    virtual void advance() override;
+
+    virtual float next1D() override;
+    virtual glm::vec2 next2D() override;
+
+private:
+    uint64_t m_seed;
+};
+} // namespace crisp
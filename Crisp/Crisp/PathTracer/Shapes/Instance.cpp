@@ -0,0 +1,141 @@
+#include <Crisp/PathTracer/Shapes/Instance.hpp>
+
+#include <Crisp/Math/Headers.hpp>
+
+namespace crisp {
+ShapePrototype::ShapePrototype(RTCDevice device)
+    : m_device(device)
+    , m_scene(rtcNewScene(device))
+    , m_instanceDepth(1) {}
+
+ShapePrototype::~ShapePrototype() {
+    rtcReleaseScene(m_scene);
+}
+
+void ShapePrototype::addShape(std::unique_ptr<Shape> shape, BSDF* bsdf) {
+    if (!shape->addToAccelerationStructure(m_device, m_scene)) {
+        return;
+    }
+
+    if (const auto* instance = dynamic_cast<const Instance*>(shape.get())) {
+        m_instanceDepth = std::max(m_instanceDepth, instance->getPrototype()->getInstanceDepth() + 1);
+    }
+
+    shape->setBSDF(bsdf);
+    m_boundingBox.expandBy(shape->getBoundingBox());
+    m_shapes.emplace_back(std::move(shape));
+}
+
+void ShapePrototype::commit() {
+    rtcCommitScene(m_scene);
+}
+
+RTCScene ShapePrototype::getEmbreeScene() const {
+    return m_scene;
+}
+
+BoundingBox3 ShapePrototype::getBoundingBox() const {
+    return m_boundingBox;
+}
+
+bool ShapePrototype::isEmpty() const {
+    return m_shapes.empty();
+}
+
+int ShapePrototype::getInstanceDepth() const {
+    return m_instanceDepth;
+}
+
+size_t ShapePrototype::getMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& shape : m_shapes) {
+        bytes += shape->getMemoryUsage();
+    }
+    return bytes;
+}
+
+void ShapePrototype::fillIntersection(
+    const std::span<const unsigned int> instanceIds,
+    const unsigned int geometryId,
+    const unsigned int primitiveId,
+    const Ray3& ray,
+    Intersection& its) const {
+    fillInstancedIntersection(m_shapes, instanceIds, geometryId, primitiveId, ray, its);
+}
+
+Instance::Instance(const VariantMap& params, const ShapePrototype* prototype)
+    : m_prototype(prototype) {
+    m_toWorld = params.get<Transform>("toWorld");
+
+    const BoundingBox3 localBounds = m_prototype->getBoundingBox();
+    for (int i = 0; i < 8; ++i) {
+        m_boundingBox.expandBy(m_toWorld.transformPoint(localBounds.getCorner(i)));
+    }
+}
+
+void Instance::fillIntersection(const unsigned int triangleId, const Ray3& ray, Intersection& its) const {
+    fillIntersection({}, 0, triangleId, ray, its);
+}
+
+void Instance::fillIntersection(
+    const std::span<const unsigned int> instanceIds,
+    const unsigned int geometryId,
+    const unsigned int primitiveId,
+    const Ray3& ray,
+    Intersection& its) const {
+    // The local ray keeps its unnormalized direction, so the hit distance reported by Embree stays valid in it.
+    m_prototype->fillIntersection(instanceIds, geometryId, primitiveId, m_toWorld.invert() * ray, its);
+
+    its.p = m_toWorld.transformPoint(its.p);
+    its.geoFrame = CoordinateFrame(m_toWorld.transformNormal(its.geoFrame.n));
+    its.shFrame = CoordinateFrame(m_toWorld.transformNormal(its.shFrame.n));
+    its.dpdu = glm::vec3(m_toWorld.mat * glm::vec4(its.dpdu, 0.0f));
+    its.dpdv = glm::vec3(m_toWorld.mat * glm::vec4(its.dpdv, 0.0f));
+    if (m_bsdf) {
+        its.shape = this;
+    }
+}
+
+void Instance::sampleSurface(Shape::Sample& shapeSample, Sampler& /*sampler*/) const {
+    // Instances cannot be emitters, so they are never sampled by area.
+    shapeSample.pdf = 0.0f;
+}
+
+float Instance::pdfSurface(const Shape::Sample& /*shapeSample*/) const {
+    return 0.0f;
+}
+
+bool Instance::addToAccelerationStructure(RTCDevice device, RTCScene scene) {
+    if (m_prototype->isEmpty()) {
+        return false;
+    }
+
+    m_geometry = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
+    rtcSetGeometryInstancedScene(m_geometry, m_prototype->getEmbreeScene());
+    rtcSetGeometryTransform(m_geometry, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, glm::value_ptr(m_toWorld.mat));
+    rtcCommitGeometry(m_geometry);
+    m_geometryId = rtcAttachGeometry(scene, m_geometry);
+    return true;
+}
+
+const ShapePrototype* Instance::getPrototype() const {
+    return m_prototype;
+}
+
+void fillInstancedIntersection(
+    const std::vector<std::unique_ptr<Shape>>& shapes,
+    const std::span<const unsigned int> instanceIds,
+    const unsigned int geometryId,
+    const unsigned int primitiveId,
+    const Ray3& ray,
+    Intersection& its) {
+    if (instanceIds.empty() || instanceIds.front() == RTC_INVALID_GEOMETRY_ID) {
+        shapes[geometryId]->fillIntersection(primitiveId, ray, its);
+        return;
+    }
+
+    // Instance ids are only ever assigned to Instance geometries.
+    const auto& instance = static_cast<const Instance&>(*shapes[instanceIds.front()]);
+    instance.fillIntersection(instanceIds.subspan(1), geometryId, primitiveId, ray, its);
+}
+} // namespace crisp
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <Crisp/PathTracer/Shapes/Shape.hpp>
+
+namespace crisp {
+// A group of shapes stored once, in its own Embree scene, and placed into the world by any number of instances.
+// Prototypes may contain instances of other prototypes, up to the instance depth Embree was built with.
+class ShapePrototype {
+public:
+    explicit ShapePrototype(RTCDevice device);
+    ~ShapePrototype();
+
+    ShapePrototype(const ShapePrototype&) = delete;
+    ShapePrototype& operator=(const ShapePrototype&) = delete;
+
+    void addShape(std::unique_ptr<Shape> shape, BSDF* bsdf);
+
+    // Must be called after the last shape is added and before the prototype is instanced.
+    void commit();
+
+    RTCScene getEmbreeScene() const;
+    BoundingBox3 getBoundingBox() const;
+    bool isEmpty() const;
+
+    // Number of instance levels a ray passes through when it hits the deepest shape of this prototype.
+    int getInstanceDepth() const;
+
+    size_t getMemoryUsage() const;
+
+    void fillIntersection(
+        std::span<const unsigned int> instanceIds,
+        unsigned int geometryId,
+        unsigned int primitiveId,
+        const Ray3& ray,
+        Intersection& its) const;
+
+private:
+    RTCDevice m_device;
+    RTCScene m_scene;
+    std::vector<std::unique_ptr<Shape>> m_shapes;
+    BoundingBox3 m_boundingBox;
+    int m_instanceDepth;
+};
+
+// Places a prototype in the scene with its own transform. If the instance has a BSDF, it overrides the BSDFs of all
+// prototype shapes; otherwise hits report the prototype shape itself.
+class Instance : public Shape {
+public:
+    Instance(const VariantMap& params, const ShapePrototype* prototype);
+
+    virtual void fillIntersection(unsigned int triangleId, const Ray3& ray, Intersection& its) const override;
+    virtual void sampleSurface(Shape::Sample& shapeSample, Sampler& sampler) const override;
+    virtual float pdfSurface(const Shape::Sample& shapeSample) const override;
+    virtual bool addToAccelerationStructure(RTCDevice embreeDevice, RTCScene embreeScene) override;
+
+    const ShapePrototype* getPrototype() const;
+
+    // Fills a hit on one of the prototype shapes. The instance ids start below this instance, as in RTCHit::instID.
+    void fillIntersection(
+        std::span<const unsigned int> instanceIds,
+        unsigned int geometryId,
+        unsigned int primitiveId,
+        const Ray3& ray,
+        Intersection& its) const;
+
+private:
+    const ShapePrototype* m_prototype;
+};
+
+// Resolves an Embree hit against the shapes of one scene level, descending into instances as needed.
+void fillInstancedIntersection(
+    const std::vector<std::unique_ptr<Shape>>& shapes,
+    std::span<const unsigned int> instanceIds,
+    unsigned int geometryId,
+    unsigned int primitiveId,
+    const Ray3& ray,
+    Intersection& its);
+} // namespace crisp
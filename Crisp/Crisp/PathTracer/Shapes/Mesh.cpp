@@ -3,20 +3,30 @@
 #include <Crisp/Math/Warp.hpp>
 #include <Crisp/Mesh/Io/MeshLoader.hpp>
 #include <Crisp/PathTracer/Samplers/Sampler.hpp>
+#include <Crisp/PathTracer/Shapes/MeshCache.hpp>
 
 namespace crisp {
+namespace {
+TriangleMesh loadMesh(const VariantMap& params) {
+    const std::filesystem::path path = params.get<std::string>("filename");
+    const std::string cacheDirectory = params.get<std::string>("cacheDirectory");
+    return cacheDirectory.empty() ? loadTriangleMesh(path).unwrap()
+                                  : loadCachedTriangleMesh(path, cacheDirectory).unwrap();
+}
+} // namespace
+
 Mesh::Mesh(const VariantMap& params)
-    : m_mesh(loadTriangleMesh(params.get<std::string>("filename")).unwrap()) {
+    : m_mesh(loadMesh(params)) {
     m_toWorld = params.get<Transform>("toWorld");
 
     m_mesh.transform(m_toWorld.mat);
     m_boundingBox = m_mesh.getBoundingBox();
 
-    m_pdf.reserve(getNumTriangles());
-    for (auto i = 0; i < getNumTriangles(); i++) {
-        m_pdf.append(m_mesh.calculateTriangleArea(i));
+    std::vector<float> areas(getNumTriangles());
+    for (uint32_t i = 0; i < areas.size(); ++i) {
+        areas[i] = m_mesh.calculateTriangleArea(i);
     }
-    m_pdf.normalize();
+    m_pdf = AliasDistribution1D(areas);
 }
 
 void Mesh::fillIntersection(unsigned int triangleId, const Ray3& /*ray*/, Intersection& its) const {
@@ -28,6 +38,7 @@ void Mesh::fillIntersection(unsigned int triangleId, const Ray3& /*ray*/, Inters
 
     if (!m_mesh.getTexCoords().empty()) {
         its.uv = m_mesh.interpolateTexCoord(triangleId, barycentric);
+        computeTriangleDpDuv(triangleId, its.dpdu, its.dpdv);
     }
 
     its.shape = this;
@@ -57,28 +68,24 @@ bool Mesh::addToAccelerationStructure(RTCDevice device, RTCScene scene) {
 
     m_geometry = rtcNewGeometry(device, RTCGeometryType::RTC_GEOMETRY_TYPE_TRIANGLE);
 
-    m_vertexBuffer = rtcNewBuffer(device, sizeof(glm::vec3) * m_mesh.getVertexCount());
-    auto* vertices = static_cast<glm::vec3*>(rtcGetBufferData(m_vertexBuffer));
-    memcpy(vertices, m_mesh.getPositions().data(), m_mesh.getVertexCount() * sizeof(glm::vec3));
-    rtcSetGeometryBuffer(
+    // Embree reads the positions and indices in place, so the mesh must neither be modified nor outlive its geometry
+    // from here on. Embree may read up to 16 bytes from the start of the last element, hence the padding.
+    m_mesh.reserveSimdPadding();
+    rtcSetSharedGeometryBuffer(
         m_geometry,
         RTC_BUFFER_TYPE_VERTEX,
         0,
         RTC_FORMAT_FLOAT3,
-        m_vertexBuffer,
+        m_mesh.getPositionsPtr(),
         0,
         sizeof(glm::vec3),
         m_mesh.getVertexCount());
-
-    m_indexBuffer = rtcNewBuffer(device, sizeof(glm::uvec3) * m_mesh.getTriangleCount());
-    auto* faces = static_cast<glm::uvec3*>(rtcGetBufferData(m_indexBuffer));
-    memcpy(faces, m_mesh.getTriangles().data(), m_mesh.getTriangleCount() * sizeof(glm::uvec3));
-    rtcSetGeometryBuffer(
+    rtcSetSharedGeometryBuffer(
         m_geometry,
         RTC_BUFFER_TYPE_INDEX,
         0,
         RTC_FORMAT_UINT3,
-        m_indexBuffer,
+        m_mesh.getIndices(),
         0,
         sizeof(glm::uvec3),
         m_mesh.getTriangleCount());
@@ -88,6 +95,61 @@ bool Mesh::addToAccelerationStructure(RTCDevice device, RTCScene scene) {
     return true;
 }
 
+float Mesh::getSurfaceArea() const {
+    return m_pdf.getSum();
+}
+
+DirectionCone Mesh::getNormalBounds() const {
+    // Emission follows the shading normals where the mesh has them, so those are the ones to bound.
+    std::vector<glm::vec3> normals = m_mesh.getNormals();
+    if (normals.empty()) {
+        normals.reserve(getNumTriangles());
+        for (uint32_t i = 0; i < getNumTriangles(); ++i) {
+            normals.push_back(m_mesh.calculateTriangleNormal(i));
+        }
+    }
+
+    glm::vec3 axis(0.0f);
+    for (const auto& n : normals) {
+        axis += n;
+    }
+    if (glm::length2(axis) == 0.0f) {
+        return DirectionCone::createEntireSphere();
+    }
+
+    DirectionCone cone{glm::normalize(axis), 1.0f};
+    for (const auto& n : normals) {
+        cone.cosTheta = std::min(cone.cosTheta, glm::dot(cone.w, n));
+    }
+    return cone;
+}
+
+void Mesh::computeTriangleDpDuv(const uint32_t triangleId, glm::vec3& dpdu, glm::vec3& dpdv) const {
+    const glm::uvec3& triangle = m_mesh.getTriangles()[triangleId];
+    const auto& positions = m_mesh.getPositions();
+    const auto& texCoords = m_mesh.getTexCoords();
+
+    const glm::vec2 duv02 = texCoords[triangle[0]] - texCoords[triangle[2]];
+    const glm::vec2 duv12 = texCoords[triangle[1]] - texCoords[triangle[2]];
+    const glm::vec3 dp02 = positions[triangle[0]] - positions[triangle[2]];
+    const glm::vec3 dp12 = positions[triangle[1]] - positions[triangle[2]];
+    const float det = duv02.x * duv12.y - duv02.y * duv12.x;
+
+    // Degenerate UVs leave the derivatives at zero, which disables texture filtering for the hit.
+    if (std::abs(det) < 1e-12f) {
+        dpdu = dpdv = glm::vec3(0.0f);
+        return;
+    }
+
+    const float invDet = 1.0f / det;
+    dpdu = (duv12.y * dp02 - duv02.y * dp12) * invDet;
+    dpdv = (duv02.x * dp12 - duv12.x * dp02) * invDet;
+}
+
+size_t Mesh::getMemoryUsage() const {
+    return m_mesh.getMemoryUsage() + m_pdf.getMemoryUsage();
+}
+
 size_t Mesh::getNumTriangles() const {
     return m_mesh.getTriangleCount();
 }
@@ -2,10 +2,16 @@
 
 #include <Crisp/PathTracer/Shapes/Shape.hpp>
 
-#include <Crisp/Math/Distribution1D.hpp>
+#include <Crisp/Math/AliasDistribution1D.hpp>
 #include <Crisp/Mesh/TriangleMesh.hpp>
 
 namespace crisp {
+// A triangle mesh loaded from an OBJ file.
+//
+// Parameters:
+//   filename: the OBJ file.
+//   toWorld: transform from the file's space to world space.
+//   cacheDirectory: where loaded meshes are cached, no caching when empty (default).
 class Mesh : public Shape {
 public:
     Mesh(const VariantMap& params = VariantMap());
@@ -14,6 +20,9 @@ public:
     virtual void sampleSurface(Shape::Sample& shapeSample, Sampler& sampler) const override;
     virtual float pdfSurface(const Shape::Sample& shapeSample) const override;
     virtual bool addToAccelerationStructure(RTCDevice embreeDevice, RTCScene embreeScene) override;
+    virtual size_t getMemoryUsage() const override;
+    virtual float getSurfaceArea() const override;
+    virtual DirectionCone getNormalBounds() const override;
 
     virtual size_t getNumTriangles() const;
     virtual size_t getNumVertices() const;
@@ -22,7 +31,9 @@ public:
     virtual const std::vector<glm::uvec3>& getTriangleIndices() const;
 
 protected:
+    void computeTriangleDpDuv(uint32_t triangleId, glm::vec3& dpdu, glm::vec3& dpdv) const;
+
     TriangleMesh m_mesh;
-    Distribution1D m_pdf;
+    AliasDistribution1D m_pdf;
 };
 } // namespace crisp
\ No newline at end of file
@@ -0,0 +1,346 @@
+#include <Crisp/PathTracer/Shapes/MeshCache.hpp>
+
+#include <Crisp/Core/Format.hpp>
+#include <Crisp/Core/Logger.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <span>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace crisp {
+namespace {
+constexpr std::array<char, 8> kMagic{'C', 'R', 'S', 'P', 'M', 'E', 'S', 'H'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kAlignment = 64;
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t viewCount;
+    uint64_t positionCount;
+    uint64_t normalCount;
+    uint64_t texCoordCount;
+    uint64_t tangentCount;
+    uint64_t triangleCount;
+    uint64_t nameSize;
+    uint64_t stringSize; // The mesh name followed by the tags of all views.
+};
+
+struct ViewRecord {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint64_t tagOffset; // Into the strings, past the mesh name.
+    uint64_t tagSize;
+};
+
+// Byte offsets of the arrays in a cache file, each aligned to a cache line.
+struct FileLayout {
+    size_t positions;
+    size_t normals;
+    size_t texCoords;
+    size_t tangents;
+    size_t triangles;
+    size_t views;
+    size_t strings;
+    size_t fileSize;
+};
+
+FileLayout computeLayout(const FileHeader& header) {
+    size_t offset = sizeof(FileHeader);
+    const auto place = [&offset](const uint64_t count, const size_t elementSize) {
+        const size_t start = (offset + kAlignment - 1) / kAlignment * kAlignment;
+        offset = start + count * elementSize;
+        return start;
+    };
+
+    FileLayout layout{};
+    layout.positions = place(header.positionCount, sizeof(glm::vec3));
+    layout.normals = place(header.normalCount, sizeof(glm::vec3));
+    layout.texCoords = place(header.texCoordCount, sizeof(glm::vec2));
+    layout.tangents = place(header.tangentCount, sizeof(glm::vec4));
+    layout.triangles = place(header.triangleCount, sizeof(glm::uvec3));
+    layout.views = place(header.viewCount, sizeof(ViewRecord));
+    layout.strings = place(header.stringSize, 1);
+    layout.fileSize = offset;
+    return layout;
+}
+
+// A read-only mapping of a whole file, which is empty if the file could not be mapped.
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+        m_file = CreateFileW(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        LARGE_INTEGER size{};
+        if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+            return;
+        }
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping == nullptr) {
+            return;
+        }
+        m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        m_size = m_data ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+        m_fd = open(path.c_str(), O_RDONLY);
+        struct stat status {};
+        if (m_fd < 0 || fstat(m_fd, &status) != 0 || status.st_size == 0) {
+            return;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (data == MAP_FAILED) {
+            return;
+        }
+        // Every byte is copied out once, front to back.
+        madvise(data, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+        m_data = data;
+        m_size = static_cast<size_t>(status.st_size);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (m_data) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping) {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+#else
+        if (m_data) {
+            munmap(m_data, m_size);
+        }
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const std::byte> getData() const {
+        return {static_cast<const std::byte*>(m_data), m_size};
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE m_file{INVALID_HANDLE_VALUE};
+    HANDLE m_mapping{nullptr};
+#else
+    int m_fd{-1};
+#endif
+    void* m_data{nullptr};
+    size_t m_size{0};
+};
+
+template <typename T>
+std::vector<T> copyArray(const std::span<const std::byte> data, const size_t offset, const uint64_t count) {
+    std::vector<T> values(count);
+    std::memcpy(values.data(), data.data() + offset, count * sizeof(T));
+    return values;
+}
+
+// Vertex attributes are either absent or given for every vertex.
+bool isAttributeCountValid(const uint64_t count, const uint64_t positionCount) {
+    return count == 0 || count == positionCount;
+}
+
+uint64_t getProcessId() {
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return static_cast<uint64_t>(getpid());
+#endif
+}
+
+std::optional<TriangleMesh> readCacheFile(const std::filesystem::path& cachePath) {
+    const MappedFile file(cachePath);
+    const std::span<const std::byte> data = file.getData();
+    if (data.size() < sizeof(FileHeader)) {
+        return std::nullopt;
+    }
+
+    FileHeader header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+    // Counts are checked against the file size first, so that computing the layout cannot overflow.
+    const uint64_t largestCount = std::max(
+        {header.positionCount,
+         header.normalCount,
+         header.texCoordCount,
+         header.tangentCount,
+         header.triangleCount,
+         header.stringSize});
+    if (header.magic != kMagic || header.version != kVersion || largestCount > data.size() ||
+        header.nameSize > header.stringSize || computeLayout(header).fileSize != data.size() ||
+        !isAttributeCountValid(header.normalCount, header.positionCount) ||
+        !isAttributeCountValid(header.texCoordCount, header.positionCount) ||
+        !isAttributeCountValid(header.tangentCount, header.positionCount)) {
+        return std::nullopt;
+    }
+    const FileLayout layout = computeLayout(header);
+
+    const auto* strings = reinterpret_cast<const char*>(data.data() + layout.strings);
+    std::vector<TriangleMeshView> views;
+    views.reserve(header.viewCount);
+    for (uint32_t i = 0; i < header.viewCount; ++i) {
+        ViewRecord record{};
+        std::memcpy(&record, data.data() + layout.views + i * sizeof(ViewRecord), sizeof(record));
+        if (record.tagOffset > header.stringSize - header.nameSize ||
+            record.tagSize > header.stringSize - header.nameSize - record.tagOffset ||
+            uint64_t{record.firstIndex} + record.indexCount > header.triangleCount * 3) {
+            return std::nullopt;
+        }
+        views.emplace_back(
+            std::string(strings + header.nameSize + record.tagOffset, record.tagSize),
+            record.firstIndex,
+            record.indexCount);
+    }
+
+    // The mesh constructor would derive the normals and tangents again, so the arrays are set directly.
+    TriangleMesh mesh;
+    mesh.setPositions(copyArray<glm::vec3>(data, layout.positions, header.positionCount));
+    mesh.setNormals(copyArray<glm::vec3>(data, layout.normals, header.normalCount));
+    mesh.setTexCoords(copyArray<glm::vec2>(data, layout.texCoords, header.texCoordCount));
+    mesh.setTangents(copyArray<glm::vec4>(data, layout.tangents, header.tangentCount));
+    auto triangles = copyArray<glm::uvec3>(data, layout.triangles, header.triangleCount);
+    // A triangle that indexes past the vertices would be read out of bounds by the renderer.
+    const auto isOutOfBounds = [&header](const glm::uvec3& triangle) {
+        return triangle.x >= header.positionCount || triangle.y >= header.positionCount ||
+               triangle.z >= header.positionCount;
+    };
+    if (std::ranges::any_of(triangles, isOutOfBounds)) {
+        return std::nullopt;
+    }
+    mesh.setTriangles(std::move(triangles));
+    mesh.setViews(std::move(views));
+    mesh.setMeshName(std::string(strings, header.nameSize));
+    return mesh;
+}
+
+void padTo(std::ofstream& file, const size_t offset) {
+    static constexpr std::array<char, kAlignment> kZeros{};
+    const auto position = static_cast<size_t>(file.tellp());
+    file.write(kZeros.data(), static_cast<std::streamsize>(offset - position));
+}
+
+template <typename T>
+void writeArray(std::ofstream& file, const size_t offset, const std::vector<T>& values) {
+    padTo(file, offset);
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+Result<> writeCacheFile(const std::filesystem::path& cachePath, const TriangleMesh& mesh) {
+    const std::string name = mesh.getMeshName();
+    std::string strings = name;
+    std::vector<ViewRecord> viewRecords;
+    for (const auto& view : mesh.getViews()) {
+        viewRecords.push_back({
+            .firstIndex = view.firstIndex,
+            .indexCount = view.indexCount,
+            .tagOffset = strings.size() - name.size(),
+            .tagSize = view.tag.size(),
+        });
+        strings += view.tag;
+    }
+
+    FileHeader header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.viewCount = static_cast<uint32_t>(viewRecords.size());
+    header.positionCount = mesh.getPositions().size();
+    header.normalCount = mesh.getNormals().size();
+    header.texCoordCount = mesh.getTexCoords().size();
+    header.tangentCount = mesh.getTangents().size();
+    header.triangleCount = mesh.getTriangles().size();
+    header.nameSize = name.size();
+    header.stringSize = strings.size();
+    const FileLayout layout = computeLayout(header);
+
+    // Meshes of the same file may be cached by several threads and processes at once, each of which writes a file of
+    // its own and moves it into place only once it is complete.
+    const auto temporaryPath = std::filesystem::path(cachePath).concat(fmt::format(
+        ".{:x}-{:x}.tmp", getProcessId(), std::hash<std::thread::id>{}(std::this_thread::get_id())));
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return resultError("Failed to create mesh cache file {}", temporaryPath.string());
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeArray(file, layout.positions, mesh.getPositions());
+        writeArray(file, layout.normals, mesh.getNormals());
+        writeArray(file, layout.texCoords, mesh.getTexCoords());
+        writeArray(file, layout.tangents, mesh.getTangents());
+        writeArray(file, layout.triangles, mesh.getTriangles());
+        writeArray(file, layout.views, viewRecords);
+        padTo(file, layout.strings);
+        file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!file) {
+            return resultError("Failed to write mesh cache file {}", temporaryPath.string());
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return resultError("Failed to move mesh cache file to {}", cachePath.string());
+    }
+    return kResultSuccess;
+}
+} // namespace
+
+std::filesystem::path getMeshCachePath(
+    const std::filesystem::path& meshPath,
+    const std::filesystem::path& cacheDirectory,
+    const TriangleMeshLoadOptions& options) {
+    std::error_code error;
+    const auto fileSize = std::filesystem::file_size(meshPath, error);
+    const auto writeTime = std::filesystem::last_write_time(meshPath, error).time_since_epoch().count();
+    const uint32_t optionBits = (options.normalizeNormals ? 1u : 0u) | (options.computeVertexNormals ? 2u : 0u) |
+                                (options.computeTangents ? 4u : 0u);
+    const size_t key = std::hash<std::string>{}(
+        std::filesystem::absolute(meshPath).string() + '|' + std::to_string(fileSize) + '|' +
+        std::to_string(writeTime) + '|' + std::to_string(optionBits));
+    return cacheDirectory / fmt::format("{}-{:016x}.mesh", meshPath.stem().string(), key);
+}
+
+Result<TriangleMesh> loadCachedTriangleMesh(
+    const std::filesystem::path& meshPath,
+    const std::filesystem::path& cacheDirectory,
+    const TriangleMeshLoadOptions& options) {
+    const auto cachePath = getMeshCachePath(meshPath, cacheDirectory, options);
+    if (auto mesh = readCacheFile(cachePath)) {
+        return std::move(*mesh);
+    }
+
+    CRISP_TRY(auto mesh, loadTriangleMesh(meshPath, options));
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    if (const auto written = writeCacheFile(cachePath, mesh); !written.isValid()) {
+        spdlog::warn("Mesh {} is not cached: {}", meshPath.string(), written.getError());
+    }
+    return mesh;
+}
+} // namespace crisp
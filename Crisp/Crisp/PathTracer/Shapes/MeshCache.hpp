@@ -0,0 +1,24 @@
+#pragma once
+
+#include <filesystem>
+
+#include <Crisp/Core/Result.hpp>
+#include <Crisp/Mesh/Io/MeshLoader.hpp>
+#include <Crisp/Mesh/TriangleMesh.hpp>
+
+namespace crisp {
+// Loads a triangle mesh through a binary copy of the loaded mesh in cacheDirectory. The cache file is keyed by the
+// source path, size, modification time and load options, so an edited source is simply loaded and cached again. Its
+// arrays are stored at aligned offsets and read back through a memory mapping, which leaves I/O as the only cost of a
+// cached load. Failing to write the cache file is not an error.
+Result<TriangleMesh> loadCachedTriangleMesh(
+    const std::filesystem::path& meshPath,
+    const std::filesystem::path& cacheDirectory,
+    const TriangleMeshLoadOptions& options = {});
+
+// Returns the cache file that holds the mesh, whether or not it has been written yet.
+std::filesystem::path getMeshCachePath(
+    const std::filesystem::path& meshPath,
+    const std::filesystem::path& cacheDirectory,
+    const TriangleMeshLoadOptions& options = {});
+} // namespace crisp
@@ -14,6 +14,18 @@ BoundingBox3 Shape::getBoundingBox() const {
     return m_boundingBox;
 }
 
+float Shape::getSurfaceArea() const {
+    return 0.0f;
+}
+
+DirectionCone Shape::getNormalBounds() const {
+    return DirectionCone::createEntireSphere();
+}
+
+size_t Shape::getMemoryUsage() const {
+    return 0;
+}
+
 void Shape::setLight(Light* light) {
     m_light = light;
 }
@@ -16,6 +16,7 @@
 #include <Crisp/Math/Transform.hpp>
 #include <Crisp/PathTracer/Core/Intersection.hpp>
 #include <Crisp/PathTracer/Core/VariantMap.hpp>
+#include <Crisp/PathTracer/Lights/LightBounds.hpp>
 
 namespace crisp {
 class BSDF;
@@ -56,6 +57,13 @@ public:
 
     BoundingBox3 getBoundingBox() const;
 
+    // Surface area and a cone containing all surface normals, used to bound the emission of area lights.
+    virtual float getSurfaceArea() const;
+    virtual DirectionCone getNormalBounds() const;
+
+    // Bytes of heap memory owned by the shape, not counting what Embree allocates for it.
+    virtual size_t getMemoryUsage() const;
+
     void setLight(Light* light);
     const Light* getLight() const;
 
@@ -79,8 +87,6 @@ protected:
 
     unsigned int m_geometryId;
     RTCGeometry m_geometry;
-    RTCBuffer m_vertexBuffer;
-    RTCBuffer m_indexBuffer;
 
     BoundingBox3 m_boundingBox;
 };
@@ -69,6 +69,10 @@ Sphere::Sphere(const VariantMap& params) {
 
 Sphere::~Sphere() {}
 
+float Sphere::getSurfaceArea() const {
+    return 4.0f * PI<> * m_radius * m_radius;
+}
+
 void Sphere::fillBounds(const RTCBoundsFunctionArguments* args) {
     const Sphere* s = static_cast<const Sphere*>(args->geometryUserPtr);
     args->bounds_o->lower_x = s->m_center.x - s->m_radius;
@@ -86,12 +90,21 @@ void Sphere::rayIntersect(const RTCIntersectFunctionNArguments* args) {
     RTCHitN* hits = RTCRayHitN_HitN(args->rayhit, args->N);
 
     for (unsigned int i = 0; i < args->N; ++i) {
+        // Inactive lanes of a ray packet must not be touched.
+        if (args->valid[i] == 0) {
+            continue;
+        }
+
         RTCRay ray = rtcGetRayFromRayN(rays, args->N, i);
         float t;
         if (analyticIntersection(sphere->m_center, sphere->m_radius, ray, t)) {
             RTCRayN_tfar(rays, args->N, i) = t;
             RTCHitN_geomID(hits, args->N, i) = sphere->m_geometryId;
             RTCHitN_primID(hits, args->N, i) = 0;
+            // User geometry has to record the instance path itself when the sphere lives in a prototype.
+            for (unsigned int level = 0; level < RTC_MAX_INSTANCE_LEVEL_COUNT; ++level) {
+                RTCHitN_instID(hits, args->N, i, level) = args->context->instID[level];
+            }
         }
     }
 }
@@ -100,6 +113,10 @@ void Sphere::rayOcclude(const RTCOccludedFunctionNArguments* args) {
     const Sphere* sphere = reinterpret_cast<const Sphere*>(args->geometryUserPtr);
 
     for (unsigned int i = 0; i < args->N; ++i) {
+        if (args->valid[i] == 0) {
+            continue;
+        }
+
         RTCRay ray = rtcGetRayFromRayN(args->ray, args->N, i);
 
         float t;
@@ -123,6 +140,12 @@ void Sphere::fillIntersection(unsigned int /*triangleId*/, const Ray3& ray, Inte
     const float v = clamp(0.5f - alpha * InvPI<float>, 0.0f, 1.0f);
     its.uv = {u, 1.0f - v};
 
+    // The UV coordinates map linearly to beta over [-pi, pi] and to alpha over [-pi/2, pi/2].
+    const float cosAlpha = std::cos(alpha);
+    its.dpdu = 2.0f * PI<> * m_radius * glm::vec3(-std::sin(beta) * cosAlpha, std::cos(beta) * cosAlpha, 0.0f);
+    its.dpdv = PI<> * m_radius *
+               glm::vec3(-std::sin(alpha) * std::cos(beta), -std::sin(alpha) * std::sin(beta), cosAlpha);
+
     its.shape = this;
 }
 
@@ -16,6 +16,7 @@ public:
     virtual void sampleSurface(Shape::Sample& shapeSample, Sampler& sampler) const override;
     virtual float pdfSurface(const Shape::Sample& shapeSample) const override;
     virtual bool addToAccelerationStructure(RTCDevice device, RTCScene scene) override;
+    virtual float getSurfaceArea() const override;
 
 protected:
     glm::vec3 m_center;
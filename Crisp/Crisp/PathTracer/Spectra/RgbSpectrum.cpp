@@ -121,6 +121,10 @@ RgbSpectrum RgbSpectrum::exp() const {
     return RgbSpectrum{std::exp(r), std::exp(g), std::exp(b)};
 }
 
+RgbSpectrum RgbSpectrum::sqrt() const {
+    return RgbSpectrum{std::sqrt(r), std::sqrt(g), std::sqrt(b)};
+}
+
 RgbSpectrum RgbSpectrum::clamp() const {
     return {std::max(r, 0.0f), std::max(g, 0.0f), std::max(b, 0.0f)};
 }
@@ -166,6 +170,10 @@ RgbSpectrum RgbSpectrum::toSrgb() const {
     return result;
 }
 
+glm::vec3 RgbSpectrum::toRgb() const {
+    return {r, g, b};
+}
+
 RgbSpectrum operator+(float scalar, const RgbSpectrum& rgbSpectrum) {
     return rgbSpectrum + scalar;
 }
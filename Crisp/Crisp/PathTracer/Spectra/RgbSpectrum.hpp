@@ -58,6 +58,7 @@ struct RgbSpectrum {
     float maxCoeff() const;
 
     RgbSpectrum exp() const;
+    RgbSpectrum sqrt() const;
     RgbSpectrum clamp() const;
 
     bool isValid() const;
@@ -66,6 +67,11 @@ struct RgbSpectrum {
     bool isNaN() const;
 
     RgbSpectrum toSrgb() const;
+    glm::vec3 toRgb() const;
+
+    // RGB carries no per-sample state, see SampledSpectrum.
+    static void beginSample(const glm::ivec2& /*pixel*/, uint32_t /*sampleIndex*/) {}
+    static void endSample() {}
 
     constexpr static RgbSpectrum zero() {
         return {0.0f};
@@ -0,0 +1,213 @@
+#include <Crisp/PathTracer/Spectra/SampledSpectrum.hpp>
+
+namespace crisp {
+namespace {
+// Smits' basis spectra, sampled in ten equal bins from 380 to 720 nm.
+constexpr float kBasisMin = 380.0f;
+constexpr float kBasisMax = 720.0f;
+constexpr int kBasisBinCount = 10;
+constexpr std::array<std::array<float, kBasisBinCount>, SampledWavelengths::BasisCount> kBasisSpectra = {{
+    {1.0000f, 1.0000f, 0.9999f, 0.9993f, 0.9992f, 0.9998f, 1.0000f, 1.0000f, 1.0000f, 1.0000f}, // White
+    {0.9710f, 0.9426f, 1.0007f, 1.0007f, 1.0007f, 1.0007f, 0.1564f, 0.0000f, 0.0000f, 0.0000f}, // Cyan
+    {1.0000f, 1.0000f, 0.9685f, 0.2229f, 0.0000f, 0.0458f, 0.8369f, 1.0000f, 1.0000f, 0.9959f}, // Magenta
+    {0.0001f, 0.0000f, 0.1088f, 0.6651f, 1.0000f, 1.0000f, 0.9996f, 0.9586f, 0.9685f, 0.9840f}, // Yellow
+    {0.1012f, 0.0515f, 0.0000f, 0.0000f, 0.0000f, 0.0000f, 0.8325f, 1.0149f, 1.0149f, 1.0149f}, // Red
+    {0.0000f, 0.0000f, 0.0273f, 0.7937f, 1.0000f, 0.9418f, 0.1719f, 0.0000f, 0.0000f, 0.0025f}, // Green
+    {1.0000f, 1.0000f, 0.8916f, 0.3323f, 0.0000f, 0.0000f, 0.0003f, 0.0369f, 0.0483f, 0.0496f}, // Blue
+}};
+
+// Interpolates linearly between bin centers and holds the outermost bins beyond them.
+float evalBasis(const SampledWavelengths::Basis basis, const float lambda) {
+    constexpr float kBinWidth = (kBasisMax - kBasisMin) / kBasisBinCount;
+    const float x = std::clamp((lambda - kBasisMin) / kBinWidth - 0.5f, 0.0f, kBasisBinCount - 1.0f);
+    const int bin = std::min(static_cast<int>(x), kBasisBinCount - 2);
+    const float t = x - static_cast<float>(bin);
+    return (1.0f - t) * kBasisSpectra[basis][bin] + t * kBasisSpectra[basis][bin + 1];
+}
+
+float evalPiecewiseGaussian(const float lambda, const float mean, const float sigmaLow, const float sigmaHigh) {
+    const float t = (lambda - mean) / (lambda < mean ? sigmaLow : sigmaHigh);
+    return std::exp(-0.5f * t * t);
+}
+
+// CIE 1931 color matching functions, in the multi-lobe fit of Wyman et al., "Simple Analytic Approximations to the CIE
+// XYZ Color Matching Functions".
+glm::vec3 evalColorMatching(const float lambda) {
+    return {
+        1.056f * evalPiecewiseGaussian(lambda, 599.8f, 37.9f, 31.0f) +
+            0.362f * evalPiecewiseGaussian(lambda, 442.0f, 16.0f, 26.7f) -
+            0.065f * evalPiecewiseGaussian(lambda, 501.1f, 20.4f, 26.2f),
+        0.821f * evalPiecewiseGaussian(lambda, 568.8f, 46.9f, 40.5f) +
+            0.286f * evalPiecewiseGaussian(lambda, 530.9f, 16.3f, 31.1f),
+        1.217f * evalPiecewiseGaussian(lambda, 437.0f, 11.8f, 36.0f) +
+            0.681f * evalPiecewiseGaussian(lambda, 459.0f, 26.0f, 13.8f)};
+}
+
+// Everything a wavelength needs, tabulated at every nanometer so that drawing the wavelengths of a sample is a few
+// table lookups rather than dozens of exponentials and bin searches.
+struct WavelengthTableEntry {
+    std::array<float, SampledWavelengths::BasisCount> basis;
+    glm::vec3 colorMatching;
+};
+
+constexpr int kWavelengthTableSize = static_cast<int>(SampledWavelengths::kMax - SampledWavelengths::kMin) + 1;
+
+const std::array<WavelengthTableEntry, kWavelengthTableSize>& getWavelengthTable() {
+    static const auto table = [] {
+        std::array<WavelengthTableEntry, kWavelengthTableSize> entries{};
+        for (int i = 0; i < kWavelengthTableSize; ++i) {
+            const float lambda = SampledWavelengths::kMin + static_cast<float>(i);
+            for (int basis = 0; basis < SampledWavelengths::BasisCount; ++basis) {
+                entries[i].basis[basis] = evalBasis(static_cast<SampledWavelengths::Basis>(basis), lambda);
+            }
+            entries[i].colorMatching = evalColorMatching(lambda);
+        }
+        return entries;
+    }();
+    return table;
+}
+
+glm::vec3 xyzToLinearSrgb(const glm::vec3& xyz) {
+    return {
+        3.2404542f * xyz.x - 1.5371385f * xyz.y - 0.4985314f * xyz.z,
+        -0.9692660f * xyz.x + 1.8760108f * xyz.y + 0.0415560f * xyz.z,
+        0.0556434f * xyz.x - 0.2040259f * xyz.y + 1.0572252f * xyz.z};
+}
+
+// RGB of the constant unit spectrum, which the conversion divides out so that gray stays gray.
+glm::vec3 computeWhiteRgb() {
+    constexpr int kStepCount = 4700;
+    constexpr float kStep = (SampledWavelengths::kMax - SampledWavelengths::kMin) / kStepCount;
+    glm::vec3 xyz(0.0f);
+    for (int i = 0; i < kStepCount; ++i) {
+        xyz += evalColorMatching(SampledWavelengths::kMin + (static_cast<float>(i) + 0.5f) * kStep) * kStep;
+    }
+    return xyzToLinearSrgb(xyz);
+}
+
+uint32_t hashPixel(const glm::ivec2& pixel) {
+    uint32_t hash = static_cast<uint32_t>(pixel.x) * 0x8da6b343u ^ static_cast<uint32_t>(pixel.y) * 0xd8163841u;
+    hash ^= hash >> 16;
+    hash *= 0x7feb352du;
+    hash ^= hash >> 15;
+    hash *= 0x846ca68bu;
+    hash ^= hash >> 16;
+    return hash;
+}
+} // namespace
+
+SampledWavelengths SampledWavelengths::sample(const float u) {
+    const auto& table = getWavelengthTable();
+    SampledWavelengths wavelengths;
+    for (int i = 0; i < kCount; ++i) {
+        float offset = u + static_cast<float>(i) / kCount;
+        offset -= std::floor(offset);
+        wavelengths.lambda[i] = kMin + offset * (kMax - kMin);
+
+        const float x = std::clamp(wavelengths.lambda[i] - kMin, 0.0f, kWavelengthTableSize - 1.0f);
+        const int index = std::min(static_cast<int>(x), kWavelengthTableSize - 2);
+        const float t = x - static_cast<float>(index);
+        const WavelengthTableEntry& lo = table[index];
+        const WavelengthTableEntry& hi = table[index + 1];
+        for (int basis = 0; basis < BasisCount; ++basis) {
+            wavelengths.basis[basis][i] = (1.0f - t) * lo.basis[basis] + t * hi.basis[basis];
+        }
+        wavelengths.colorMatching[i] = (1.0f - t) * lo.colorMatching + t * hi.colorMatching;
+    }
+    return wavelengths;
+}
+
+float SampledSpectrum::getLuminance() const {
+    const glm::vec3 rgb = toRgb();
+    return rgb.r * 0.212671f + rgb.g * 0.715160f + rgb.b * 0.072169f;
+}
+
+bool SampledSpectrum::isValid() const {
+    for (int i = 0; i < getValueCount(); ++i) {
+        if (m_values[i] < 0.0f || !std::isfinite(m_values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SampledSpectrum::isZero() const {
+    for (int i = 0; i < getValueCount(); ++i) {
+        if (m_values[i] != 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SampledSpectrum::isInfinite() const {
+    for (int i = 0; i < getValueCount(); ++i) {
+        if (!std::isfinite(m_values[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SampledSpectrum::isNaN() const {
+    for (int i = 0; i < getValueCount(); ++i) {
+        if (std::isnan(m_values[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SampledSpectrum SampledSpectrum::toSrgb() const {
+    SampledSpectrum result(toRgb());
+    for (int i = 0; i < 3; ++i) {
+        const float val = result[i];
+        result[i] = val <= 0.0031308f ? 12.92f * val : (1.f + 0.055f) * std::pow(val, 1.f / 2.4f) - 0.055f;
+    }
+    return result;
+}
+
+glm::vec3 SampledSpectrum::toRgb() const {
+    if (!m_isSampled) {
+        return {m_values[0], m_values[1], m_values[2]};
+    }
+
+    // Monte Carlo estimate of the XYZ integrals from the wavelengths of this sample.
+    glm::vec3 xyz(0.0f);
+    for (int i = 0; i < SampledWavelengths::kCount; ++i) {
+        xyz += m_values[i] * s_wavelengths.colorMatching[i];
+    }
+    xyz /= SampledWavelengths::pdf() * SampledWavelengths::kCount;
+
+    static const glm::vec3 whiteRgb = computeWhiteRgb();
+    return xyzToLinearSrgb(xyz) / whiteRgb;
+}
+
+void SampledSpectrum::beginSample(const glm::ivec2& pixel, const uint32_t sampleIndex) {
+    if (s_isSampling && s_pixel == pixel && s_sampleIndex == sampleIndex) {
+        return;
+    }
+
+    // A random offset per pixel, advanced by the golden ratio with every sample, stratifies each pixel's wavelengths.
+    constexpr double kGoldenRatioFraction = 0.6180339887498949;
+    const double u = static_cast<double>(hashPixel(pixel)) * 0x1p-32 + kGoldenRatioFraction * sampleIndex;
+    s_wavelengths = SampledWavelengths::sample(static_cast<float>(u - std::floor(u)));
+    s_isSampling = true;
+    s_pixel = pixel;
+    s_sampleIndex = sampleIndex;
+}
+
+void SampledSpectrum::endSample() {
+    s_isSampling = false;
+}
+
+std::ostream& operator<<(std::ostream& stream, const SampledSpectrum& spec) {
+    const int count = spec.isSampled() ? SampledWavelengths::kCount : 3;
+    stream << "[ ";
+    for (int i = 0; i < count; ++i) {
+        stream << spec[i] << (i + 1 < count ? ", " : "");
+    }
+    stream << "]";
+    return stream;
+}
+} // namespace crisp
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <Crisp/Math/Headers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+namespace crisp {
+// Wavelengths carried by the spectra of one camera sample, after Wilkie et al., "Hero Wavelength Spectral Sampling".
+// The hero wavelength is drawn uniformly from the visible range and the others follow it at equal offsets, wrapping
+// around the range, so that all of them share one pdf and their estimates are averaged without weights.
+struct SampledWavelengths {
+    static constexpr int kCount = 4;
+    static constexpr float kMin = 360.0f;
+    static constexpr float kMax = 830.0f;
+
+    // Basis spectra of the RGB uplifting, in the order of Smits, "An RGB-to-Spectrum Conversion for Reflectances".
+    enum Basis { White, Cyan, Magenta, Yellow, Red, Green, Blue, BasisCount };
+
+    std::array<float, kCount> lambda{};
+    std::array<std::array<float, kCount>, BasisCount> basis{}; // Each basis spectrum evaluated at lambda.
+    std::array<glm::vec3, kCount> colorMatching{};              // CIE XYZ matching functions at lambda.
+
+    static SampledWavelengths sample(float u);
+
+    static constexpr float pdf() {
+        return 1.0f / (kMax - kMin);
+    }
+};
+
+// Spectrum of the hero-wavelength backend. Values are constructed in RGB, as the scene description and textures are,
+// and are uplifted to the active wavelengths the first time they meet a sampled value, or any value while a sample is
+// being traced, see beginSample. Scene data therefore stays RGB and a path's estimate becomes spectral as it is built.
+struct alignas(16) SampledSpectrum {
+    constexpr SampledSpectrum(float value = 0.0f) // NOLINT
+        : SampledSpectrum(value, value, value) {}
+
+    constexpr SampledSpectrum(float red, float green, float blue) // NOLINT
+        : m_values{red, green, blue, 0.0f}
+        , m_isSampled(false) {}
+
+    constexpr SampledSpectrum(const glm::vec3& vec) // NOLINT (single-arg)
+        : SampledSpectrum(vec.r, vec.g, vec.b) {}
+
+    static SampledSpectrum fromSampled(const std::array<float, SampledWavelengths::kCount>& values) {
+        SampledSpectrum spectrum;
+        spectrum.m_values = values;
+        spectrum.m_isSampled = true;
+        return spectrum;
+    }
+
+    // Channel in RGB, wavelength once sampled.
+    float& operator[](int index) {
+        return m_values[index];
+    }
+
+    const float& operator[](int index) const {
+        return m_values[index];
+    }
+
+    SampledSpectrum& operator+=(const SampledSpectrum& spectrum) {
+        return combine(spectrum, [](float x, float y) { return x + y; });
+    }
+
+    SampledSpectrum& operator-=(const SampledSpectrum& spectrum) {
+        return combine(spectrum, [](float x, float y) { return x - y; });
+    }
+
+    SampledSpectrum& operator*=(const SampledSpectrum& spectrum) {
+        return combine(spectrum, [](float x, float y) { return x * y; });
+    }
+
+    SampledSpectrum& operator/=(const SampledSpectrum& spectrum) {
+        return combine(spectrum, [](float x, float y) { return x / y; });
+    }
+
+    SampledSpectrum operator+(const SampledSpectrum& spectrum) const {
+        return SampledSpectrum(*this) += spectrum;
+    }
+
+    SampledSpectrum operator-(const SampledSpectrum& spectrum) const {
+        return SampledSpectrum(*this) -= spectrum;
+    }
+
+    SampledSpectrum operator*(const SampledSpectrum& spectrum) const {
+        return SampledSpectrum(*this) *= spectrum;
+    }
+
+    SampledSpectrum operator/(const SampledSpectrum& spectrum) const {
+        return SampledSpectrum(*this) /= spectrum;
+    }
+
+    // Scalars are gray in both representations, so they never uplift.
+    SampledSpectrum& operator+=(float scalar) {
+        return apply([scalar](float x) { return x + scalar; });
+    }
+
+    SampledSpectrum& operator-=(float scalar) {
+        return apply([scalar](float x) { return x - scalar; });
+    }
+
+    SampledSpectrum& operator*=(float scalar) {
+        return apply([scalar](float x) { return x * scalar; });
+    }
+
+    SampledSpectrum& operator/=(float scalar) {
+        return apply([scalar](float x) { return x / scalar; });
+    }
+
+    SampledSpectrum operator+(float scalar) const {
+        return SampledSpectrum(*this) += scalar;
+    }
+
+    SampledSpectrum operator-(float scalar) const {
+        return SampledSpectrum(*this) -= scalar;
+    }
+
+    SampledSpectrum operator*(float scalar) const {
+        return SampledSpectrum(*this) *= scalar;
+    }
+
+    SampledSpectrum operator/(float scalar) const {
+        return SampledSpectrum(*this) /= scalar;
+    }
+
+    SampledSpectrum operator-() const {
+        return SampledSpectrum(*this).apply([](float x) { return -x; });
+    }
+
+    float getLuminance() const;
+
+    float maxCoeff() const {
+        float result = m_values[0];
+        for (int i = 1; i < getValueCount(); ++i) {
+            result = std::max(result, m_values[i]);
+        }
+        return result;
+    }
+
+    SampledSpectrum exp() const {
+        return SampledSpectrum(*this).apply([](float x) { return std::exp(x); });
+    }
+
+    SampledSpectrum sqrt() const {
+        return SampledSpectrum(*this).apply([](float x) { return std::sqrt(x); });
+    }
+
+    SampledSpectrum clamp() const {
+        return SampledSpectrum(*this).apply([](float x) { return std::max(x, 0.0f); });
+    }
+
+    bool isValid() const;
+    bool isZero() const;
+    bool isInfinite() const;
+    bool isNaN() const;
+
+    bool isSampled() const {
+        return m_isSampled;
+    }
+
+    SampledSpectrum toSrgb() const;
+
+    // Linear sRGB, projecting sampled values through the CIE matching functions at the active wavelengths.
+    glm::vec3 toRgb() const;
+
+    // Activates the wavelengths of the given camera sample on this thread. They are a function of the pixel and sample
+    // index alone, so every part of the renderer that resumes the sample sees the same ones.
+    static void beginSample(const glm::ivec2& pixel, uint32_t sampleIndex);
+    static void endSample();
+
+    static bool isSampling() {
+        return s_isSampling;
+    }
+
+    static const SampledWavelengths& getWavelengths() {
+        return s_wavelengths;
+    }
+
+    constexpr static SampledSpectrum zero() {
+        return {0.0f};
+    }
+
+private:
+    int getValueCount() const {
+        return m_isSampled ? SampledWavelengths::kCount : 3;
+    }
+
+    template <typename Op>
+    SampledSpectrum& apply(const Op& op) {
+        for (float& value : m_values) {
+            value = op(value);
+        }
+        return *this;
+    }
+
+    template <typename Op>
+    SampledSpectrum& combine(const SampledSpectrum& spectrum, const Op& op) {
+        if (m_isSampled || spectrum.m_isSampled || s_isSampling) {
+            const std::array<float, SampledWavelengths::kCount> values = spectrum.getSampledValues();
+            m_values = getSampledValues();
+            m_isSampled = true;
+            for (int i = 0; i < SampledWavelengths::kCount; ++i) {
+                m_values[i] = op(m_values[i], values[i]);
+            }
+        } else {
+            for (int i = 0; i < 3; ++i) {
+                m_values[i] = op(m_values[i], spectrum.m_values[i]);
+            }
+        }
+        return *this;
+    }
+
+    std::array<float, SampledWavelengths::kCount> getSampledValues() const {
+        return m_isSampled ? m_values : uplift(m_values[0], m_values[1], m_values[2]);
+    }
+
+    // Smits' construction: the smallest channel as white, the middle one minus it as the complementary color of the
+    // largest channel, and what remains of the largest as its primary.
+    static std::array<float, SampledWavelengths::kCount> uplift(float r, float g, float b) {
+        using enum SampledWavelengths::Basis;
+        float white = 0.0f;
+        float secondary = 0.0f;
+        float primary = 0.0f;
+        SampledWavelengths::Basis secondaryBasis = White;
+        SampledWavelengths::Basis primaryBasis = White;
+        if (r <= g && r <= b) {
+            white = r;
+            secondaryBasis = Cyan;
+            if (g <= b) {
+                secondary = g - r;
+                primary = b - g;
+                primaryBasis = Blue;
+            } else {
+                secondary = b - r;
+                primary = g - b;
+                primaryBasis = Green;
+            }
+        } else if (g <= r && g <= b) {
+            white = g;
+            secondaryBasis = Magenta;
+            if (r <= b) {
+                secondary = r - g;
+                primary = b - r;
+                primaryBasis = Blue;
+            } else {
+                secondary = b - g;
+                primary = r - b;
+                primaryBasis = Red;
+            }
+        } else {
+            white = b;
+            secondaryBasis = Yellow;
+            if (r <= g) {
+                secondary = r - b;
+                primary = g - r;
+                primaryBasis = Green;
+            } else {
+                secondary = g - b;
+                primary = r - g;
+                primaryBasis = Red;
+            }
+        }
+
+        const auto& basis = s_wavelengths.basis;
+        std::array<float, SampledWavelengths::kCount> values{};
+        for (int i = 0; i < SampledWavelengths::kCount; ++i) {
+            values[i] = white * basis[White][i] + secondary * basis[secondaryBasis][i] +
+                        primary * basis[primaryBasis][i];
+        }
+        return values;
+    }
+
+    std::array<float, SampledWavelengths::kCount> m_values;
+    bool m_isSampled;
+
+    static inline thread_local SampledWavelengths s_wavelengths{};
+    static inline thread_local bool s_isSampling{false};
+    static inline thread_local glm::ivec2 s_pixel{-1, -1};
+    static inline thread_local uint32_t s_sampleIndex{0};
+};
+
+inline SampledSpectrum operator+(float scalar, const SampledSpectrum& spectrum) {
+    return spectrum + scalar;
+}
+
+inline SampledSpectrum operator*(float scalar, const SampledSpectrum& spectrum) {
+    return spectrum * scalar;
+}
+
+std::ostream& operator<<(std::ostream& stream, const SampledSpectrum& spec);
+} // namespace crisp
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <Crisp/Math/Headers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CRISP_SPECTRUM_USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace crisp {
+// RGB spectrum padded to four lanes, so that every operator is a single SSE instruction inlined at the call site. The
+// fourth lane is kept at zero. Same interface as RgbSpectrum.
+struct alignas(16) SimdRgbSpectrum {
+#pragma warning(push)
+#pragma warning(disable : 4201) // nameless struct
+
+    union {
+#ifdef CRISP_SPECTRUM_USE_SSE
+        __m128 simd;
+#endif
+        float values[4]; // NOLINT
+
+        struct {
+            float r, g, b, a;
+        };
+    };
+
+#pragma warning(pop)
+
+    constexpr SimdRgbSpectrum(float value = 0.0f) // NOLINT
+        : SimdRgbSpectrum(value, value, value) {}
+
+    constexpr SimdRgbSpectrum(float red, float green, float blue) { // NOLINT
+#ifdef CRISP_SPECTRUM_USE_SSE
+        // A single register write, since loading the lanes stored one by one would stall on store forwarding.
+        if !consteval {
+            simd = _mm_set_ps(0.0f, blue, green, red);
+            return;
+        }
+#endif
+        r = red;
+        g = green;
+        b = blue;
+        a = 0.0f;
+    }
+
+    constexpr SimdRgbSpectrum(const glm::vec3& vec) // NOLINT (single-arg)
+        : SimdRgbSpectrum(vec.r, vec.g, vec.b) {}
+
+    float& operator[](int index) {
+        return values[index];
+    }
+
+    const float& operator[](int index) const {
+        return values[index];
+    }
+
+#ifdef CRISP_SPECTRUM_USE_SSE
+    SimdRgbSpectrum& operator+=(const SimdRgbSpectrum& spectrum) {
+        simd = _mm_add_ps(simd, spectrum.simd);
+        return *this;
+    }
+
+    SimdRgbSpectrum& operator-=(const SimdRgbSpectrum& spectrum) {
+        simd = _mm_sub_ps(simd, spectrum.simd);
+        return *this;
+    }
+
+    SimdRgbSpectrum& operator*=(const SimdRgbSpectrum& spectrum) {
+        simd = _mm_mul_ps(simd, spectrum.simd);
+        return *this;
+    }
+
+    // Masks the fourth lane afterwards, which would otherwise hold 0 / 0.
+    SimdRgbSpectrum& operator/=(const SimdRgbSpectrum& spectrum) {
+        simd = _mm_and_ps(_mm_div_ps(simd, spectrum.simd), rgbMask());
+        return *this;
+    }
+
+    SimdRgbSpectrum& operator+=(float scalar) {
+        simd = _mm_add_ps(simd, _mm_set_ps(0.0f, scalar, scalar, scalar));
+        return *this;
+    }
+
+    SimdRgbSpectrum& operator-=(float scalar) {
+        simd = _mm_sub_ps(simd, _mm_set_ps(0.0f, scalar, scalar, scalar));
+        return *this;
+    }
+
+    SimdRgbSpectrum& operator*=(float scalar) {
+        simd = _mm_mul_ps(simd, _mm_set1_ps(scalar));
+        return *this;
+    }
+
+    SimdRgbSpectrum& operator/=(float scalar) {
+        simd = _mm_div_ps(simd, _mm_set_ps(1.0f, scalar, scalar, scalar));
+        return *this;
+    }
+
+    SimdRgbSpectrum operator-() const {
+        SimdRgbSpectrum result;
+        result.simd = _mm_sub_ps(_mm_setzero_ps(), simd);
+        return result;
+    }
+
+    float maxCoeff() const {
+        const __m128 max = _mm_max_ps(simd, _mm_shuffle_ps(simd, simd, _MM_SHUFFLE(3, 0, 2, 1)));
+        return std::max(_mm_cvtss_f32(max), b);
+    }
+
+    SimdRgbSpectrum sqrt() const {
+        SimdRgbSpectrum result;
+        result.simd = _mm_sqrt_ps(simd);
+        return result;
+    }
+
+    SimdRgbSpectrum clamp() const {
+        SimdRgbSpectrum result;
+        result.simd = _mm_max_ps(simd, _mm_setzero_ps());
+        return result;
+    }
+
+    bool isZero() const {
+        return _mm_movemask_ps(_mm_cmpeq_ps(simd, _mm_setzero_ps())) == 0xF;
+    }
+#else
+    SimdRgbSpectrum& operator+=(const SimdRgbSpectrum& spectrum) {
+        return apply(spectrum, [](float x, float y) { return x + y; });
+    }
+
+    SimdRgbSpectrum& operator-=(const SimdRgbSpectrum& spectrum) {
+        return apply(spectrum, [](float x, float y) { return x - y; });
+    }
+
+    SimdRgbSpectrum& operator*=(const SimdRgbSpectrum& spectrum) {
+        return apply(spectrum, [](float x, float y) { return x * y; });
+    }
+
+    SimdRgbSpectrum& operator/=(const SimdRgbSpectrum& spectrum) {
+        apply(spectrum, [](float x, float y) { return x / y; });
+        a = 0.0f;
+        return *this;
+    }
+
+    SimdRgbSpectrum& operator+=(float scalar) {
+        return *this += SimdRgbSpectrum(scalar);
+    }
+
+    SimdRgbSpectrum& operator-=(float scalar) {
+        return *this -= SimdRgbSpectrum(scalar);
+    }
+
+    SimdRgbSpectrum& operator*=(float scalar) {
+        return *this *= SimdRgbSpectrum(scalar);
+    }
+
+    SimdRgbSpectrum& operator/=(float scalar) {
+        return *this /= SimdRgbSpectrum(scalar);
+    }
+
+    SimdRgbSpectrum operator-() const {
+        return {-r, -g, -b};
+    }
+
+    float maxCoeff() const {
+        return std::max(r, std::max(g, b));
+    }
+
+    SimdRgbSpectrum sqrt() const {
+        return {std::sqrt(r), std::sqrt(g), std::sqrt(b)};
+    }
+
+    SimdRgbSpectrum clamp() const {
+        return {std::max(r, 0.0f), std::max(g, 0.0f), std::max(b, 0.0f)};
+    }
+
+    bool isZero() const {
+        return r == 0.0f && g == 0.0f && b == 0.0f;
+    }
+#endif
+
+    SimdRgbSpectrum operator+(const SimdRgbSpectrum& spectrum) const {
+        return SimdRgbSpectrum(*this) += spectrum;
+    }
+
+    SimdRgbSpectrum operator-(const SimdRgbSpectrum& spectrum) const {
+        return SimdRgbSpectrum(*this) -= spectrum;
+    }
+
+    SimdRgbSpectrum operator*(const SimdRgbSpectrum& spectrum) const {
+        return SimdRgbSpectrum(*this) *= spectrum;
+    }
+
+    SimdRgbSpectrum operator/(const SimdRgbSpectrum& spectrum) const {
+        return SimdRgbSpectrum(*this) /= spectrum;
+    }
+
+    SimdRgbSpectrum operator+(float scalar) const {
+        return SimdRgbSpectrum(*this) += scalar;
+    }
+
+    SimdRgbSpectrum operator-(float scalar) const {
+        return SimdRgbSpectrum(*this) -= scalar;
+    }
+
+    SimdRgbSpectrum operator*(float scalar) const {
+        return SimdRgbSpectrum(*this) *= scalar;
+    }
+
+    SimdRgbSpectrum operator/(float scalar) const {
+        return SimdRgbSpectrum(*this) /= scalar;
+    }
+
+    float getLuminance() const {
+        return r * 0.212671f + g * 0.715160f + b * 0.072169f;
+    }
+
+    SimdRgbSpectrum exp() const {
+        return {std::exp(r), std::exp(g), std::exp(b)};
+    }
+
+    bool isValid() const {
+        return r >= 0.0f && g >= 0.0f && b >= 0.0f && !isInfinite();
+    }
+
+    bool isInfinite() const {
+        return !std::isfinite(r) || !std::isfinite(g) || !std::isfinite(b);
+    }
+
+    bool isNaN() const {
+        return std::isnan(r) || std::isnan(g) || std::isnan(b);
+    }
+
+    SimdRgbSpectrum toSrgb() const {
+        SimdRgbSpectrum result;
+        for (int i = 0; i < 3; ++i) {
+            const float val = values[i];
+            result[i] = val <= 0.0031308f ? 12.92f * val : (1.f + 0.055f) * std::pow(val, 1.f / 2.4f) - 0.055f;
+        }
+        return result;
+    }
+
+    glm::vec3 toRgb() const {
+        return {r, g, b};
+    }
+
+    // RGB carries no per-sample state, see SampledSpectrum.
+    static void beginSample(const glm::ivec2& /*pixel*/, uint32_t /*sampleIndex*/) {}
+
+    static void endSample() {}
+
+    constexpr static SimdRgbSpectrum zero() {
+        return {0.0f};
+    }
+
+private:
+#ifdef CRISP_SPECTRUM_USE_SSE
+    static __m128 rgbMask() {
+        return _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    }
+#else
+    template <typename Op>
+    SimdRgbSpectrum& apply(const SimdRgbSpectrum& spectrum, const Op& op) {
+        for (int i = 0; i < 4; ++i) {
+            values[i] = op(values[i], spectrum.values[i]);
+        }
+        return *this;
+    }
+#endif
+};
+
+inline SimdRgbSpectrum operator+(float scalar, const SimdRgbSpectrum& spectrum) {
+    return spectrum + scalar;
+}
+
+inline SimdRgbSpectrum operator*(float scalar, const SimdRgbSpectrum& spectrum) {
+    return spectrum * scalar;
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const SimdRgbSpectrum& spec) {
+    stream << "[ " << spec.r << ", " << spec.g << ", " << spec.b << "]";
+    return stream;
+}
+} // namespace crisp
@@ -3,7 +3,20 @@
 #include <Crisp/PathTracer/Spectra/RgbSpectrum.hpp>
 #include <Crisp/PathTracer/Spectra/WeightedRgbSpectrum.hpp>
 
+// The backend is chosen by the CrispSpectrum library variant linked in, see CRISP_SPECTRUM_BACKEND.
+#if defined(CRISP_SPECTRUM_HERO_SPECTRAL)
+#include <Crisp/PathTracer/Spectra/SampledSpectrum.hpp>
+#elif defined(CRISP_SPECTRUM_SIMD_RGB)
+#include <Crisp/PathTracer/Spectra/SimdRgbSpectrum.hpp>
+#endif
+
 namespace crisp {
+#if defined(CRISP_SPECTRUM_HERO_SPECTRAL)
+using Spectrum = SampledSpectrum;
+#elif defined(CRISP_SPECTRUM_SIMD_RGB)
+using Spectrum = SimdRgbSpectrum;
+#else
 using Spectrum = RgbSpectrum;
+#endif
 using WeightedSpectrum = WeightedRgbSpectrum;
 } // namespace crisp
@@ -0,0 +1,115 @@
+#include <Crisp/PathTracer/Denoiser.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+constexpr glm::ivec2 kSize(64, 64);
+
+std::vector<float> createRgba(const glm::ivec2 size, const auto& func) {
+    std::vector<float> rgba;
+    for (int32_t y = 0; y < size.y; ++y) {
+        for (int32_t x = 0; x < size.x; ++x) {
+            const glm::vec3 value = func(x, y);
+            rgba.insert(rgba.end(), {value.r, value.g, value.b, 1.0f});
+        }
+    }
+    return rgba;
+}
+
+// A plane facing the camera at unit distance, whose albedo is given per pixel.
+FeatureImages createPlane(const auto& albedo) {
+    return {
+        .albedo = createRgba(kSize, albedo),
+        .normal = createRgba(kSize, [](int32_t, int32_t) { return glm::vec3(0.0f, 0.0f, 1.0f); }),
+        .depth = createRgba(kSize, [](int32_t, int32_t) { return glm::vec3(1.0f); }),
+    };
+}
+
+// Adds zero-mean noise with a relative standard deviation of about a half, as in an image of a few samples per pixel.
+std::vector<float> addNoise(std::vector<float> rgba) {
+    std::mt19937 engine(11);
+    std::normal_distribution<float> distribution(1.0f, 0.5f);
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+        const float scale = distribution(engine);
+        for (size_t c = 0; c < 3; ++c) {
+            rgba[i + c] *= scale;
+        }
+    }
+    return rgba;
+}
+
+// Root mean squared error of the red channel over the pixels that the predicate selects.
+double computeError(const std::vector<float>& image, const std::vector<float>& reference, const auto& predicate) {
+    double sum = 0.0;
+    int32_t count = 0;
+    for (int32_t y = 0; y < kSize.y; ++y) {
+        for (int32_t x = 0; x < kSize.x; ++x) {
+            if (predicate(x, y)) {
+                const size_t i = (static_cast<size_t>(y) * kSize.x + x) * 4;
+                sum += (image[i] - reference[i]) * (image[i] - reference[i]);
+                ++count;
+            }
+        }
+    }
+    return std::sqrt(sum / count);
+}
+
+const auto kAllPixels = [](int32_t, int32_t) { return true; };
+
+TEST(DenoiserTest, SmoothsNoiseOnAUniformSurface) {
+    const FeatureImages features = createPlane([](int32_t, int32_t) { return glm::vec3(0.5f); });
+    const std::vector<float> reference = createRgba(kSize, [](int32_t, int32_t) { return glm::vec3(0.8f); });
+    const std::vector<float> noisy = addNoise(reference);
+
+    const std::vector<float> denoised = Denoiser(DenoiserSettings()).denoise(kSize, noisy, features);
+    ASSERT_EQ(denoised.size(), noisy.size());
+    EXPECT_LT(computeError(denoised, reference, kAllPixels), 0.1 * computeError(noisy, reference, kAllPixels));
+}
+
+TEST(DenoiserTest, KeepsTextureDetailThroughTheAlbedo) {
+    // A checkerboard of one-pixel squares, which any filter would blur without the albedo guide.
+    const auto checker = [](int32_t x, int32_t y) { return glm::vec3((x + y) % 2 == 0 ? 0.9f : 0.1f); };
+    const FeatureImages features = createPlane(checker);
+    const std::vector<float> reference = createRgba(kSize, [&](int32_t x, int32_t y) { return 2.0f * checker(x, y); });
+    const std::vector<float> noisy = addNoise(reference);
+
+    const std::vector<float> denoised = Denoiser(DenoiserSettings()).denoise(kSize, noisy, features);
+    EXPECT_LT(computeError(denoised, reference, kAllPixels), 0.1 * computeError(noisy, reference, kAllPixels));
+}
+
+TEST(DenoiserTest, DoesNotBlurAcrossGeometricEdges) {
+    // Two walls meeting in a crease down the middle of the image, lit very differently.
+    FeatureImages features = createPlane([](int32_t, int32_t) { return glm::vec3(0.5f); });
+    features.normal = createRgba(kSize, [](int32_t x, int32_t) {
+        return x < kSize.x / 2 ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+    });
+    const std::vector<float> reference =
+        createRgba(kSize, [](int32_t x, int32_t) { return glm::vec3(x < kSize.x / 2 ? 0.05f : 1.0f); });
+    const std::vector<float> noisy = addNoise(reference);
+
+    const std::vector<float> denoised = Denoiser(DenoiserSettings()).denoise(kSize, noisy, features);
+    const auto isNextToEdge = [](int32_t x, int32_t) { return std::abs(x - kSize.x / 2) <= 2; };
+    EXPECT_LT(computeError(denoised, reference, isNextToEdge), 0.5 * computeError(noisy, reference, isNextToEdge));
+    for (int32_t y = 0; y < kSize.y; ++y) {
+        EXPECT_LT(denoised[(static_cast<size_t>(y) * kSize.x + kSize.x / 2 - 1) * 4], 0.1f);
+    }
+}
+
+TEST(DenoiserTest, ZeroIterationsReturnTheInput) {
+    const FeatureImages features = createPlane([](int32_t x, int32_t) { return glm::vec3(x % 3 == 0 ? 0.0f : 0.7f); });
+    const std::vector<float> noisy = addNoise(createRgba(kSize, [](int32_t, int32_t) { return glm::vec3(0.3f); }));
+
+    DenoiserSettings settings;
+    settings.iterations = 0;
+    const std::vector<float> denoised = Denoiser(settings).denoise(kSize, noisy, features);
+    for (size_t i = 0; i < noisy.size(); ++i) {
+        EXPECT_NEAR(denoised[i], noisy[i], 1e-5f);
+    }
+}
+} // namespace
+} // namespace crisp::test
@@ -0,0 +1,153 @@
+#include <Crisp/PathTracer/ImageBlock.hpp>
+#include <Crisp/PathTracer/ReconstructionFilters/BoxFilter.hpp>
+#include <Crisp/PathTracer/ReconstructionFilters/GaussianFilter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace crisp::test {
+namespace {
+TEST(ImageBlockTest, PixelStatisticsMatchSampleMeanAndVariance) {
+    const std::vector<float> values = {0.5f, 1.5f, 2.0f, 4.0f, 3.0f};
+
+    ImageBlock::PixelStatistics stats{};
+    for (const float value : values) {
+        stats.add(value);
+    }
+
+    EXPECT_EQ(stats.sampleCount, values.size());
+    EXPECT_NEAR(stats.mean, 2.2f, 1e-6f);
+    // Unbiased sample variance of the values is 1.825.
+    EXPECT_NEAR(stats.m2 / static_cast<float>(values.size() - 1), 1.825f, 1e-5f);
+    EXPECT_NEAR(stats.getMeanVariance(), 1.825f / 5.0f, 1e-5f);
+    EXPECT_NEAR(stats.getRelativeError(), std::sqrt(1.825f / 5.0f) / 2.2f, 1e-5f);
+}
+
+TEST(ImageBlockTest, MergedPixelStatisticsMatchSequentialUpdates) {
+    ImageBlock::PixelStatistics sequential{};
+    ImageBlock::PixelStatistics first{};
+    ImageBlock::PixelStatistics second{};
+    for (int i = 0; i < 10; ++i) {
+        const float value = static_cast<float>(i * i) * 0.1f;
+        sequential.add(value);
+        (i < 3 ? first : second).add(value);
+    }
+
+    first.merge(second);
+    EXPECT_EQ(first.sampleCount, sequential.sampleCount);
+    EXPECT_NEAR(first.mean, sequential.mean, 1e-5f);
+    EXPECT_NEAR(first.m2, sequential.m2, 1e-3f);
+}
+
+TEST(ImageBlockTest, RelativeErrorIsInfiniteBeforeTwoSamples) {
+    ImageBlock::PixelStatistics stats{};
+    EXPECT_TRUE(std::isinf(stats.getRelativeError()));
+    stats.add(1.0f);
+    EXPECT_TRUE(std::isinf(stats.getRelativeError()));
+    stats.add(1.0f);
+    EXPECT_EQ(stats.getRelativeError(), 0.0f);
+}
+
+TEST(ImageBlockTest, SamplesAreCountedInTheirPixel) {
+    const GaussianFilter filter;
+    ImageBlock block(glm::ivec2(8, 4), glm::ivec2(4, 4), &filter);
+    block.clear();
+
+    block.addSample(glm::vec2(9.5f, 5.5f), Spectrum(1.0f));
+    block.addSample(glm::vec2(9.25f, 5.75f), Spectrum(1.0f));
+    block.addSample(glm::vec2(11.5f, 7.5f), Spectrum(1.0f));
+
+    EXPECT_EQ(block.getPixelStatistics(1, 1).sampleCount, 2u);
+    EXPECT_EQ(block.getPixelStatistics(3, 3).sampleCount, 1u);
+    EXPECT_EQ(block.getPixelStatistics(0, 0).sampleCount, 0u);
+    EXPECT_EQ(block.getTotalSampleCount(), 3u);
+
+    ImageBlock image(glm::ivec2(16, 16), &filter);
+    image.clear();
+    image.put(block);
+    EXPECT_EQ(image.getPixelStatistics(9, 5).sampleCount, 2u);
+    EXPECT_EQ(image.getSampleCountRaw()[(7 * 16 + 11) * 4], 1.0f);
+}
+
+TEST(ImageBlockTest, BoxFilterAveragesSamplesWithinTheirPixel) {
+    const BoxFilter filter;
+    ImageBlock block(glm::ivec2(2, 2), &filter);
+    block.clear();
+
+    block.addSample(glm::vec2(0.1f, 0.9f), Spectrum(1.0f, 2.0f, 3.0f));
+    block.addSample(glm::vec2(0.9f, 0.1f), Spectrum(3.0f, 2.0f, 1.0f));
+
+    EXPECT_EQ(block.getFullSize(), glm::ivec2(2, 2));
+    const std::vector<float> rgba = block.getRaw();
+    EXPECT_EQ(rgba[0], 2.0f);
+    EXPECT_EQ(rgba[1], 2.0f);
+    EXPECT_EQ(rgba[2], 2.0f);
+    for (size_t i = 4; i < rgba.size(); i += 4) {
+        EXPECT_EQ(rgba[i], 0.0f);
+    }
+}
+
+TEST(ImageBlockTest, SplatsAcrossBlockBordersAreMergedIntoNeighbors) {
+    const GaussianFilter filter;
+    ImageBlock left(glm::ivec2(0, 0), glm::ivec2(4, 4), &filter);
+    ImageBlock right(glm::ivec2(4, 0), glm::ivec2(4, 4), &filter);
+    ImageBlock reference(glm::ivec2(8, 4), &filter);
+    left.clear();
+    right.clear();
+    reference.clear();
+
+    // A sample next to the seam also lands in the first column of the right block.
+    left.addSample(glm::vec2(3.9f, 1.5f), Spectrum(1.0f));
+    right.addSample(glm::vec2(4.2f, 2.5f), Spectrum(0.5f));
+    reference.addSample(glm::vec2(3.9f, 1.5f), Spectrum(1.0f));
+    reference.addSample(glm::vec2(4.2f, 2.5f), Spectrum(0.5f));
+
+    ImageBlock image(glm::ivec2(8, 4), &filter);
+    image.clear();
+    image.put(left);
+    image.put(right);
+
+    std::vector<float> merged(8 * 4 * 4);
+    image.writeRgba(ImageBlock::Descriptor(0, 0, 8, 4), merged, glm::ivec2(0), 8);
+    const std::vector<float> expected = reference.getRaw();
+    ASSERT_EQ(merged.size(), expected.size());
+    for (size_t i = 0; i < merged.size(); ++i) {
+        EXPECT_NEAR(merged[i], expected[i], 1e-6f) << "at index " << i;
+    }
+}
+
+TEST(ImageBlockTest, FeaturesAreAveragedInTheirPixelOnly) {
+    const GaussianFilter filter;
+    ImageBlock block(glm::ivec2(2, 0), glm::ivec2(2, 2), &filter);
+    block.clear();
+
+    block.addFeatures(glm::vec2(2.5f, 0.5f), Spectrum(0.2f, 0.4f, 0.6f), glm::vec3(0.0f, 0.0f, 1.0f), 2.0f);
+    block.addFeatures(glm::vec2(2.7f, 0.1f), Spectrum(0.4f, 0.4f, 0.4f), glm::vec3(0.0f, 1.0f, 0.0f), 4.0f);
+    block.addFeatures(glm::vec2(3.5f, 1.5f), Spectrum(0.0f), glm::vec3(0.0f), 0.0f);
+
+    ImageBlock image(glm::ivec2(4, 2), &filter);
+    image.clear();
+    image.put(block);
+
+    std::vector<float> albedo(4 * 2 * 4);
+    std::vector<float> normal(4 * 2 * 4);
+    std::vector<float> depth(4 * 2 * 4);
+    image.writeFeatures(ImageBlock::Descriptor(0, 0, 4, 2), albedo, normal, depth, glm::ivec2(0), 4);
+
+    const size_t pixel = 2 * 4;
+    EXPECT_NEAR(albedo[pixel], 0.3f, 1e-6f);
+    EXPECT_NEAR(albedo[pixel + 2], 0.5f, 1e-6f);
+    EXPECT_NEAR(normal[pixel + 1], std::sqrt(0.5f), 1e-6f);
+    EXPECT_NEAR(normal[pixel + 2], std::sqrt(0.5f), 1e-6f);
+    EXPECT_EQ(depth[pixel], 3.0f);
+
+    // Neither the neighbor of the splatted pixel nor the background pixel receive any features.
+    for (const size_t other : {size_t{3 * 4}, size_t{7 * 4}}) {
+        EXPECT_EQ(albedo[other], 0.0f);
+        EXPECT_EQ(normal[other + 2], 0.0f);
+        EXPECT_EQ(depth[other], 0.0f);
+    }
+}
+} // namespace
+} // namespace crisp::test
@@ -0,0 +1,139 @@
+#include <Crisp/PathTracer/BSDFs/DielectricBSDF.hpp>
+#include <Crisp/PathTracer/BSDFs/LambertianBSDF.hpp>
+#include <Crisp/PathTracer/Core/JsonSceneParser.hpp>
+#include <Crisp/PathTracer/Core/Scene.hpp>
+#include <Crisp/PathTracer/Shapes/Mesh.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+constexpr float kTolerance = 1e-4f;
+
+constexpr const char* kQuadPrototype =
+    R"({"name": "quad", "shapes": [{"type": "mesh", "filename": "instance-quad.obj",
+        "bsdf": {"type": "lambertian", "reflectance": [0.5, 0.5, 0.5]}}]})";
+
+// The inner and outer transforms of the nested instance, which the flat mesh applies in one go.
+constexpr const char* kInnerTransform = R"({"scale": [2.0, 3.0, 1.0]},
+    {"rotation": {"axis": [0.0, 1.0, 0.0], "angleDegrees": 20.0}})";
+constexpr const char* kOuterTransform = R"({"rotation": {"axis": [1.0, 0.0, 0.0], "angleDegrees": -15.0}},
+    {"translation": [0.5, -1.0, -4.0]})";
+
+std::unique_ptr<pt::Scene> loadScene(
+    const std::string& name, const std::string& prototypes, const std::string& shapes) {
+    const std::filesystem::path directory = ::testing::TempDir();
+    std::ofstream(directory / "instance-quad.obj") << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+                                                    << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+                                                    << "f 1/1 2/2 3/3\nf 1/1 3/3 4/4\n";
+    const auto scenePath = directory / (name + ".json");
+    std::ofstream(scenePath) << R"({"prototypes": [)" << prototypes << R"(], "shapes": [)" << shapes
+                             << R"(], "lights": [{"type": "point", "position": [0.0, 5.0, 0.0]}]})";
+    auto scene = JsonSceneParser().parse(scenePath, directory);
+    return scene ? scene.extract() : nullptr;
+}
+
+// Rays from one point towards a grid that covers the transformed quad and some of its surroundings.
+std::vector<Ray3> createRays() {
+    std::vector<Ray3> rays;
+    const glm::vec3 origin(1.5f, 0.5f, 2.0f);
+    for (int y = 0; y < 24; ++y) {
+        for (int x = 0; x < 24; ++x) {
+            const glm::vec3 target(-1.0f + 0.2f * x, -2.5f + 0.25f * y, -4.0f);
+            rays.emplace_back(origin, glm::normalize(target - origin));
+        }
+    }
+    return rays;
+}
+
+void expectSameHit(const Intersection& nested, const Intersection& flat) {
+    EXPECT_NEAR(nested.tHit, flat.tHit, kTolerance);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_NEAR(nested.p[i], flat.p[i], kTolerance);
+        EXPECT_NEAR(nested.geoFrame.n[i], flat.geoFrame.n[i], kTolerance);
+    }
+    EXPECT_NEAR(nested.uv.x, flat.uv.x, kTolerance);
+    EXPECT_NEAR(nested.uv.y, flat.uv.y, kTolerance);
+}
+
+TEST(InstanceTest, NestedInstanceMatchesFlatMesh) {
+    const auto nested = loadScene(
+        "instance-nested",
+        std::string(kQuadPrototype) +
+            R"(, {"name": "tiltedQuad", "shapes": [{"type": "instance", "prototype": "quad", "toWorld": [)" +
+            kInnerTransform + "]}]}",
+        R"({"type": "instance", "prototype": "tiltedQuad", "toWorld": [)" + std::string(kOuterTransform) + "]}");
+    const auto flat = loadScene(
+        "instance-flat",
+        "",
+        R"({"type": "mesh", "filename": "instance-quad.obj", "toWorld": [)" + std::string(kInnerTransform) + ", " +
+            kOuterTransform + R"(], "bsdf": {"type": "lambertian", "reflectance": [0.5, 0.5, 0.5]}})");
+    ASSERT_NE(nested, nullptr);
+    ASSERT_NE(flat, nullptr);
+
+    const std::vector<Ray3> rays = createRays();
+    std::vector<Intersection> nestedPacketHits(rays.size());
+    nested->rayIntersect(rays, nestedPacketHits);
+
+    int hitCount = 0;
+    for (size_t i = 0; i < rays.size(); ++i) {
+        Intersection nestedHit;
+        Intersection flatHit;
+        const bool isNestedHit = nested->rayIntersect(rays[i], nestedHit);
+        ASSERT_EQ(isNestedHit, flat->rayIntersect(rays[i], flatHit));
+        ASSERT_EQ(isNestedHit, nestedPacketHits[i].shape != nullptr);
+        if (isNestedHit) {
+            ++hitCount;
+            expectSameHit(nestedHit, flatHit);
+            expectSameHit(nestedPacketHits[i], flatHit);
+            // Without a BSDF of their own, the instances report the prototype mesh.
+            EXPECT_NE(dynamic_cast<const Mesh*>(nestedHit.shape), nullptr);
+            EXPECT_NE(dynamic_cast<const LambertianBSDF*>(nestedHit.shape->getBSDF()), nullptr);
+        }
+    }
+    EXPECT_GT(hitCount, 0);
+    EXPECT_LT(hitCount, static_cast<int>(rays.size()));
+}
+
+TEST(InstanceTest, InstanceBsdfOverridesPrototypeBsdf) {
+    // Three quads side by side: a plain instance, an instance with a glass BSDF, and a glass instance of a prototype
+    // that instances the quad in turn.
+    const auto scene = loadScene(
+        "instance-override",
+        std::string(kQuadPrototype) +
+            R"(, {"name": "nestedQuad", "shapes": [{"type": "instance", "prototype": "quad"}]})",
+        R"({"type": "instance", "prototype": "quad", "toWorld": [{"translation": [-3.0, 0.0, -4.0]}]},
+           {"type": "instance", "prototype": "quad", "toWorld": [{"translation": [0.0, 0.0, -4.0]}],
+            "bsdf": {"type": "dielectric"}},
+           {"type": "instance", "prototype": "nestedQuad", "toWorld": [{"translation": [3.0, 0.0, -4.0]}],
+            "bsdf": {"type": "dielectric"}})");
+    ASSERT_NE(scene, nullptr);
+    const auto& shapes = scene->getShapes();
+    ASSERT_EQ(shapes.size(), 3u);
+
+    const auto trace = [&scene](const float x) {
+        Intersection its;
+        EXPECT_TRUE(scene->rayIntersect(Ray3(glm::vec3(x, 0.5f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f)), its));
+        return its;
+    };
+
+    const Intersection plain = trace(-2.5f);
+    EXPECT_NE(dynamic_cast<const Mesh*>(plain.shape), nullptr);
+    EXPECT_NE(dynamic_cast<const LambertianBSDF*>(plain.shape->getBSDF()), nullptr);
+
+    const Intersection overridden = trace(0.5f);
+    EXPECT_EQ(overridden.shape, shapes[1].get());
+    EXPECT_NE(dynamic_cast<const DielectricBSDF*>(overridden.shape->getBSDF()), nullptr);
+
+    const Intersection nestedOverridden = trace(3.5f);
+    EXPECT_EQ(nestedOverridden.shape, shapes[2].get());
+    EXPECT_NE(dynamic_cast<const DielectricBSDF*>(nestedOverridden.shape->getBSDF()), nullptr);
+    EXPECT_NEAR(nestedOverridden.p.z, -4.0f, kTolerance);
+}
+} // namespace
+} // namespace crisp::test
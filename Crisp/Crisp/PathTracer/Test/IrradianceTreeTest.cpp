@@ -0,0 +1,97 @@
+#include <Crisp/PathTracer/BSSRDFs/IrradianceTree.hpp>
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <random>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+std::vector<IrradiancePoint> createPoints(const size_t count) {
+    std::mt19937 engine(5);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<IrradiancePoint> points;
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec3 p(distribution(engine), distribution(engine) * 0.5f, distribution(engine) * 2.0f);
+        const Spectrum e(distribution(engine), distribution(engine), distribution(engine));
+        points.emplace_back(SurfacePoint(p, glm::vec3(0.0f, 1.0f, 0.0f), 1e-3f), e);
+    }
+    return points;
+}
+
+Spectrum falloff(const float sqrDist) {
+    return Spectrum(1.0f / (1.0f + 100.0f * sqrDist));
+}
+
+TEST(IrradianceTreeTest, NodesAreBreadthFirstAndCoverAllPoints) {
+    const IrradianceTree tree(createPoints(5000));
+    const auto nodes = tree.getNodes();
+    ASSERT_FALSE(nodes.empty());
+
+    std::vector<int> visits(tree.getPoints().size(), 0);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const auto& node = nodes[i];
+        if (node.isLeaf()) {
+            EXPECT_LE(node.pointCount, IrradianceTree::kMaxLeafPoints);
+            for (uint32_t j = node.offset; j < node.offset + node.pointCount; ++j) {
+                EXPECT_TRUE(node.bounds.contains(tree.getPoints()[j].p));
+                ++visits[j];
+            }
+        } else {
+            EXPECT_GT(node.offset, i);
+            const auto childCount = static_cast<uint32_t>(std::popcount(node.childMask));
+            for (uint32_t j = node.offset; j < node.offset + childCount; ++j) {
+                EXPECT_TRUE(node.bounds.contains(nodes[j].bounds));
+            }
+        }
+    }
+    for (const int count : visits) {
+        EXPECT_EQ(count, 1);
+    }
+
+    EXPECT_NEAR(nodes[0].sumArea, 5.0f, 1e-3f);
+}
+
+TEST(IrradianceTreeTest, ExactQueryMatchesBruteForce) {
+    const std::vector<IrradiancePoint> points = createPoints(3000);
+    const IrradianceTree tree(points);
+
+    for (const glm::vec3 query : {glm::vec3(0.5f, 0.25f, 1.0f), glm::vec3(-1.0f, 0.0f, 3.0f)}) {
+        Spectrum expected(0.0f);
+        for (const auto& point : points) {
+            const glm::vec3 diff = point.p - query;
+            expected += falloff(glm::dot(diff, diff)) * point.e * point.area;
+        }
+
+        const glm::vec3 expectedRgb = expected.toRgb();
+        const glm::vec3 exact = tree.Mo(query, falloff, 0.0f).toRgb();
+        EXPECT_NEAR(exact.r, expectedRgb.r, 1e-4f * expectedRgb.r);
+        EXPECT_NEAR(exact.g, expectedRgb.g, 1e-4f * expectedRgb.g);
+        EXPECT_NEAR(exact.b, expectedRgb.b, 1e-4f * expectedRgb.b);
+
+        // Aggregating distant subtrees only perturbs the result slightly.
+        const glm::vec3 approximate = tree.Mo(query, falloff, 0.05f).toRgb();
+        EXPECT_NEAR(approximate.r, expectedRgb.r, 0.05f * expectedRgb.r);
+    }
+}
+
+TEST(IrradianceTreeTest, CoincidentPointsStopAtMaxDepth) {
+    std::vector<IrradiancePoint> points = createPoints(16);
+    for (auto& point : points) {
+        point.p = glm::vec3(0.25f);
+    }
+    points.front().p = glm::vec3(1.0f);
+
+    const IrradianceTree tree(points);
+    const glm::vec3 exact = tree.Mo(glm::vec3(0.0f), falloff, 0.0f).toRgb();
+    EXPECT_GT(exact.r, 0.0f);
+    EXPECT_LT(tree.getNodes().size(), 8 * IrradianceTree::kMaxDepth);
+}
+
+TEST(IrradianceTreeTest, EmptyTreeIntegratesToZero) {
+    const IrradianceTree tree(std::vector<IrradiancePoint>{});
+    EXPECT_TRUE(tree.Mo(glm::vec3(0.0f), falloff, 0.1f).isZero());
+}
+} // namespace
+} // namespace crisp::test
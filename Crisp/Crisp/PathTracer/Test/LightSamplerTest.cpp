@@ -0,0 +1,123 @@
+#include <Crisp/PathTracer/LightSamplers/LightSamplerFactory.hpp>
+#include <Crisp/PathTracer/Lights/PointLight.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+std::vector<std::unique_ptr<Light>> createPointLights(const int count) {
+    std::vector<std::unique_ptr<Light>> lights;
+    for (int i = 0; i < count; ++i) {
+        VariantMap parameters;
+        parameters.insert("position", glm::vec3(static_cast<float>(i % 7) * 3.0f, 1.0f, static_cast<float>(i / 7)));
+        parameters.insert("power", Spectrum(1.0f + static_cast<float>((i * 37) % 11)));
+        lights.push_back(std::make_unique<PointLight>(parameters));
+    }
+    return lights;
+}
+
+std::vector<Light*> getPointers(const std::vector<std::unique_ptr<Light>>& lights) {
+    std::vector<Light*> pointers;
+    for (const auto& light : lights) {
+        pointers.push_back(light.get());
+    }
+    return pointers;
+}
+
+class LightSamplerTest : public ::testing::TestWithParam<std::string> {};
+
+TEST_P(LightSamplerTest, SampledPmfMatchesEvaluatedPmf) {
+    const auto lights = createPointLights(23);
+    const std::vector<Light*> pointers = getPointers(lights);
+    const auto sampler = LightSamplerFactory::create(GetParam(), VariantMap());
+    sampler->build(pointers);
+
+    const glm::vec3 p(4.0f, 0.0f, 1.5f);
+    const glm::vec3 n(0.0f, 1.0f, 0.0f);
+    for (int i = 0; i < 256; ++i) {
+        float pmf = 0.0f;
+        const Light* light = sampler->sample(p, n, (static_cast<float>(i) + 0.5f) / 256.0f, pmf);
+        ASSERT_NE(light, nullptr);
+        EXPECT_GT(pmf, 0.0f);
+        EXPECT_NEAR(sampler->pmf(p, n, light), pmf, 1e-5f);
+    }
+}
+
+TEST_P(LightSamplerTest, PmfSumsToOneOverAllLights) {
+    const auto lights = createPointLights(23);
+    const std::vector<Light*> pointers = getPointers(lights);
+    const auto sampler = LightSamplerFactory::create(GetParam(), VariantMap());
+    sampler->build(pointers);
+
+    for (const glm::vec3 p : {glm::vec3(0.0f), glm::vec3(10.0f, 2.0f, -3.0f), glm::vec3(4.0f, 0.5f, 2.0f)}) {
+        for (const glm::vec3 n : {glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)}) {
+            float sum = 0.0f;
+            for (const Light* light : pointers) {
+                sum += sampler->pmf(p, n, light);
+            }
+            EXPECT_NEAR(sum, 1.0f, 1e-4f);
+        }
+    }
+}
+
+TEST_P(LightSamplerTest, SampleFrequenciesMatchPmf) {
+    const auto lights = createPointLights(9);
+    const std::vector<Light*> pointers = getPointers(lights);
+    const auto sampler = LightSamplerFactory::create(GetParam(), VariantMap());
+    sampler->build(pointers);
+
+    const glm::vec3 p(2.0f, 0.5f, 0.0f);
+    const glm::vec3 n(0.0f, 1.0f, 0.0f);
+    constexpr int kSampleCount = 1 << 16;
+    std::vector<int> counts(pointers.size(), 0);
+    for (int i = 0; i < kSampleCount; ++i) {
+        float pmf = 0.0f;
+        const Light* light = sampler->sample(p, n, (static_cast<float>(i) + 0.5f) / kSampleCount, pmf);
+        ++counts[std::find(pointers.begin(), pointers.end(), light) - pointers.begin()];
+    }
+
+    for (size_t i = 0; i < pointers.size(); ++i) {
+        EXPECT_NEAR(static_cast<float>(counts[i]) / kSampleCount, sampler->pmf(p, n, pointers[i]), 1e-3f);
+    }
+}
+
+TEST(PowerLightSamplerTest, PicksLightsInProportionToPower) {
+    const auto lights = createPointLights(5);
+    const std::vector<Light*> pointers = getPointers(lights);
+    const auto sampler = LightSamplerFactory::create("power", VariantMap());
+    sampler->build(pointers);
+
+    float totalPower = 0.0f;
+    for (const Light* light : pointers) {
+        totalPower += light->getPower().getLuminance();
+    }
+    for (const Light* light : pointers) {
+        EXPECT_NEAR(sampler->pmf(glm::vec3(0.0f), glm::vec3(0.0f), light),
+                    light->getPower().getLuminance() / totalPower,
+                    1e-6f);
+    }
+}
+
+TEST(BvhLightSamplerTest, PrefersNearbyLights) {
+    VariantMap nearParameters;
+    nearParameters.insert("position", glm::vec3(0.0f, 1.0f, 0.0f));
+    nearParameters.insert("power", Spectrum(1.0f));
+    VariantMap farParameters;
+    farParameters.insert("position", glm::vec3(100.0f, 1.0f, 0.0f));
+    farParameters.insert("power", Spectrum(1.0f));
+    PointLight nearLight(nearParameters);
+    PointLight farLight(farParameters);
+    const std::vector<Light*> pointers = {&nearLight, &farLight};
+
+    const auto sampler = LightSamplerFactory::create("bvh", VariantMap());
+    sampler->build(pointers);
+    EXPECT_GT(sampler->pmf(glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), &nearLight), 0.99f);
+}
+
+INSTANTIATE_TEST_SUITE_P(LightSamplers, LightSamplerTest, ::testing::Values("uniform", "power", "bvh"));
+} // namespace
+} // namespace crisp::test
@@ -0,0 +1,114 @@
+#include <Crisp/PathTracer/Shapes/MeshCache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+namespace crisp::test {
+namespace {
+const std::filesystem::path& getCacheDirectory() {
+    static const std::filesystem::path directory = std::filesystem::path(::testing::TempDir()) / "crisp-mesh-cache";
+    return directory;
+}
+
+std::filesystem::path writeQuad(const std::string& name, const float z) {
+    const auto path = std::filesystem::path(::testing::TempDir()) / (name + ".obj");
+    std::ofstream file(path);
+    file << "o " << name << "\n";
+    file << "v 0 0 " << z << "\nv 1 0 " << z << "\nv 1 1 " << z << "\nv 0 1 " << z << "\n";
+    file << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n";
+    file << "vn 0 0 1\nvn 0 0 1\nvn 0 0 1\nvn 0 0 1\n";
+    file << "f 1/1/1 2/2/2 3/3/3\nf 1/1/1 3/3/3 4/4/4\n";
+    return path;
+}
+
+void expectSameMesh(const TriangleMesh& cached, const TriangleMesh& loaded) {
+    EXPECT_EQ(cached.getPositions(), loaded.getPositions());
+    EXPECT_EQ(cached.getNormals(), loaded.getNormals());
+    EXPECT_EQ(cached.getTexCoords(), loaded.getTexCoords());
+    EXPECT_EQ(cached.getTangents(), loaded.getTangents());
+    EXPECT_EQ(cached.getTriangles(), loaded.getTriangles());
+    EXPECT_EQ(cached.getMeshName(), loaded.getMeshName());
+    ASSERT_EQ(cached.getViews().size(), loaded.getViews().size());
+    for (size_t i = 0; i < cached.getViews().size(); ++i) {
+        EXPECT_EQ(cached.getViews()[i].tag, loaded.getViews()[i].tag);
+        EXPECT_EQ(cached.getViews()[i].firstIndex, loaded.getViews()[i].firstIndex);
+        EXPECT_EQ(cached.getViews()[i].indexCount, loaded.getViews()[i].indexCount);
+    }
+    EXPECT_EQ(cached.getBoundingBox().min, loaded.getBoundingBox().min);
+    EXPECT_EQ(cached.getBoundingBox().max, loaded.getBoundingBox().max);
+}
+
+TEST(MeshCacheTest, CachedMeshMatchesLoadedMesh) {
+    const auto path = writeQuad("cached-quad", 0.0f);
+    const auto loaded = loadTriangleMesh(path);
+    ASSERT_TRUE(loaded);
+
+    const auto first = loadCachedTriangleMesh(path, getCacheDirectory());
+    ASSERT_TRUE(first);
+    const auto cachePath = getMeshCachePath(path, getCacheDirectory());
+    ASSERT_TRUE(std::filesystem::exists(cachePath));
+    expectSameMesh(*first, *loaded);
+
+    const auto second = loadCachedTriangleMesh(path, getCacheDirectory());
+    ASSERT_TRUE(second);
+    expectSameMesh(*second, *loaded);
+}
+
+TEST(MeshCacheTest, KeyChangesWithOptionsAndSource) {
+    const auto path = writeQuad("edited-quad", 0.0f);
+    const auto cachePath = getMeshCachePath(path, getCacheDirectory());
+    EXPECT_NE(getMeshCachePath(path, getCacheDirectory(), {.computeTangents = false}), cachePath);
+
+    // The source changes size, and with it the key, so the edited mesh is loaded rather than the cached one.
+    ASSERT_TRUE(loadCachedTriangleMesh(path, getCacheDirectory()));
+    writeQuad("edited-quad", 0.25f);
+    EXPECT_NE(getMeshCachePath(path, getCacheDirectory()), cachePath);
+    const auto edited = loadCachedTriangleMesh(path, getCacheDirectory());
+    ASSERT_TRUE(edited);
+    EXPECT_EQ((*edited).getPositions().front().z, 0.25f);
+}
+
+TEST(MeshCacheTest, InvalidCacheFileIsRebuilt) {
+    const auto path = writeQuad("corrupt-quad", 0.0f);
+    const auto cachePath = getMeshCachePath(path, getCacheDirectory());
+    std::filesystem::create_directories(getCacheDirectory());
+    std::ofstream(cachePath, std::ios::binary | std::ios::trunc) << "not a mesh";
+
+    const auto mesh = loadCachedTriangleMesh(path, getCacheDirectory());
+    ASSERT_TRUE(mesh);
+    EXPECT_EQ((*mesh).getTriangleCount(), 2);
+    EXPECT_GT(std::filesystem::file_size(cachePath), 64);
+}
+
+TEST(MeshCacheTest, OutOfBoundsTriangleIsRebuilt) {
+    const auto path = writeQuad("out-of-bounds-quad", 0.0f);
+    const auto loaded = loadTriangleMesh(path);
+    ASSERT_TRUE(loaded);
+    ASSERT_TRUE(loadCachedTriangleMesh(path, getCacheDirectory()));
+
+    // The file keeps its size and header, but its first triangle indexes past the four vertices.
+    const auto cachePath = getMeshCachePath(path, getCacheDirectory());
+    std::string contents;
+    {
+        std::ifstream file(cachePath, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const glm::uvec3 triangle = (*loaded).getTriangles().front();
+    const std::string_view triangleBytes(reinterpret_cast<const char*>(&triangle), sizeof(triangle));
+    const size_t triangleOffset = contents.find(triangleBytes);
+    ASSERT_NE(triangleOffset, std::string::npos);
+    const glm::uvec3 corruptTriangle(triangle.x, triangle.y, 100);
+    contents.replace(
+        triangleOffset, sizeof(corruptTriangle), reinterpret_cast<const char*>(&corruptTriangle), sizeof(triangle));
+    std::ofstream(cachePath, std::ios::binary | std::ios::trunc) << contents;
+
+    const auto mesh = loadCachedTriangleMesh(path, getCacheDirectory());
+    ASSERT_TRUE(mesh);
+    EXPECT_EQ((*mesh).getTriangles(), (*loaded).getTriangles());
+}
+} // namespace
+} // namespace crisp::test
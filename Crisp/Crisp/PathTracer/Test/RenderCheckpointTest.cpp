@@ -0,0 +1,127 @@
+#include <Crisp/PathTracer/RenderCheckpoint.hpp>
+#include <Crisp/PathTracer/ReconstructionFilters/GaussianFilter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace crisp::test {
+namespace {
+constexpr glm::ivec2 kSize(12, 7);
+
+std::filesystem::path getCheckpointPath(const std::string& name) {
+    return std::filesystem::path(::testing::TempDir()) / (name + ".ckpt");
+}
+
+ImageBlock createImage(const ReconstructionFilter& filter, const float scale) {
+    ImageBlock image(kSize, &filter);
+    image.clear();
+    for (int32_t y = 0; y < kSize.y; ++y) {
+        for (int32_t x = 0; x < kSize.x; ++x) {
+            const glm::vec2 position(static_cast<float>(x) + 0.3f, static_cast<float>(y) + 0.6f);
+            image.addSample(position, Spectrum(scale * static_cast<float>(x), 0.5f, scale * static_cast<float>(y)));
+            image.addSample(position + glm::vec2(0.2f), Spectrum(1.0f));
+            image.addFeatures(position, Spectrum(0.25f), glm::vec3(0.0f, 1.0f, 0.0f), static_cast<float>(x + y));
+        }
+    }
+    return image;
+}
+
+TEST(RenderCheckpointTest, ProgressiveCheckpointRoundTrips) {
+    const GaussianFilter filter;
+    const ImageBlock image = createImage(filter, 1.0f);
+    const ImageBlock evenPasses = createImage(filter, 0.5f);
+    const RenderCheckpoint checkpoint{
+        .mode = RenderCheckpoint::Mode::Progressive,
+        .sceneHash = 0x1234'5678'9abc'def0,
+        .sampleCount = 64,
+        .passesRendered = 3,
+        .samplesRendered = 12,
+        .passSampleCount = 4,
+        .renderTime = 81.5,
+        .finishedBlocks = {1, 0, 1},
+    };
+    const auto path = getCheckpointPath("progressive");
+    ASSERT_TRUE(writeRenderCheckpoint(path, checkpoint, image, &evenPasses).isValid());
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(path).concat(".tmp")));
+
+    ImageBlock restoredImage(kSize, &filter);
+    ImageBlock restoredEvenPasses(kSize, &filter);
+    const auto restored = readRenderCheckpoint(path, restoredImage, &restoredEvenPasses);
+    ASSERT_TRUE(restored);
+    EXPECT_EQ(restored->mode, checkpoint.mode);
+    EXPECT_EQ(restored->sceneHash, checkpoint.sceneHash);
+    EXPECT_EQ(restored->sampleCount, checkpoint.sampleCount);
+    EXPECT_EQ(restored->passesRendered, checkpoint.passesRendered);
+    EXPECT_EQ(restored->samplesRendered, checkpoint.samplesRendered);
+    EXPECT_EQ(restored->passSampleCount, checkpoint.passSampleCount);
+    EXPECT_EQ(restored->renderTime, checkpoint.renderTime);
+    EXPECT_EQ(restored->finishedBlocks, checkpoint.finishedBlocks);
+
+    EXPECT_EQ(restoredImage.getRaw(), image.getRaw());
+    EXPECT_EQ(restoredImage.getSampleCountRaw(), image.getSampleCountRaw());
+    EXPECT_EQ(restoredImage.getVarianceRaw(), image.getVarianceRaw());
+    EXPECT_EQ(restoredEvenPasses.getRaw(), evenPasses.getRaw());
+}
+
+TEST(RenderCheckpointTest, RestoredImageKeepsAccumulating) {
+    // Merging the samples of a resumed render into the restored image gives the image of an uninterrupted render.
+    const GaussianFilter filter;
+    ImageBlock uninterrupted = createImage(filter, 1.0f);
+    uninterrupted.put(createImage(filter, 2.0f));
+
+    const auto path = getCheckpointPath("blocks");
+    const RenderCheckpoint checkpoint{.finishedBlocks = {1}};
+    ASSERT_TRUE(writeRenderCheckpoint(path, checkpoint, createImage(filter, 1.0f), nullptr).isValid());
+    ImageBlock resumed(kSize, &filter);
+    ASSERT_TRUE(readRenderCheckpoint(path, resumed, nullptr));
+    resumed.put(createImage(filter, 2.0f));
+
+    EXPECT_EQ(resumed.getRaw(), uninterrupted.getRaw());
+    EXPECT_EQ(resumed.getSampleCountRaw(), uninterrupted.getSampleCountRaw());
+    const auto writeDepth = [](const ImageBlock& block) {
+        std::vector<float> albedo(static_cast<size_t>(kSize.x) * kSize.y * 4);
+        std::vector<float> normal(albedo.size());
+        std::vector<float> depth(albedo.size());
+        block.writeFeatures(ImageBlock::Descriptor(0, 0, kSize.x, kSize.y), albedo, normal, depth, {}, kSize.x);
+        return depth;
+    };
+    EXPECT_EQ(writeDepth(resumed), writeDepth(uninterrupted));
+}
+
+TEST(RenderCheckpointTest, CheckpointOfDifferentImageSizeIsRejected) {
+    const GaussianFilter filter;
+    const auto path = getCheckpointPath("size");
+    ASSERT_TRUE(writeRenderCheckpoint(path, RenderCheckpoint{}, createImage(filter, 1.0f), nullptr).isValid());
+
+    ImageBlock image(kSize + glm::ivec2(1, 0), &filter);
+    image.clear();
+    EXPECT_FALSE(readRenderCheckpoint(path, image, nullptr));
+    EXPECT_EQ(image.getTotalSampleCount(), 0u);
+}
+
+TEST(RenderCheckpointTest, ModeMustMatchTheEvenPassImage) {
+    const GaussianFilter filter;
+    const ImageBlock image = createImage(filter, 1.0f);
+    const auto path = getCheckpointPath("mode");
+    EXPECT_FALSE(writeRenderCheckpoint(path, RenderCheckpoint{}, image, &image).isValid());
+
+    ASSERT_TRUE(writeRenderCheckpoint(path, RenderCheckpoint{}, image, nullptr).isValid());
+    ImageBlock restored(kSize, &filter);
+    ImageBlock evenPasses(kSize, &filter);
+    EXPECT_FALSE(readRenderCheckpoint(path, restored, &evenPasses));
+}
+
+TEST(RenderCheckpointTest, TruncatedCheckpointIsRejected) {
+    const GaussianFilter filter;
+    const auto path = getCheckpointPath("truncated");
+    ASSERT_TRUE(writeRenderCheckpoint(path, RenderCheckpoint{}, createImage(filter, 1.0f), nullptr).isValid());
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 16);
+
+    ImageBlock image(kSize, &filter);
+    EXPECT_FALSE(readRenderCheckpoint(path, image, nullptr));
+    EXPECT_FALSE(readRenderCheckpoint(getCheckpointPath("missing"), image, nullptr));
+}
+} // namespace
+} // namespace crisp::test
@@ -0,0 +1,69 @@
+#include <Crisp/PathTracer/Core/RenderCounters.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+TEST(RenderCountersTest, SumsCountersOfAllThreads) {
+    const RenderCounters before = RenderCounters::collect();
+
+    constexpr int kThreadCount = 4;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadCount; ++i) {
+        threads.emplace_back([] {
+            RenderCounters::addPrimaryRays(10);
+            RenderCounters::addIntersectionRays(25);
+            RenderCounters::addShadowRays(7);
+            RenderCounters::addInvalidSample();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Counters of threads that have exited are kept.
+    const RenderCounters counters = RenderCounters::collect() - before;
+    EXPECT_EQ(counters.primaryRays, 40);
+    EXPECT_EQ(counters.extensionRays, 60);
+    EXPECT_EQ(counters.shadowRays, 28);
+    EXPECT_EQ(counters.getRayCount(), 128);
+    EXPECT_EQ(counters.invalidSamples, 4);
+}
+
+TEST(RenderCountersTest, RecordsPathLengthsAndLobes) {
+    const RenderCounters before = RenderCounters::collect();
+    RenderCounters::addPath(0, false);
+    RenderCounters::addPath(3, true);
+    RenderCounters::addPath(100, true);
+    RenderCounters::addBsdfSample(2); // Diffuse
+    RenderCounters::addBsdfSample(8); // Delta
+    RenderCounters::addBsdfSample(8);
+
+    const RenderCounters counters = RenderCounters::collect() - before;
+    EXPECT_EQ(counters.getPathCount(), 3);
+    EXPECT_EQ(counters.pathLengths[0], 1);
+    EXPECT_EQ(counters.pathLengths[3], 1);
+    EXPECT_EQ(counters.pathLengths.back(), 1);
+    EXPECT_EQ(counters.russianRouletteTerminations, 2);
+    EXPECT_DOUBLE_EQ(counters.getMeanPathLength(), (0.0 + 3.0 + 16.0) / 3.0);
+    EXPECT_EQ(counters.bsdfSamples, (std::array<uint64_t, RenderCounters::kLobeCount>{0, 1, 0, 2}));
+}
+
+TEST(RenderCountersTest, TimesStages) {
+    const RenderCounters before = RenderCounters::collect();
+    {
+        const ScopedRenderStage stage(RenderStage::Shading);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    RenderCounters::addStageTime(RenderStage::ShadowRays, std::chrono::milliseconds(250));
+
+    const RenderCounters counters = RenderCounters::collect() - before;
+    EXPECT_GE(counters.stageSeconds[static_cast<size_t>(RenderStage::Shading)], 0.005);
+    EXPECT_NEAR(counters.stageSeconds[static_cast<size_t>(RenderStage::ShadowRays)], 0.25, 1e-9);
+    EXPECT_EQ(counters.stageSeconds[static_cast<size_t>(RenderStage::MisRays)], 0.0);
+}
+} // namespace
+} // namespace crisp::test
@@ -0,0 +1,133 @@
+#include <Crisp/PathTracer/Integrators/SDTree.hpp>
+
+#include <Crisp/Math/Constants.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+glm::vec3 sampleUniformSphere(std::mt19937& engine) {
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    return DTree::toDirection(glm::vec2(distribution(engine), distribution(engine)));
+}
+
+// Radiance from a bright cone around +z over a dim background, recorded over a few refinements.
+DTree trainTree() {
+    std::mt19937 engine(3);
+    DTree tree;
+    DTree sampling;
+    for (int iteration = 0; iteration < 4; ++iteration) {
+        for (int i = 0; i < 20000; ++i) {
+            const glm::vec3 direction = sampleUniformSphere(engine);
+            tree.record(direction, direction.z > 0.9f ? 100.0f : 1.0f);
+        }
+        sampling = tree;
+        tree.refine(0.01f);
+    }
+    return sampling;
+}
+
+TEST(SDTreeTest, CanonicalMappingRoundTrips) {
+    std::mt19937 engine(1);
+    for (int i = 0; i < 1000; ++i) {
+        const glm::vec3 direction = sampleUniformSphere(engine);
+        const glm::vec3 mapped = DTree::toDirection(DTree::toCanonical(direction));
+        EXPECT_NEAR(glm::dot(direction, mapped), 1.0f, 1e-4f);
+    }
+}
+
+TEST(SDTreeTest, EmptyTreeIsUniform) {
+    const DTree tree;
+    std::mt19937 engine(2);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_FLOAT_EQ(tree.pdf(sampleUniformSphere(engine)), InvFourPI<>);
+    }
+}
+
+TEST(SDTreeTest, PdfIntegratesToOneAndFollowsRadiance) {
+    const DTree tree = trainTree();
+    EXPECT_GT(tree.getNodeCount(), 1u);
+
+    std::mt19937 engine(4);
+    double integral = 0.0;
+    constexpr int kSampleCount = 200000;
+    for (int i = 0; i < kSampleCount; ++i) {
+        integral += tree.pdf(sampleUniformSphere(engine));
+    }
+    EXPECT_NEAR(integral * 4.0 * PI<double> / kSampleCount, 1.0, 0.02);
+    EXPECT_GT(tree.pdf(glm::vec3(0.0f, 0.0f, 1.0f)), 10.0f * tree.pdf(glm::vec3(0.0f, 0.0f, -1.0f)));
+}
+
+TEST(SDTreeTest, SamplesAreDistributedByPdf) {
+    const DTree tree = trainTree();
+
+    // Compares the fraction of samples in each latitude band to the band's probability, found by integrating the pdf.
+    constexpr int kBandCount = 8;
+    constexpr int kSampleCount = 100000;
+    std::vector<double> expected(kBandCount, 0.0);
+    std::vector<double> observed(kBandCount, 0.0);
+    std::mt19937 engine(5);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    for (int i = 0; i < kSampleCount; ++i) {
+        const glm::vec3 uniform = sampleUniformSphere(engine);
+        const auto uniformBand = std::min(static_cast<int>(0.5f * (uniform.z + 1.0f) * kBandCount), kBandCount - 1);
+        expected[uniformBand] += tree.pdf(uniform) * 4.0 * PI<double> / kSampleCount;
+
+        const glm::vec3 sampled = tree.sample(glm::vec2(distribution(engine), distribution(engine)));
+        EXPECT_NEAR(glm::length(sampled), 1.0f, 1e-4f);
+        const auto sampledBand = std::min(static_cast<int>(0.5f * (sampled.z + 1.0f) * kBandCount), kBandCount - 1);
+        observed[sampledBand] += 1.0 / kSampleCount;
+    }
+
+    for (int band = 0; band < kBandCount; ++band) {
+        EXPECT_NEAR(observed[band], expected[band], 0.01 + 0.05 * expected[band]);
+    }
+}
+
+TEST(SDTreeTest, ConcurrentRecordingLosesNoRadiance) {
+    // A subdivided tree, so that every record updates several levels.
+    DTree tree = trainTree();
+    tree.refine(0.01f);
+    constexpr int kThreadCount = 8;
+    constexpr int kRecordCount = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+        threads.emplace_back([&tree, t] {
+            std::mt19937 engine(t);
+            for (int i = 0; i < kRecordCount; ++i) {
+                tree.record(sampleUniformSphere(engine), 1.0f);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(tree.getSampleCount(), static_cast<uint64_t>(kThreadCount * kRecordCount));
+    EXPECT_FLOAT_EQ(tree.getRadianceSum(), static_cast<float>(kThreadCount * kRecordCount));
+}
+
+TEST(SDTreeTest, SpatialRefinementSplitsBusyLeaves) {
+    SDTree tree(BoundingBox3(glm::vec3(0.0f), glm::vec3(1.0f)));
+    const glm::vec3 left(0.1f, 0.5f, 0.5f);
+    const glm::vec3 right(0.9f, 0.5f, 0.5f);
+    EXPECT_EQ(&tree.getLeaf(left), &tree.getLeaf(right));
+
+    for (int i = 0; i < 1000; ++i) {
+        tree.getLeaf(left).building.record(glm::vec3(0.0f, 0.0f, 1.0f), 1.0f);
+    }
+    tree.refine(300, 0.01f);
+
+    // A thousand samples need two splits to fall below the threshold, the first of which separates the points.
+    EXPECT_EQ(tree.getLeafCount(), 4u);
+    EXPECT_NE(&tree.getLeaf(left), &tree.getLeaf(right));
+    EXPECT_FLOAT_EQ(tree.getLeaf(right).sampling.getRadianceSum(), 1000.0f);
+    EXPECT_EQ(tree.getLeaf(right).building.getSampleCount(), 0u);
+    EXPECT_GT(tree.getLeaf(left).sampling.pdf(glm::vec3(0.0f, 0.0f, 1.0f)), InvFourPI<>);
+}
+} // namespace
+} // namespace crisp::test
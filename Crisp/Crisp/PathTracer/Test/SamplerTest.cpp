@@ -0,0 +1,96 @@
+#include <Crisp/PathTracer/Samplers/Halton.hpp>
+#include <Crisp/PathTracer/Samplers/Independent.hpp>
+#include <Crisp/PathTracer/Samplers/SamplerFactory.hpp>
+#include <Crisp/PathTracer/Samplers/Sobol.hpp>
+#include <Crisp/PathTracer/Samplers/Stratified.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+
+namespace crisp::test {
+namespace {
+VariantMap createParameters(const int samplesPerPixel) {
+    VariantMap parameters;
+    parameters.insert("samplesPerPixel", samplesPerPixel);
+    return parameters;
+}
+
+class DeterministicSamplerTest : public ::testing::TestWithParam<std::string> {};
+
+TEST_P(DeterministicSamplerTest, ValuesDependOnlyOnSampleState) {
+    const auto sampler = SamplerFactory::create(GetParam(), createParameters(16));
+    const auto other = sampler->clone();
+
+    sampler->startPixelSample(glm::ivec2(7, 3), 5);
+    const float first = sampler->next1D();
+    const glm::vec2 second = sampler->next2D();
+    const SampleState afterThreeDimensions = sampler->getSampleState();
+    const float fourth = sampler->next1D();
+
+    // Draw unrelated values first, then jump straight to the same coordinates.
+    other->startPixelSample(glm::ivec2(1, 1), 2);
+    other->next2D();
+    other->startPixelSample(glm::ivec2(7, 3), 5);
+    EXPECT_EQ(other->next1D(), first);
+    EXPECT_EQ(other->next2D(), second);
+    other->setSampleState(afterThreeDimensions);
+    EXPECT_EQ(other->next1D(), fourth);
+}
+
+TEST_P(DeterministicSamplerTest, FirstDimensionIsStratifiedOverSampleCount) {
+    constexpr uint32_t kSampleCount = 64;
+    const auto sampler = SamplerFactory::create(GetParam(), createParameters(kSampleCount));
+
+    std::vector<uint32_t> strata;
+    for (uint32_t i = 0; i < kSampleCount; ++i) {
+        sampler->startPixelSample(glm::ivec2(12, 34), i);
+        const float value = sampler->next1D();
+        ASSERT_GE(value, 0.0f);
+        ASSERT_LT(value, 1.0f);
+        strata.push_back(static_cast<uint32_t>(value * kSampleCount));
+    }
+
+    std::ranges::sort(strata);
+    for (uint32_t i = 0; i < kSampleCount; ++i) {
+        EXPECT_EQ(strata[i], i);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SamplerTypes, DeterministicSamplerTest, ::testing::Values("sobol", "halton", "stratified"), [](const auto& info) {
+        return info.param;
+    });
+
+TEST(SamplerTest, IndependentFillMatchesSequentialDraws) {
+    IndependentSampler sampler(createParameters(16));
+    sampler.startPixelSample(glm::ivec2(5, 8), 3);
+    std::array<float, 6> filled{};
+    sampler.fill(filled);
+    EXPECT_EQ(sampler.getSampleState().dimension, filled.size());
+
+    sampler.startPixelSample(glm::ivec2(5, 8), 3);
+    for (const float value : filled) {
+        EXPECT_EQ(sampler.next1D(), value);
+    }
+
+    // Restoring a state in the middle of a sample continues the same stream.
+    sampler.setSampleState(SampleState{glm::ivec2(5, 8), 3, 4});
+    EXPECT_EQ(sampler.next1D(), filled[4]);
+    EXPECT_EQ(sampler.next1D(), filled[5]);
+}
+
+TEST(SamplerTest, HaltonValuesStayInUnitInterval) {
+    HaltonSampler sampler(createParameters(16));
+    for (uint32_t i = 0; i < 256; ++i) {
+        sampler.startPixelSample(glm::ivec2(3, 9), i);
+        for (uint32_t dimension = 0; dimension < 40; ++dimension) {
+            const float value = sampler.next1D();
+            ASSERT_GE(value, 0.0f);
+            ASSERT_LT(value, 1.0f);
+        }
+    }
+}
+} // namespace
+} // namespace crisp::test
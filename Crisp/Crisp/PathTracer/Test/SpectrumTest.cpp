@@ -0,0 +1,102 @@
+#include <Crisp/PathTracer/Spectra/RgbSpectrum.hpp>
+#include <Crisp/PathTracer/Spectra/SampledSpectrum.hpp>
+#include <Crisp/PathTracer/Spectra/SimdRgbSpectrum.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+
+namespace crisp::test {
+namespace {
+void expectEqual(const SimdRgbSpectrum& actual, const RgbSpectrum& expected) {
+    EXPECT_FLOAT_EQ(actual.r, expected.r);
+    EXPECT_FLOAT_EQ(actual.g, expected.g);
+    EXPECT_FLOAT_EQ(actual.b, expected.b);
+    EXPECT_EQ(actual.a, 0.0f);
+}
+
+// Averages the RGB of the uplifted color over many samples, each with its own wavelengths.
+glm::vec3 averageRoundTrip(const glm::vec3& rgb) {
+    constexpr uint32_t kSampleCount = 4096;
+    glm::vec3 sum(0.0f);
+    for (uint32_t s = 0; s < kSampleCount; ++s) {
+        SampledSpectrum::beginSample(glm::ivec2(3, 7), s);
+        sum += (SampledSpectrum(1.0f) * SampledSpectrum(rgb)).toRgb();
+    }
+    SampledSpectrum::endSample();
+    return sum / static_cast<float>(kSampleCount);
+}
+
+TEST(SpectrumTest, SimdRgbMatchesRgb) {
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<float> distribution(0.1f, 2.0f);
+    for (int i = 0; i < 100; ++i) {
+        const glm::vec3 x(distribution(engine), distribution(engine), distribution(engine));
+        const glm::vec3 y(distribution(engine), distribution(engine), distribution(engine));
+        const float s = distribution(engine);
+
+        expectEqual(SimdRgbSpectrum(x) + SimdRgbSpectrum(y), RgbSpectrum(x) + RgbSpectrum(y));
+        expectEqual(SimdRgbSpectrum(x) - SimdRgbSpectrum(y), RgbSpectrum(x) - RgbSpectrum(y));
+        expectEqual(SimdRgbSpectrum(x) * SimdRgbSpectrum(y), RgbSpectrum(x) * RgbSpectrum(y));
+        expectEqual(SimdRgbSpectrum(x) / SimdRgbSpectrum(y), RgbSpectrum(x) / RgbSpectrum(y));
+        expectEqual(SimdRgbSpectrum(x) + s, RgbSpectrum(x) + s);
+        expectEqual(SimdRgbSpectrum(x) / s, RgbSpectrum(x) / s);
+        expectEqual(s * SimdRgbSpectrum(x), s * RgbSpectrum(x));
+        expectEqual(SimdRgbSpectrum(x).sqrt(), RgbSpectrum(x).sqrt());
+        EXPECT_FLOAT_EQ(SimdRgbSpectrum(x).maxCoeff(), RgbSpectrum(x).maxCoeff());
+        EXPECT_FLOAT_EQ(SimdRgbSpectrum(x).getLuminance(), RgbSpectrum(x).getLuminance());
+    }
+
+    EXPECT_TRUE(SimdRgbSpectrum(0.0f).isZero());
+    EXPECT_FALSE(SimdRgbSpectrum(0.0f, 0.0f, 1.0f).isZero());
+    EXPECT_FALSE(SimdRgbSpectrum(-1.0f).isValid());
+    EXPECT_FLOAT_EQ(SimdRgbSpectrum(-1.0f, -3.0f, -2.0f).maxCoeff(), -1.0f);
+}
+
+TEST(SpectrumTest, SampledStaysRgbOutsideOfSamples) {
+    SampledSpectrum::endSample();
+    const SampledSpectrum value = SampledSpectrum(0.2f, 0.4f, 0.6f) * SampledSpectrum(0.5f) + 1.0f;
+    EXPECT_FALSE(value.isSampled());
+    EXPECT_FLOAT_EQ(value.toRgb().r, 1.1f);
+    EXPECT_FLOAT_EQ(value.toRgb().g, 1.2f);
+    EXPECT_FLOAT_EQ(value.toRgb().b, 1.3f);
+}
+
+TEST(SpectrumTest, SampledWavelengthsAreStratifiedAndRepeatable) {
+    SampledSpectrum::beginSample(glm::ivec2(4, 2), 9);
+    const SampledWavelengths first = SampledSpectrum::getWavelengths();
+    SampledSpectrum::beginSample(glm::ivec2(4, 3), 9);
+    SampledSpectrum::beginSample(glm::ivec2(4, 2), 9);
+    EXPECT_EQ(SampledSpectrum::getWavelengths().lambda, first.lambda);
+    SampledSpectrum::endSample();
+
+    constexpr float kRange = SampledWavelengths::kMax - SampledWavelengths::kMin;
+    for (int i = 0; i < SampledWavelengths::kCount; ++i) {
+        EXPECT_GE(first.lambda[i], SampledWavelengths::kMin);
+        EXPECT_LE(first.lambda[i], SampledWavelengths::kMax);
+        const float offset = first.lambda[(i + 1) % SampledWavelengths::kCount] - first.lambda[i];
+        EXPECT_NEAR(std::fmod(offset + kRange, kRange), kRange / SampledWavelengths::kCount, 1e-2f);
+    }
+}
+
+TEST(SpectrumTest, GrayRoundTripsThroughWavelengths) {
+    const glm::vec3 gray = averageRoundTrip(glm::vec3(0.5f));
+    EXPECT_NEAR(gray.r, 0.5f, 0.01f);
+    EXPECT_NEAR(gray.g, 0.5f, 0.01f);
+    EXPECT_NEAR(gray.b, 0.5f, 0.01f);
+}
+
+TEST(SpectrumTest, ColorsRoundTripApproximately) {
+    // Smits' basis spectra only approximately project back onto the primaries.
+    const std::array<glm::vec3, 3> colors = {
+        glm::vec3(0.7f, 0.3f, 0.2f), glm::vec3(0.2f, 0.6f, 0.3f), glm::vec3(0.1f, 0.2f, 0.8f)};
+    for (const glm::vec3& color : colors) {
+        const glm::vec3 rgb = averageRoundTrip(color);
+        EXPECT_NEAR(rgb.r, color.r, 0.03f);
+        EXPECT_NEAR(rgb.g, color.g, 0.03f);
+        EXPECT_NEAR(rgb.b, color.b, 0.03f);
+    }
+}
+} // namespace
+} // namespace crisp::test
@@ -0,0 +1,167 @@
+#include <Crisp/PathTracer/Textures/ImageTexture.hpp>
+#include <Crisp/PathTracer/Textures/TextureCache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+std::filesystem::path getCachePath(const std::string& name) {
+    return std::filesystem::path(::testing::TempDir()) / (name + ".tiles");
+}
+
+std::shared_ptr<TextureCache> createCache(const float budgetMB) {
+    VariantMap parameters;
+    parameters.insert("budgetMB", budgetMB);
+    parameters.insert("directory", ::testing::TempDir());
+    return std::make_shared<TextureCache>(parameters);
+}
+
+// Red grows along x and green along the rows, top row first; blue is constant.
+std::vector<float> createGradient(const glm::ivec2 size) {
+    std::vector<float> rgb;
+    for (int32_t y = 0; y < size.y; ++y) {
+        for (int32_t x = 0; x < size.x; ++x) {
+            rgb.push_back(static_cast<float>(x) / static_cast<float>(size.x));
+            rgb.push_back(static_cast<float>(y) / static_cast<float>(size.y));
+            rgb.push_back(0.25f);
+        }
+    }
+    return rgb;
+}
+
+TextureCache::ImageHandle addImage(
+    TextureCache& cache, const std::vector<float>& rgb, const glm::ivec2 size, const std::string& name) {
+    auto image = TiledImage::create(rgb, size, TiledImage::Format::Half, getCachePath(name));
+    EXPECT_TRUE(image);
+    return cache.addImage(image.extract());
+}
+
+TEST(TextureCacheTest, PyramidEndsInSingleTexel) {
+    const glm::ivec2 size(300, 70);
+    auto image = TiledImage::create(createGradient(size), size, TiledImage::Format::Half, getCachePath("pyramid"));
+    ASSERT_TRUE(image);
+    ASSERT_EQ((*image)->getLevelCount(), 10);
+    EXPECT_EQ((*image)->getLevel(0).tileCount, glm::ivec2(5, 2));
+    EXPECT_EQ((*image)->getLevel(1).size, glm::ivec2(150, 35));
+    EXPECT_EQ((*image)->getLevel(9).size, glm::ivec2(1));
+}
+
+TEST(TextureCacheTest, BilinearLookupAtTexelCenterReturnsTexel) {
+    const glm::ivec2 size(200, 100);
+    const std::vector<float> rgb = createGradient(size);
+    auto cache = createCache(16.0f);
+    const auto handle = addImage(*cache, rgb, size, "gradient");
+
+    VariantMap parameters;
+    parameters.insert("filter", std::string("bilinear"));
+    const ImageTexture<Spectrum> texture(parameters, cache, handle);
+    for (const glm::ivec2 texel : {glm::ivec2(0, 0), glm::ivec2(130, 17), glm::ivec2(64, 64), glm::ivec2(199, 99)}) {
+        // Texture coordinates start at the bottom row.
+        const glm::vec2 uv((texel.x + 0.5f) / size.x, 1.0f - (texel.y + 0.5f) / size.y);
+        const glm::vec3 value = texture.eval(uv).toRgb();
+        const size_t index = 3 * (static_cast<size_t>(texel.y) * size.x + texel.x);
+        EXPECT_NEAR(value.r, rgb[index], 1e-3f);
+        EXPECT_NEAR(value.g, rgb[index + 1], 1e-3f);
+        EXPECT_NEAR(value.b, rgb[index + 2], 1e-3f);
+    }
+}
+
+TEST(TextureCacheTest, ConstantImageIsConstantAtEveryFootprint) {
+    const glm::ivec2 size(173, 91);
+    const std::vector<float> rgb(static_cast<size_t>(size.x) * size.y * 3, 0.5f);
+    auto cache = createCache(16.0f);
+    const auto handle = addImage(*cache, rgb, size, "constant");
+
+    for (const std::string filter : {"trilinear", "ewa"}) {
+        VariantMap parameters;
+        parameters.insert("filter", filter);
+        const ImageTexture<float> texture(parameters, cache, handle);
+        for (const float footprint : {0.0f, 1e-3f, 0.02f, 0.3f, 4.0f}) {
+            const glm::vec2 uv(0.37f, 0.81f);
+            EXPECT_NEAR(texture.evalFiltered(uv, glm::vec2(footprint, 0.0f), glm::vec2(0.0f, footprint)), 0.5f, 1e-3f);
+            EXPECT_NEAR(
+                texture.evalFiltered(uv, glm::vec2(footprint, footprint * 0.2f), glm::vec2(0.0f, footprint * 0.1f)),
+                0.5f,
+                1e-3f);
+        }
+    }
+}
+
+TEST(TextureCacheTest, LargeFootprintReturnsImageAverage) {
+    const glm::ivec2 size(256, 256);
+    const std::vector<float> rgb = createGradient(size);
+    auto cache = createCache(16.0f);
+    const auto handle = addImage(*cache, rgb, size, "average");
+
+    const ImageTexture<Spectrum> texture(VariantMap(), cache, handle);
+    const glm::vec3 value =
+        texture.evalFiltered(glm::vec2(0.5f), glm::vec2(2.0f, 0.0f), glm::vec2(0.0f, 2.0f)).toRgb();
+    EXPECT_NEAR(value.r, 127.5f / 256.0f, 1e-3f);
+    EXPECT_NEAR(value.g, 127.5f / 256.0f, 1e-3f);
+    EXPECT_NEAR(value.b, 0.25f, 1e-3f);
+}
+
+TEST(TextureCacheTest, ResidentTilesStayWithinBudget) {
+    const glm::ivec2 size(1024, 1024);
+    auto cache = createCache(1.0f);
+    const auto handle = addImage(*cache, createGradient(size), size, "budget");
+
+    // Two passes over all tiles of the first level, which is several times larger than the budget.
+    VariantMap parameters;
+    parameters.insert("filter", std::string("bilinear"));
+    const ImageTexture<Spectrum> texture(parameters, cache, handle);
+    for (int32_t pass = 0; pass < 2; ++pass) {
+        for (int32_t y = 0; y < 16; ++y) {
+            for (int32_t x = 0; x < 16; ++x) {
+                texture.eval(glm::vec2((x + 0.5f) / 16.0f, (y + 0.5f) / 16.0f));
+                EXPECT_LE(cache->getStatistics().residentBytes, cache->getBudget());
+            }
+        }
+    }
+
+    const TextureCache::Statistics statistics = cache->getStatistics();
+    EXPECT_GT(statistics.evictions, 0u);
+    EXPECT_GT(statistics.misses, 256u);
+    EXPECT_LE(statistics.peakResidentBytes, cache->getBudget());
+}
+
+TEST(TextureCacheTest, RepeatedLookupsHitTheCache) {
+    const glm::ivec2 size(128, 128);
+    auto cache = createCache(16.0f);
+    const auto handle = addImage(*cache, createGradient(size), size, "hits");
+
+    const ImageTexture<Spectrum> texture(VariantMap(), cache, handle);
+    for (int32_t i = 0; i < 100; ++i) {
+        texture.eval(glm::vec2(0.25f, 0.25f));
+    }
+    const TextureCache::Statistics statistics = cache->getStatistics();
+    EXPECT_EQ(statistics.misses, 1u);
+    EXPECT_EQ(statistics.hits, 99u);
+}
+
+TEST(TextureCacheTest, PyramidWithoutCachePathIsKeptInMemory) {
+    const glm::ivec2 size(150, 90);
+    const std::vector<float> rgb = createGradient(size);
+    auto cache = createCache(16.0f);
+    const auto cachedHandle = addImage(*cache, rgb, size, "stored");
+    auto image = TiledImage::create(rgb, size, TiledImage::Format::Half, {});
+    ASSERT_TRUE(image);
+    ASSERT_TRUE((*image)->isInMemory());
+    const auto inMemoryHandle = cache->addImage(image.extract());
+
+    const ImageTexture<Spectrum> cached(VariantMap(), cache, cachedHandle);
+    const ImageTexture<Spectrum> inMemory(VariantMap(), cache, inMemoryHandle);
+    for (const glm::vec2 uv : {glm::vec2(0.1f, 0.9f), glm::vec2(0.5f), glm::vec2(0.77f, 0.31f)}) {
+        for (const float footprint : {0.0f, 0.01f, 0.2f}) {
+            const glm::vec2 dUVdx(footprint, 0.0f);
+            const glm::vec2 dUVdy(0.0f, footprint);
+            EXPECT_EQ(inMemory.evalFiltered(uv, dUVdx, dUVdy).toRgb(), cached.evalFiltered(uv, dUVdx, dUVdy).toRgb());
+        }
+    }
+}
+} // namespace
+} // namespace crisp::test
@@ -0,0 +1,136 @@
+#include <Crisp/PathTracer/Distributed/TileProtocol.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace crisp::test {
+namespace {
+constexpr auto kTimeout = std::chrono::milliseconds(2000);
+
+struct Connection {
+    Socket client;
+    Socket server;
+};
+
+Connection connectLoopback(ListenSocket& listener) {
+    Connection connection;
+    auto client = Socket::connect("127.0.0.1", listener.getPort());
+    EXPECT_TRUE(client);
+    connection.client = client.extract();
+    auto server = listener.accept(kTimeout);
+    EXPECT_TRUE(server);
+    connection.server = server.extract();
+    EXPECT_TRUE(connection.server.isOpen());
+    return connection;
+}
+
+TEST(TileProtocolTest, MessagesRoundTripOverLoopback) {
+    auto listener = ListenSocket::listen(0);
+    ASSERT_TRUE(listener);
+    EXPECT_NE(listener->getPort(), 0);
+    Connection connection = connectLoopback(*listener);
+
+    const TileMessage tile{.x = 64, .y = 128, .width = 64, .height = 32, .firstSample = 16, .sampleCount = 48};
+    ASSERT_TRUE(sendMessage(connection.server, TileMessageType::Tile, tile).isValid());
+    const std::string blockData(10'000, 'x');
+    ASSERT_TRUE(sendMessage(connection.server, TileMessageType::TileResult, std::as_bytes(std::span(blockData)))
+                    .isValid());
+    ASSERT_TRUE(sendMessage(connection.server, TileMessageType::Done, std::span<const std::byte>()).isValid());
+
+    const auto tileMessage = receiveMessage(connection.client);
+    ASSERT_TRUE(tileMessage);
+    EXPECT_EQ(tileMessage->type, TileMessageType::Tile);
+    const auto received = tileMessage->read<TileMessage>();
+    ASSERT_TRUE(received);
+    EXPECT_EQ(received->x, tile.x);
+    EXPECT_EQ(received->y, tile.y);
+    EXPECT_EQ(received->width, tile.width);
+    EXPECT_EQ(received->height, tile.height);
+    EXPECT_EQ(received->firstSample, tile.firstSample);
+    EXPECT_EQ(received->sampleCount, tile.sampleCount);
+
+    const auto resultMessage = receiveMessage(connection.client);
+    ASSERT_TRUE(resultMessage);
+    EXPECT_EQ(resultMessage->type, TileMessageType::TileResult);
+    EXPECT_EQ(resultMessage->payload, blockData);
+
+    const auto doneMessage = receiveMessage(connection.client);
+    ASSERT_TRUE(doneMessage);
+    EXPECT_EQ(doneMessage->type, TileMessageType::Done);
+    EXPECT_TRUE(doneMessage->payload.empty());
+    EXPECT_FALSE(doneMessage->read<TileMessage>());
+}
+
+TEST(TileProtocolTest, HelloIsSentWithZeroedReservedBytes) {
+    auto listener = ListenSocket::listen(0);
+    ASSERT_TRUE(listener);
+    Connection connection = connectLoopback(*listener);
+
+    const HelloMessage hello{.protocolVersion = kTileProtocolVersion, .sceneHash = 0x0123456789abcdef};
+    ASSERT_TRUE(sendMessage(connection.client, TileMessageType::Hello, hello).isValid());
+
+    const auto message = receiveMessage(connection.server);
+    ASSERT_TRUE(message);
+    ASSERT_EQ(message->payload.size(), sizeof(HelloMessage));
+    EXPECT_EQ(message->payload.substr(offsetof(HelloMessage, reserved), sizeof(uint32_t)), std::string(4, '\0'));
+    const auto received = message->read<HelloMessage>();
+    ASSERT_TRUE(received);
+    EXPECT_EQ(received->protocolVersion, kTileProtocolVersion);
+    EXPECT_EQ(received->sceneHash, hello.sceneHash);
+}
+
+TEST(TileProtocolTest, ClosedConnectionFailsToReceive) {
+    auto listener = ListenSocket::listen(0);
+    ASSERT_TRUE(listener);
+    Connection connection = connectLoopback(*listener);
+
+    connection.server.close();
+    EXPECT_FALSE(receiveMessage(connection.client));
+}
+
+TEST(TileProtocolTest, SilentConnectionTimesOut) {
+    auto listener = ListenSocket::listen(0);
+    ASSERT_TRUE(listener);
+    Connection connection = connectLoopback(*listener);
+
+    connection.client.setReceiveTimeout(std::chrono::milliseconds(10));
+    EXPECT_FALSE(receiveMessage(connection.client));
+}
+
+TEST(TileProtocolTest, InvalidHeaderIsRejected) {
+    auto listener = ListenSocket::listen(0);
+    ASSERT_TRUE(listener);
+    Connection connection = connectLoopback(*listener);
+
+    const std::array<uint32_t, 4> header = {1000, 0, 0, 0};
+    ASSERT_TRUE(connection.server.send(std::as_bytes(std::span(header))).isValid());
+    EXPECT_FALSE(receiveMessage(connection.client));
+}
+
+TEST(TileProtocolTest, AcceptTimesOutWithoutConnections) {
+    auto listener = ListenSocket::listen(0);
+    ASSERT_TRUE(listener);
+    const auto socket = (*listener).accept(std::chrono::milliseconds(10));
+    ASSERT_TRUE(socket);
+    EXPECT_FALSE(socket->isOpen());
+}
+
+TEST(TileProtocolTest, InvalidBindAddressIsRejected) {
+    EXPECT_FALSE(ListenSocket::listen(0, "not an address"));
+}
+
+TEST(TileProtocolTest, ConnectingToClosedPortFails) {
+    uint16_t port = 0;
+    {
+        auto listener = ListenSocket::listen(0);
+        ASSERT_TRUE(listener);
+        port = listener->getPort();
+    }
+    EXPECT_FALSE(Socket::connect("127.0.0.1", port));
+}
+} // namespace
+} // namespace crisp::test
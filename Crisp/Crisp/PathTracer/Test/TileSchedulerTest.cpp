@@ -0,0 +1,119 @@
+#include <Crisp/PathTracer/TileScheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+namespace crisp::test {
+namespace {
+std::vector<int> countCoverage(const glm::ivec2& size, const std::vector<ImageBlock::Descriptor>& tiles) {
+    std::vector<int> coverage(static_cast<size_t>(size.x) * size.y, 0);
+    for (const auto& tile : tiles) {
+        for (int y = tile.offset.y; y < tile.offset.y + tile.size.y; ++y) {
+            for (int x = tile.offset.x; x < tile.offset.x + tile.size.x; ++x) {
+                ++coverage[static_cast<size_t>(y) * size.x + x];
+            }
+        }
+    }
+    return coverage;
+}
+
+std::vector<size_t> getAllBlocks(const std::vector<ImageBlock::Descriptor>& blocks) {
+    std::vector<size_t> indices(blocks.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    return indices;
+}
+
+TEST(TileSchedulerTest, SpiralBlocksCoverImageOnce) {
+    const glm::ivec2 size(200, 130);
+    const auto blocks = TileScheduler::createSpiralBlocks(size, 64);
+    ASSERT_EQ(blocks.size(), 12);
+    EXPECT_EQ(countCoverage(size, blocks), std::vector<int>(static_cast<size_t>(size.x) * size.y, 1));
+
+    // The spiral ends in the top left corner and starts next to the center.
+    EXPECT_EQ(blocks.back().offset, glm::ivec2(0, 0));
+    EXPECT_EQ(blocks.front().offset, glm::ivec2(128, 64));
+}
+
+TEST(TileSchedulerTest, OrdersBlocksByDecreasingCost) {
+    const auto blocks = TileScheduler::createSpiralBlocks(glm::ivec2(256, 64), 64);
+    const std::vector<double> costs = {1.0, 4.0, 1.0, 2.0};
+    TileScheduler scheduler;
+    scheduler.reset(blocks, getAllBlocks(blocks), costs, 1, 0);
+
+    std::vector<size_t> order;
+    while (const auto tile = scheduler.pop()) {
+        order.push_back(tile->blockIndex);
+    }
+    EXPECT_EQ(order, std::vector<size_t>({1, 3, 0, 2}));
+}
+
+TEST(TileSchedulerTest, KeepsGivenOrderWithoutCosts) {
+    const auto blocks = TileScheduler::createSpiralBlocks(glm::ivec2(256, 64), 64);
+    TileScheduler scheduler;
+    scheduler.reset(blocks, std::vector<size_t>{2, 0}, {}, 1, 0);
+    EXPECT_EQ(scheduler.pop()->blockIndex, 2);
+    EXPECT_EQ(scheduler.pop()->blockIndex, 0);
+    EXPECT_FALSE(scheduler.pop());
+}
+
+TEST(TileSchedulerTest, SplitsTilesOnceQueueDrains) {
+    const glm::ivec2 size(128, 64);
+    const auto blocks = TileScheduler::createSpiralBlocks(size, 64);
+    TileScheduler scheduler;
+    scheduler.reset(blocks, getAllBlocks(blocks), {}, 4, 16);
+
+    std::vector<ScheduledTile> tiles;
+    while (const auto tile = scheduler.pop()) {
+        EXPECT_GE(tile->desc.size.x, 16);
+        EXPECT_GE(tile->desc.size.y, 16);
+        tiles.push_back(*tile);
+    }
+    EXPECT_GT(scheduler.getSplitCount(), 0);
+    EXPECT_GT(tiles.size(), blocks.size());
+
+    std::vector<ImageBlock::Descriptor> descs;
+    for (const auto& tile : tiles) {
+        descs.push_back(tile.desc);
+    }
+    EXPECT_EQ(countCoverage(size, descs), std::vector<int>(static_cast<size_t>(size.x) * size.y, 1));
+
+    // Only the last tile of each block finishes it.
+    std::vector<int> finishedBlocks(blocks.size(), 0);
+    std::vector<int> remainingTiles(blocks.size(), 0);
+    for (const auto& tile : tiles) {
+        ++remainingTiles[tile.blockIndex];
+    }
+    for (const auto& tile : tiles) {
+        const bool isLast = --remainingTiles[tile.blockIndex] == 0;
+        EXPECT_EQ(scheduler.finish(tile), isLast);
+        finishedBlocks[tile.blockIndex] += isLast ? 1 : 0;
+    }
+    EXPECT_EQ(finishedBlocks, std::vector<int>(blocks.size(), 1));
+}
+
+TEST(TileSchedulerTest, DoesNotSplitWhileEnoughTilesAreQueued) {
+    const auto blocks = TileScheduler::createSpiralBlocks(glm::ivec2(512, 64), 64);
+    TileScheduler scheduler;
+    scheduler.reset(blocks, getAllBlocks(blocks), {}, 2, 16);
+
+    // Eight blocks for two threads: the first six are handed out whole.
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(scheduler.pop()->desc.size, glm::ivec2(64));
+    }
+    EXPECT_EQ(scheduler.getSplitCount(), 0);
+    EXPECT_EQ(scheduler.pop()->desc.size, glm::ivec2(32));
+}
+
+TEST(TileSchedulerTest, RequeuedTileIsTakenFirst) {
+    const auto blocks = TileScheduler::createSpiralBlocks(glm::ivec2(256, 64), 64);
+    TileScheduler scheduler;
+    scheduler.reset(blocks, getAllBlocks(blocks), {}, 1, 0);
+    const auto first = scheduler.pop();
+    ASSERT_TRUE(first);
+    scheduler.push(*first);
+    EXPECT_EQ(scheduler.getQueuedCount(), blocks.size());
+    EXPECT_EQ(scheduler.pop()->blockIndex, first->blockIndex);
+}
+} // namespace
+} // namespace crisp::test
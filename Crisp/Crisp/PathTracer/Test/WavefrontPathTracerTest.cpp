@@ -0,0 +1,124 @@
+#include <Crisp/PathTracer/Cameras/Camera.hpp>
+#include <Crisp/PathTracer/Core/JsonSceneParser.hpp>
+#include <Crisp/PathTracer/Core/Scene.hpp>
+#include <Crisp/PathTracer/Integrators/MisPathTracer.hpp>
+#include <Crisp/PathTracer/Integrators/WavefrontPathTracer.hpp>
+#include <Crisp/PathTracer/Samplers/Sampler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace crisp::test {
+namespace {
+constexpr int kImageSize = 16;
+constexpr uint32_t kSampleCount = 64;
+
+// A diffuse floor, a glass and a glossy sphere lit by a spherical emitter and a point light, so that paths take
+// diffuse, glossy and delta bounces and hit several BSDF types in every wavefront.
+constexpr const char* kScene = R"({
+    "integrator": {"type": "mis-path-tracer"},
+    "sampler": {"type": "independent", "samplesPerPixel": 64, "seed": 7},
+    "camera": {
+        "type": "perspective",
+        "imageSize": [16, 16],
+        "fovY": 40.0,
+        "position": [0.0, 1.0, 6.0],
+        "target": [0.0, 0.5, 0.0],
+        "up": [0.0, 1.0, 0.0]
+    },
+    "shapes": [
+        {"type": "sphere", "center": [0.0, -1000.0, 0.0], "radius": 1000.0,
+         "bsdf": {"type": "lambertian", "reflectance": [0.6, 0.6, 0.6]}},
+        {"type": "sphere", "center": [-0.8, 0.6, 0.0], "radius": 0.6,
+         "bsdf": {"type": "dielectric", "interiorIor": 1.5, "exteriorIor": 1.0}},
+        {"type": "sphere", "center": [0.8, 0.6, 0.0], "radius": 0.6,
+         "bsdf": {"type": "rough-conductor", "conductorIorPreset": "Au", "microfacetAlpha": 0.3}},
+        {"type": "sphere", "center": [0.0, 3.0, 1.0], "radius": 0.5,
+         "bsdf": {"type": "lambertian", "reflectance": [0.0, 0.0, 0.0]},
+         "light": {"type": "area", "radiance": [8.0, 8.0, 8.0]}}
+    ],
+    "lights": [
+        {"type": "point", "position": [2.0, 2.5, 2.0], "power": [20.0, 20.0, 20.0]}
+    ]
+})";
+
+struct Estimate {
+    double mean{0.0};
+    double variance{0.0};
+};
+
+std::unique_ptr<pt::Scene> loadScene() {
+    const auto scenePath = std::filesystem::path(::testing::TempDir()) / "wavefront-scene.json";
+    std::ofstream(scenePath) << kScene;
+    auto scene = JsonSceneParser().parse(scenePath, ::testing::TempDir());
+    return scene ? scene.extract() : nullptr;
+}
+
+// Estimates the mean luminance of the image along with the variance of that mean. Every sample of every pixel is
+// traced as one batch, so that the wavefront integrator sees as many paths at a time as it does in a render.
+Estimate estimateImageMean(const pt::Scene& scene, const Integrator& integrator) {
+    auto sampler = scene.getSampler()->clone();
+    const Camera& camera = *scene.getCamera();
+
+    const size_t pathCount = static_cast<size_t>(kImageSize) * kImageSize * kSampleCount;
+    std::vector<SampleState> sampleStates(pathCount);
+    std::vector<Ray3> rays(pathCount);
+    std::vector<Spectrum> responses(pathCount);
+    std::vector<Intersection> hits(pathCount);
+    std::vector<Spectrum> radiance(pathCount);
+    size_t k = 0;
+    for (int y = 0; y < kImageSize; ++y) {
+        for (int x = 0; x < kImageSize; ++x) {
+            for (uint32_t s = 0; s < kSampleCount; ++s, ++k) {
+                sampler->startPixelSample(glm::ivec2(x, y), s);
+                const glm::vec2 pixelSample = sampler->next2D();
+                const glm::vec2 apertureSample = sampler->next2D();
+                responses[k] = camera.sampleRay(rays[k], glm::vec2(x, y) + pixelSample, apertureSample);
+                sampleStates[k] = sampler->getSampleState();
+            }
+        }
+    }
+    scene.rayIntersect(rays, hits);
+    integrator.LiBatch(&scene, *sampler, sampleStates, rays, hits, radiance);
+
+    double sum = 0.0;
+    double sumOfSquares = 0.0;
+    for (k = 0; k < pathCount; ++k) {
+        Spectrum::beginSample(sampleStates[k].pixel, sampleStates[k].sampleIndex);
+        const double value = (responses[k] * radiance[k]).getLuminance();
+        sum += value;
+        sumOfSquares += value * value;
+    }
+    Spectrum::endSample();
+
+    const double mean = sum / static_cast<double>(pathCount);
+    const double sampleVariance = sumOfSquares / static_cast<double>(pathCount) - mean * mean;
+    return {.mean = mean, .variance = sampleVariance / static_cast<double>(pathCount - 1)};
+}
+
+TEST(WavefrontPathTracerTest, MatchesMisPathTracer) {
+    const auto scene = loadScene();
+    ASSERT_NE(scene, nullptr);
+
+    VariantMap parameters;
+    parameters.insert("maxDepth", 6);
+    parameters.insert("rrDepth", 3);
+    MisPathTracerIntegrator misIntegrator(parameters);
+    WavefrontPathTracerIntegrator wavefrontIntegrator(parameters);
+    misIntegrator.preprocess(scene.get());
+    wavefrontIntegrator.preprocess(scene.get());
+
+    const Estimate mis = estimateImageMean(*scene, misIntegrator);
+    const Estimate wavefront = estimateImageMean(*scene, wavefrontIntegrator);
+    ASSERT_GT(mis.mean, 0.0);
+
+    // Both estimate the same image, so their means agree to within a few standard errors.
+    const double standardError = std::sqrt(mis.variance + wavefront.variance);
+    EXPECT_NEAR(wavefront.mean, mis.mean, 4.0 * standardError);
+}
+} // namespace
+} // namespace crisp::test
@@ -0,0 +1,177 @@
+#include <Crisp/PathTracer/Textures/ImageTexture.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace crisp {
+namespace {
+constexpr float kMaxAnisotropy = 8.0f;
+constexpr size_t kWeightTableSize = 128;
+
+// Gaussian falloff over the squared radius of the unit ellipse, shifted to reach zero at its boundary.
+const std::array<float, kWeightTableSize>& getEwaWeights() {
+    static const std::array<float, kWeightTableSize> weights = [] {
+        constexpr float kAlpha = 2.0f;
+        std::array<float, kWeightTableSize> values{};
+        for (size_t i = 0; i < values.size(); ++i) {
+            const float r2 = static_cast<float>(i) / static_cast<float>(kWeightTableSize - 1);
+            values[i] = std::exp(-kAlpha * r2) - std::exp(-kAlpha);
+        }
+        return values;
+    }();
+    return weights;
+}
+
+int32_t wrapCoordinate(const int32_t coordinate, const int32_t size, const TiledImageLookup::Wrap wrap) {
+    if (wrap == TiledImageLookup::Wrap::Clamp) {
+        return std::clamp(coordinate, 0, size - 1);
+    }
+    const int32_t wrapped = coordinate % size;
+    return wrapped < 0 ? wrapped + size : wrapped;
+}
+
+// Flips the texture coordinates to the image's top-down row order.
+glm::vec2 toImageSpace(const glm::vec2& uv) {
+    return {uv.x, 1.0f - uv.y};
+}
+} // namespace
+
+TiledImageLookup::TiledImageLookup(
+    std::shared_ptr<TextureCache> cache, const TextureCache::ImageHandle image, const Filter filter, const Wrap wrap)
+    : m_cache(std::move(cache))
+    , m_imageHandle(image)
+    , m_image(&m_cache->getImage(image))
+    , m_filter(filter)
+    , m_wrap(wrap) {}
+
+glm::vec3 TiledImageLookup::eval(const glm::vec2& uv) const {
+    TileReference reference;
+    return bilinear(0, toImageSpace(uv), reference);
+}
+
+glm::vec3 TiledImageLookup::evalFiltered(const glm::vec2& uv, const glm::vec2& dUVdx, const glm::vec2& dUVdy) const {
+    TileReference reference;
+    const glm::vec2 st = toImageSpace(uv);
+    glm::vec2 dst0(dUVdx.x, -dUVdx.y);
+    glm::vec2 dst1(dUVdy.x, -dUVdy.y);
+    if (m_filter == Filter::Bilinear) {
+        return bilinear(0, st, reference);
+    } else if (m_filter == Filter::Trilinear) {
+        const float width = 2.0f * std::max({std::abs(dst0.x), std::abs(dst0.y), std::abs(dst1.x), std::abs(dst1.y)});
+        return trilinear(st, width, reference);
+    }
+
+    // Make dst0 the major axis and limit the eccentricity, which would otherwise let a grazing footprint cover an
+    // unbounded number of texels. The minor axis is lengthened, blurring rather than aliasing.
+    if (glm::dot(dst0, dst0) < glm::dot(dst1, dst1)) {
+        std::swap(dst0, dst1);
+    }
+    const float majorLength = glm::length(dst0);
+    float minorLength = glm::length(dst1);
+    if (minorLength * kMaxAnisotropy < majorLength && minorLength > 0.0f) {
+        const float scale = majorLength / (minorLength * kMaxAnisotropy);
+        dst1 *= scale;
+        minorLength *= scale;
+    }
+    if (minorLength == 0.0f) {
+        return bilinear(0, st, reference);
+    }
+
+    const float lod = std::max(0.0f, static_cast<float>(m_image->getLevelCount() - 1) + std::log2(minorLength));
+    const auto level = static_cast<int32_t>(lod);
+    const float t = lod - static_cast<float>(level);
+    const glm::vec3 fine = ewa(level, st, dst0, dst1, reference);
+    return t == 0.0f ? fine : glm::mix(fine, ewa(level + 1, st, dst0, dst1, reference), t);
+}
+
+glm::vec3 TiledImageLookup::fetchTexel(const int32_t level, glm::ivec2 texel, TileReference& reference) const {
+    const TiledImage::Level& info = m_image->getLevel(level);
+    texel.x = wrapCoordinate(texel.x, info.size.x, m_wrap);
+    texel.y = wrapCoordinate(texel.y, info.size.y, m_wrap);
+
+    const glm::ivec2 tile = texel / TiledImage::kTileSize;
+    if (reference.level != level || reference.tile != tile) {
+        reference.texels = m_cache->getTile(m_imageHandle, level, tile);
+        reference.level = level;
+        reference.tile = tile;
+    }
+
+    const glm::ivec2 local = texel - tile * TiledImage::kTileSize;
+    const size_t offset = static_cast<size_t>(local.y * TiledImage::kTileSize + local.x) * m_image->getBytesPerTexel();
+    return m_image->decodeTexel(reference.texels->data() + offset);
+}
+
+glm::vec3 TiledImageLookup::bilinear(const int32_t level, const glm::vec2& st, TileReference& reference) const {
+    const glm::vec2 size(m_image->getLevel(level).size);
+    const glm::vec2 texel = st * size - 0.5f;
+    const glm::vec2 base = glm::floor(texel);
+    const glm::vec2 d = texel - base;
+    const glm::ivec2 i(base);
+    return (1.0f - d.x) * (1.0f - d.y) * fetchTexel(level, i, reference) +
+           d.x * (1.0f - d.y) * fetchTexel(level, i + glm::ivec2(1, 0), reference) +
+           (1.0f - d.x) * d.y * fetchTexel(level, i + glm::ivec2(0, 1), reference) +
+           d.x * d.y * fetchTexel(level, i + glm::ivec2(1, 1), reference);
+}
+
+glm::vec3 TiledImageLookup::trilinear(const glm::vec2& st, const float width, TileReference& reference) const {
+    const int32_t lastLevel = m_image->getLevelCount() - 1;
+    const float lod = static_cast<float>(lastLevel) + std::log2(std::max(width, 1e-8f));
+    if (lod <= 0.0f) {
+        return bilinear(0, st, reference);
+    } else if (lod >= static_cast<float>(lastLevel)) {
+        return fetchTexel(lastLevel, glm::ivec2(0), reference);
+    }
+
+    const auto level = static_cast<int32_t>(lod);
+    const float t = lod - static_cast<float>(level);
+    return glm::mix(bilinear(level, st, reference), bilinear(level + 1, st, reference), t);
+}
+
+glm::vec3 TiledImageLookup::ewa(
+    const int32_t level, const glm::vec2& st, glm::vec2 dst0, glm::vec2 dst1, TileReference& reference) const {
+    if (level >= m_image->getLevelCount()) {
+        return fetchTexel(m_image->getLevelCount() - 1, glm::ivec2(0), reference);
+    }
+
+    // Implicit ellipse A*s^2 + B*s*t + C*t^2 < 1 around the lookup point, in texels of this level. The added ones
+    // keep it at least a texel wide, so the filter never falls between texel centers.
+    const glm::vec2 size(m_image->getLevel(level).size);
+    const glm::vec2 center = st * size - 0.5f;
+    dst0 *= size;
+    dst1 *= size;
+    float a = dst0.y * dst0.y + dst1.y * dst1.y + 1.0f;
+    float b = -2.0f * (dst0.x * dst0.y + dst1.x * dst1.y);
+    float c = dst0.x * dst0.x + dst1.x * dst1.x + 1.0f;
+    const float invF = 1.0f / (a * c - b * b * 0.25f);
+    a *= invF;
+    b *= invF;
+    c *= invF;
+
+    const float det = -b * b + 4.0f * a * c;
+    const float invDet = 1.0f / det;
+    const float uSqrt = std::sqrt(det * c);
+    const float vSqrt = std::sqrt(a * det);
+    const auto s0 = static_cast<int32_t>(std::ceil(center.x - 2.0f * invDet * uSqrt));
+    const auto s1 = static_cast<int32_t>(std::floor(center.x + 2.0f * invDet * uSqrt));
+    const auto t0 = static_cast<int32_t>(std::ceil(center.y - 2.0f * invDet * vSqrt));
+    const auto t1 = static_cast<int32_t>(std::floor(center.y + 2.0f * invDet * vSqrt));
+
+    const auto& weights = getEwaWeights();
+    glm::vec3 sum(0.0f);
+    float weightSum = 0.0f;
+    for (int32_t it = t0; it <= t1; ++it) {
+        const float tt = static_cast<float>(it) - center.y;
+        for (int32_t is = s0; is <= s1; ++is) {
+            const float ss = static_cast<float>(is) - center.x;
+            const float r2 = a * ss * ss + b * ss * tt + c * tt * tt;
+            if (r2 < 1.0f) {
+                const size_t index = std::min(static_cast<size_t>(r2 * kWeightTableSize), kWeightTableSize - 1);
+                sum += weights[index] * fetchTexel(level, glm::ivec2(is, it), reference);
+                weightSum += weights[index];
+            }
+        }
+    }
+    return weightSum > 0.0f ? sum / weightSum : bilinear(level, st, reference);
+}
+} // namespace crisp
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+
+#include <Crisp/PathTracer/Textures/Texture.hpp>
+#include <Crisp/PathTracer/Textures/TextureCache.hpp>
+
+namespace crisp {
+// Filtered lookups into a tiled image held by a texture cache. Texture coordinates have their origin at the bottom
+// left of the image, as with the rest of the texture types.
+class TiledImageLookup {
+public:
+    enum class Filter {
+        Bilinear,  // Level 0 only, ignores the footprint.
+        Trilinear, // Isotropic, blends the two levels closest to the longer footprint axis.
+        Ewa,       // Elliptically weighted average over the anisotropic footprint.
+    };
+
+    enum class Wrap {
+        Repeat,
+        Clamp,
+    };
+
+    TiledImageLookup(std::shared_ptr<TextureCache> cache, TextureCache::ImageHandle image, Filter filter, Wrap wrap);
+
+    glm::vec3 eval(const glm::vec2& uv) const;
+    glm::vec3 evalFiltered(const glm::vec2& uv, const glm::vec2& dUVdx, const glm::vec2& dUVdy) const;
+
+private:
+    // Holds on to the last tile fetched during one lookup, since the texels of a filter footprint mostly share one.
+    struct TileReference {
+        int32_t level{-1};
+        glm::ivec2 tile{-1};
+        TextureCache::Tile texels;
+    };
+
+    glm::vec3 fetchTexel(int32_t level, glm::ivec2 texel, TileReference& reference) const;
+    glm::vec3 bilinear(int32_t level, const glm::vec2& st, TileReference& reference) const;
+    glm::vec3 trilinear(const glm::vec2& st, float width, TileReference& reference) const;
+    glm::vec3 ewa(int32_t level, const glm::vec2& st, glm::vec2 dst0, glm::vec2 dst1, TileReference& reference) const;
+
+    std::shared_ptr<TextureCache> m_cache;
+    TextureCache::ImageHandle m_imageHandle;
+    const TiledImage* m_image;
+    Filter m_filter;
+    Wrap m_wrap;
+};
+
+template <typename T>
+class ImageTexture : public Texture<T> {
+public:
+    // Parameters:
+    //   filter: "bilinear", "trilinear" (default) or "ewa".
+    //   wrap: "repeat" (default) or "clamp".
+    // Float textures read the first channel of the image.
+    ImageTexture(const VariantMap& params, std::shared_ptr<TextureCache> cache, TextureCache::ImageHandle image)
+        : Texture<T>(params)
+        , m_lookup(std::move(cache), image, parseFilter(params), parseWrap(params)) {}
+
+    T eval(const glm::vec2& uv) const override {
+        return convert(m_lookup.eval(uv));
+    }
+
+    T evalFiltered(const glm::vec2& uv, const glm::vec2& dUVdx, const glm::vec2& dUVdy) const override {
+        return convert(m_lookup.evalFiltered(uv, dUVdx, dUVdy));
+    }
+
+private:
+    static TiledImageLookup::Filter parseFilter(const VariantMap& params) {
+        const auto filter = params.get<std::string>("filter", "trilinear");
+        if (filter == "bilinear") {
+            return TiledImageLookup::Filter::Bilinear;
+        } else if (filter == "ewa") {
+            return TiledImageLookup::Filter::Ewa;
+        } else {
+            return TiledImageLookup::Filter::Trilinear;
+        }
+    }
+
+    static TiledImageLookup::Wrap parseWrap(const VariantMap& params) {
+        return params.get<std::string>("wrap", "repeat") == "clamp" ? TiledImageLookup::Wrap::Clamp
+                                                                     : TiledImageLookup::Wrap::Repeat;
+    }
+
+    static T convert(const glm::vec3& rgb) {
+        if constexpr (std::is_same_v<T, float>) {
+            return rgb.r;
+        } else {
+            return Spectrum(rgb);
+        }
+    }
+
+    TiledImageLookup m_lookup;
+};
+} // namespace crisp
@@ -12,5 +12,11 @@ public:
     virtual ~Texture() {}
 
     virtual T eval(const glm::vec2& uv) const = 0;
+
+    // Averages the texture over the footprint spanned by the UV differentials. Textures without a notion of
+    // resolution ignore the footprint.
+    virtual T evalFiltered(const glm::vec2& uv, const glm::vec2& /*dUVdx*/, const glm::vec2& /*dUVdy*/) const {
+        return eval(uv);
+    }
 };
 } // namespace crisp
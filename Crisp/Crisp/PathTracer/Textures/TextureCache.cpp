@@ -0,0 +1,117 @@
+#include <Crisp/PathTracer/Textures/TextureCache.hpp>
+
+#include <Crisp/Core/Logger.hpp>
+
+namespace crisp {
+namespace {
+// Image, level and tile coordinates packed as 16, 8, 20 and 20 bits.
+uint64_t createTileKey(const TextureCache::ImageHandle handle, const int32_t level, const glm::ivec2 tile) {
+    return (static_cast<uint64_t>(handle) << 48) | (static_cast<uint64_t>(level) << 40) |
+           (static_cast<uint64_t>(tile.y) << 20) | static_cast<uint64_t>(tile.x);
+}
+} // namespace
+
+TextureCache::TextureCache(const VariantMap& parameters)
+    : m_budget(static_cast<size_t>(parameters.get<float>("budgetMB", 1024.0f) * 1024.0f * 1024.0f))
+    , m_directory(parameters.get<std::string>("directory")) {}
+
+Result<TextureCache::ImageHandle> TextureCache::addImage(const std::filesystem::path& imagePath, const bool linear) {
+    const std::string name = std::filesystem::absolute(imagePath).string() + (linear ? "|linear" : "|srgb");
+    if (const auto it = m_imageHandles.find(name); it != m_imageHandles.end()) {
+        return it->second;
+    }
+
+    auto image = TiledImage::create(imagePath, m_directory, linear);
+    if (!image) {
+        return resultError("{}", image.getError());
+    }
+
+    const ImageHandle handle = addImage(image.extract());
+    m_imageHandles.emplace(name, handle);
+    return handle;
+}
+
+TextureCache::ImageHandle TextureCache::addImage(std::unique_ptr<TiledImage> image) {
+    m_images.push_back(std::move(image));
+    return static_cast<ImageHandle>(m_images.size() - 1);
+}
+
+const TiledImage& TextureCache::getImage(const ImageHandle handle) const {
+    return *m_images[handle];
+}
+
+TextureCache::Tile TextureCache::getTile(const ImageHandle handle, const int32_t level, const glm::ivec2 tile) {
+    const TiledImage& image = *m_images[handle];
+    if (image.isInMemory()) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return image.getTile(level, tile);
+    }
+
+    const uint64_t key = createTileKey(handle, level, tile);
+    Shard& shard = getShard(key);
+    {
+        std::scoped_lock lock(shard.mutex);
+        if (const auto it = shard.entries.find(key); it != shard.entries.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lruPosition);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.tile;
+        }
+    }
+
+    // The file read happens outside of the lock, so other threads can keep hitting the shard. If two threads miss on
+    // the same tile, both read it and the second one adopts the copy of the first.
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    auto texels = std::make_shared<std::vector<std::byte>>(image.getTileByteSize());
+    image.readTile(level, tile, *texels);
+
+    const size_t shardBudget = m_budget / kShardCount;
+    std::scoped_lock lock(shard.mutex);
+    const auto [it, inserted] = shard.entries.try_emplace(key);
+    if (!inserted) {
+        return it->second.tile;
+    }
+
+    shard.lru.push_front(key);
+    it->second = {std::move(texels), shard.lru.begin()};
+    shard.residentBytes += it->second.tile->size();
+    int64_t residentDelta = static_cast<int64_t>(it->second.tile->size());
+
+    // The tile just loaded always stays, even if a shard's share of the budget is smaller than a tile.
+    while (shard.residentBytes > shardBudget && shard.lru.size() > 1) {
+        const auto victim = shard.entries.find(shard.lru.back());
+        shard.residentBytes -= victim->second.tile->size();
+        residentDelta -= static_cast<int64_t>(victim->second.tile->size());
+        shard.entries.erase(victim);
+        shard.lru.pop_back();
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+    addResidentBytes(residentDelta);
+    return it->second.tile;
+}
+
+size_t TextureCache::getBudget() const {
+    return m_budget;
+}
+
+TextureCache::Statistics TextureCache::getStatistics() const {
+    Statistics statistics{};
+    statistics.hits = m_hits.load(std::memory_order_relaxed);
+    statistics.misses = m_misses.load(std::memory_order_relaxed);
+    statistics.evictions = m_evictions.load(std::memory_order_relaxed);
+    statistics.residentBytes = static_cast<size_t>(m_residentBytes.load(std::memory_order_relaxed));
+    statistics.peakResidentBytes = static_cast<size_t>(m_peakResidentBytes.load(std::memory_order_relaxed));
+    return statistics;
+}
+
+TextureCache::Shard& TextureCache::getShard(const uint64_t key) {
+    // Fibonacci hashing spreads neighboring tiles, which are usually requested together, over different shards.
+    return m_shards[(key * 0x9E3779B97F4A7C15ull) >> 59];
+}
+
+void TextureCache::addResidentBytes(const int64_t bytes) {
+    const int64_t resident = m_residentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = m_peakResidentBytes.load(std::memory_order_relaxed);
+    while (resident > peak && !m_peakResidentBytes.compare_exchange_weak(peak, resident, std::memory_order_relaxed)) {
+    }
+}
+} // namespace crisp
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Crisp/Core/Result.hpp>
+#include <Crisp/PathTracer/Core/VariantMap.hpp>
+#include <Crisp/PathTracer/Textures/TiledImage.hpp>
+
+namespace crisp {
+// Keeps the most recently used tiles of all tiled images in memory, up to a fixed budget. Tiles are loaded from the
+// image cache files on first use and the least recently used ones are dropped when the budget is exceeded, so scenes
+// can reference far more texture data than fits in memory.
+//
+// Parameters:
+//   budgetMB: memory budget for resident tiles, in megabytes (default 1024).
+//   directory: where the tiled versions of the images are stored. Without one, the pyramids are built in memory on
+//              every load and stay resident outside of the budget.
+class TextureCache {
+public:
+    using ImageHandle = uint32_t;
+    using Tile = TiledImage::Tile;
+
+    struct Statistics {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t evictions{0};
+        size_t residentBytes{0};
+        size_t peakResidentBytes{0};
+    };
+
+    explicit TextureCache(const VariantMap& parameters = VariantMap());
+
+    // Registers an image file, reusing the existing handle if it was already added with the same linear flag.
+    // Must not be called while the cache is being used for lookups.
+    Result<ImageHandle> addImage(const std::filesystem::path& imagePath, bool linear);
+    ImageHandle addImage(std::unique_ptr<TiledImage> image);
+
+    const TiledImage& getImage(ImageHandle handle) const;
+
+    // Returns the texels of a tile, loading it if it is not resident. The tile remains valid for as long as the
+    // returned pointer is held, even if the cache evicts it in the meantime. Safe to call concurrently.
+    Tile getTile(ImageHandle handle, int32_t level, glm::ivec2 tile);
+
+    size_t getBudget() const;
+    Statistics getStatistics() const;
+
+private:
+    static constexpr size_t kShardCount = 32;
+
+    // Each shard caches its part of the key space under its own lock, to keep threads from contending on every
+    // lookup, and gets an even share of the budget.
+    struct Shard {
+        struct Entry {
+            Tile tile;
+            std::list<uint64_t>::iterator lruPosition;
+        };
+
+        std::mutex mutex;
+        std::unordered_map<uint64_t, Entry> entries;
+        std::list<uint64_t> lru; // Most recently used tile first.
+        size_t residentBytes{0};
+    };
+
+    Shard& getShard(uint64_t key);
+
+    void addResidentBytes(int64_t bytes);
+
+    size_t m_budget;
+    std::filesystem::path m_directory;
+
+    std::vector<std::unique_ptr<TiledImage>> m_images;
+    std::unordered_map<std::string, ImageHandle> m_imageHandles;
+
+    std::array<Shard, kShardCount> m_shards;
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_evictions{0};
+    std::atomic<int64_t> m_residentBytes{0};
+    std::atomic<int64_t> m_peakResidentBytes{0};
+};
+} // namespace crisp
@@ -7,19 +7,24 @@
 #include <Crisp/PathTracer/Core/VariantMap.hpp>
 #include <Crisp/PathTracer/Textures/CheckerboardTexture.hpp>
 #include <Crisp/PathTracer/Textures/ConstantTexture.hpp>
+#include <Crisp/PathTracer/Textures/ImageTexture.hpp>
 #include <Crisp/PathTracer/Textures/Texture.hpp>
 #include <Crisp/PathTracer/Textures/UVTexture.hpp>
 
 namespace crisp {
 class TextureFactory {
 public:
+    // Image textures load their tiles through the cache, which must be provided for them.
     template <typename T>
-    static std::unique_ptr<Texture<T>> create(std::string type, VariantMap parameters) {
+    static std::unique_ptr<Texture<T>> create(
+        std::string type, VariantMap parameters, const std::shared_ptr<TextureCache>& cache = nullptr) {
         if constexpr (std::is_same_v<T, float>) {
             if (type == "constant-float") {
                 return std::make_unique<ConstantTexture<float>>(parameters);
             } else if (type == "checkerboard-float") {
                 return std::make_unique<CheckerboardTexture<float>>(parameters);
+            } else if (type == "image-float") {
+                return createImageTexture<float>(parameters, cache);
             } else {
                 spdlog::warn("Unknown texture type '{}'; using a constant float texture.", type);
                 return std::make_unique<ConstantTexture<float>>(parameters);
@@ -31,11 +36,32 @@ public:
                 return std::make_unique<CheckerboardTexture<Spectrum>>(parameters);
             } else if (type == "uv") {
                 return std::make_unique<UVTexture>(parameters);
+            } else if (type == "image-spectrum") {
+                return createImageTexture<Spectrum>(parameters, cache);
             } else {
                 spdlog::warn("Unknown texture type '{}'; using a constant spectrum texture.", type);
                 return std::make_unique<ConstantTexture<Spectrum>>(parameters);
             }
         }
     }
+
+private:
+    // Falls back to a constant texture if the image cannot be loaded, so that a missing file does not stop the render.
+    template <typename T>
+    static std::unique_ptr<Texture<T>> createImageTexture(
+        const VariantMap& parameters, const std::shared_ptr<TextureCache>& cache) {
+        const auto filename = parameters.get<std::string>("filename");
+        if (!cache) {
+            spdlog::warn("Image texture '{}' requires a texture cache; using a constant texture.", filename);
+            return std::make_unique<ConstantTexture<T>>(parameters);
+        }
+
+        auto image = cache->addImage(filename, parameters.get<bool>("linear", false));
+        if (!image) {
+            spdlog::warn("Failed to load image texture '{}'; using a constant texture.", filename);
+            return std::make_unique<ConstantTexture<T>>(parameters);
+        }
+        return std::make_unique<ImageTexture<T>>(parameters, cache, *image);
+    }
 };
 } // namespace crisp
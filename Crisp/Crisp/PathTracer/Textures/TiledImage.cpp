@@ -0,0 +1,394 @@
+#include <Crisp/PathTracer/Textures/TiledImage.hpp>
+
+#include <Crisp/Core/Format.hpp>
+#include <Crisp/Image/Io/Exr.hpp>
+#include <Crisp/Image/Io/Utils.hpp>
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace crisp {
+namespace {
+constexpr std::array<char, 8> kMagic{'C', 'R', 'S', 'P', 'T', 'I', 'L', 'E'};
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    uint32_t version;
+    TiledImage::Format format;
+    int32_t width;
+    int32_t height;
+    int32_t tileSize;
+};
+
+float srgbToLinear(const float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(const float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& getSrgbDecodingTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = srgbToLinear(static_cast<float>(i) / 255.0f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+uint8_t encodeUnorm8(const float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+size_t getBytesPerTexel(const TiledImage::Format format) {
+    return format == TiledImage::Format::Half ? 3 * sizeof(uint16_t) : 3;
+}
+
+std::vector<TiledImage::Level> computeLevels(glm::ivec2 size) {
+    std::vector<TiledImage::Level> levels;
+    uint64_t firstTile = 0;
+    while (true) {
+        const glm::ivec2 tileCount = (size + TiledImage::kTileSize - 1) / TiledImage::kTileSize;
+        levels.push_back({size, tileCount, firstTile});
+        firstTile += static_cast<uint64_t>(tileCount.x) * tileCount.y;
+        if (size == glm::ivec2(1)) {
+            return levels;
+        }
+        size = glm::max((size + 1) / 2, glm::ivec2(1));
+    }
+}
+
+// Halves the level with a box filter. Odd sizes round up, so the last row or column is averaged with itself.
+std::vector<glm::vec3> downsample(const std::vector<glm::vec3>& texels, const glm::ivec2 size, const glm::ivec2 next) {
+    std::vector<glm::vec3> result(static_cast<size_t>(next.x) * next.y);
+    for (int32_t y = 0; y < next.y; ++y) {
+        const int32_t y0 = std::min(2 * y, size.y - 1);
+        const int32_t y1 = std::min(2 * y + 1, size.y - 1);
+        for (int32_t x = 0; x < next.x; ++x) {
+            const int32_t x0 = std::min(2 * x, size.x - 1);
+            const int32_t x1 = std::min(2 * x + 1, size.x - 1);
+            result[static_cast<size_t>(y) * next.x + x] =
+                0.25f * (texels[static_cast<size_t>(y0) * size.x + x0] + texels[static_cast<size_t>(y0) * size.x + x1] +
+                         texels[static_cast<size_t>(y1) * size.x + x0] + texels[static_cast<size_t>(y1) * size.x + x1]);
+        }
+    }
+    return result;
+}
+
+void encodeTexel(const TiledImage::Format format, const glm::vec3& value, std::byte* dst) {
+    switch (format) {
+    case TiledImage::Format::Srgb8:
+        for (int c = 0; c < 3; ++c) {
+            dst[c] = static_cast<std::byte>(encodeUnorm8(linearToSrgb(std::clamp(value[c], 0.0f, 1.0f))));
+        }
+        break;
+    case TiledImage::Format::Unorm8:
+        for (int c = 0; c < 3; ++c) {
+            dst[c] = static_cast<std::byte>(encodeUnorm8(value[c]));
+        }
+        break;
+    case TiledImage::Format::Half:
+        for (int c = 0; c < 3; ++c) {
+            const uint16_t half = glm::packHalf1x16(value[c]);
+            std::memcpy(dst + c * sizeof(uint16_t), &half, sizeof(uint16_t));
+        }
+        break;
+    }
+}
+
+// Encodes the tiles of every level in file order and hands each one to writeTile.
+void encodeTiles(
+    std::vector<glm::vec3> texels,
+    const std::vector<TiledImage::Level>& levels,
+    const TiledImage::Format format,
+    const std::function<void(std::span<const std::byte>)>& writeTile) {
+    constexpr int32_t kTileSize = TiledImage::kTileSize;
+    const size_t bytesPerTexel = getBytesPerTexel(format);
+    std::vector<std::byte> tile(static_cast<size_t>(kTileSize) * kTileSize * bytesPerTexel);
+    for (size_t levelIndex = 0; levelIndex < levels.size(); ++levelIndex) {
+        const TiledImage::Level& level = levels[levelIndex];
+        if (levelIndex > 0) {
+            texels = downsample(texels, levels[levelIndex - 1].size, level.size);
+        }
+
+        for (int32_t ty = 0; ty < level.tileCount.y; ++ty) {
+            for (int32_t tx = 0; tx < level.tileCount.x; ++tx) {
+                for (int32_t y = 0; y < kTileSize; ++y) {
+                    const int32_t srcY = std::min(ty * kTileSize + y, level.size.y - 1);
+                    for (int32_t x = 0; x < kTileSize; ++x) {
+                        const int32_t srcX = std::min(tx * kTileSize + x, level.size.x - 1);
+                        encodeTexel(
+                            format,
+                            texels[static_cast<size_t>(srcY) * level.size.x + srcX],
+                            tile.data() + (static_cast<size_t>(y) * kTileSize + x) * bytesPerTexel);
+                    }
+                }
+                writeTile(tile);
+            }
+        }
+    }
+}
+
+uint64_t getProcessId() {
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return static_cast<uint64_t>(getpid());
+#endif
+}
+
+Result<std::vector<float>> loadLinearRgb(const std::filesystem::path& imagePath, const bool linear, glm::ivec2& size) {
+    const std::string extension = imagePath.extension().string();
+    std::vector<float> rgb;
+    if (extension == ".exr") {
+        auto exr = loadExr(imagePath);
+        if (!exr) {
+            return resultError("Failed to load texture {}: {}", imagePath.string(), exr.getError());
+        }
+        const ExrImageData& data = *exr;
+        size = glm::ivec2(data.width, data.height);
+        rgb.resize(static_cast<size_t>(data.width) * data.height * 3);
+        for (size_t i = 0; i < rgb.size() / 3; ++i) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                rgb[3 * i + c] = data.pixelData[i * data.channelCount + std::min(c, data.channelCount - 1)];
+            }
+        }
+        return rgb;
+    }
+
+    auto image = loadImage(imagePath, 3);
+    if (!image) {
+        return resultError("Failed to load texture {}: {}", imagePath.string(), image.getError());
+    }
+    size = glm::ivec2(image->getWidth(), image->getHeight());
+    rgb.resize(static_cast<size_t>(size.x) * size.y * 3);
+    if (extension == ".hdr") {
+        std::memcpy(rgb.data(), image->getData(), rgb.size() * sizeof(float));
+    } else {
+        const auto& srgbTable = getSrgbDecodingTable();
+        const uint8_t* bytes = image->getData();
+        for (size_t i = 0; i < rgb.size(); ++i) {
+            rgb[i] = linear ? static_cast<float>(bytes[i]) / 255.0f : srgbTable[bytes[i]];
+        }
+    }
+    return rgb;
+}
+} // namespace
+
+TiledImage::TiledImage(const Format format, const glm::ivec2 size, std::filesystem::path cachePath)
+    : m_format(format)
+    , m_levels(computeLevels(size))
+    , m_cachePath(std::move(cachePath)) {}
+
+Result<std::unique_ptr<TiledImage>> TiledImage::create(
+    const std::filesystem::path& imagePath, const std::filesystem::path& cacheDirectory, const bool linear) {
+    std::error_code error;
+    const auto fileSize = std::filesystem::file_size(imagePath, error);
+    if (error) {
+        return resultError("Texture {} does not exist", imagePath.string());
+    }
+
+    const std::string extension = imagePath.extension().string();
+    const bool isHdr = extension == ".exr" || extension == ".hdr";
+    const Format format = isHdr ? Format::Half : (linear ? Format::Unorm8 : Format::Srgb8);
+
+    glm::ivec2 size{};
+    if (cacheDirectory.empty()) {
+        auto rgb = loadLinearRgb(imagePath, linear, size);
+        if (!rgb) {
+            return resultError("{}", rgb.getError());
+        }
+        return create(*rgb, size, format, {});
+    }
+
+    // The cache file is keyed by everything that changes its contents, so an edited source is simply rebuilt.
+    const auto writeTime = std::filesystem::last_write_time(imagePath, error).time_since_epoch().count();
+    const size_t key = std::hash<std::string>{}(
+        std::filesystem::absolute(imagePath).string() + '|' + std::to_string(fileSize) + '|' +
+        std::to_string(writeTime) + '|' + std::to_string(static_cast<uint32_t>(format)));
+    const auto cachePath = cacheDirectory / fmt::format("{}-{:016x}.tiles", imagePath.stem().string(), key);
+
+    if (std::filesystem::exists(cachePath)) {
+        // Only the header is needed to reopen the pyramid; the size is validated against it.
+        std::ifstream file(cachePath, std::ios::binary);
+        FileHeader header{};
+        if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == kMagic &&
+            header.version == kVersion && header.format == format) {
+            auto image = std::unique_ptr<TiledImage>(
+                new TiledImage(format, glm::ivec2(header.width, header.height), cachePath));
+            if (image->open().isValid()) {
+                return image;
+            }
+        }
+    }
+
+    auto rgb = loadLinearRgb(imagePath, linear, size);
+    if (!rgb) {
+        return resultError("{}", rgb.getError());
+    }
+
+    std::filesystem::create_directories(cacheDirectory, error);
+    return create(*rgb, size, format, cachePath);
+}
+
+Result<std::unique_ptr<TiledImage>> TiledImage::create(
+    const std::span<const float> rgb,
+    const glm::ivec2 size,
+    const Format format,
+    const std::filesystem::path& cachePath) {
+    if (size.x <= 0 || size.y <= 0 || rgb.size() != static_cast<size_t>(size.x) * size.y * 3) {
+        return resultError("Invalid texture dimensions {}x{}", size.x, size.y);
+    }
+
+    auto image = std::unique_ptr<TiledImage>(new TiledImage(format, size, cachePath));
+
+    std::vector<glm::vec3> texels(static_cast<size_t>(size.x) * size.y);
+    for (size_t i = 0; i < texels.size(); ++i) {
+        texels[i] = glm::vec3(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+    }
+
+    if (cachePath.empty()) {
+        image->m_tiles.reserve(image->m_levels.back().firstTile + 1);
+        encodeTiles(std::move(texels), image->m_levels, format, [&image](const std::span<const std::byte> tile) {
+            image->m_tiles.push_back(std::make_shared<const std::vector<std::byte>>(tile.begin(), tile.end()));
+        });
+        return image;
+    }
+
+    // Written to a file of this thread's own first, and moved into place once complete, so that concurrent builds
+    // of the same pyramid by other threads or processes never see a partially written one.
+    const auto temporaryPath = std::filesystem::path(cachePath).concat(fmt::format(
+        ".{:x}-{:x}.tmp", getProcessId(), std::hash<std::thread::id>{}(std::this_thread::get_id())));
+    bool isWritten = false;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return resultError("Failed to create texture cache file {}", temporaryPath.string());
+        }
+
+        const FileHeader header{kMagic, kVersion, format, size.x, size.y, kTileSize};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        encodeTiles(std::move(texels), image->m_levels, format, [&file](const std::span<const std::byte> tile) {
+            file.write(reinterpret_cast<const char*>(tile.data()), static_cast<std::streamsize>(tile.size()));
+        });
+        file.close();
+        isWritten = !file.fail();
+    }
+
+    std::error_code error;
+    if (!isWritten) {
+        std::filesystem::remove(temporaryPath, error);
+        return resultError("Failed to write texture cache file {}", temporaryPath.string());
+    }
+
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error) {
+        const std::string message = error.message();
+        std::filesystem::remove(temporaryPath, error);
+        return resultError("Failed to move texture cache file to {}: {}", cachePath.string(), message);
+    }
+
+    if (const auto opened = image->open(); !opened.isValid()) {
+        return resultError("{}", opened.getError());
+    }
+    return image;
+}
+
+Result<> TiledImage::open() {
+    m_file.open(m_cachePath, std::ios::binary);
+    if (!m_file) {
+        return resultError("Failed to open texture cache file {}", m_cachePath.string());
+    }
+
+    const Level& last = m_levels.back();
+    const auto expectedSize = sizeof(FileHeader) + (last.firstTile + 1) * getTileByteSize();
+    std::error_code error;
+    if (std::filesystem::file_size(m_cachePath, error) != expectedSize || error) {
+        return resultError("Texture cache file {} is truncated", m_cachePath.string());
+    }
+    return kResultSuccess;
+}
+
+TiledImage::Format TiledImage::getFormat() const {
+    return m_format;
+}
+
+int32_t TiledImage::getLevelCount() const {
+    return static_cast<int32_t>(m_levels.size());
+}
+
+const TiledImage::Level& TiledImage::getLevel(const int32_t level) const {
+    return m_levels[level];
+}
+
+size_t TiledImage::getTileByteSize() const {
+    return static_cast<size_t>(kTileSize) * kTileSize * getBytesPerTexel();
+}
+
+size_t TiledImage::getBytesPerTexel() const {
+    return ::crisp::getBytesPerTexel(m_format);
+}
+
+void TiledImage::readTile(const int32_t level, const glm::ivec2 tile, const std::span<std::byte> texels) const {
+    const Level& info = m_levels[level];
+    const uint64_t tileIndex = info.firstTile + static_cast<uint64_t>(tile.y) * info.tileCount.x + tile.x;
+    if (isInMemory()) {
+        std::ranges::copy_n(m_tiles[tileIndex]->begin(), static_cast<std::ptrdiff_t>(texels.size()), texels.begin());
+        return;
+    }
+
+    std::scoped_lock lock(m_fileMutex);
+    m_file.seekg(static_cast<std::streamoff>(sizeof(FileHeader) + tileIndex * getTileByteSize()));
+    m_file.read(reinterpret_cast<char*>(texels.data()), static_cast<std::streamsize>(texels.size()));
+}
+
+bool TiledImage::isInMemory() const {
+    return !m_tiles.empty();
+}
+
+const TiledImage::Tile& TiledImage::getTile(const int32_t level, const glm::ivec2 tile) const {
+    const Level& info = m_levels[level];
+    return m_tiles[info.firstTile + static_cast<uint64_t>(tile.y) * info.tileCount.x + tile.x];
+}
+
+glm::vec3 TiledImage::decodeTexel(const std::byte* texel) const {
+    switch (m_format) {
+    case Format::Srgb8: {
+        const auto& table = getSrgbDecodingTable();
+        return {
+            table[static_cast<uint8_t>(texel[0])],
+            table[static_cast<uint8_t>(texel[1])],
+            table[static_cast<uint8_t>(texel[2])],
+        };
+    }
+    case Format::Unorm8:
+        return glm::vec3(
+                   static_cast<uint8_t>(texel[0]), static_cast<uint8_t>(texel[1]), static_cast<uint8_t>(texel[2])) /
+               255.0f;
+    case Format::Half: {
+        std::array<uint16_t, 3> halves{};
+        std::memcpy(halves.data(), texel, sizeof(halves));
+        return {glm::unpackHalf1x16(halves[0]), glm::unpackHalf1x16(halves[1]), glm::unpackHalf1x16(halves[2])};
+    }
+    }
+    return glm::vec3(0.0f);
+}
+} // namespace crisp
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include <Crisp/Core/Result.hpp>
+#include <Crisp/Math/Headers.hpp>
+
+namespace crisp {
+// Mip pyramid of an RGB image, split into square tiles that live in a cache file and are read one at a time, or that
+// are all kept in memory when there is no cache file. Texels are stored compactly: 8 bits per channel for low dynamic
+// range sources and half floats for high dynamic range ones, so a tile of a color texture takes a quarter or half of
+// the space of float RGB.
+class TiledImage {
+public:
+    using Tile = std::shared_ptr<const std::vector<std::byte>>;
+
+    enum class Format : uint32_t {
+        Srgb8,  // 8-bit sRGB-encoded color.
+        Unorm8, // 8-bit linear data, such as roughness or normal maps.
+        Half,   // 16-bit floats.
+    };
+
+    static constexpr int32_t kTileSize = 64;
+
+    struct Level {
+        glm::ivec2 size;
+        glm::ivec2 tileCount;
+        uint64_t firstTile; // Index of the level's first tile in the cache file.
+    };
+
+    // Opens the tiled version of the image file in cacheDirectory, building it first if it is missing or stale.
+    // Without a cacheDirectory, the pyramid is built in memory every time.
+    // LDR images are Srgb8 unless linear is set, in which case they are Unorm8; EXR and HDR images are always Half.
+    static Result<std::unique_ptr<TiledImage>> create(
+        const std::filesystem::path& imagePath, const std::filesystem::path& cacheDirectory, bool linear);
+
+    // Builds the pyramid from linear RGB texels, stored row by row from the top, and writes it to cachePath, or keeps
+    // it in memory if cachePath is empty.
+    static Result<std::unique_ptr<TiledImage>> create(
+        std::span<const float> rgb, glm::ivec2 size, Format format, const std::filesystem::path& cachePath);
+
+    Format getFormat() const;
+    int32_t getLevelCount() const;
+    const Level& getLevel(int32_t level) const;
+
+    size_t getTileByteSize() const;
+    size_t getBytesPerTexel() const;
+
+    // Reads one tile of kTileSize^2 texels, padded with the edge texels of the level. Safe to call concurrently.
+    void readTile(int32_t level, glm::ivec2 tile, std::span<std::byte> texels) const;
+
+    // Pyramids kept in memory hand out their tiles directly.
+    bool isInMemory() const;
+    const Tile& getTile(int32_t level, glm::ivec2 tile) const;
+
+    // Decodes the texel at the given byte offset of a tile into linear RGB.
+    glm::vec3 decodeTexel(const std::byte* texel) const;
+
+private:
+    TiledImage(Format format, glm::ivec2 size, std::filesystem::path cachePath);
+
+    Result<> open();
+
+    Format m_format;
+    std::vector<Level> m_levels;
+    std::filesystem::path m_cachePath;
+    std::vector<Tile> m_tiles; // All tiles in file order, for a pyramid kept in memory.
+
+    mutable std::mutex m_fileMutex;
+    mutable std::ifstream m_file;
+};
+} // namespace crisp
@@ -0,0 +1,144 @@
+#include <Crisp/PathTracer/TileScheduler.hpp>
+
+#include <algorithm>
+
+namespace crisp {
+std::vector<ImageBlock::Descriptor> TileScheduler::createSpiralBlocks(const glm::ivec2& size, const int blockSize) {
+    const int numRows = (size.y - 1) / blockSize + 1;
+    const int numCols = (size.x - 1) / blockSize + 1;
+
+    std::vector<ImageBlock::Descriptor> descriptors;
+    descriptors.reserve(static_cast<size_t>(numRows) * numCols);
+    for (int row = 0; row < size.y; row += blockSize) {
+        for (int col = 0; col < size.x; col += blockSize) {
+            descriptors.emplace_back(col, row, std::min(blockSize, size.x - col), std::min(blockSize, size.y - row));
+        }
+    }
+
+    // Walks the grid from the outside in, clockwise, and reverses the result below.
+    std::vector<int> indices;
+    indices.reserve(descriptors.size());
+    int top = 0;
+    int left = 0;
+    int bottom = numRows;
+    int right = numCols;
+    while (top < bottom && left < right) {
+        for (int i = left; i < right; ++i) {
+            indices.push_back(top * numCols + i);
+        }
+        ++top;
+        for (int i = top; i < bottom; ++i) {
+            indices.push_back(i * numCols + right - 1);
+        }
+        --right;
+
+        if (top < bottom) {
+            for (int i = right - 1; i >= left; --i) {
+                indices.push_back((bottom - 1) * numCols + i);
+            }
+            --bottom;
+        }
+
+        if (left < right) {
+            for (int i = bottom - 1; i >= top; --i) {
+                indices.push_back(i * numCols + left);
+            }
+            ++left;
+        }
+    }
+
+    std::vector<ImageBlock::Descriptor> orderedDescriptors;
+    orderedDescriptors.reserve(indices.size());
+    for (auto iter = indices.rbegin(); iter != indices.rend(); ++iter) {
+        orderedDescriptors.push_back(descriptors[*iter]);
+    }
+    return orderedDescriptors;
+}
+
+void TileScheduler::reset(
+    const std::span<const ImageBlock::Descriptor> blocks,
+    const std::span<const size_t> pendingBlocks,
+    const std::span<const double> costs,
+    const int concurrency,
+    const int minTileSize) {
+    std::vector<size_t> order(pendingBlocks.begin(), pendingBlocks.end());
+    if (!costs.empty()) {
+        // Equally expensive blocks keep the order they were given in.
+        std::ranges::stable_sort(order, std::ranges::greater{}, [&costs](const size_t index) { return costs[index]; });
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_queue.clear();
+    m_outstandingTiles.assign(blocks.size(), 0);
+    for (const size_t index : order) {
+        m_queue.push_back({.desc = blocks[index], .blockIndex = index});
+        m_outstandingTiles[index] = 1;
+    }
+    m_concurrency = static_cast<size_t>(std::max(concurrency, 1));
+    m_minTileSize = minTileSize;
+    m_splitCount = 0;
+}
+
+std::optional<ScheduledTile> TileScheduler::pop() {
+    std::lock_guard lock(m_mutex);
+    if (m_queue.empty()) {
+        return std::nullopt;
+    }
+
+    ScheduledTile tile = m_queue.front();
+    m_queue.pop_front();
+    if (m_minTileSize <= 0 || m_queue.size() >= m_concurrency) {
+        return tile;
+    }
+
+    const glm::ivec2 size = tile.desc.size;
+    const bool splitX = size.x >= 2 * m_minTileSize;
+    const bool splitY = size.y >= 2 * m_minTileSize;
+    if (!splitX && !splitY) {
+        return tile;
+    }
+
+    const glm::ivec2 first(splitX ? size.x / 2 : size.x, splitY ? size.y / 2 : size.y);
+    const glm::ivec2 offset = tile.desc.offset;
+    std::vector<ImageBlock::Descriptor> parts;
+    parts.emplace_back(offset.x, offset.y, first.x, first.y);
+    if (splitX) {
+        parts.emplace_back(offset.x + first.x, offset.y, size.x - first.x, first.y);
+    }
+    if (splitY) {
+        parts.emplace_back(offset.x, offset.y + first.y, first.x, size.y - first.y);
+    }
+    if (splitX && splitY) {
+        parts.emplace_back(offset.x + first.x, offset.y + first.y, size.x - first.x, size.y - first.y);
+    }
+
+    // The other parts are as expensive as the tile they came from, so they go ahead of everything else.
+    for (size_t i = parts.size() - 1; i > 0; --i) {
+        m_queue.push_front({.desc = parts[i], .blockIndex = tile.blockIndex});
+    }
+    m_outstandingTiles[tile.blockIndex] += static_cast<uint32_t>(parts.size() - 1);
+    ++m_splitCount;
+    tile.desc = parts.front();
+    return tile;
+}
+
+void TileScheduler::push(const ScheduledTile& tile) {
+    std::lock_guard lock(m_mutex);
+    m_queue.push_front(tile);
+}
+
+bool TileScheduler::finish(const ScheduledTile& tile) {
+    std::lock_guard lock(m_mutex);
+    return --m_outstandingTiles[tile.blockIndex] == 0;
+}
+
+size_t TileScheduler::getQueuedCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_queue.size();
+}
+
+size_t TileScheduler::getSplitCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_splitCount;
+}
+} // namespace crisp
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <Crisp/PathTracer/ImageBlock.hpp>
+
+namespace crisp {
+// A region of the image handed to one thread, together with the block it belongs to. Tiles are whole blocks unless
+// the scheduler had to split them.
+struct ScheduledTile {
+    ImageBlock::Descriptor desc;
+    size_t blockIndex{0};
+};
+
+// Hands out the blocks of a frame to the rendering threads. Blocks are queued in order of decreasing estimated cost,
+// so that the expensive ones start early instead of leaving the other threads waiting at the end of the frame. Once
+// fewer tiles are queued than threads render them, every tile taken from the queue is split into quarters, down to a
+// minimum size, and the quarters not returned are queued in front for the threads that run out of work.
+class TileScheduler {
+public:
+    // Splits the image into blockSize squares, clipped at the right and bottom, ordered in a spiral that starts at the
+    // center of the image.
+    static std::vector<ImageBlock::Descriptor> createSpiralBlocks(const glm::ivec2& size, int blockSize);
+
+    // Queues the pending blocks, in the given order when costs is empty and by decreasing cost otherwise, with one cost
+    // per block. Splitting is disabled when minTileSize is 0.
+    void reset(
+        std::span<const ImageBlock::Descriptor> blocks,
+        std::span<const size_t> pendingBlocks,
+        std::span<const double> costs,
+        int concurrency,
+        int minTileSize);
+
+    std::optional<ScheduledTile> pop();
+
+    // Queues a tile again, e.g. one that a distributed worker failed to return.
+    void push(const ScheduledTile& tile);
+
+    // Records that a tile has been rendered and returns whether it was the last outstanding tile of its block.
+    bool finish(const ScheduledTile& tile);
+
+    size_t getQueuedCount() const;
+    size_t getSplitCount() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::deque<ScheduledTile> m_queue;
+    std::vector<uint32_t> m_outstandingTiles; // Tiles of each block that are queued or being rendered.
+    size_t m_concurrency{1};
+    int m_minTileSize{0};
+    size_t m_splitCount{0};
+};
+} // namespace crisp
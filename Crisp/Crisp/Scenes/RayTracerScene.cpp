@@ -99,14 +99,15 @@ void RayTracerScene::writeImageToExr() {
     }
 
     spdlog::info("Writing an EXR image at {}", filepath.string());
-    const glm::ivec2 imageSize = m_rayTracer->getImageSize();
-    saveExr(filepath, m_imageData, imageSize.x, imageSize.y, FlipAxis::Y).unwrap();
+    m_rayTracer->writeLayeredExr(filepath, ExrPixelType::Half, {.flipAxis = FlipAxis::Y}).unwrap();
 }
 
 void RayTracerScene::openSceneFile(const std::filesystem::path& filename) {
     m_renderer->flushResourceUpdates(true);
     m_projectName = filename.stem().string();
-    m_rayTracer->initializeScene(filename, m_renderer->getResourcesPath());
+    if (!m_rayTracer->initializeScene(filename, m_renderer->getResourcesPath()).isValid()) {
+        return;
+    }
 
     glm::ivec2 imageSize = m_rayTracer->getImageSize();
     m_image = std::make_unique<RayTracedImage>(imageSize.x, imageSize.y, m_renderer);
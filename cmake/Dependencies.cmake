@@ -161,6 +161,8 @@ block()
 set(BUILD_TESTING OFF)
 set(EMBREE_ISPC_SUPPORT OFF CACHE BOOL "" FORCE)
 set(EMBREE_TUTORIALS OFF CACHE BOOL "" FORCE)
+# Scene prototypes may instance other prototypes; the default of a single level rejects any nesting.
+set(EMBREE_MAX_INSTANCE_LEVEL_COUNT 4 CACHE STRING "" FORCE)
 FetchContent_MakeAvailable(embree)
 endblock()
 